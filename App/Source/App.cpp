@@ -1,12 +1,23 @@
 #include "Mupfel.h"
 #include "HelloWorldLayer.h"
 
-int main()
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
 {
 
 	Mupfel::ApplicationSpecification app_spec;
 	app_spec.name.insert(0, "My first Application");
 
+	/* "--headless [frames]" runs the simulation without a window, e.g. on CI. */
+	if (argc > 1 && std::strcmp(argv[1], "--headless") == 0)
+	{
+		app_spec.headless.enabled = true;
+		app_spec.headless.unlimited = true;
+		app_spec.headless.maxFrames = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 600;
+	}
+
 	if (Mupfel::App::Init(app_spec))
 	{
 		Mupfel::App::PushLayer<HelloWorldLayer>();
@@ -12,6 +12,9 @@ void HelloWorldLayer::OnInit()
 	/* Create a Scene */
 	mainMenu = Scenes::Create<MainMenu>("MainMenu");
 	level = Scenes::Create<Level>("Dungeon");
+
+	/* The level's entities are built in the background and merged over the first frames. */
+	Scenes::Stream(level);
 }
 
 void HelloWorldLayer::OnUpdate(double timestep)
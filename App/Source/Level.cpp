@@ -7,48 +7,48 @@ using namespace Mupfel;
 void Level::OnInit()
 {
 	camera.pitch = 1.569051f;
-	Images::Load("Images/dungeon.png").transform([this](ImageHandle handle) { this->image_map["Map"] = handle; });
-
-	Images::LoadAnimated("Images/Vampires1/With_shadow/Vampires1_Idle_with_shadow.png", {.rows = 4, .columns = 4})
-			.transform([this](ImageHandle handle) { this->image_map["Vampire"] = handle; });
-
-	Images::LoadAnimated("Images/chest.png", {.rows = 3, .columns = 5})
-				 .transform([this](ImageHandle handle) { this->image_map["Chest"] = handle; });
-
-	Images::LoadAnimated("Images/garg_lava.png", {.rows = 1, .columns = 3})
-				 .transform([this](ImageHandle handle) { this->image_map["GargLava"] = handle; });
-
-	Images::LoadAnimated("Images/garg_water.png", {.rows = 1, .columns = 3})
-				 .transform([this](ImageHandle handle) { this->image_map["GargWater"] = handle; });
+	/* Decoded in the background; the sprites show the default texture for the first frames. */
+	image_map["Map"] = Images::LoadAsync("Images/dungeon.png");
+	image_map["Vampire"] = Images::LoadAnimatedAsync(
+		"Images/Vampires1/With_shadow/Vampires1_Idle_with_shadow.png", {.rows = 4, .columns = 4});
+	image_map["Chest"] = Images::LoadAnimatedAsync("Images/chest.png", {.rows = 3, .columns = 5});
+	image_map["GargLava"] = Images::LoadAnimatedAsync("Images/garg_lava.png", {.rows = 1, .columns = 3});
+	image_map["GargWater"] = Images::LoadAnimatedAsync("Images/garg_water.png", {.rows = 1, .columns = 3});
+	image_map["Spikes"] = Images::LoadAnimatedAsync("Images/spikes.png", {.rows = 1, .columns = 4});
+
+	/* The rest of the level is built by OnStage() when the level streams in. */
+	player.Init();
+}
 
-	Images::LoadAnimated("Images/spikes.png", {.rows = 1, .columns = 4})
-				 .transform([this](ImageHandle handle) { this->image_map["Spikes"] = handle; });
+void Level::OnStage(Registry& staging)
+{
+	/* Runs on a worker thread after OnInit(); image_map is only read here. */
 
 	// Ground: one large flat quad in the x/y plane, grass tiled ~1 texture per world unit.
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.scale_x = 31.0f;
 		g.scale_y = 13.0f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("Map"))
 		{
 			Texture tex;
 			tex.uvScale = 1.0f;
-			tex.index = image_map["Map"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("Map");
+			staging.AddComponent<Texture>(e, tex);
 		}
 	}
 
 	/* A simple Light */
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.pos_z = 1.0f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		Light l;
 		l.ambientStrength = 0.1;
@@ -56,102 +56,102 @@ void Level::OnInit()
 		l.g = 1.0f;
 		l.b = 1.0f;
 
-		Entities::AddComponent<Light>(e, l);
+		staging.AddComponent<Light>(e, l);
 	}
 
 	/* The 3 different chests */
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("Chest"))
 		{
 			Texture tex;
-			tex.index = image_map["Chest"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("Chest");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {0, 5, 2.0f});
+		staging.AddComponent<Animation>(e, {0, 5, 2.0f});
 	}
 
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.pos_x = 1.0f;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("Chest"))
 		{
 			Texture tex;
-			tex.index = image_map["Chest"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("Chest");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {5, 5, 2.0f});
+		staging.AddComponent<Animation>(e, {5, 5, 2.0f});
 	}
 
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.pos_x = 2.0f;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("Chest"))
 		{
 			Texture tex;
-			tex.index = image_map["Chest"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("Chest");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {10, 5, 2.0f});
+		staging.AddComponent<Animation>(e, {10, 5, 2.0f});
 	}
 
 	/* Two gargs */
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.scale_y = 3.0f;
 		g.pos_x = -6.0f;
 		g.pos_y = 5.0f;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("GargLava"))
 		{
 			Texture tex;
-			tex.index = image_map["GargLava"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("GargLava");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {0, 3, 2.0f});
+		staging.AddComponent<Animation>(e, {0, 3, 2.0f});
 	}
 
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.scale_y = 3.0f;
 		g.pos_x = -5.0f;
 		g.pos_y = 5.0f;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("GargWater"))
 		{
 			Texture tex;
-			tex.index = image_map["GargWater"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("GargWater");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {0, 3, 2.0f});
+		staging.AddComponent<Animation>(e, {0, 3, 2.0f});
 	}
 
 	/* A bunch of spikes */
@@ -175,26 +175,24 @@ void Level::OnInit()
 
 	for (auto& [x, y] : spike_positions)
 	{
-		Entity	  e = Entities::Create();
+		Entity	  e = staging.CreateEntity();
 		Transform g;
 		g.pos_x = x;
 		g.pos_y = y;
 		g.pos_z = 0.08f;
 
-		Entities::AddComponent<Transform>(e, g);
+		staging.AddComponent<Transform>(e, g);
 
 		if (image_map.contains("Spikes"))
 		{
 			Texture tex;
-			tex.index = image_map["Spikes"];
-			Entities::AddComponent<Texture>(e, tex);
+			tex.index = image_map.at("Spikes");
+			staging.AddComponent<Texture>(e, tex);
 		}
 
-		Entities::AddComponent<Animation>(e, {0, 4, 1.0f, elapsed});
+		staging.AddComponent<Animation>(e, {0, 4, 1.0f, elapsed});
 		elapsed += 0.1f;
 	}
-
-	player.Init();
 }
 
 void Level::OnUpdate(double timestep) { player.UpdateMovement(timestep); }
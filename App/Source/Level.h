@@ -19,6 +19,7 @@ public:
 	void OnRender() final;
 	void OnSwitchIn() final;
 	void OnSwitchOut() final;
+	void OnStage(Mupfel::Registry& staging) final;
 
 private:
 	void Serialize(const std::string& path) final;
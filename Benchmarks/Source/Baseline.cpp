@@ -0,0 +1,276 @@
+// Baseline comparison for the benchmark runner, see Baseline.h.
+
+#include "Baseline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+namespace MupfelBench {
+
+namespace {
+
+// Splits one CSV line on ';', honoring double quotes (with "" as an escaped quote).
+std::vector<std::string> SplitFields(const std::string& line)
+{
+	std::vector<std::string> fields(1);
+	bool					 quoted = false;
+
+	for (size_t i = 0; i < line.size(); ++i)
+	{
+		const char c = line[i];
+		if (c == '"')
+		{
+			if (quoted && i + 1 < line.size() && line[i + 1] == '"')
+			{
+				fields.back() += '"';
+				++i;
+			}
+			else
+			{
+				quoted = !quoted;
+			}
+		}
+		else if (c == ';' && !quoted)
+		{
+			fields.emplace_back();
+		}
+		else if (c != '\r')
+		{
+			fields.back() += c;
+		}
+	}
+
+	return fields;
+}
+
+std::optional<double> ParseNumber(const std::string& field)
+{
+	char*		 end = nullptr;
+	const double value = std::strtod(field.c_str(), &end);
+	if (end == field.c_str() || !std::isfinite(value))
+	{
+		return std::nullopt;
+	}
+	return value;
+}
+
+std::string Key(const std::string& title, const std::string& name) { return title + '\x1f' + name; }
+
+const char* StatusLabel(BaselineStatus status)
+{
+	switch (status)
+	{
+	case BaselineStatus::Improved:
+		return "improved";
+	case BaselineStatus::Regressed:
+		return "REGRESSED";
+	case BaselineStatus::New:
+		return "new";
+	case BaselineStatus::Missing:
+		return "missing";
+	default:
+		return "";
+	}
+}
+
+} // namespace
+
+std::vector<BaselineRow> ParseBaseline(std::istream& csv)
+{
+	struct Columns
+	{
+		int title = -1;
+		int name = -1;
+		int unit = -1;
+		int batch = -1;
+		int elapsed = -1;
+		int error = -1;
+	};
+
+	std::vector<BaselineRow> rows;
+	Columns					 columns;
+	std::string				 line;
+
+	while (std::getline(csv, line))
+	{
+		const std::vector<std::string> fields = SplitFields(line);
+
+		// Every RenderCsv call starts with a header line; re-read it, in case the template changed.
+		if (fields[0] == "title")
+		{
+			columns = {};
+			for (int i = 0; i < static_cast<int>(fields.size()); ++i)
+			{
+				const std::string& f = fields[i];
+				if (f == "title")
+					columns.title = i;
+				else if (f == "name")
+					columns.name = i;
+				else if (f == "unit")
+					columns.unit = i;
+				else if (f == "batch")
+					columns.batch = i;
+				else if (f == "elapsed")
+					columns.elapsed = i;
+				else if (f == "error %")
+					columns.error = i;
+			}
+			continue;
+		}
+
+		const int needed = std::max({columns.title, columns.name, columns.batch, columns.elapsed});
+		if (columns.title < 0 || columns.name < 0 || columns.elapsed < 0 ||
+			needed >= static_cast<int>(fields.size()))
+		{
+			continue;
+		}
+
+		const std::optional<double> elapsed = ParseNumber(fields[columns.elapsed]);
+		if (!elapsed || *elapsed <= 0.0)
+		{
+			continue;
+		}
+
+		BaselineRow& row = rows.emplace_back();
+		row.title = fields[columns.title];
+		row.name = fields[columns.name];
+		row.elapsed = *elapsed;
+
+		if (columns.unit >= 0 && columns.unit < static_cast<int>(fields.size()))
+		{
+			row.unit = fields[columns.unit];
+		}
+		if (columns.batch >= 0)
+		{
+			row.batch = std::max(ParseNumber(fields[columns.batch]).value_or(1.0), 1e-12);
+		}
+		if (columns.error >= 0 && columns.error < static_cast<int>(fields.size()))
+		{
+			row.error = std::abs(ParseNumber(fields[columns.error]).value_or(0.0));
+		}
+	}
+
+	return rows;
+}
+
+std::optional<std::vector<BaselineRow>> LoadBaseline(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		return std::nullopt;
+	}
+	return ParseBaseline(file);
+}
+
+std::vector<BaselineComparison> CompareBaseline(
+	const std::vector<BaselineRow>& baseline,
+	const std::vector<BaselineRow>& current,
+	double							threshold)
+{
+	// A case that ran twice (e.g. a repeated group) keeps its last result, on both sides.
+	std::unordered_map<std::string, const BaselineRow*> before;
+	for (const BaselineRow& row : baseline)
+	{
+		before[Key(row.title, row.name)] = &row;
+	}
+
+	std::vector<BaselineComparison> comparison;
+	std::unordered_map<std::string, size_t> seen;
+
+	for (const BaselineRow& row : current)
+	{
+		const std::string key = Key(row.title, row.name);
+
+		BaselineComparison entry;
+		entry.title = row.title;
+		entry.name = row.name;
+		entry.current = row.PerUnit();
+
+		auto it = before.find(key);
+		if (it == before.end())
+		{
+			entry.status = BaselineStatus::New;
+		}
+		else
+		{
+			const BaselineRow& old = *it->second;
+			entry.baseline = old.PerUnit();
+			entry.change = entry.current / entry.baseline - 1.0;
+			entry.noise = std::sqrt(old.error * old.error + row.error * row.error);
+
+			const double significant = std::max(threshold, entry.noise);
+			if (entry.change > significant)
+				entry.status = BaselineStatus::Regressed;
+			else if (entry.change < -significant)
+				entry.status = BaselineStatus::Improved;
+		}
+
+		auto [slot, inserted] = seen.try_emplace(key, comparison.size());
+		if (inserted)
+			comparison.push_back(std::move(entry));
+		else
+			comparison[slot->second] = std::move(entry);
+	}
+
+	for (const BaselineRow& row : baseline)
+	{
+		const std::string key = Key(row.title, row.name);
+		if (seen.contains(key))
+		{
+			continue;
+		}
+		seen.emplace(key, comparison.size());
+
+		BaselineComparison& entry = comparison.emplace_back();
+		entry.title = row.title;
+		entry.name = row.name;
+		entry.baseline = before[key]->PerUnit();
+		entry.status = BaselineStatus::Missing;
+	}
+
+	return comparison;
+}
+
+uint32_t PrintComparison(const std::vector<BaselineComparison>& comparison, double threshold, std::ostream& out)
+{
+	out << "\n| baseline ns/unit | current ns/unit |  change |  noise | status    | benchmark\n"
+		   "|-----------------:|----------------:|--------:|-------:|:----------|:----------\n";
+
+	uint32_t regressions = 0;
+	uint32_t improvements = 0;
+
+	for (const BaselineComparison& c : comparison)
+	{
+		const bool both = c.status != BaselineStatus::New && c.status != BaselineStatus::Missing;
+
+		char row[160];
+		if (both)
+		{
+			std::snprintf(row, sizeof(row), "| %16.3f | %15.3f | %+6.1f%% | %5.1f%% | %-9s |", c.baseline * 1e9,
+				c.current * 1e9, c.change * 100.0, c.noise * 100.0, StatusLabel(c.status));
+		}
+		else
+		{
+			std::snprintf(row, sizeof(row), "| %16.3f | %15.3f | %7s | %6s | %-9s |", c.baseline * 1e9,
+				c.current * 1e9, "", "", StatusLabel(c.status));
+		}
+		out << row << " `" << c.title << " / " << c.name << "`\n";
+
+		regressions += (c.status == BaselineStatus::Regressed) ? 1 : 0;
+		improvements += (c.status == BaselineStatus::Improved) ? 1 : 0;
+	}
+
+	out << "\n" << regressions << " regressed, " << improvements << " improved (threshold "
+		<< threshold * 100.0 << "%, or the noise if larger)\n";
+
+	return regressions;
+}
+
+} // namespace MupfelBench
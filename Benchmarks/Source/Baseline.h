@@ -0,0 +1,81 @@
+#pragma once
+//
+// Baseline comparison for the benchmark runner (`--baseline` / `--save-baseline`, see main.cpp).
+//
+// A baseline is nothing but the CSV the groups write through RenderCsv: one row per benchmarked case with
+// its median time per invocation and nanobench's error estimate (median absolute percentage error). A run
+// is compared against it row by row, matched on group title + case name.
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace MupfelBench {
+
+/** One benchmarked case, as read back from nanobench's CSV template. */
+struct BaselineRow
+{
+	std::string title;
+	std::string name;
+	std::string unit;
+	double		batch = 1.0;
+	/** Median seconds per invocation of the benchmarked lambda (i.e. per `batch` units). */
+	double elapsed = 0.0;
+	/** Median absolute percentage error of `elapsed`, as a fraction (0.01 = 1%). */
+	double error = 0.0;
+
+	/** Seconds per unit (entity, op, ...). */
+	double PerUnit() const { return elapsed / batch; }
+};
+
+/**
+ * Parses the rows of one or more nanobench CSV renders (header lines may repeat, one per group). Columns
+ * are located by header name, so extra or reordered columns don't matter; malformed lines are skipped.
+ */
+std::vector<BaselineRow> ParseBaseline(std::istream& csv);
+
+/** Reads a baseline file; std::nullopt if it can't be opened. */
+std::optional<std::vector<BaselineRow>> LoadBaseline(const std::string& path);
+
+enum class BaselineStatus : uint8_t
+{
+	/** The change is within the threshold or within the measurement noise. */
+	Unchanged,
+	Improved,
+	Regressed,
+	/** Only in the current run. */
+	New,
+	/** Only in the baseline (e.g. a group was filtered out or removed). */
+	Missing
+};
+
+struct BaselineComparison
+{
+	std::string title;
+	std::string name;
+	/** Seconds per unit; 0 where the row doesn't exist. */
+	double baseline = 0.0;
+	double current = 0.0;
+	/** current / baseline - 1, e.g. 0.25 for 25% slower. */
+	double change = 0.0;
+	/** Combined error estimate of both measurements, as a fraction. */
+	double noise = 0.0;
+	BaselineStatus status = BaselineStatus::Unchanged;
+};
+
+/**
+ * Compares `current` against `baseline`. A row only counts as regressed (improved) when it got slower
+ * (faster) by more than `threshold` *and* by more than its noise, sqrt(error_baseline^2 + error_current^2),
+ * so a single jittery row doesn't fail the run. Rows keep the order of `current`; missing ones come last.
+ */
+std::vector<BaselineComparison> CompareBaseline(
+	const std::vector<BaselineRow>& baseline,
+	const std::vector<BaselineRow>& current,
+	double							threshold);
+
+/** Prints the comparison as a markdown table and returns the number of regressed rows. */
+uint32_t PrintComparison(const std::vector<BaselineComparison>& comparison, double threshold, std::ostream& out);
+
+} // namespace MupfelBench
@@ -12,6 +12,7 @@
 #include "ECS/Registry.h"
 #include "ECS/Components/Transform.h"
 #include "ECS/Components/Movement.h"
+#include "ECS/Components/Texture.h"
 
 #include <nanobench.h>
 
@@ -20,10 +21,27 @@
 #include <cstdint>
 #include <ostream>
 #include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 
 namespace MupfelBench {
 
+/** Settings the runner takes from the command line (see main.cpp) and every group picks up. */
+struct RunOptions
+{
+	/** Minimum time per epoch, `--min-epoch-ms`. */
+	std::chrono::milliseconds minEpochTime{50};
+	/** When set (`--json`), RenderCsv also appends every bench rendered with nanobench's JSON template. */
+	std::vector<std::string>* json = nullptr;
+};
+
+inline RunOptions& Options()
+{
+	static RunOptions options;
+	return options;
+}
+
 /**
  * Applies the reliability knobs every benchmark group shares, then returns the bench for chaining
  * (`ApplyDefaults(bench).title(...).unit(...)`):
@@ -31,12 +49,16 @@ namespace MupfelBench {
  *   - minEpochTime(50ms)        : each epoch runs at least 50ms worth of iterations, so even the
  *                                 fastest cases accumulate hundreds of samples and report a stable
  *                                 median instead of nanobench's "Unstable, increase iterations" warning.
- * Runtime vs. stability is a single dial here: lower minEpochTime for a faster suite, raise it for
+ *                                 `--min-epoch-ms` overrides it (Options().minEpochTime).
+ *   - performanceCounters(true) : on Linux, adds instructions, IPC and branch misses per op to every
+ *                                 table (nanobench's own perf_event group). Where the kernel doesn't
+ *                                 allow counting, nanobench just leaves those columns out.
+ * Runtime vs. stability is a single dial here: lower the epoch time for a faster suite, raise it for
  * tighter error bars.
  */
 inline ankerl::nanobench::Bench& ApplyDefaults(ankerl::nanobench::Bench& bench)
 {
-	return bench.warmup(20).minEpochTime(std::chrono::milliseconds(50));
+	return bench.warmup(20).minEpochTime(Options().minEpochTime).performanceCounters(true);
 }
 
 /**
@@ -91,6 +113,37 @@ inline uint32_t MovementMatches(uint32_t count, uint32_t movement_stride)
 	return (count + movement_stride - 1) / movement_stride;
 }
 
+/**
+ * Scatters `count` drawable sprites (Transform + Texture) uniformly over a square world of edge length
+ * `extent`, centered on 0 -- the input of the renderer's instance packing.
+ */
+inline void PopulateSprites(World& world, uint32_t count, float extent)
+{
+	std::mt19937						  rng(0xC0FFEEu);
+	std::uniform_real_distribution<float> pos(-extent * 0.5f, extent * 0.5f);
+
+	world.entities.clear();
+	world.entities.reserve(count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Mupfel::Entity e = world.registry.CreateEntity();
+
+		Mupfel::Transform t;
+		t.pos_x = pos(rng);
+		t.pos_y = pos(rng);
+		t.pos_z = 0.08f;
+		world.registry.AddComponent<Mupfel::Transform>(e, t);
+		world.registry.AddComponent<Mupfel::Texture>(e, Mupfel::Texture{i % 16, 1.0f});
+
+		world.entities.push_back(e);
+	}
+
+	// Drain the creation events so they don't sit in the buffers for the whole run.
+	world.events.Update();
+	world.events.Update();
+}
+
 /**
  * A fixed-seed shuffled copy of `world.entities`, for random-access benchmarks: iterating these
  * instead of the creation-ordered list measures sparse-set indirection under cache-unfriendly access
@@ -107,11 +160,19 @@ inline std::vector<Mupfel::Entity> ShuffledEntities(const World& world, uint32_t
 /**
  * If `csv` is non-null, appends this bench's results to it in CSV form (one row per benchmarked case)
  * for machine-readable regression tracking. The human-readable markdown table always goes to stdout.
+ * With `--json`, the bench is also kept as a JSON document (all its epochs, for offline analysis).
  */
 inline void RenderCsv(ankerl::nanobench::Bench& bench, std::ostream* csv)
 {
 	if (csv)
 		bench.render(ankerl::nanobench::templates::csv(), *csv);
+
+	if (Options().json)
+	{
+		std::ostringstream json;
+		bench.render(ankerl::nanobench::templates::json(), json);
+		Options().json->push_back(json.str());
+	}
 }
 
 } // namespace MupfelBench
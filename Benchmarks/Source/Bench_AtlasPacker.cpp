@@ -0,0 +1,91 @@
+// Texture atlas packing benchmarks: the CPU cost of placing sprites into atlas pages, see AtlasPacker.
+//
+// 10k rectangles with random sizes between 8 and 64 pixels (typical sprites and sprite-sheet frames)
+// are packed into 1024x1024 pages, padding 1:
+//   1. online -- AtlasPacker::Insert one rectangle at a time, in arrival order, as asynchronous image
+//                loads do.
+//   2. batch  -- AtlasPacker::InsertBatch, which sorts tallest first before placing.
+// Numbers are per rectangle. The resulting page count and occupancy (how much of the page area holds
+// pixels) are printed along with each run, since a fast packer that wastes half the atlas is no win.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Renderer/AtlasPacker.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t rect_count = 10000;
+constexpr uint32_t page_size = 1024;
+
+std::vector<AtlasRect> MakeSizes(uint32_t count)
+{
+	std::mt19937							rng(0xA71A5u);
+	std::uniform_int_distribution<uint32_t> size(8, 64);
+
+	std::vector<AtlasRect> sizes(count);
+	for (AtlasRect& rect : sizes)
+	{
+		rect.width = size(rng);
+		rect.height = size(rng);
+	}
+	return sizes;
+}
+
+void PrintPacking(const char* name, const AtlasPacker& packer)
+{
+	char line[128];
+	std::snprintf(
+		line, sizeof(line), "%s: %u pages, %.1f%% occupancy\n", name, packer.GetPageCount(),
+		packer.GetOccupancy() * 100.0f);
+	std::cout << line;
+}
+
+} // namespace
+
+void RunAtlasPackerBenchmarks(std::ostream* csv)
+{
+	const std::vector<AtlasRect> sizes = MakeSizes(rect_count);
+	std::vector<AtlasRect>		 placed(rect_count);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench)
+		.title("Atlas packing (" + std::to_string(rect_count) + " rects, " + std::to_string(page_size) + "px pages)")
+		.unit("rect")
+		.relative(true);
+
+	AtlasPacker online(page_size, page_size);
+	bench.batch(rect_count).run("online Insert",
+		[&]
+		{
+			online.Clear();
+			for (const AtlasRect& rect : sizes)
+			{
+				doNotOptimizeAway(online.Insert(rect.width, rect.height));
+			}
+		});
+
+	AtlasPacker batch(page_size, page_size);
+	bench.batch(rect_count).run("InsertBatch (tallest first)",
+		[&]
+		{
+			batch.Clear();
+			doNotOptimizeAway(batch.InsertBatch(sizes, placed));
+		});
+
+	RenderCsv(bench, csv);
+
+	PrintPacking("online Insert", online);
+	PrintPacking("InsertBatch", batch);
+}
+
+} // namespace MupfelBench
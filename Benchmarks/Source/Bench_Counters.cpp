@@ -0,0 +1,148 @@
+// Hardware counter benchmarks: IPC and last level cache misses of the engine's hottest loops, read with
+// Mupfel::PerfCounterGroup (the same counters MUPFEL_PROFILE_COUNTERS scopes report in the DebugLayer).
+//
+// nanobench's own counters (enabled in ApplyDefaults) cover cycles, instructions and branches, but not
+// cache misses, which is what separates a dense-array walk from a sparse-set chase. Cases:
+//   1. view<Transform>, 50k entities      -- dense, every entity matches.
+//   2. view<Movement>, 50k, 10% match     -- the signature filter skips most entities.
+//   3. InstancePacker::Pack, 1M sprites   -- no culling, every sprite is written.
+//   4. InstancePacker::Pack, 1M sprites   -- frustum test, few sprites are written.
+// Numbers are per entity in the world, averaged over `repeats` runs after one warmup run. Where counters
+// are unavailable (no PMU in a VM, perf_event_paranoid, non-Linux), the group prints why and is skipped.
+// It writes no CSV rows; its numbers are for reading, not for regression tracking.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/PerfCounters.h"
+#include "Renderer/Camera.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/InstancePacker.h"
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t repeats = 20;
+
+void PrintHeader()
+{
+	std::cout << "\n| cycles/entity | ins/entity | IPC | LLC miss/entity | branch miss/entity | Hardware counters\n"
+				 "|--------------:|-----------:|----:|----------------:|-------------------:|:------------------\n";
+}
+
+// Runs `body` once to warm up, then `repeats` times under the counters, and prints one table row.
+void Measure(const char* label, uint32_t entities, const std::function<void()>& body)
+{
+	const PerfCounterGroup& group = PerfCounterGroup::ForCurrentThread();
+
+	body();
+
+	const PerfCounterValues before = group.Read();
+	for (uint32_t i = 0; i < repeats; ++i)
+	{
+		body();
+	}
+	const PerfCounterValues delta = (group.Read() - before).Scaled();
+
+	const double per = 1.0 / (static_cast<double>(entities) * repeats);
+	auto		 cell = [&](PerfCounter counter, uint64_t value)
+	{
+		char text[32] = "n/a";
+		if (group.Has(counter))
+		{
+			std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(value) * per);
+		}
+		return std::string(text);
+	};
+
+	char row[256];
+	std::snprintf(row, sizeof(row), "| %13s | %10s | %3.2f | %15s | %18s | `%s`\n",
+		cell(PerfCounter::Cycles, delta.cycles).c_str(),
+		cell(PerfCounter::Instructions, delta.instructions).c_str(),
+		delta.Ipc(),
+		cell(PerfCounter::LlcMisses, delta.llcMisses).c_str(),
+		cell(PerfCounter::BranchMisses, delta.branchMisses).c_str(),
+		label);
+	std::cout << row;
+}
+
+} // namespace
+
+void RunCounterBenchmarks(std::ostream* /*csv*/)
+{
+	const PerfCounterGroup& group = PerfCounterGroup::ForCurrentThread();
+	if (!group.IsAvailable())
+	{
+		std::cout << "\nHardware counters unavailable (" << group.GetError() << "), skipping.\n";
+		return;
+	}
+	if (!group.GetError().empty())
+	{
+		std::cout << "\nSome hardware counters are unavailable: " << group.GetError() << "\n";
+	}
+
+	PrintHeader();
+
+	{
+		constexpr uint32_t count = 50000;
+
+		World dense;
+		Populate(dense, count, 1);
+		Measure("view<Transform>  50k entities", count,
+			[&]
+			{
+				float sum = 0.0f;
+				for (auto [e, t] : dense.registry.view<Transform>())
+					sum += t.pos_x;
+				doNotOptimizeAway(sum);
+			});
+
+		World sparse;
+		Populate(sparse, count, 10);
+		Measure("view<Movement>  50k entities, 10% match", count,
+			[&]
+			{
+				float sum = 0.0f;
+				for (auto [e, m] : sparse.registry.view<Movement>())
+					sum += m.velocity_x;
+				doNotOptimizeAway(sum);
+			});
+	}
+
+	{
+		constexpr uint32_t count = 1000000;
+
+		World world;
+		PopulateSprites(world, count, 2000.0f);
+
+		const CameraMatrices matrices = CameraMatrices::FromCamera(Camera{}, 16.0f / 9.0f);
+		const Frustum		 frustum = Frustum::FromViewProjection(matrices.proj * matrices.view);
+
+		std::vector<TextureInstance> instances(count);
+
+		Measure("InstancePacker::Pack  1M sprites, no culling", count,
+			[&]
+			{
+				uint32_t n = InstancePacker::Pack(world.registry, Frustum{}, instances);
+				doNotOptimizeAway(n);
+			});
+
+		Measure("InstancePacker::Pack  1M sprites, frustum test", count,
+			[&]
+			{
+				uint32_t n = InstancePacker::Pack(world.registry, frustum, instances);
+				doNotOptimizeAway(n);
+			});
+	}
+}
+
+} // namespace MupfelBench
@@ -0,0 +1,90 @@
+// Culling benchmarks: the CPU side of ECSRenderer::SyncRenderableObjects for a large world seen
+// through a small viewport.
+//
+// 1M drawable (Texture + Transform) sprites are scattered over a 2000 x 2000 world and looked at with
+// the default scene camera, which sees only a ~40 x 20 unit patch of it. Four ways of filling the
+// instance buffer are compared:
+//   1. pack all      -- no culling, what the renderer did before (baseline; draws everything).
+//   2. frustum test  -- InstancePacker::Pack with a per-instance bounding-sphere test.
+//   3. grid query    -- VisibilityGrid prebuilt once (static world), per frame only query + pack.
+//   4. grid rebuild  -- VisibilityGrid rebuilt every frame, then query + pack (moving world).
+// All numbers are per entity in the world, so they show what each approach costs per frame / 1M.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Renderer/Camera.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/InstancePacker.h"
+#include "Renderer/VisibilityGrid.h"
+
+#include <string>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+void RunCullingBenchmarks(std::ostream* csv)
+{
+	constexpr uint32_t count = 1000000;
+	constexpr float	   extent = 2000.0f;
+
+	World world;
+	PopulateSprites(world, count, extent);
+
+	const CameraMatrices matrices = CameraMatrices::FromCamera(Camera{}, 16.0f / 9.0f);
+	const Frustum		 frustum = Frustum::FromViewProjection(matrices.proj * matrices.view);
+
+	std::vector<TextureInstance> instances(count);
+	std::vector<Entity>			 visible;
+	visible.reserve(count);
+
+	VisibilityGrid grid;
+	grid.Build(world.registry);
+
+	const uint32_t on_screen = InstancePacker::Pack(world.registry, frustum, instances);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench)
+		.title("Instance culling + packing (1M sprites, " + std::to_string(on_screen) + " on screen)")
+		.unit("entity")
+		.relative(true);
+
+	bench.batch(count).run("pack all (no culling)",
+		[&]
+		{
+			uint32_t n = InstancePacker::Pack(world.registry, Frustum{}, instances);
+			doNotOptimizeAway(n);
+		});
+
+	bench.batch(count).run("frustum test per instance",
+		[&]
+		{
+			uint32_t n = InstancePacker::Pack(world.registry, frustum, instances);
+			doNotOptimizeAway(n);
+		});
+
+	bench.batch(count).run("VisibilityGrid query (prebuilt, static world)",
+		[&]
+		{
+			visible.clear();
+			grid.Query(frustum, visible);
+			uint32_t n = InstancePacker::Pack(world.registry, visible, instances);
+			doNotOptimizeAway(n);
+		});
+
+	bench.batch(count).run("VisibilityGrid rebuild + query (moving world)",
+		[&]
+		{
+			grid.Build(world.registry);
+			visible.clear();
+			grid.Query(frustum, visible);
+			uint32_t n = InstancePacker::Pack(world.registry, visible, instances);
+			doNotOptimizeAway(n);
+		});
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
@@ -0,0 +1,129 @@
+// Component array order: view throughput over a churned registry, and what sorting and defragmenting win back.
+//
+// 200k entities with Transform + Movement, then 1M random operations, each toggling one of the two
+// components of a random entity: removed if it has it, added back if not. Every swap-remove and re-add
+// scrambles an array, and as the two see different operations, they drift apart. Each row integrates
+// Transforms by their Movement with `view<Transform, Movement>`:
+//   fresh       -- before the churn: both arrays in creation order, walked front to back.
+//   churned     -- after it: the Movement lookups land anywhere in their array.
+//   SortLike    -- SortLike<Movement, Transform>: Movements follow the Transforms' order again.
+//   Defragment  -- Registry::Defragment until done: both arrays back in entity index order.
+// Rows are per matching entity; after the churn only about half of them have both components, and the
+// rows pay for skipping the rest too. The frames a 0.5 ms Defragment budget needs are printed below.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include <iostream>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t entityCount = 200000;
+constexpr uint32_t churnOps = 1000000;
+constexpr double   frameBudget = 0.0005;
+
+void Churn(World& world)
+{
+	Registry&								registry = world.registry;
+	std::mt19937							rng(0xC0FFEEu);
+	std::uniform_int_distribution<uint32_t> pick(0, entityCount - 1);
+	for (uint32_t i = 0; i < churnOps; ++i)
+	{
+		const Entity e = world.entities[pick(rng)];
+		if (rng() & 1u)
+		{
+			if (registry.HasComponent<Transform>(e))
+				registry.RemoveComponent<Transform>(e);
+			else
+				registry.AddComponent<Transform>(e, Transform{});
+		}
+		else
+		{
+			if (registry.HasComponent<Movement>(e))
+			{
+				registry.RemoveComponent<Movement>(e);
+			}
+			else
+			{
+				Movement m;
+				m.velocity_x = 1.0f;
+				registry.AddComponent<Movement>(e, m);
+			}
+		}
+	}
+	world.events.Update();
+	world.events.Update();
+}
+
+// A churned world, built once per row so every row starts from the same scrambled arrays.
+void ChurnedWorld(World& world)
+{
+	Populate(world, entityCount);
+	Churn(world);
+}
+
+uint32_t Matches(World& world)
+{
+	uint32_t count = 0;
+	for (auto [e, t, m] : world.registry.view<Transform, Movement>())
+	{
+		count++;
+	}
+	return count;
+}
+
+void Step(World& world)
+{
+	constexpr float dt = 1.0f / 60.0f;
+	for (auto [e, t, m] : world.registry.view<Transform, Movement>())
+	{
+		t.pos_x += m.velocity_x * dt;
+		t.pos_y += m.velocity_y * dt;
+	}
+}
+
+} // namespace
+
+void RunDefragmentBenchmarks(std::ostream* csv)
+{
+	World fresh;
+	Populate(fresh, entityCount);
+	fresh.events.Update();
+	fresh.events.Update();
+
+	World churned;
+	ChurnedWorld(churned);
+
+	World sorted;
+	ChurnedWorld(sorted);
+	sorted.registry.SortLike<Movement, Transform>();
+
+	World defragmented;
+	ChurnedWorld(defragmented);
+	uint32_t frames = 1;
+	while (!defragmented.registry.Defragment(frameBudget))
+	{
+		frames++;
+	}
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("view<Transform, Movement> over a churned registry").unit("entity");
+
+	bench.batch(Matches(fresh)).run("fresh", [&] { Step(fresh); });
+	bench.batch(Matches(churned)).run("after 1M add/remove", [&] { Step(churned); });
+	bench.batch(Matches(sorted)).run("after 1M add/remove, SortLike<Movement, Transform>", [&] { Step(sorted); });
+	bench.batch(Matches(defragmented)).run("after 1M add/remove, Defragment", [&] { Step(defragmented); });
+
+	doNotOptimizeAway(Matches(churned));
+	RenderCsv(bench, csv);
+
+	std::cout << "\nDefragment with a " << frameBudget * 1000.0 << " ms budget: " << frames
+			  << " frames to put " << entityCount << " entities' arrays back in order\n";
+}
+
+} // namespace MupfelBench
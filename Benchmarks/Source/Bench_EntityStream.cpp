@@ -0,0 +1,148 @@
+// Entity file loading: the streaming EntityStreamLoader (SAX parse, batched bulk inserts) against the DOM
+// path EntityFileManager used before it (json::parse, then one CreateEntity / AddComponent per entity and
+// component).
+//
+// The input is a synthetic entity file in the layout of App/Data/entities.json -- a name plus a Transform,
+// a Texture, a Movement and a Collider per entity -- written to the temp directory:
+//   small  -- 20 MB; both loaders, as nanobench rows (3 single-shot epochs, fresh Registry each).
+//   large  -- 500 MB; the streaming loader only, timed once. The DOM of a file that size alone takes
+//             several GB, which is exactly what the streaming loader avoids.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "FS/EntityStreamLoader.h"
+
+#include "json.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+using namespace Mupfel;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint64_t smallBytes = 20ull * 1024 * 1024;
+constexpr uint64_t largeBytes = 500ull * 1024 * 1024;
+
+// Writes entities until the file reaches `bytes`; returns the number written.
+uint32_t WriteEntityFile(const std::filesystem::path& file, uint64_t bytes)
+{
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	std::mt19937  rng(0xC0FFEEu);
+	std::uniform_real_distribution<float> pos(0.0f, 1024.0f);
+
+	out << "[\n";
+	uint64_t written = 2;
+	uint32_t count = 0;
+	char	 entity[512];
+
+	while (written < bytes)
+	{
+		const int length = std::snprintf(entity, sizeof(entity),
+			"%s  {\"name\": \"Entity%u\", \"components\": ["
+			"{\"name\": \"Transform\", \"pos_x\": %.1f, \"pos_y\": %.1f, \"pos_z\": 0, \"scale_x\": 32, "
+			"\"scale_y\": 32, \"rotation\": %.1f}, "
+			"{\"name\": \"Texture\"}, "
+			"{\"name\": \"Movement\", \"velocity_x\": %.1f, \"velocity_y\": %.1f}, "
+			"{\"name\": \"Collider\", \"type\": \"Circle\", \"radius\": 16.3}]}",
+			count ? ",\n" : "", count, pos(rng), pos(rng), pos(rng) / 100.0f, pos(rng) / 10.0f, pos(rng) / 10.0f);
+		out.write(entity, length);
+		written += static_cast<uint64_t>(length);
+		count++;
+	}
+	out << "\n]\n";
+	return count;
+}
+
+// EntityFileManager::Load before the streaming loader, with the registry passed in.
+void LoadDom(Registry& registry, const std::filesystem::path& file)
+{
+	std::ifstream		 stream(file);
+	const nlohmann::json data = nlohmann::json::parse(stream);
+	for (auto ent : data)
+	{
+		Entity e = registry.CreateEntity();
+		for (auto comp : ent["components"])
+		{
+			if (comp["name"] == "Transform")
+			{
+				Transform t;
+				t.pos_x = comp["pos_x"];
+				t.pos_y = comp["pos_y"];
+				t.pos_z = comp["pos_z"];
+				t.scale_x = comp["scale_x"];
+				t.scale_y = comp["scale_y"];
+				t.rotation = comp["rotation"];
+				registry.AddComponent<Transform>(e, t);
+			}
+			else if (comp["name"] == "Movement")
+			{
+				Movement m;
+				m.velocity_x = comp["velocity_x"];
+				m.velocity_y = comp["velocity_y"];
+				registry.AddComponent<Movement>(e, m);
+			}
+		}
+	}
+}
+
+double MiB(uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+} // namespace
+
+void RunEntityStreamBenchmarks(std::ostream* csv)
+{
+	const std::filesystem::path small = std::filesystem::temp_directory_path() / "mupfel_bench_entities_20mb.json";
+	const std::filesystem::path large = std::filesystem::temp_directory_path() / "mupfel_bench_entities_500mb.json";
+	const uint32_t				small_count = WriteEntityFile(small, smallBytes);
+
+	/* The registries share one EventSystem and ThreadPool; only the Registry is rebuilt per iteration. */
+	World					  shared;
+	std::unique_ptr<Registry> registry;
+	EntityStreamLoader		  loader;
+
+	auto fresh = [&]() -> Registry&
+	{
+		registry = std::make_unique<Registry>(shared.events, shared.thread_pool);
+		shared.events.Update();
+		shared.events.Update();
+		return *registry;
+	};
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Entity file load, 20 MB").unit("entity").batch(small_count);
+	bench.warmup(0).epochs(3).epochIterations(1);
+
+	bench.run("dom     json::parse + AddComponent", [&] { LoadDom(fresh(), small); });
+	bench.run("stream  EntityStreamLoader", [&] { (void)loader.Load(fresh(), small); });
+
+	RenderCsv(bench, csv);
+	std::filesystem::remove(small);
+
+	const uint32_t large_count = WriteEntityFile(large, largeBytes);
+	const uint64_t large_size = std::filesystem::file_size(large);
+
+	Registry&  target = fresh();
+	const auto start = std::chrono::steady_clock::now();
+	auto	   loaded = loader.Load(target, large);
+	const auto end = std::chrono::steady_clock::now();
+
+	const double   seconds = std::chrono::duration<double>(end - start).count();
+	const uint32_t created = loaded ? *loaded : 0;
+
+	char line[200];
+	std::snprintf(line, sizeof(line), "\n%.0f MiB entity file streamed: %.2f s, %.0f MiB/s (%u of %u entities)\n",
+		MiB(large_size), seconds, MiB(large_size) / seconds, created, large_count);
+	std::cout << line;
+
+	registry.reset();
+	std::filesystem::remove(large);
+}
+
+} // namespace MupfelBench
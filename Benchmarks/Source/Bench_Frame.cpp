@@ -0,0 +1,419 @@
+// Frame macro-benchmark: one whole simulated frame of a realistic world, headless.
+//
+// The world is App/Data/entities.json (50 sprites with Transform, Texture, Movement and Collider) tiled
+// outward until it holds 10k / 100k entities, scaled to world units (a 32px sprite is 1 unit) so the
+// default scene camera sees a screenful of it. Every copy gets a random velocity and every fourth one an
+// Animation, since the file has neither. Each frame then runs, in the order Application does:
+//   1. spawn/despawn -- 0.1% of the entities are destroyed and recreated (projectiles, pickups), which
+//                       feeds the events below.
+//   2. events        -- EventSystem::Update.
+//   3. animation     -- AnimationSystem::Advance.
+//   4. movement      -- integrates Transform by Movement, bouncing off the world's edge.
+//   5. collision     -- uniform-grid broadphase + circle overlap test on Collider entities.
+//   6. packing       -- InstancePacker::Pack with the camera frustum, as ECSRenderer does.
+// MovementSystem::Move and CollisionSystem::Update are still empty in the engine, so steps 4 and 5 are
+// stand-ins of the expected per-entity cost; swap them for the real systems once those land.
+//
+// Two outputs per world size: a nanobench row per frame (median, err%, CSV / baseline tracking) and a
+// frame-time distribution over `frames` consecutive frames, per step and in total, from a LogHistogram.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/LogHistogram.h"
+#include "ECS/Components/Animation.h"
+#include "ECS/Components/Collider.h"
+#include "Renderer/AnimationSystem.h"
+#include "Renderer/Camera.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/InstancePacker.h"
+
+#include "json.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr float	   dt = 1.0f / 60.0f;
+constexpr uint32_t frames = 600;
+/** Edge length of one tile (one copy of the template), in world units. */
+constexpr float tile = 32.0f;
+constexpr float pixels_per_unit = 32.0f;
+
+struct Prototype
+{
+	Transform transform;
+	bool	  texture = false;
+	bool	  movement = false;
+	bool	  collider = false;
+};
+
+// The entities of App/Data/entities.json, in world units and centered on the tile; synthetic ones if
+// the file isn't found from the working directory.
+std::vector<Prototype> LoadPrototypes(std::string& source)
+{
+	std::vector<Prototype> prototypes;
+
+	for (const char* path : {"App/Data/entities.json", "../App/Data/entities.json", "../../App/Data/entities.json"})
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			continue;
+		}
+
+		const nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+		if (data.is_discarded())
+		{
+			continue;
+		}
+
+		for (const nlohmann::json& entity : data)
+		{
+			Prototype& p = prototypes.emplace_back();
+			for (const nlohmann::json& component : entity["components"])
+			{
+				const std::string name = component.value("name", "");
+				if (name == "Transform")
+				{
+					p.transform.pos_x = (component.value("pos_x", 0.0f) - 512.0f) / pixels_per_unit;
+					p.transform.pos_y = (component.value("pos_y", 0.0f) - 512.0f) / pixels_per_unit;
+					p.transform.pos_z = 0.08f;
+					p.transform.scale_x = component.value("scale_x", pixels_per_unit) / pixels_per_unit;
+					p.transform.scale_y = component.value("scale_y", pixels_per_unit) / pixels_per_unit;
+					p.transform.rotation = component.value("rotation", 0.0f);
+				}
+				p.texture |= name == "Texture";
+				p.movement |= name == "Movement";
+				p.collider |= name == "Collider";
+			}
+		}
+
+		source = path;
+		return prototypes;
+	}
+
+	std::mt19937						  rng(7);
+	std::uniform_real_distribution<float> pos(-tile * 0.5f, tile * 0.5f);
+	for (uint32_t i = 0; i < 50; ++i)
+	{
+		Prototype& p = prototypes.emplace_back(Prototype{{}, true, true, true});
+		p.transform.pos_x = pos(rng);
+		p.transform.pos_y = pos(rng);
+		p.transform.pos_z = 0.08f;
+	}
+	source = "synthetic (entities.json not found)";
+	return prototypes;
+}
+
+class FrameWorld
+{
+public:
+	FrameWorld(const std::vector<Prototype>& in_prototypes, uint32_t count)
+		: prototypes(in_prototypes), rng(0xF00Du)
+	{
+		const uint32_t tiles = (count + static_cast<uint32_t>(prototypes.size()) - 1) /
+							   static_cast<uint32_t>(prototypes.size());
+		side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(tiles))));
+		half_extent = side * tile * 0.5f;
+
+		world.entities.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			world.entities.push_back(Spawn(i));
+		}
+		world.events.Update();
+		world.events.Update();
+
+		const CameraMatrices matrices = CameraMatrices::FromCamera(Camera{}, 16.0f / 9.0f);
+		frustum = Frustum::FromViewProjection(matrices.proj * matrices.view);
+		instances.resize(count);
+
+		const uint32_t cells_per_side = static_cast<uint32_t>(std::ceil(2.0f * half_extent / cell));
+		grid_side = std::max(cells_per_side, 1u);
+		cell_start.resize(static_cast<size_t>(grid_side) * grid_side + 1);
+	}
+
+	uint32_t Count() const { return static_cast<uint32_t>(world.entities.size()); }
+
+	void Churn()
+	{
+		const uint32_t churn = std::max(1u, Count() / 1000);
+		for (uint32_t i = 0; i < churn; ++i)
+		{
+			const uint32_t slot = next_churn++ % Count();
+			world.registry.DestroyEntity(world.entities[slot]);
+			world.entities[slot] = Spawn(slot);
+		}
+	}
+
+	void Events() { world.events.Update(); }
+
+	void Animate() { AnimationSystem::Advance(world.registry, dt); }
+
+	void Move()
+	{
+		for (auto [e, m, t] : world.registry.view<Movement, Transform>())
+		{
+			t.pos_x += m.velocity_x * dt;
+			t.pos_y += m.velocity_y * dt;
+			t.rotation += m.angular_velocity * dt;
+
+			if (std::abs(t.pos_x) > half_extent)
+			{
+				m.velocity_x = -m.velocity_x;
+			}
+			if (std::abs(t.pos_y) > half_extent)
+			{
+				m.velocity_y = -m.velocity_y;
+			}
+		}
+	}
+
+	uint32_t Collide()
+	{
+		bodies.clear();
+		for (auto [e, c, t] : world.registry.view<Collider, Transform>())
+		{
+			bodies.push_back({t.pos_x, t.pos_y, 0.5f * std::max(t.scale_x, t.scale_y), CellOf(t.pos_x, t.pos_y)});
+		}
+
+		/* Counting sort of the bodies by cell. */
+		std::fill(cell_start.begin(), cell_start.end(), 0u);
+		for (const Body& b : bodies)
+		{
+			cell_start[b.cell + 1]++;
+		}
+		for (size_t i = 1; i < cell_start.size(); ++i)
+		{
+			cell_start[i] += cell_start[i - 1];
+		}
+		sorted.resize(bodies.size());
+		cursor.assign(cell_start.begin(), cell_start.end() - 1);
+		for (const Body& b : bodies)
+		{
+			sorted[cursor[b.cell]++] = b;
+		}
+
+		/* Every pair once: the body's own cell (later bodies only) and four of its eight neighbours. */
+		static constexpr std::array<std::array<int, 2>, 4> neighbours = {{{1, 0}, {-1, 1}, {0, 1}, {1, 1}}};
+
+		uint32_t contacts = 0;
+		for (uint32_t i = 0; i < sorted.size(); ++i)
+		{
+			const Body&	   a = sorted[i];
+			const uint32_t cx = a.cell % grid_side;
+			const uint32_t cy = a.cell / grid_side;
+
+			for (uint32_t j = i + 1; j < cell_start[a.cell + 1]; ++j)
+			{
+				contacts += Overlaps(a, sorted[j]) ? 1 : 0;
+			}
+
+			for (const auto& [dx, dy] : neighbours)
+			{
+				const int nx = static_cast<int>(cx) + dx;
+				const int ny = static_cast<int>(cy) + dy;
+				if (nx < 0 || ny < 0 || nx >= static_cast<int>(grid_side) || ny >= static_cast<int>(grid_side))
+				{
+					continue;
+				}
+
+				const uint32_t n = static_cast<uint32_t>(ny) * grid_side + static_cast<uint32_t>(nx);
+				for (uint32_t j = cell_start[n]; j < cell_start[n + 1]; ++j)
+				{
+					contacts += Overlaps(a, sorted[j]) ? 1 : 0;
+				}
+			}
+		}
+
+		return contacts;
+	}
+
+	uint32_t Pack() { return InstancePacker::Pack(world.registry, frustum, instances); }
+
+private:
+	struct Body
+	{
+		float	 x;
+		float	 y;
+		float	 radius;
+		uint32_t cell;
+	};
+
+	/** Larger than any collider's diameter, so contacts never span more than neighbouring cells. */
+	static constexpr float cell = 2.0f;
+
+	static bool Overlaps(const Body& a, const Body& b)
+	{
+		const float dx = a.x - b.x;
+		const float dy = a.y - b.y;
+		const float r = a.radius + b.radius;
+		return dx * dx + dy * dy < r * r;
+	}
+
+	uint32_t CellOf(float x, float y) const
+	{
+		const float	   fx = std::clamp((x + half_extent) / cell, 0.0f, static_cast<float>(grid_side - 1));
+		const float	   fy = std::clamp((y + half_extent) / cell, 0.0f, static_cast<float>(grid_side - 1));
+		const uint32_t cx = static_cast<uint32_t>(fx);
+		const uint32_t cy = static_cast<uint32_t>(fy);
+		return cy * grid_side + cx;
+	}
+
+	// Creates the `index`-th entity: a copy of a prototype, moved to its tile.
+	Entity Spawn(uint32_t index)
+	{
+		const Prototype& p = prototypes[index % prototypes.size()];
+		const uint32_t	 tile_index = index / static_cast<uint32_t>(prototypes.size());
+
+		std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+
+		Entity	  e = world.registry.CreateEntity();
+		Transform t = p.transform;
+		t.pos_x += (static_cast<float>(tile_index % side) + 0.5f) * tile - half_extent;
+		t.pos_y += (static_cast<float>(tile_index / side) + 0.5f) * tile - half_extent;
+		world.registry.AddComponent<Transform>(e, t);
+
+		if (p.texture)
+		{
+			world.registry.AddComponent<Texture>(e, Texture{index % 16, 1.0f});
+		}
+		if (p.movement)
+		{
+			Movement m;
+			m.velocity_x = velocity(rng);
+			m.velocity_y = velocity(rng);
+			world.registry.AddComponent<Movement>(e, m);
+		}
+		if (p.collider)
+		{
+			world.registry.AddComponent<Collider>(e, Collider{});
+		}
+		if (index % 4 == 0)
+		{
+			world.registry.AddComponent<Animation>(e, Animation{0, 8, 12.0f});
+		}
+
+		return e;
+	}
+
+private:
+	const std::vector<Prototype>& prototypes;
+	std::mt19937				  rng;
+	World						  world;
+	uint32_t					  side = 1;
+	float						  half_extent = 0.0f;
+	uint32_t					  next_churn = 0;
+
+	Frustum						 frustum;
+	std::vector<TextureInstance> instances;
+
+	uint32_t			  grid_side = 1;
+	std::vector<Body>	  bodies;
+	std::vector<Body>	  sorted;
+	std::vector<uint32_t> cell_start;
+	std::vector<uint32_t> cursor;
+};
+
+constexpr const char* step_names[] = {"spawn/despawn", "events", "animation", "movement", "collision", "packing"};
+constexpr uint32_t	  step_count = sizeof(step_names) / sizeof(step_names[0]);
+
+uint64_t Nanoseconds(std::chrono::steady_clock::duration d)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
+// Runs one frame; with `timings`, records the nanoseconds of every step and of the whole frame.
+void RunFrame(FrameWorld& world, std::array<LogHistogram, step_count + 1>* timings)
+{
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point marks[step_count + 1];
+	marks[0] = Clock::now();
+
+	world.Churn();
+	marks[1] = Clock::now();
+	world.Events();
+	marks[2] = Clock::now();
+	world.Animate();
+	marks[3] = Clock::now();
+	world.Move();
+	marks[4] = Clock::now();
+	uint32_t contacts = world.Collide();
+	marks[5] = Clock::now();
+	uint32_t drawn = world.Pack();
+	marks[6] = Clock::now();
+
+	doNotOptimizeAway(contacts);
+	doNotOptimizeAway(drawn);
+
+	if (timings)
+	{
+		for (uint32_t i = 0; i < step_count; ++i)
+		{
+			(*timings)[i].Record(Nanoseconds(marks[i + 1] - marks[i]));
+		}
+		(*timings)[step_count].Record(Nanoseconds(marks[step_count] - marks[0]));
+	}
+}
+
+void PrintDistribution(uint32_t count, const std::array<LogHistogram, step_count + 1>& timings)
+{
+	std::cout << "\nFrame time distribution, " << count << " entities, " << frames << " frames (ms)\n\n"
+			  << "|   mean |    p50 |    p95 |    p99 |    max | step\n"
+				 "|-------:|-------:|-------:|-------:|-------:|:-----\n";
+
+	constexpr double ns_to_ms = 1e-6;
+
+	for (uint32_t i = 0; i <= step_count; ++i)
+	{
+		const LogHistogram& h = timings[i];
+		auto				ms = [&](uint64_t ns) { return static_cast<double>(ns) * ns_to_ms; };
+
+		char row[160];
+		std::snprintf(row, sizeof(row), "| %6.3f | %6.3f | %6.3f | %6.3f | %6.3f | %s\n", h.GetMean() * ns_to_ms,
+			ms(h.GetPercentile(50.0)), ms(h.GetPercentile(95.0)), ms(h.GetPercentile(99.0)), ms(h.GetMax()),
+			i < step_count ? step_names[i] : "**frame**");
+		std::cout << row;
+	}
+}
+
+} // namespace
+
+void RunFrameBenchmarks(std::ostream* csv)
+{
+	std::string					 source;
+	const std::vector<Prototype> prototypes = LoadPrototypes(source);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Headless frame (world from " + source + ")").unit("frame");
+
+	for (uint32_t count : {10000u, 100000u})
+	{
+		FrameWorld world(prototypes, count);
+
+		bench.run(std::to_string(count) + " entities", [&] { RunFrame(world, nullptr); });
+
+		std::array<LogHistogram, step_count + 1> timings;
+		for (uint32_t i = 0; i < frames; ++i)
+		{
+			RunFrame(world, &timings);
+		}
+		PrintDistribution(count, timings);
+	}
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
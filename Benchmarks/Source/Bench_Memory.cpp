@@ -0,0 +1,113 @@
+// Memory footprint of the ECS and the event buffers, read with Registry::GetMemoryUsage and
+// EventSystem::GetMemoryUsage (the same numbers the DebugLayer's "Memory" section shows).
+//
+// Answers "how much memory does a 200k-entity scene take?" for a typical sprite world: every entity has
+// a Transform and a Texture, every second one a Movement, every fourth one an Animation. The world is
+// measured at four points:
+//   1. spawned          -- right after creating it; the creation events are still queued.
+//   2. events consumed  -- after two EventSystem::Update calls. The buffers are empty but keep their
+//                          capacity, which is what "event buffers never shrink" costs.
+//   3. half destroyed   -- the upper half of the entities is gone; the storage is still sized for all.
+//   4. shrunk           -- after Registry::ShrinkToFit and EventSystem::ShrinkToFit.
+// It writes no CSV rows; its numbers are for reading, not for regression tracking.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/MemoryUsage.h"
+#include "ECS/Components/Animation.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace Mupfel;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t count = 200000;
+
+double MiB(size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+void PrintBreakdown(const RegistryMemoryUsage& registry, const MemoryUsage& events)
+{
+	std::cout << "\n|    count | used MiB | reserved MiB | B/entity | Storage, 200k entities spawned\n"
+				 "|---------:|---------:|-------------:|---------:|:-------------------------------\n";
+
+	auto row = [](const char* name, uint32_t n, const MemoryUsage& memory)
+	{
+		char text[160];
+		std::snprintf(text, sizeof(text), "| %8u | %8.2f | %12.2f | %8.1f | `%s`\n", n, MiB(memory.used),
+			MiB(memory.reserved), static_cast<double>(memory.reserved) / count, name);
+		std::cout << text;
+	};
+
+	row("entities (signatures, scene masks, free list)", count, registry.entities);
+	for (const ComponentMemoryUsage& c : registry.components)
+	{
+		row(std::string(c.name).c_str(), c.count, c.memory);
+	}
+	row("event buffers", 0, events);
+}
+
+} // namespace
+
+void RunMemoryBenchmarks(std::ostream* /*csv*/)
+{
+	World world;
+	world.entities.reserve(count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Entity e = world.registry.CreateEntity();
+		world.registry.AddComponent<Transform>(e, Transform{});
+		world.registry.AddComponent<Texture>(e, Texture{i % 16, 1.0f});
+		if (i % 2 == 0)
+		{
+			world.registry.AddComponent<Movement>(e, Movement{});
+		}
+		if (i % 4 == 0)
+		{
+			world.registry.AddComponent<Animation>(e, Animation{0, 4, 8.0f});
+		}
+		world.entities.push_back(e);
+	}
+
+	PrintBreakdown(world.registry.GetMemoryUsage(), world.events.GetMemoryUsage());
+
+	std::cout << "\n| used MiB | reserved MiB | events reserved MiB | Total, 200k entities\n"
+				 "|---------:|-------------:|--------------------:|:--------------------\n";
+
+	auto total = [&](const char* label)
+	{
+		const MemoryUsage events = world.events.GetMemoryUsage();
+		const MemoryUsage all = world.registry.GetMemoryUsage().Total() + events;
+
+		char text[160];
+		std::snprintf(text, sizeof(text), "| %8.2f | %12.2f | %19.2f | `%s`\n", MiB(all.used), MiB(all.reserved),
+			MiB(events.reserved), label);
+		std::cout << text;
+	};
+
+	total("spawned");
+
+	world.events.Update();
+	world.events.Update();
+	total("events consumed");
+
+	for (uint32_t i = count / 2; i < count; ++i)
+	{
+		world.registry.DestroyEntity(world.entities[i]);
+	}
+	world.entities.erase(world.entities.begin() + count / 2, world.entities.end());
+	world.events.Update();
+	world.events.Update();
+	total("half destroyed");
+
+	world.registry.ShrinkToFit();
+	world.events.ShrinkToFit();
+	total("shrunk");
+}
+
+} // namespace MupfelBench
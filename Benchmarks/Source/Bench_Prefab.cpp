@@ -0,0 +1,128 @@
+// Prefab instantiation: spawning 10k copies of a 20-entity group into a fresh Registry.
+//
+// The group is a root with a Transform and a Movement plus 19 parts with a Transform and a Texture, every
+// fourth part also animated -- 45 components per copy. It is spawned
+//   AddComponent  -- as Level::OnStage builds its decor: one CreateEntity per entity and one AddComponent
+//                    per component, each firing (and queueing) its event.
+//   per copy      -- Registry::Instantiate once per copy: one bulk column copy per component type and one
+//                    PrefabInstantiatedEvent per call.
+//   all at once   -- Registry::Instantiate(prefab, 10000): every column copied 10k times in one call.
+// Every iteration starts from an empty Registry, so the rows include growing its storage.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "ECS/Components/Animation.h"
+#include "ECS/Prefab.h"
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t prefabEntities = 20;
+constexpr uint32_t copies = 10000;
+
+Transform PartTransform(uint32_t i)
+{
+	Transform t;
+	t.pos_x = static_cast<float>(i % 5);
+	t.pos_y = static_cast<float>(i / 5);
+	return t;
+}
+
+// The group, spawned entity by entity.
+void Spawn(Registry& registry)
+{
+	Entity	 root = registry.CreateEntity();
+	Movement m;
+	m.velocity_x = 1.0f;
+	registry.AddComponent<Transform>(root, Transform{});
+	registry.AddComponent<Movement>(root, m);
+
+	for (uint32_t i = 1; i < prefabEntities; ++i)
+	{
+		Entity e = registry.CreateEntity();
+		registry.AddComponent<Transform>(e, PartTransform(i));
+		registry.AddComponent<Texture>(e, Texture{i % 4, 1.0f});
+		if (i % 4 == 0)
+		{
+			registry.AddComponent<Animation>(e, Animation(0, 4, 8.0f));
+		}
+	}
+}
+
+// The same group as a prefab.
+Prefab BuildPrefab()
+{
+	Prefab	 prefab;
+	Entity	 root = prefab.CreateEntity();
+	Movement m;
+	m.velocity_x = 1.0f;
+	prefab.AddComponent<Transform>(root, Transform{});
+	prefab.AddComponent<Movement>(root, m);
+
+	for (uint32_t i = 1; i < prefabEntities; ++i)
+	{
+		Entity e = prefab.CreateEntity();
+		prefab.AddComponent<Transform>(e, PartTransform(i));
+		prefab.AddComponent<Texture>(e, Texture{i % 4, 1.0f});
+		if (i % 4 == 0)
+		{
+			prefab.AddComponent<Animation>(e, Animation(0, 4, 8.0f));
+		}
+	}
+	return prefab;
+}
+
+} // namespace
+
+void RunPrefabBenchmarks(std::ostream* csv)
+{
+	const Prefab prefab = BuildPrefab();
+	ThreadPool	 pool{1};
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench)
+		.title("Spawn 10k copies of a 20-entity group")
+		.unit("entity")
+		.batch(copies * prefabEntities)
+		.minEpochIterations(3);
+
+	bench.run("AddComponent per entity and component",
+		[&]
+		{
+			EventSystem events;
+			Registry	registry(events, pool);
+			for (uint32_t k = 0; k < copies; ++k)
+			{
+				Spawn(registry);
+			}
+			doNotOptimizeAway(registry.GetCurrentEntities());
+		});
+
+	bench.run("Registry::Instantiate per copy",
+		[&]
+		{
+			EventSystem events;
+			Registry	registry(events, pool);
+			for (uint32_t k = 0; k < copies; ++k)
+			{
+				doNotOptimizeAway(registry.Instantiate(prefab));
+			}
+		});
+
+	bench.run("Registry::Instantiate 10k copies at once",
+		[&]
+		{
+			EventSystem events;
+			Registry	registry(events, pool);
+			doNotOptimizeAway(registry.Instantiate(prefab, copies));
+		});
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
@@ -0,0 +1,102 @@
+// Per-scene storage: iterating the active scene while other scenes hold far more entities.
+//
+// Ten scenes of 50k entities each (Transform + Movement), created scene by scene. Each row integrates
+// the active scene's Transforms by their Movement:
+//   1 scene      -- a registry holding just the one scene, the lower bound.
+//   1 of 10      -- the same scene with nine inactive ones next to it. The component arrays are
+//                   partitioned by scene, so this should match the row above: the inactive 450k
+//                   entities are never visited (with a global scene-mask check they all were).
+//   all 10       -- SetActiveScene to each scene in turn and iterate it; 500k entities in total.
+// Views and ParallelForEach are both measured; ParallelForEach runs on a pool of the hardware's threads.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t sceneCount = 10;
+constexpr uint32_t perScene = 50000;
+
+// Fills scenes 0 to `scenes - 1` with `perScene` entities each and leaves scene 0 active.
+void PopulateScenes(World& world, uint32_t scenes)
+{
+	for (SceneHandle scene = 0; scene < scenes; ++scene)
+	{
+		world.registry.SetActiveScene(scene);
+		for (uint32_t i = 0; i < perScene; ++i)
+		{
+			Entity	  e = world.registry.CreateEntity();
+			Transform t;
+			t.pos_x = static_cast<float>(i);
+			world.registry.AddComponent<Transform>(e, t);
+			Movement m;
+			m.velocity_x = 1.0f;
+			m.velocity_y = 2.0f;
+			world.registry.AddComponent<Movement>(e, m);
+		}
+	}
+	world.registry.SetActiveScene(0);
+	world.events.Update();
+	world.events.Update();
+}
+
+void ViewStep(World& world)
+{
+	constexpr float dt = 1.0f / 60.0f;
+	for (auto [e, t, m] : world.registry.view<Transform, Movement>())
+	{
+		t.pos_x += m.velocity_x * dt;
+		t.pos_y += m.velocity_y * dt;
+	}
+}
+
+void ParallelStep(World& world)
+{
+	constexpr float dt = 1.0f / 60.0f;
+	world.registry.ParallelForEach<Transform, Movement>(
+		[](Entity, Transform& t, Movement& m)
+		{
+			t.pos_x += m.velocity_x * dt;
+			t.pos_y += m.velocity_y * dt;
+		});
+}
+
+} // namespace
+
+void RunScenePartitionBenchmarks(std::ostream* csv)
+{
+	World single;
+	PopulateScenes(single, 1);
+	World scenes;
+	PopulateScenes(scenes, sceneCount);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Active scene of 50k entities").unit("entity").batch(perScene);
+
+	bench.run("view<Transform, Movement>, 1 scene", [&] { ViewStep(single); });
+	bench.run("view<Transform, Movement>, 1 of 10 scenes", [&] { ViewStep(scenes); });
+	bench.run("ParallelForEach<Transform, Movement>, 1 scene", [&] { ParallelStep(single); });
+	bench.run("ParallelForEach<Transform, Movement>, 1 of 10 scenes", [&] { ParallelStep(scenes); });
+
+	bench.batch(perScene * sceneCount);
+	bench.run("view<Transform, Movement>, all 10 scenes in turn",
+		[&]
+		{
+			for (SceneHandle scene = 0; scene < sceneCount; ++scene)
+			{
+				scenes.registry.SetActiveScene(scene);
+				ViewStep(scenes);
+			}
+			scenes.registry.SetActiveScene(0);
+		});
+
+	doNotOptimizeAway(scenes.registry.GetComponent<Transform>(scenes.registry.GetActiveSceneEntities()[0]));
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
@@ -0,0 +1,178 @@
+// Scene switch benchmark: the frame time while a large scene comes in, headless.
+//
+// The live world is 20k moving sprites; every frame integrates their Transforms by their Movement and
+// drains the events, a stand-in for a light frame. Frames are paced at 60 Hz, as in headless mode, so
+// the thread pool gets the time between them. At frame `switchFrame`, a second scene of 100k
+// entities (Transform + Texture, every second one a Movement, every fourth an Animation) comes in:
+//   sync    -- built on the main thread within one frame, as Application::SwitchScene followed by the
+//              scene's OnInit does.
+//   stream  -- SceneStreamer, as Application::QueueSceneStream does: built on the thread pool into a
+//              staging Registry, then merged with a 2 ms budget per frame.
+// For each, `frames` frames are run, and their frame-time distribution is printed together with how many
+// frames after the switch the scene was complete. A nanobench row tracks Registry::Merge of the whole scene.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/LogHistogram.h"
+#include "Core/SceneStreamer.h"
+#include "ECS/Components/Animation.h"
+
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t	  liveCount = 20000;
+constexpr uint32_t	  sceneCount = 100000;
+constexpr uint32_t	  frames = 120;
+constexpr auto		  framePeriod = std::chrono::microseconds(16667);
+constexpr uint32_t	  switchFrame = 30;
+constexpr double	  mergeBudget = 0.002;
+constexpr SceneHandle streamedScene = 1;
+
+// The new scene's OnInit: one CreateEntity and AddComponent per entity and component.
+void BuildScene(Registry& registry)
+{
+	for (uint32_t i = 0; i < sceneCount; ++i)
+	{
+		Entity	  e = registry.CreateEntity();
+		Transform t;
+		t.pos_x = static_cast<float>(i % 512);
+		t.pos_y = static_cast<float>(i / 512);
+		registry.AddComponent<Transform>(e, t);
+		registry.AddComponent<Texture>(e, Texture{i % 16, 1.0f});
+
+		if (i % 2 == 0)
+		{
+			Movement m;
+			m.velocity_x = 1.0f;
+			registry.AddComponent<Movement>(e, m);
+		}
+		if (i % 4 == 0)
+		{
+			registry.AddComponent<Animation>(e, Animation(0, 4, 8.0f));
+		}
+	}
+}
+
+// The frame's own work on the active scene.
+void Step(World& world)
+{
+	constexpr float dt = 1.0f / 60.0f;
+	for (auto [e, t, m] : world.registry.view<Transform, Movement>())
+	{
+		t.pos_x += m.velocity_x * dt;
+		t.pos_y += m.velocity_y * dt;
+	}
+	world.events.Update();
+}
+
+struct SwitchResult
+{
+	LogHistogram frameTimes;
+	/** The frame the new scene was complete in, 0 if it wasn't within `frames`. */
+	uint32_t completeFrame = 0;
+};
+
+SwitchResult RunSwitch(bool streamed)
+{
+	World world;
+	Populate(world, liveCount);
+	world.events.Update();
+	world.events.Update();
+
+	SceneStreamer streamer(world.thread_pool);
+	SwitchResult  result;
+	auto		  next_frame = std::chrono::steady_clock::now();
+
+	for (uint32_t frame = 0; frame < frames; ++frame)
+	{
+		std::this_thread::sleep_until(next_frame);
+		next_frame += framePeriod;
+		const auto start = std::chrono::steady_clock::now();
+
+		if (frame == switchFrame && !streamed)
+		{
+			/* CreateScene switches first, so OnInit's entities land in the new scene. */
+			world.registry.SetActiveScene(streamedScene);
+			BuildScene(world.registry);
+			world.registry.SetActiveScene(0);
+			result.completeFrame = frame;
+		}
+		else if (frame == switchFrame)
+		{
+			streamer.Begin(streamedScene, BuildScene);
+		}
+
+		if (streamer.IsStreaming() && streamer.Update(world.registry, mergeBudget))
+		{
+			result.completeFrame = frame;
+		}
+
+		Step(world);
+
+		result.frameTimes.Record(static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+	}
+
+	return result;
+}
+
+void PrintSwitch(const char* name, const SwitchResult& result)
+{
+	const LogHistogram& h = result.frameTimes;
+	auto				ms = [](uint64_t ns) { return static_cast<double>(ns) * 1e-6; };
+
+	char complete[16] = "-";
+	if (result.completeFrame != 0)
+	{
+		std::snprintf(complete, sizeof(complete), "%u", result.completeFrame - switchFrame);
+	}
+
+	char row[160];
+	std::snprintf(row, sizeof(row), "| %6.3f | %6.3f | %8.3f | %6s | %s\n", ms(h.GetPercentile(50.0)),
+		ms(h.GetPercentile(99.0)), ms(h.GetMax()), complete, name);
+	std::cout << row;
+}
+
+} // namespace
+
+void RunSceneStreamBenchmarks(std::ostream* csv)
+{
+	/* The whole scene staged once, merged into a fresh registry per iteration. */
+	World staged;
+	BuildScene(staged.registry);
+	const std::vector<Entity> entities = staged.registry.GetActiveSceneEntities();
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Scene merge").unit("entity").batch(sceneCount).minEpochIterations(3);
+
+	bench.run("Registry::Merge 100k entities",
+		[&]
+		{
+			EventSystem events;
+			Registry	target(events, staged.thread_pool);
+			doNotOptimizeAway(target.Merge(staged.registry, entities, streamedScene));
+		});
+
+	RenderCsv(bench, csv);
+
+	const SwitchResult sync = RunSwitch(false);
+	const SwitchResult stream = RunSwitch(true);
+
+	std::cout << "\nScene switch to " << sceneCount << " entities, live world " << liveCount << " entities, "
+			  << frames << " frames (ms)\n\n"
+			  << "|    p50 |    p99 |      max | frames | switch\n"
+				 "|-------:|-------:|---------:|-------:|:-----\n";
+	PrintSwitch("sync    built within the frame", sync);
+	PrintSwitch("stream  SceneStreamer, 2 ms merge budget", stream);
+}
+
+} // namespace MupfelBench
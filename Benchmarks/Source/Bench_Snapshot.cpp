@@ -0,0 +1,168 @@
+// Level load benchmarks: the binary SceneSnapshot format against the JSON path of EntityFileManager.
+//
+// The world is the sprite world of Bench_Memory without the Animations: every entity has a Transform and a
+// Texture, every second one a Movement. It is stored once with SceneSnapshot::Store to a temporary file,
+// and its Transforms and Movements (all the JSON loader understands) are written to a JSON string.
+// nanobench rows, all into a fresh Registry per iteration:
+//   json      -- nlohmann::json::parse plus one CreateEntity / AddComponent per entity and component,
+//                what EntityFileManager::Load did before EntityStreamLoader (see Bench_EntityStream).
+//   snapshot  -- SceneSnapshot::Load: mmap, then one bulk copy per column.
+// Each iteration includes tearing the previous Registry down, which both paths pay alike. The 1M-entity
+// snapshot load is also timed on its own, without the teardown, against the 100ms target.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "FS/SceneSnapshot.h"
+
+#include "json.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t jsonCount = 100000;
+constexpr uint32_t snapshotCount = 1000000;
+
+void PopulateLevel(World& world, uint32_t count)
+{
+	PopulateSprites(world, count, 10000.0f);
+	Movement m;
+	m.velocity_x = 1.0f;
+	m.velocity_y = 2.0f;
+	for (uint32_t i = 0; i < count; i += 2)
+	{
+		world.registry.AddComponent<Movement>(world.entities[i], m);
+	}
+	world.events.Update();
+	world.events.Update();
+}
+
+std::string ToJson(World& world)
+{
+	nlohmann::json level = nlohmann::json::array();
+	for (const Entity e : world.entities)
+	{
+		const Transform& t = world.registry.GetComponent<Transform>(e);
+		nlohmann::json	 components = nlohmann::json::array();
+		components.push_back({{"name", "Transform"}, {"pos_x", t.pos_x}, {"pos_y", t.pos_y}, {"pos_z", t.pos_z},
+			{"scale_x", t.scale_x}, {"scale_y", t.scale_y}, {"rotation", t.rotation}});
+
+		if (world.registry.HasComponent<Movement>(e))
+		{
+			const Movement& m = world.registry.GetComponent<Movement>(e);
+			components.push_back({{"name", "Movement"}, {"velocity_x", m.velocity_x}, {"velocity_y", m.velocity_y}});
+		}
+		level.push_back({{"components", std::move(components)}});
+	}
+	return level.dump();
+}
+
+// EntityFileManager::Load before EntityStreamLoader, with the registry passed in instead of taken from the
+// Application.
+void LoadJson(Registry& registry, const std::string& text)
+{
+	const nlohmann::json data = nlohmann::json::parse(text);
+	for (const auto& ent : data)
+	{
+		Entity e = registry.CreateEntity();
+		for (const auto& comp : ent["components"])
+		{
+			if (comp["name"] == "Transform")
+			{
+				Transform t;
+				t.pos_x = comp["pos_x"];
+				t.pos_y = comp["pos_y"];
+				t.pos_z = comp["pos_z"];
+				t.scale_x = comp["scale_x"];
+				t.scale_y = comp["scale_y"];
+				t.rotation = comp["rotation"];
+				registry.AddComponent<Transform>(e, t);
+			}
+			else if (comp["name"] == "Movement")
+			{
+				Movement m;
+				m.velocity_x = comp["velocity_x"];
+				m.velocity_y = comp["velocity_y"];
+				registry.AddComponent<Movement>(e, m);
+			}
+		}
+	}
+}
+
+std::filesystem::path StoreLevel(uint32_t count, const char* name)
+{
+	World world;
+	PopulateLevel(world, count);
+
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / name;
+	if (!SceneSnapshot::Store(world.registry, file))
+	{
+		std::cerr << "Could not write " << file << "\n";
+	}
+	return file;
+}
+
+} // namespace
+
+void RunSnapshotBenchmarks(std::ostream* csv)
+{
+	std::string json;
+	{
+		World world;
+		PopulateLevel(world, jsonCount);
+		json = ToJson(world);
+	}
+	const std::filesystem::path small = StoreLevel(jsonCount, "mupfel_bench_100k.msnap");
+	const std::filesystem::path large = StoreLevel(snapshotCount, "mupfel_bench_1m.msnap");
+
+	/* The registries share one EventSystem and ThreadPool; only the Registry is rebuilt per iteration. */
+	World					  shared;
+	std::unique_ptr<Registry> registry;
+
+	auto fresh = [&]() -> Registry&
+	{
+		registry = std::make_unique<Registry>(shared.events, shared.thread_pool);
+		shared.events.Update();
+		shared.events.Update();
+		return *registry;
+	};
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Level load into a fresh Registry").unit("entity").minEpochIterations(3);
+
+	bench.batch(jsonCount).run("json      100k entities", [&] { LoadJson(fresh(), json); });
+	bench.batch(jsonCount).run("snapshot  100k entities",
+		[&] { doNotOptimizeAway(SceneSnapshot::Load(fresh(), small)); });
+	bench.batch(snapshotCount).run("snapshot    1M entities",
+		[&] { doNotOptimizeAway(SceneSnapshot::Load(fresh(), large)); });
+
+	RenderCsv(bench, csv);
+
+	Registry&  target = fresh();
+	const auto start = std::chrono::steady_clock::now();
+	auto	   loaded = SceneSnapshot::Load(target, large);
+	const auto end = std::chrono::steady_clock::now();
+
+	const double   ms = std::chrono::duration<double, std::milli>(end - start).count();
+	const uint32_t created = loaded ? static_cast<uint32_t>(loaded->size()) : 0;
+
+	char line[160];
+	std::snprintf(line, sizeof(line), "\n1M entity snapshot load: %.1f ms (%u entities, target < 100 ms)\n", ms,
+		created);
+	std::cout << line;
+
+	registry.reset();
+	std::filesystem::remove(small);
+	std::filesystem::remove(large);
+}
+
+} // namespace MupfelBench
@@ -0,0 +1,134 @@
+// Sparse set benchmarks: ComponentArray's paged sparse table (SparsePages) against the flat
+// `std::vector<size_t>` it replaced, which grew to `(index + 2) * 2` entries on every out-of-range insert.
+//
+// Two worlds of 1M entity indices:
+//   dense  -- every index holds a component (Transform-like): the flat table's best case.
+//   sparse -- 50 indices spread evenly over the range hold one (Light-like): the flat table's worst case,
+//             sized for the highest index no matter how few are stored.
+// For each, a memory table (bytes of the sparse table alone) and nanobench rows for random lookups:
+// Find (Has + Get) on stored indices, and Find on random indices of which almost none are stored.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/MemoryUsage.h"
+#include "ECS/SparsePages.h"
+
+#include <cstdio>
+#include <iostream>
+#include <limits>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t indexRange = 1000000;
+constexpr uint32_t sparseCount = 50;
+constexpr uint32_t lookups = 100000;
+
+// The sparse table ComponentArray used before SparsePages, reduced to what the benchmark needs.
+class FlatSparse
+{
+public:
+	static constexpr size_t invalid = std::numeric_limits<size_t>::max();
+
+	void Set(uint32_t index, size_t slot)
+	{
+		if (index >= sparse.size())
+			sparse.resize((static_cast<size_t>(index) + 2) * 2, invalid);
+		sparse[index] = slot;
+	}
+
+	size_t Find(uint32_t index) const { return index < sparse.size() ? sparse[index] : invalid; }
+
+	MemoryUsage GetMemoryUsage() const { return MemoryUsage::Of(sparse); }
+
+private:
+	std::vector<size_t> sparse;
+};
+
+template <typename Table> void Fill(Table& table, const std::vector<uint32_t>& indices)
+{
+	for (uint32_t slot = 0; slot < indices.size(); ++slot)
+		table.Set(indices[slot], slot);
+}
+
+std::vector<uint32_t> RandomIndices(uint32_t count, uint32_t range, uint32_t seed)
+{
+	std::mt19937							rng(seed);
+	std::uniform_int_distribution<uint32_t> dist(0, range - 1);
+
+	std::vector<uint32_t> indices(count);
+	for (uint32_t& i : indices)
+		i = dist(rng);
+	return indices;
+}
+
+void PrintMemoryRow(const char* label, const MemoryUsage& flat, const MemoryUsage& paged)
+{
+	char row[160];
+	std::snprintf(row, sizeof(row), "| %13.2f | %14.2f | `%s`\n", flat.reserved / 1024.0, paged.reserved / 1024.0,
+		label);
+	std::cout << row;
+}
+
+} // namespace
+
+void RunSparseSetBenchmarks(std::ostream* csv)
+{
+	std::vector<uint32_t> denseIndices(indexRange);
+	for (uint32_t i = 0; i < indexRange; ++i)
+		denseIndices[i] = i;
+
+	std::vector<uint32_t> sparseIndices(sparseCount);
+	for (uint32_t i = 0; i < sparseCount; ++i)
+		sparseIndices[i] = (i + 1) * (indexRange / sparseCount) - 1;
+
+	FlatSparse	denseFlat, sparseFlat;
+	SparsePages densePaged, sparsePaged;
+	Fill(denseFlat, denseIndices);
+	Fill(densePaged, denseIndices);
+	Fill(sparseFlat, sparseIndices);
+	Fill(sparsePaged, sparseIndices);
+
+	std::cout << "\n| flat KiB      | paged KiB      | Sparse table size\n"
+				 "|--------------:|---------------:|:------------------\n";
+	PrintMemoryRow("dense   1M of 1M indices", denseFlat.GetMemoryUsage(), densePaged.GetMemoryUsage());
+	PrintMemoryRow("sparse  50 of 1M indices", sparseFlat.GetMemoryUsage(), sparsePaged.GetMemoryUsage());
+
+	// Stored indices in random order, and random indices over the whole range (nearly all misses when sparse).
+	const std::vector<uint32_t> denseHits = RandomIndices(lookups, indexRange, 0xC0FFEEu);
+	std::vector<uint32_t>		sparseHits(lookups);
+	for (uint32_t i = 0; i < lookups; ++i)
+		sparseHits[i] = sparseIndices[denseHits[i] % sparseCount];
+	const std::vector<uint32_t> anywhere = RandomIndices(lookups, indexRange, 0xBEEFu);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("Sparse table lookup (1M index range)").unit("lookup").batch(lookups);
+
+	auto measure = [&](const char* name, const auto& table, const std::vector<uint32_t>& indices)
+	{
+		bench.run(name,
+			[&]
+			{
+				uint64_t sum = 0;
+				for (uint32_t i : indices)
+					sum += table.Find(i);
+				doNotOptimizeAway(sum);
+			});
+	};
+
+	measure("flat   dense,  stored indices", denseFlat, denseHits);
+	measure("paged  dense,  stored indices", densePaged, denseHits);
+	measure("flat   sparse, stored indices", sparseFlat, sparseHits);
+	measure("paged  sparse, stored indices", sparsePaged, sparseHits);
+	measure("flat   sparse, random indices", sparseFlat, anywhere);
+	measure("paged  sparse, random indices", sparsePaged, anywhere);
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
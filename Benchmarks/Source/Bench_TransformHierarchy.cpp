@@ -0,0 +1,170 @@
+// Transform hierarchies: computing the WorldTransform of 100k nodes, at depths 2 to 8.
+//
+// Every level holds 100k / depth nodes (Transform only), each attached to a random node of the level
+// above, so the branching varies from node to node. Per depth:
+//   ancestor walk  -- what a flat system has to do: every node composes the Transforms of its whole
+//                     chain of ancestors, found through GetComponent<Parent>. O(nodes x depth).
+//   full, 1 thread -- TransformSystem recomputing every node (Invalidate + Update) on a pool of one
+//                     thread: the levels are walked front to back over the breadth-first arrays.
+//   full, pool     -- the same with the hardware's threads; levels of 4096+ nodes are split up.
+//   1% moved       -- 1000 random nodes get a new Transform per iteration; only their subtrees are
+//                     recomputed, the rest costs one comparison with the cached Transform.
+// All rows are per node of the hierarchy.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "ECS/Components/Hierarchy.h"
+#include "ECS/TransformSystem.h"
+
+#include <cmath>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr uint32_t nodeCount = 100000;
+constexpr uint32_t movedCount = 1000;
+
+// `depth` levels of `nodeCount / depth` nodes; returns them level by level.
+std::vector<Entity> BuildHierarchy(World& world, uint32_t depth)
+{
+	const uint32_t						  width = nodeCount / depth;
+	std::mt19937						  rng(0xC0FFEEu);
+	std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+	std::uniform_int_distribution<uint32_t> pick(0, width - 1);
+
+	std::vector<Entity> nodes;
+	nodes.reserve(width * depth);
+	for (uint32_t level = 0; level < depth; ++level)
+	{
+		for (uint32_t i = 0; i < width; ++i)
+		{
+			Entity	  e = world.registry.CreateEntity();
+			Transform t;
+			t.pos_x = offset(rng);
+			t.pos_y = offset(rng);
+			t.rotation = offset(rng) * 0.1f;
+			world.registry.AddComponent<Transform>(e, t);
+			if (level > 0)
+			{
+				TransformSystem::Attach(world.registry, e, nodes[(level - 1) * width + pick(rng)]);
+			}
+			nodes.push_back(e);
+		}
+	}
+	world.events.Update();
+	world.events.Update();
+	return nodes;
+}
+
+WorldTransform Compose(const WorldTransform& parent, const Transform& local)
+{
+	const float x = parent.scale_x * local.pos_x;
+	const float y = parent.scale_y * local.pos_y;
+
+	WorldTransform world;
+	world.pos_x = parent.pos_x + parent.cos_rotation * x - parent.sin_rotation * y;
+	world.pos_y = parent.pos_y + parent.sin_rotation * x + parent.cos_rotation * y;
+	world.pos_z = parent.pos_z + local.pos_z;
+	world.scale_x = parent.scale_x * local.scale_x;
+	world.scale_y = parent.scale_y * local.scale_y;
+	world.rotation = parent.rotation + local.rotation;
+	world.cos_rotation = std::cos(world.rotation);
+	world.sin_rotation = std::sin(world.rotation);
+	return world;
+}
+
+// Every node on its own: walk up to the root, then compose the chain back down.
+void AncestorWalk(World& world, std::span<const Entity> nodes, std::vector<WorldTransform>& out)
+{
+	Registry&			registry = world.registry;
+	std::vector<Entity> chain;
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		chain.clear();
+		for (Entity e = nodes[i];; e = registry.GetComponent<Parent>(e).entity)
+		{
+			chain.push_back(e);
+			if (!registry.HasComponent<Parent>(e))
+			{
+				break;
+			}
+		}
+
+		WorldTransform w;
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+		{
+			w = Compose(w, registry.GetComponent<Transform>(*it));
+		}
+		out[i] = w;
+	}
+}
+
+} // namespace
+
+void RunTransformHierarchyBenchmarks(std::ostream* csv)
+{
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("WorldTransforms of a 100k-node hierarchy").unit("node");
+
+	for (uint32_t depth = 2; depth <= 8; ++depth)
+	{
+		World					  world;
+		const std::vector<Entity> nodes = BuildHierarchy(world, depth);
+		ThreadPool				  single_thread{1};
+		TransformSystem			  serial{world.registry, world.events, single_thread};
+		TransformSystem			  parallel{world.registry, world.events, world.thread_pool};
+		serial.Init();
+		parallel.Init();
+		serial.Update();
+		parallel.Update();
+
+		std::vector<WorldTransform> walked(nodes.size());
+		const std::string			suffix = ", depth " + std::to_string(depth);
+		bench.batch(nodes.size());
+
+		bench.run("ancestor walk" + suffix, [&] { AncestorWalk(world, nodes, walked); });
+		bench.run("full, 1 thread" + suffix,
+			[&]
+			{
+				serial.Invalidate();
+				serial.Update();
+			});
+		bench.run("full, pool" + suffix,
+			[&]
+			{
+				parallel.Invalidate();
+				parallel.Update();
+			});
+
+		std::mt19937							moved_rng(depth);
+		std::uniform_int_distribution<size_t>	pick(0, nodes.size() - 1);
+		std::vector<Entity>						moved;
+		for (uint32_t i = 0; i < movedCount; ++i)
+		{
+			moved.push_back(nodes[pick(moved_rng)]);
+		}
+		float step = 0.01f;
+		bench.run("1% moved, pool" + suffix,
+			[&]
+			{
+				for (const Entity e : moved)
+				{
+					world.registry.GetComponent<Transform>(e).pos_x += step;
+				}
+				step = -step;
+				parallel.Update();
+			});
+
+		doNotOptimizeAway(walked.back());
+		doNotOptimizeAway(world.registry.GetComponent<WorldTransform>(nodes.back()));
+	}
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace MupfelBench
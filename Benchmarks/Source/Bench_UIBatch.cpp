@@ -0,0 +1,138 @@
+// UI command building benchmarks: the CPU side of the immediate-mode renderer (IMRenderer), which
+// collects one frame's screen-space quads in a UIBatch and copies them into the instance buffer once.
+//
+// Two groups:
+//   1. Scaling   -- Begin + N x Push + CopyTo for 1k / 10k / 50k quads per frame. The copy target is a
+//                   host vector standing in for the mapped instance buffer. After the first frame the
+//                   batch's LinearAllocator has coalesced into one block, so no frame allocates.
+//   2. Lookup    -- 10k button draws over 32 distinct button images: looking the image up by std::string
+//                   path (what Button did before: hash + compare the path every call) vs. by the
+//                   precomputed UIImage hash.
+// All numbers are per quad.
+
+#include "BenchCommon.h"
+#include "Benchmarks.h"
+
+#include "Core/UI.h"
+#include "Renderer/UIBatch.h"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+
+using namespace Mupfel;
+using ankerl::nanobench::doNotOptimizeAway;
+
+namespace MupfelBench {
+
+namespace {
+
+constexpr float screen_w = 1920.0f;
+constexpr float screen_h = 1080.0f;
+
+// Lays `count` quads out on a grid covering the screen, like a large inventory or tile palette.
+void BuildFrame(UIBatch& batch, uint32_t count)
+{
+	batch.Begin(screen_w, screen_h);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float x = static_cast<float>(i % 256) * 7.5f;
+		const float y = static_cast<float>((i / 256) % 144) * 7.5f;
+		batch.Push(x, y, 7.0f, 7.0f, 0.0f, {.slot = i % 64}, 1.0f);
+	}
+}
+
+void RunScaling(std::ostream* csv)
+{
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("UIBatch: build + copy one frame").unit("quad");
+
+	UIBatch					batch;
+	std::vector<UIInstance> mapped(50000);
+
+	for (uint32_t count : {1000u, 10000u, 50000u})
+	{
+		bench.batch(count).run(std::to_string(count) + " quads",
+			[&]
+			{
+				BuildFrame(batch, count);
+				uint32_t n = batch.CopyTo(mapped);
+				doNotOptimizeAway(n);
+			});
+	}
+
+	RenderCsv(bench, csv);
+}
+
+// Pass-through hasher, as IMRenderer uses for UIImage hashes.
+struct PrehashedKey
+{
+	size_t operator()(uint64_t hash) const { return static_cast<size_t>(hash); }
+};
+
+void RunLookup(std::ostream* csv)
+{
+	constexpr uint32_t draws = 10000;
+	constexpr uint32_t image_count = 32;
+
+	std::vector<std::string> paths;
+	std::vector<UIImage>	 handles;
+	for (uint32_t i = 0; i < image_count; ++i)
+	{
+		paths.push_back("Images/buttons/button_" + std::to_string(i) + ".png");
+	}
+	for (const std::string& path : paths)
+	{
+		handles.emplace_back(path);
+	}
+
+	std::unordered_map<std::string, std::vector<ImageHandle>>			   by_path;
+	std::unordered_map<uint64_t, std::array<ImageHandle, 3>, PrehashedKey> by_hash;
+	for (uint32_t i = 0; i < image_count; ++i)
+	{
+		by_path[paths[i]] = {i * 3, i * 3 + 1, i * 3 + 2};
+		by_hash[handles[i].GetHash()] = {i * 3, i * 3 + 1, i * 3 + 2};
+	}
+
+	UIBatch batch;
+	BuildFrame(batch, draws);
+
+	ankerl::nanobench::Bench bench;
+	ApplyDefaults(bench).title("UI button image lookup + push (10k draws, 32 images)").unit("quad").relative(true);
+
+	bench.batch(draws).run("std::string path lookup",
+		[&]
+		{
+			batch.Begin(screen_w, screen_h);
+			for (uint32_t i = 0; i < draws; ++i)
+			{
+				const std::vector<ImageHandle>& states = by_path.find(paths[i % image_count])->second;
+				batch.Push(static_cast<float>(i % 256) * 7.5f, 0.0f, 7.0f, 7.0f, 0.0f, {.slot = states[0]}, 1.0f);
+			}
+			doNotOptimizeAway(batch.Size());
+		});
+
+	bench.batch(draws).run("UIImage hash lookup",
+		[&]
+		{
+			batch.Begin(screen_w, screen_h);
+			for (uint32_t i = 0; i < draws; ++i)
+			{
+				const std::array<ImageHandle, 3>& states = by_hash.find(handles[i % image_count].GetHash())->second;
+				batch.Push(static_cast<float>(i % 256) * 7.5f, 0.0f, 7.0f, 7.0f, 0.0f, {.slot = states[0]}, 1.0f);
+			}
+			doNotOptimizeAway(batch.Size());
+		});
+
+	RenderCsv(bench, csv);
+}
+
+} // namespace
+
+void RunUIBatchBenchmarks(std::ostream* csv)
+{
+	RunScaling(csv);
+	RunLookup(csv);
+}
+
+} // namespace MupfelBench
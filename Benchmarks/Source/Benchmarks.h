@@ -9,5 +9,21 @@ void RunViewBenchmarks(std::ostream* csv);
 void RunComponentAccessBenchmarks(std::ostream* csv);
 void RunLifecycleBenchmarks(std::ostream* csv);
 void RunParallelForEachBenchmarks(std::ostream* csv);
+void RunCullingBenchmarks(std::ostream* csv);
+void RunInstanceSortBenchmarks(std::ostream* csv);
+void RunUIBatchBenchmarks(std::ostream* csv);
+void RunAtlasPackerBenchmarks(std::ostream* csv);
+void RunProfilerBenchmarks(std::ostream* csv);
+void RunCounterBenchmarks(std::ostream* csv);
+void RunFrameBenchmarks(std::ostream* csv);
+void RunMemoryBenchmarks(std::ostream* csv);
+void RunSparseSetBenchmarks(std::ostream* csv);
+void RunSnapshotBenchmarks(std::ostream* csv);
+void RunEntityStreamBenchmarks(std::ostream* csv);
+void RunSceneStreamBenchmarks(std::ostream* csv);
+void RunPrefabBenchmarks(std::ostream* csv);
+void RunScenePartitionBenchmarks(std::ostream* csv);
+void RunTransformHierarchyBenchmarks(std::ostream* csv);
+void RunDefragmentBenchmarks(std::ostream* csv);
 
 } // namespace MupfelBench
@@ -0,0 +1,163 @@
+// Host setup for the benchmark runner, see System.h.
+
+#include "System.h"
+
+#include <fstream>
+#include <set>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace MupfelBench {
+
+namespace {
+
+#if defined(_WIN32)
+DWORD_PTR original_mask = 0;
+DWORD_PTR pinned_mask = 0;
+#elif defined(__linux__)
+cpu_set_t original_mask;
+cpu_set_t pinned_mask;
+bool	  pinned = false;
+#endif
+
+} // namespace
+
+#if defined(_WIN32)
+
+std::optional<int> PinToCurrentCpu()
+{
+	const DWORD cpu = GetCurrentProcessorNumber();
+	if (cpu >= sizeof(DWORD_PTR) * 8)
+	{
+		return std::nullopt;
+	}
+
+	const DWORD_PTR mask = DWORD_PTR{1} << cpu;
+	const DWORD_PTR previous = SetThreadAffinityMask(GetCurrentThread(), mask);
+	if (previous == 0)
+	{
+		return std::nullopt;
+	}
+
+	if (original_mask == 0)
+	{
+		original_mask = previous;
+	}
+	pinned_mask = mask;
+	return static_cast<int>(cpu);
+}
+
+void UnpinCpu()
+{
+	if (original_mask != 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), original_mask);
+	}
+}
+
+void RepinCpu()
+{
+	if (pinned_mask != 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), pinned_mask);
+	}
+}
+
+#elif defined(__linux__)
+
+std::optional<int> PinToCurrentCpu()
+{
+	const int cpu = sched_getcpu();
+	if (cpu < 0 || cpu >= CPU_SETSIZE)
+	{
+		return std::nullopt;
+	}
+
+	cpu_set_t previous;
+	CPU_ZERO(&previous);
+	if (sched_getaffinity(0, sizeof(previous), &previous) != 0)
+	{
+		return std::nullopt;
+	}
+
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	CPU_SET(cpu, &mask);
+	if (sched_setaffinity(0, sizeof(mask), &mask) != 0)
+	{
+		return std::nullopt;
+	}
+
+	if (!pinned)
+	{
+		original_mask = previous;
+	}
+	pinned_mask = mask;
+	pinned = true;
+	return cpu;
+}
+
+void UnpinCpu()
+{
+	if (pinned)
+	{
+		sched_setaffinity(0, sizeof(original_mask), &original_mask);
+	}
+}
+
+void RepinCpu()
+{
+	if (pinned)
+	{
+		sched_setaffinity(0, sizeof(pinned_mask), &pinned_mask);
+	}
+}
+
+#else
+
+std::optional<int> PinToCurrentCpu() { return std::nullopt; }
+
+void UnpinCpu() {}
+
+void RepinCpu() {}
+
+#endif
+
+std::optional<std::string> CpuGovernorWarning()
+{
+	std::set<std::string> governors;
+
+	for (int cpu = 0;; ++cpu)
+	{
+		std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_governor");
+		std::string	  governor;
+		if (!(file >> governor))
+		{
+			break;
+		}
+		governors.insert(governor);
+	}
+
+	governors.erase("performance");
+	if (governors.empty())
+	{
+		return std::nullopt;
+	}
+
+	std::string names;
+	for (const std::string& governor : governors)
+	{
+		names += (names.empty() ? "" : ", ") + governor;
+	}
+
+	return "CPU frequency governor is '" + names + "', not 'performance'; clock ramping adds noise. Try\n"
+		   "    sudo cpupower frequency-set --governor performance";
+}
+
+} // namespace MupfelBench
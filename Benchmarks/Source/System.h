@@ -0,0 +1,31 @@
+#pragma once
+//
+// Host setup for steadier numbers: pinning the runner to one CPU and checking the frequency governor.
+// Both are best effort -- where the platform doesn't support them they quietly do nothing.
+
+#include <optional>
+#include <string>
+
+namespace MupfelBench {
+
+/**
+ * Pins the calling thread to the CPU it is running on, so the scheduler can't migrate it between cores
+ * (and caches) mid-measurement. Threads created afterwards inherit the pin.
+ *
+ * \return The CPU index, or std::nullopt if pinning isn't supported or failed.
+ */
+std::optional<int> PinToCurrentCpu();
+
+/** Undoes PinToCurrentCpu, for groups that measure several threads. No-op if nothing was pinned. */
+void UnpinCpu();
+
+/** Re-applies the last PinToCurrentCpu after an UnpinCpu. */
+void RepinCpu();
+
+/**
+ * A warning if any CPU's frequency governor isn't `performance` (Linux cpufreq), naming the governors in
+ * use; std::nullopt if all are, or if the governor can't be read on this system.
+ */
+std::optional<std::string> CpuGovernorWarning();
+
+} // namespace MupfelBench
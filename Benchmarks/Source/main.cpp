@@ -1,22 +1,89 @@
 // Entry point for the Mupfel ECS microbenchmarks.
 //
 // Runs every benchmark group and prints a markdown results table per group to stdout. Pass
-// `--csv <path>` to additionally dump machine-readable results for regression tracking.
+// `--csv <path>` to additionally dump machine-readable results for regression tracking, and
+// `--trace <path>` to write the ProfilingSamples recorded during the run as a Chrome trace.
+//
+// Regression tracking: `--save-baseline <path>` stores the run's results (the same CSV as `--csv`),
+// `--baseline <path>` compares the run against such a file, prints a per-row table and exits with 2
+// if any row got slower by more than `--threshold <percent>` (default 10) and more than its noise.
+//
+// Investigation: `--list` prints the group names, `--filter <regex>` runs only the groups whose name
+// matches, `--repeat N` runs them N times, `--min-epoch-ms` trades accuracy for turnaround, and
+// `--json <path>` keeps every epoch of every bench (nanobench's JSON template) for offline analysis.
+// The runner pins itself to one CPU (`--no-pin` to opt out) and warns if the CPU governor would let
+// the clock wander.
 //
 // Reliability: build the Benchmarks project in Release or Dist. Debug builds are unoptimized and
 // enable the ECS asserts, so their numbers mean nothing (a warning is printed below in that case).
 
+#include "Baseline.h"
+#include "BenchCommon.h"
 #include "Benchmarks.h"
+#include "System.h"
 
+#include "Core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <regex>
+#include <sstream>
 #include <string>
+#include <vector>
+
+namespace {
+
+struct Group
+{
+	const char* name;
+	void (*run)(std::ostream* csv);
+	/** Measures several threads, so it runs with the CPU pin lifted. */
+	bool threaded = false;
+};
+
+constexpr Group groups[] = {
+	{"View", MupfelBench::RunViewBenchmarks},
+	{"ComponentAccess", MupfelBench::RunComponentAccessBenchmarks},
+	{"Lifecycle", MupfelBench::RunLifecycleBenchmarks},
+	{"ParallelForEach", MupfelBench::RunParallelForEachBenchmarks, true},
+	{"Culling", MupfelBench::RunCullingBenchmarks},
+	{"InstanceSort", MupfelBench::RunInstanceSortBenchmarks},
+	{"UIBatch", MupfelBench::RunUIBatchBenchmarks},
+	{"AtlasPacker", MupfelBench::RunAtlasPackerBenchmarks},
+	{"Profiler", MupfelBench::RunProfilerBenchmarks, true},
+	{"Counters", MupfelBench::RunCounterBenchmarks},
+	{"Frame", MupfelBench::RunFrameBenchmarks},
+	{"Memory", MupfelBench::RunMemoryBenchmarks},
+	{"SparseSet", MupfelBench::RunSparseSetBenchmarks},
+	{"Snapshot", MupfelBench::RunSnapshotBenchmarks},
+	{"EntityStream", MupfelBench::RunEntityStreamBenchmarks},
+	{"SceneStream", MupfelBench::RunSceneStreamBenchmarks},
+	{"Prefab", MupfelBench::RunPrefabBenchmarks},
+	{"ScenePartition", MupfelBench::RunScenePartitionBenchmarks},
+	{"TransformHierarchy", MupfelBench::RunTransformHierarchyBenchmarks, true},
+	{"Defragment", MupfelBench::RunDefragmentBenchmarks},
+};
+
+} // namespace
 
 int main(int argc, char** argv)
 {
 	std::string csv_path;
+	std::string trace_path;
+	std::string baseline_path;
+	std::string save_baseline_path;
+	double		threshold = 0.10;
+	std::string json_path;
+	std::string filter;
+	bool		list = false;
+	bool		pin = true;
+	int			repeat = 1;
 
 	for (int i = 1; i < argc; ++i)
 	{
@@ -24,11 +91,61 @@ int main(int argc, char** argv)
 		{
 			csv_path = argv[++i];
 		}
+		else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			trace_path = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+		{
+			baseline_path = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--save-baseline") == 0 && i + 1 < argc)
+		{
+			save_baseline_path = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+		{
+			threshold = std::atof(argv[++i]) / 100.0;
+		}
+		else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			json_path = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+		{
+			repeat = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--min-epoch-ms") == 0 && i + 1 < argc)
+		{
+			MupfelBench::Options().minEpochTime = std::chrono::milliseconds(std::max(1, std::atoi(argv[++i])));
+		}
+		else if (std::strcmp(argv[i], "--list") == 0)
+		{
+			list = true;
+		}
+		else if (std::strcmp(argv[i], "--no-pin") == 0)
+		{
+			pin = false;
+		}
 		else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0)
 		{
 			std::cout << "Mupfel ECS benchmarks\n"
-						 "  --csv <path>   also write machine-readable CSV results (for regression tracking)\n"
-						 "  -h, --help     show this help\n";
+						 "  --csv <path>           also write machine-readable CSV results\n"
+						 "  --json <path>          write every bench with all its epochs as JSON\n"
+						 "  --trace <path>         write the run's profiling samples as a Chrome trace (Perfetto UI)\n"
+						 "  --save-baseline <path> store the results as a baseline (same CSV as --csv)\n"
+						 "  --baseline <path>      compare against a baseline; exit code 2 if a row regressed\n"
+						 "  --threshold <percent>  regression threshold for --baseline (default 10)\n"
+						 "  --list                 list the benchmark groups and exit\n"
+						 "  --filter <regex>       only run the groups whose name matches\n"
+						 "  --repeat <n>           run the selected groups n times\n"
+						 "  --min-epoch-ms <ms>    minimum time per epoch (default 50)\n"
+						 "  --no-pin               don't pin the runner to one CPU\n"
+						 "  -h, --help             show this help\n";
 			return 0;
 		}
 		else
@@ -38,6 +155,41 @@ int main(int argc, char** argv)
 		}
 	}
 
+	std::regex selection;
+	try
+	{
+		selection = std::regex(filter.empty() ? std::string(".*") : filter, std::regex::icase);
+	}
+	catch (const std::regex_error& e)
+	{
+		std::cerr << "Invalid --filter expression: " << filter << " (" << e.what() << ")\n";
+		return 1;
+	}
+
+	std::vector<const Group*> selected;
+	for (const Group& group : groups)
+	{
+		if (std::regex_search(group.name, selection))
+		{
+			selected.push_back(&group);
+		}
+	}
+
+	if (list)
+	{
+		for (const Group* group : selected)
+		{
+			std::cout << group->name << "\n";
+		}
+		return 0;
+	}
+
+	if (selected.empty())
+	{
+		std::cerr << "No benchmark group matches --filter " << filter << " (see --list)\n";
+		return 1;
+	}
+
 	std::unique_ptr<std::ofstream> csv_file;
 	if (!csv_path.empty())
 	{
@@ -48,20 +200,141 @@ int main(int argc, char** argv)
 			return 1;
 		}
 	}
-	std::ostream* csv = csv_file ? csv_file.get() : nullptr;
+
+	/* Loaded up front, so a typo in the path fails before the suite runs. */
+	std::vector<MupfelBench::BaselineRow> baseline;
+	if (!baseline_path.empty())
+	{
+		std::optional<std::vector<MupfelBench::BaselineRow>> loaded = MupfelBench::LoadBaseline(baseline_path);
+		if (!loaded)
+		{
+			std::cerr << "Could not open baseline file: " << baseline_path << "\n";
+			return 1;
+		}
+		baseline = std::move(*loaded);
+	}
+
+	/* The groups render their CSV into memory; it is written to the requested files after the run. */
+	std::stringstream results;
+	const bool		  collect = csv_file || !baseline_path.empty() || !save_baseline_path.empty();
+	std::ostream*	  csv = collect ? &results : nullptr;
+
+	std::vector<std::string> json;
+	if (!json_path.empty())
+	{
+		MupfelBench::Options().json = &json;
+	}
+
+	if (!trace_path.empty())
+	{
+		/* Every Profiler::Clear() inside a benchmark counts as a frame; the capture stops at its sample bound. */
+		Mupfel::Profiler::StartCapture(UINT32_MAX);
+	}
 
 #ifdef DEBUG
 	std::cout << "\n[!] This is a DEBUG build - the numbers below are NOT representative.\n"
 				 "    Build the Benchmarks project in Release or Dist for meaningful results.\n\n";
 #endif
 
-	MupfelBench::RunViewBenchmarks(csv);
-	MupfelBench::RunComponentAccessBenchmarks(csv);
-	MupfelBench::RunLifecycleBenchmarks(csv);
-	MupfelBench::RunParallelForEachBenchmarks(csv);
+	if (std::optional<std::string> warning = MupfelBench::CpuGovernorWarning())
+	{
+		std::cout << "[!] " << *warning << "\n";
+	}
+
+	if (pin)
+	{
+		if (std::optional<int> cpu = MupfelBench::PinToCurrentCpu())
+		{
+			std::cout << "Pinned to CPU " << *cpu << " (multi-threaded groups run unpinned)\n";
+		}
+	}
 
-	if (csv)
+	for (int run = 0; run < repeat; ++run)
+	{
+		if (repeat > 1)
+		{
+			std::cout << "\n# Run " << run + 1 << " of " << repeat << "\n";
+		}
+
+		for (const Group* group : selected)
+		{
+			/* Threads inherit the pin when they are created, so lift it before a group starts any. */
+			if (group->threaded)
+			{
+				MupfelBench::UnpinCpu();
+			}
+
+			group->run(csv);
+
+			if (group->threaded)
+			{
+				MupfelBench::RepinCpu();
+			}
+		}
+	}
+
+	if (csv_file)
+	{
+		*csv_file << results.str();
 		std::cout << "\nCSV results written to " << csv_path << "\n";
+	}
+
+	if (!save_baseline_path.empty())
+	{
+		std::ofstream file(save_baseline_path, std::ios::trunc);
+		if (!(file << results.str()))
+		{
+			std::cerr << "Could not write baseline file: " << save_baseline_path << "\n";
+			return 1;
+		}
+		std::cout << "Baseline written to " << save_baseline_path << "\n";
+	}
+
+	if (!json_path.empty())
+	{
+		/* One JSON document per bench; wrap them in an array so the file is valid JSON as a whole. */
+		std::ofstream file(json_path, std::ios::trunc);
+		file << "[\n";
+		for (size_t i = 0; i < json.size(); ++i)
+		{
+			file << json[i] << (i + 1 < json.size() ? ",\n" : "\n");
+		}
+		file << "]\n";
+
+		if (!file)
+		{
+			std::cerr << "Could not write JSON file: " << json_path << "\n";
+			return 1;
+		}
+		std::cout << "JSON results written to " << json_path << "\n";
+	}
+
+	if (!trace_path.empty())
+	{
+		/* Picks up samples finished since the last Clear() as a final frame. */
+		Mupfel::Profiler::Clear();
+		Mupfel::Profiler::StopCapture();
+
+		if (!Mupfel::Profiler::WriteChromeTrace(trace_path))
+		{
+			std::cerr << "Could not write trace file: " << trace_path << "\n";
+			return 1;
+		}
+		std::cout << "Trace (" << Mupfel::Profiler::GetCapturedSamples().size() << " samples) written to "
+				  << trace_path << "\n";
+	}
+
+	if (!baseline_path.empty())
+	{
+		const std::vector<MupfelBench::BaselineRow> current = MupfelBench::ParseBaseline(results);
+		const uint32_t								regressions = MupfelBench::PrintComparison(
+			   MupfelBench::CompareBaseline(baseline, current, threshold), threshold, std::cout);
+
+		if (regressions > 0)
+		{
+			return 2;
+		}
+	}
 
 	return 0;
 }
@@ -48,6 +48,9 @@ project "Core"
         DepPath("spdlog", "include"),
         DepPath("imgui"),
         DepPath("box2d", "include"),
+        DepPath("stb"),
+        DepPath("lz4"),
+        DepPath("zstd", "lib"),
     }
 
     libdirs
@@ -64,4 +67,6 @@ project "Core"
         "glfw3",
         "vulkan",
         "box2d",
+        "lz4",
+        "zstd",
     }
@@ -14,9 +14,9 @@ namespace Mupfel::App
 {
 
 /**
- * Initializes the engine subsystems and creates the main window.
+ * Initializes the engine subsystems and creates the main window (unless running headless).
  *
- * \param spec Application name and window configuration.
+ * \param spec Application name, window and headless configuration.
  * \return True if initialization succeeded.
  */
 inline bool Init(const ApplicationSpecification& spec) { return Application::Get().Init(spec); }
@@ -42,4 +42,7 @@ inline void PushLayer()
 /** Whether the debug overlay is currently toggled on. */
 [[nodiscard]] inline bool DebugMode() { return Application::isDebugModeEnabled(); }
 
+/** Whether the application runs without a window and renderer, see HeadlessSpecification. */
+[[nodiscard]] inline bool Headless() { return Application::IsHeadless(); }
+
 } // namespace Mupfel::App
@@ -7,11 +7,14 @@
 #pragma once
 #include "Core/Application.h"
 #include "ECS/Entity.h"
+#include "ECS/Prefab.h"
 #include "ECS/Registry.h"
+#include "ECS/TransformSystem.h"
 #include "ECS/View.h"
 #include <concepts>
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 namespace Mupfel::Entities
 {
@@ -19,9 +22,32 @@ namespace Mupfel::Entities
 /** Creates an entity in the active scene and fires an EntityCreatedEvent. */
 [[nodiscard]] inline Entity Create() { return Application::GetCurrentRegistry().CreateEntity(); }
 
+/**
+ * Creates \a count copies of \a prefab in the active scene and fires one PrefabInstantiatedEvent.
+ *
+ * \return The new entities, copy by copy, see `Registry::Instantiate`.
+ */
+inline std::vector<Entity> Instantiate(const Prefab& prefab, uint32_t count = 1)
+{
+	return Application::GetCurrentRegistry().Instantiate(prefab, count);
+}
+
 /** Destroys \a e and fires an EntityDestroyedEvent. */
 inline void Destroy(Entity e) { Application::GetCurrentRegistry().DestroyEntity(e); }
 
+/**
+ * Attaches \a child to \a parent: from the next frame on, it is drawn relative to \a parent.
+ *
+ * \return False, and nothing changes, if the link is impossible, see `TransformSystem::Attach`.
+ */
+inline bool Attach(Entity child, Entity parent)
+{
+	return TransformSystem::Attach(Application::GetCurrentRegistry(), child, parent);
+}
+
+/** Detaches \a child from its parent; it keeps its `Transform`, which is now relative to the world. */
+inline void Detach(Entity child) { TransformSystem::Detach(Application::GetCurrentRegistry(), child); }
+
 /** The number of live entities in the registry, across all scenes. */
 [[nodiscard]] inline uint32_t Count() { return Application::GetCurrentRegistry().GetCurrentEntities(); }
 
@@ -72,6 +98,21 @@ template <typename T> [[nodiscard]] inline bool HasComponent(Entity e)
 	return Application::GetCurrentRegistry().HasComponent<T>(e);
 }
 
+/**
+ * Sorts the components of type T of the active scene with \a compare, see `Registry::Sort`.
+ *
+ * \note Meant for between frames: it invalidates references to components of type T.
+ */
+template <typename T, typename Compare>
+	requires std::strict_weak_order<Compare&, const T&, const T&>
+inline void Sort(Compare compare)
+{
+	Application::GetCurrentRegistry().Sort<T>(std::move(compare));
+}
+
+/** Puts the components of type T in the order of those of type U, see `Registry::SortLike`. */
+template <typename T, typename U> inline void SortLike() { Application::GetCurrentRegistry().SortLike<T, U>(); }
+
 /**
  * Iterate over all entities that have a specified set of components.
  *
@@ -48,4 +48,40 @@ LoadSpriteSheet(const std::string& path, const ImageSpecification& spec)
 	return Application::LoadSpriteSheetImages(path, spec);
 }
 
+/**
+ * Loads a single, unanimated image in the background.
+ *
+ * The handle can be used right away; it shows the default texture until the image has been decoded on
+ * the thread pool and uploaded at the start of a later frame.
+ *
+ * \param path Path to the image, relative to the working directory.
+ * \return The image handle.
+ */
+[[nodiscard]] inline ImageHandle LoadAsync(const std::string& path) { return Application::LoadBasicImageAsync(path); }
+
+/**
+ * Loads an animated image in the background, see LoadAsync().
+ *
+ * \param path Path to the image.
+ * \param spec The frame grid to interpret the image with.
+ * \return The image handle.
+ */
+[[nodiscard]] inline ImageHandle LoadAnimatedAsync(const std::string& path, const ImageSpecification& spec)
+{
+	return Application::LoadAnimatedImageAsync(path, spec);
+}
+
+/**
+ * Loads a spritesheet in the background, see LoadAsync().
+ *
+ * \param path Path to the spritesheet.
+ * \param spec The frame grid to cut the sheet with.
+ * \return One handle per frame.
+ */
+[[nodiscard]] inline std::vector<ImageHandle>
+LoadSpriteSheetAsync(const std::string& path, const ImageSpecification& spec)
+{
+	return Application::LoadSpriteSheetImagesAsync(path, spec);
+}
+
 } // namespace Mupfel::Images
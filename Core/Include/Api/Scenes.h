@@ -36,6 +36,14 @@ template <typename T>
  */
 inline void Switch(SceneHandle handle) { Application::QueueSceneSwitch(handle); }
 
+/**
+ * Streams \a handle in and switches to it once it is complete.
+ *
+ * The scene's OnStage() builds its entities on a worker thread; they are merged over the following
+ * frames, so a large scene doesn't stall a frame. See Application::QueueSceneStream().
+ */
+inline void Stream(SceneHandle handle) { Application::QueueSceneStream(handle); }
+
 /** The scene currently being updated and rendered. */
 [[nodiscard]] inline SceneHandle Current() { return Application::GetCurrentSceneHandle(); }
 
@@ -24,11 +24,37 @@ namespace Mupfel
 class DebugLayer;
 class PhysicsSimulation;
 class AnimationSystem;
+class TransformSystem;
 class Renderer;
 class ECSRenderer;
 class DebugRenderer;
 class IMRenderer;
 class UI;
+class ResourceManager;
+class SceneStreamer;
+
+/**
+ * @brief Configures headless mode: the main loop without a window, renderer or GPU.
+ *
+ * Meant for dedicated simulation servers, CI and performance tests on machines without a GPU.
+ * Scenes, layers, physics and animation are updated as usual, but nothing is rendered:
+ * OnRender() is never called, image loads return the default image handle and input queries
+ * report no keys.
+ */
+struct HeadlessSpecification
+{
+	/** @brief Runs the application headless. */
+	bool enabled = false;
+
+	/** @brief Simulation ticks per second. Every frame advances the simulation by 1 / tickRate. */
+	double tickRate = 60.0;
+
+	/** @brief Runs frames back to back instead of pacing them at tickRate (the timestep stays fixed). */
+	bool unlimited = false;
+
+	/** @brief Stops the main loop after this many frames, 0 runs until Stop() is called. */
+	uint64_t maxFrames = 0;
+};
 
 /**
  * @brief Defines the specification parameters used to initialize the Application.
@@ -47,6 +73,32 @@ struct ApplicationSpecification
 	 * @brief The configuration of the main window (size, title, vSync, etc.).
 	 */
 	WindowSpecification windowSpec;
+
+	/**
+	 * @brief Headless mode configuration, disabled by default.
+	 */
+	HeadlessSpecification headless;
+
+	/**
+	 * @brief Resource pack to mount at startup, none if empty.
+	 *
+	 * Images and entity files found in the pack are read from it instead of the file system.
+	 */
+	std::string resourcePack;
+
+	/**
+	 * @brief Time per frame, in seconds, spent merging a streamed scene into the registry.
+	 *
+	 * See Application::QueueSceneStream(). At least one slice of entities is merged per frame regardless.
+	 */
+	double sceneMergeBudget = 0.002;
+
+	/**
+	 * @brief Time per frame, in seconds, spent putting component arrays back in order after removals.
+	 *
+	 * See Registry::Defragment(). 0 turns it off.
+	 */
+	double defragmentBudget = 0.0005;
 };
 
 /**
@@ -79,7 +131,8 @@ public:
 	~Application();
 
 	/**
-	 * @brief Initializes the engine subsystems and creates the main window.
+	 * @brief Initializes the engine subsystems and creates the main window
+	 * (unless the specification asks for headless mode).
 	 * @param spec The specification used for initialization.
 	 * @return True if initialization succeeded.
 	 */
@@ -89,7 +142,8 @@ public:
 	 * @brief Starts the main application loop.
 	 *
 	 * This function runs the engine until the window is closed or
-	 * Application::Stop() is called.
+	 * Application::Stop() is called. In headless mode, it also stops
+	 * after HeadlessSpecification::maxFrames frames.
 	 */
 	void Run();
 
@@ -123,6 +177,11 @@ public:
 	 */
 	static bool IsWindowMinimized();
 
+	/**
+	 * @brief Returns whether the application runs without a window and renderer.
+	 */
+	static bool IsHeadless();
+
 	/**
 	 * @brief Returns whether the Debug Mode is currently enabled.
 	 */
@@ -171,6 +230,22 @@ public:
 	[[nodiscard]] static Expected<std::vector<ImageHandle>>
 	LoadSpriteSheetImages(const std::string path, const ImageSpecification& spec);
 
+	/**
+	 * Load a single image in the background. The handle is valid immediately and shows the default
+	 * texture until the image has been decoded and uploaded.
+	 *
+	 * \param path Path to the image.
+	 * \return Image Handle.
+	 */
+	[[nodiscard]] static ImageHandle LoadBasicImageAsync(const std::string path);
+
+	/** Background variant of LoadAnimatedImage(), see LoadBasicImageAsync(). */
+	[[nodiscard]] static ImageHandle LoadAnimatedImageAsync(const std::string path, const ImageSpecification& spec);
+
+	/** Background variant of LoadSpriteSheetImages(), see LoadBasicImageAsync(). */
+	[[nodiscard]] static std::vector<ImageHandle>
+	LoadSpriteSheetImagesAsync(const std::string path, const ImageSpecification& spec);
+
 	template <typename T> static std::optional<T> GetConfigEntry(const std::string key);
 
 	template <typename T> static void SetConfigEntry(const std::string key, T value);
@@ -180,6 +255,11 @@ public:
 	 */
 	static ThreadPool& GetCurrentThreadPool();
 
+	/**
+	 * @brief The resource pack mounted at startup, or nullptr if there is none.
+	 */
+	static const ResourceManager* GetResourcePack();
+
 	static uint64_t GetFrameCount();
 
 	/**
@@ -205,6 +285,15 @@ public:
 
 	static void QueueSceneSwitch(SceneHandle handle);
 
+	/**
+	 * @brief Streams a scene in and switches to it once it is complete.
+	 *
+	 * The scene's OnStage() builds its entities into a staging registry on the thread pool, and they
+	 * are merged into the registry over the following frames, ApplicationSpecification::sceneMergeBudget
+	 * per frame. The current scene keeps running meanwhile. Ignored while another stream is in flight.
+	 */
+	static void QueueSceneStream(SceneHandle handle);
+
 	static SceneHandle GetCurrentSceneHandle();
 
 	static Camera& GetCurrentSceneCamera();
@@ -224,6 +313,18 @@ private:
 	 */
 	void DeInit();
 
+	/**
+	 * @brief The main loop of headless mode, see HeadlessSpecification.
+	 */
+	void RunHeadless();
+
+	/**
+	 * @brief Switches to a queued scene and updates the scene, layers, physics and animation.
+	 *
+	 * This is the part of a frame that is shared by the windowed and the headless main loop.
+	 */
+	void UpdateSimulation(double timestep);
+
 	static ImageManager& GetCurrentImageManager();
 
 	/**
@@ -293,6 +394,9 @@ private:
 	/** Image Manager. */
 	ImageManager image_manager;
 
+	/** The mounted resource pack, see ApplicationSpecification::resourcePack. */
+	std::unique_ptr<ResourceManager> resources;
+
 	/**
 	 * @brief Thread pool for multi-threaded jobs (e.g., physics, AI).
 	 *
@@ -308,6 +412,9 @@ private:
 
 	std::unique_ptr<AnimationSystem> animationSystem;
 
+	/** @brief Computes the WorldTransforms of entity hierarchies, after physics and animation. */
+	std::unique_ptr<TransformSystem> transformSystem;
+
 	std::array<std::unique_ptr<Scene>, Scene::MAX_SCENES> scenes;
 
 	SceneHandle current_scene = 0;
@@ -316,6 +423,13 @@ private:
 
 	SceneHandle next_free_handle = 0;
 
+	/**
+	 * @brief Streams scenes in, see QueueSceneStream().
+	 *
+	 * @warning Must stay declared after `scenes` and `registry`, which a running stage job uses.
+	 */
+	std::unique_ptr<SceneStreamer> streamer;
+
 	/** @brief The debug rendering layer used for profiling and visualization. */
 	std::unique_ptr<DebugLayer> debug_layer;
 
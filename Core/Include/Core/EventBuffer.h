@@ -1,5 +1,6 @@
 #pragma once
 #include "Event.h"
+#include "MemoryUsage.h"
 #include <cstdint>
 #include <optional>
 #include <span>
@@ -30,6 +31,17 @@ public:
 	 * add a way to clear the EventBuffer.
 	 */
 	virtual void Clear() = 0;
+
+	/**
+	 * @brief Heap memory held by the buffer. Clearing keeps the capacity, so
+	 * `reserved` is the peak number of events seen in one frame.
+	 */
+	virtual MemoryUsage GetMemoryUsage() const = 0;
+
+	/**
+	 * @brief Gives back the capacity the current events don't need.
+	 */
+	virtual void ShrinkToFit() = 0;
 };
 
 /**
@@ -87,6 +99,10 @@ public:
 	 */
 	uint64_t GetPendingEvents() override;
 
+	MemoryUsage GetMemoryUsage() const override;
+
+	void ShrinkToFit() override;
+
 	/**
 	 * Returns a span over the vector.
 	 * 
@@ -142,4 +158,17 @@ inline uint64_t EventBuffer<T>::GetPendingEvents()
 {
 	return event_buf.size();
 }
+template <typename T>
+	requires EventType<T>
+inline MemoryUsage EventBuffer<T>::GetMemoryUsage() const
+{
+	return MemoryUsage::Of(event_buf);
+}
+
+template <typename T>
+	requires EventType<T>
+inline void EventBuffer<T>::ShrinkToFit()
+{
+	event_buf.shrink_to_fit();
+}
 } // namespace Mupfel
\ No newline at end of file
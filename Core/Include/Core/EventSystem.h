@@ -69,6 +69,25 @@ namespace Mupfel {
 			requires EventType<T>
 		void AddImmediateEvent(T&& event);
 
+		/**
+		 * @brief Only calls the registered callbacks for the event, without queueing
+		 * it. Meant for bulk operations that would otherwise queue millions of events
+		 * nobody reads; check HasListeners() first to skip building the events.
+		 * @tparam T The event type.
+		 * @param event The event passed to the callbacks.
+		 */
+		template<typename T>
+			requires EventType<T>
+		void NotifyListeners(const T& event);
+
+		/**
+		 * @brief Whether any callback is registered for the given Event type.
+		 * @tparam T The event type.
+		 */
+		template<typename T>
+			requires EventType<T>
+		bool HasListeners() const;
+
 		/**
 		 * @brief Get the amount of events currently pending for the specified
 		 * Event type.
@@ -116,6 +135,19 @@ namespace Mupfel {
 			requires EventType<T>
 		size_t EventTypeToID();
 
+		/**
+		 * @brief Heap memory held by the EventBuffers of both frames. The buffers
+		 * keep their capacity when they are cleared, so `reserved` follows the
+		 * busiest frame seen so far.
+		 */
+		MemoryUsage GetMemoryUsage() const;
+
+		/**
+		 * @brief Gives the capacity of all EventBuffers back that their current
+		 * events don't need. They grow again on demand.
+		 */
+		void ShrinkToFit();
+
 	private:
 
 		/**
@@ -231,6 +263,32 @@ namespace Mupfel {
 		AddEvent<T>(std::move(event));
 	}
 
+	template<typename T>
+		requires EventType<T>
+	inline void EventSystem::NotifyListeners(const T& event)
+	{
+		auto it = listeners.find(EventIndex<T>());
+		if (it == listeners.end())
+		{
+			return;
+		}
+
+		/* See AddImmediateEvent for why this is an index loop over a reference. */
+		std::vector<EventCallback>& callbacks_to_run = it->second;
+		for (uint32_t i = 0; i < callbacks_to_run.size(); i++)
+		{
+			callbacks_to_run[i](event);
+		}
+	}
+
+	template<typename T>
+		requires EventType<T>
+	inline bool EventSystem::HasListeners() const
+	{
+		auto it = listeners.find(EventIndex<T>());
+		return it != listeners.end() && !it->second.empty();
+	}
+
 	template<typename T>
 		requires EventType<T>
 	inline std::optional<T> EventSystem::GetLatestEvent()
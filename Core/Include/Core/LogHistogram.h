@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace Mupfel
+{
+
+/**
+ * A histogram of non-negative integer values (e.g. durations in nanoseconds) with constant memory and
+ * bounded relative error, in the spirit of HdrHistogram.
+ *
+ * Values below `subBuckets` are counted exactly. Above that, every power of two is split into
+ * `subBuckets` equally wide buckets, so a bucket is never wider than 1 / `subBuckets` of the values it
+ * holds. Percentiles report the middle of their bucket, which keeps them within half that, about 0.8%,
+ * of the exact value. Values beyond the largest power of two land in the last bucket.
+ */
+class LogHistogram
+{
+public:
+	/** Linear buckets per power of two; also the range counted exactly. */
+	static constexpr uint32_t subBucketBits = 6;
+	static constexpr uint32_t subBuckets = 1u << subBucketBits;
+	/** Largest power of two with buckets of its own: 2^40 ns is about 18 minutes. */
+	static constexpr uint32_t maxExponent = 40;
+	static constexpr uint32_t bucketCount = subBuckets + (maxExponent - subBucketBits + 1) * subBuckets;
+
+	void Record(uint64_t value);
+
+	/** Adds all values recorded by \a other. */
+	void Merge(const LogHistogram& other);
+
+	void Clear();
+
+	uint64_t GetCount() const;
+
+	/** The smallest / largest value recorded, exactly; 0 when empty. */
+	uint64_t GetMin() const;
+	uint64_t GetMax() const;
+
+	/** Exact mean; 0 when empty. */
+	double GetMean() const;
+
+	/**
+	 * The value below which \a percentile percent of the recorded values lie, e.g. 99.0 for p99.
+	 * Clamped to the exact minimum and maximum; 0 when empty.
+	 */
+	uint64_t GetPercentile(double percentile) const;
+
+private:
+	static uint32_t BucketIndex(uint64_t value);
+
+	/** The middle of the values bucket \a index covers. */
+	static uint64_t BucketValue(uint32_t index);
+
+private:
+	std::array<uint32_t, bucketCount> counts{};
+	uint64_t						  count = 0;
+	uint64_t						  min = UINT64_MAX;
+	uint64_t						  max = 0;
+	/** Kept as double, so long runs of large values can't overflow. */
+	double sum = 0.0;
+};
+
+} // namespace Mupfel
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Heap memory held by a container: `used` counts the bytes of the elements it currently holds,
+ * `reserved` the bytes it has allocated (its capacity). The difference is what a `ShrinkToFit`
+ * could give back.
+ */
+struct MemoryUsage
+{
+	size_t used = 0;
+	size_t reserved = 0;
+
+	MemoryUsage& operator+=(const MemoryUsage& other)
+	{
+		used += other.used;
+		reserved += other.reserved;
+		return *this;
+	}
+
+	MemoryUsage operator+(const MemoryUsage& other) const { return MemoryUsage(*this) += other; }
+
+	template <typename T> static MemoryUsage Of(const std::vector<T>& v)
+	{
+		return {v.size() * sizeof(T), v.capacity() * sizeof(T)};
+	}
+
+	/** `std::vector<bool>` packs its elements into bits. */
+	static MemoryUsage Of(const std::vector<bool>& v) { return {(v.size() + 7) / 8, (v.capacity() + 7) / 8}; }
+};
+
+} // namespace Mupfel
@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Mupfel
+{
+
+/** The hardware events a `PerfCounterGroup` counts. */
+enum class PerfCounter : uint8_t
+{
+	Cycles,
+	Instructions,
+	/** Last level cache misses (the kernel's generic "cache-misses" event). */
+	LlcMisses,
+	BranchMisses,
+	Count
+};
+
+/**
+ * Event counts, either running totals (`PerfCounterGroup::Read`) or the difference of two of them, next to
+ * the nanoseconds the group was enabled and actually running on the PMU over the same span.
+ */
+struct PerfCounterValues
+{
+	uint64_t cycles = 0;
+	uint64_t instructions = 0;
+	uint64_t llcMisses = 0;
+	uint64_t branchMisses = 0;
+	uint64_t timeEnabled = 0;
+	uint64_t timeRunning = 0;
+
+	/** Instructions per cycle; 0 when no cycles were counted. */
+	double Ipc() const;
+
+	/**
+	 * The counts scaled up to the whole of `timeEnabled`, estimating what they would have been had the
+	 * group never been multiplexed. Meant for differences: the ratio of the totals says nothing about the
+	 * share of one interval the group ran for.
+	 */
+	PerfCounterValues Scaled() const;
+
+	/** Per field, clamped at 0: the events of the interval between \a other and this. */
+	PerfCounterValues  operator-(const PerfCounterValues& other) const;
+	PerfCounterValues& operator+=(const PerfCounterValues& other);
+};
+
+/**
+ * A group of hardware performance counters for the calling thread, opened with Linux' perf_event_open.
+ *
+ * All events are scheduled onto the PMU together and read with a single `read` syscall, so the values of
+ * one `Read` belong to the same interval. The counters run from construction on and are never reset;
+ * measure a piece of code by subtracting the `Read` before it from the one after it. Should the kernel
+ * multiplex the group with other users of the PMU, `Scaled` on that difference makes up for the time the
+ * group didn't run.
+ *
+ * Counters are frequently unavailable: on other platforms, in virtual machines without a virtual PMU,
+ * or when `/proc/sys/kernel/perf_event_paranoid` forbids user space counting. Then `IsAvailable` is
+ * false, `GetError` says why and `Read` returns zeros, so callers never have to special-case the
+ * platform. Events the CPU lacks (e.g. LLC misses on some cores) read as 0 while the others still count.
+ *
+ * A group only counts the thread that created it. Use `ForCurrentThread` to share one per thread.
+ */
+class PerfCounterGroup
+{
+public:
+	PerfCounterGroup();
+	~PerfCounterGroup();
+
+	PerfCounterGroup(const PerfCounterGroup&) = delete;
+	PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+	/** Whether at least the cycle counter could be opened. */
+	bool IsAvailable() const;
+
+	/** Whether \a counter is being counted. */
+	bool Has(PerfCounter counter) const;
+
+	/** Why the group (or one of its events) could not be opened; empty if everything is counted. */
+	const std::string& GetError() const;
+
+	/** The raw totals and times since construction; zeros if the group is unavailable. */
+	PerfCounterValues Read() const;
+
+	/** The group of the calling thread, opened on first use and closed when the thread exits. */
+	static PerfCounterGroup& ForCurrentThread();
+
+private:
+	static constexpr uint32_t counterCount = static_cast<uint32_t>(PerfCounter::Count);
+
+	/** File descriptor per event, -1 if it is not counted. The cycle counter leads the group. */
+	std::array<int, counterCount> fds;
+	/** Position of each event's value in the group's read buffer. */
+	std::array<uint32_t, counterCount> slots{};
+	uint32_t						   opened = 0;
+	std::string						   error;
+};
+
+} // namespace Mupfel
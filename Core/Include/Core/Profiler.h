@@ -1,11 +1,23 @@
 #pragma once
+#include "Core/Error.h"
+#include "Core/LogHistogram.h"
+#include "Core/PerfCounters.h"
+#include <chrono>
+#include <deque>
+#include <map>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <cstdint>
 
 namespace Mupfel {
 
+	class Profiler;
+
 	/**
 	 * @brief Represents a single profiling sample within the engine.
 	 *
@@ -23,6 +35,8 @@ namespace Mupfel {
 	 * RAII-based lifetime management.
 	 */
 	struct ProfilingSample {
+		friend class Profiler;
+
 		/**
 		 * @brief Creates and starts a new profiling sample.
 		 * @param in_name The name of the code block being profiled.
@@ -91,15 +105,125 @@ namespace Mupfel {
 
 		/** @brief Nesting depth level of this sample (used for hierarchical profiling visualization). */
 		uint32_t depth = 0;
+
+		/** @brief Index of the thread that recorded the sample, in the order threads first recorded one. */
+		uint32_t thread = 0;
+
+	private:
+		/** @brief An empty, inactive sample; fills the Profiler's per-thread buffers. */
+		ProfilingSample() noexcept;
+	};
+
+	/**
+	 * @brief Static description of one MUPFEL_PROFILE_SCOPE call site.
+	 */
+	struct ProfileScopeInfo {
+		std::string_view name;
+		std::string_view file;
+		uint32_t line;
+	};
+
+	/**
+	 * @brief The scope object behind MUPFEL_PROFILE_SCOPE.
+	 *
+	 * A leaner sibling of ProfilingSample: it holds a reference to its call site's
+	 * static ProfileScopeInfo instead of a name, reads raw steady_clock ticks
+	 * instead of Application::GetTime(), takes no sample ID and has no vtable.
+	 * The ticks are only converted to seconds when the sample is written into
+	 * the thread's buffer, where it joins the ProfilingSamples.
+	 *
+	 * Samples recorded this way carry the ID 0; order them by start_time.
+	 */
+	class ProfileScope final {
+	public:
+		explicit ProfileScope(const ProfileScopeInfo& in_info) noexcept;
+		~ProfileScope();
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		void* operator new(size_t) = delete;
+		void* operator new[](size_t) = delete;
+
+	private:
+		const ProfileScopeInfo& info;
+		uint64_t start;
+		uint32_t depth;
+	};
+
+	/**
+	 * @brief The scope object behind MUPFEL_PROFILE_COUNTERS.
+	 *
+	 * Reads the calling thread's PerfCounterGroup on entry and on exit and adds
+	 * the difference to the Profiler's totals for \a name. While counters are
+	 * switched off (Profiler::SetCountersEnabled) it does nothing but check the flag,
+	 * since every read is a syscall of a few hundred nanoseconds.
+	 */
+	class CounterScope final {
+	public:
+		explicit CounterScope(std::string_view in_name);
+		~CounterScope();
+
+		CounterScope(const CounterScope&) = delete;
+		CounterScope& operator=(const CounterScope&) = delete;
+
+		void* operator new(size_t) = delete;
+		void* operator new[](size_t) = delete;
+
+	private:
+		std::string_view name;
+		PerfCounterValues start;
+		bool active;
+	};
+
+	/**
+	 * @brief A sample kept by a Profiler capture, tagged with the frame it was recorded in.
+	 */
+	struct CapturedSample {
+		std::string_view name;
+		double start_time;
+		double end_time;
+		uint32_t thread;
+		uint32_t depth;
+		/** @brief Index of the frame within the capture, counted in calls to Profiler::Clear. */
+		uint32_t frame;
+	};
+
+	/**
+	 * @brief Duration statistics of one profiling scope over the recent frames, in milliseconds.
+	 */
+	struct ScopeStats {
+		/** @brief Valid until Profiler::ResetScopeStats is called. */
+		std::string_view name;
+		/** @brief Number of samples the statistics are based on. */
+		uint64_t count;
+		double min_ms;
+		double mean_ms;
+		double p50_ms;
+		double p95_ms;
+		double p99_ms;
+		double max_ms;
+	};
+
+	/**
+	 * @brief Hardware counter totals of one MUPFEL_PROFILE_COUNTERS scope since the last reset.
+	 */
+	struct ScopeCounters {
+		/** @brief Valid until Profiler::ResetScopeStats is called. */
+		std::string_view name;
+		/** @brief Number of times the scope ran while counters were enabled. */
+		uint64_t count;
+		PerfCounterValues total;
 	};
 
 	/**
 	 * @brief Singleton that collects and manages profiling samples.
 	 *
-	 * The Profiler provides a thread-safe container for all ProfilingSample
-	 * instances recorded during a frame. It supports clearing all samples,
-	 * generating new unique sample IDs, and exposing the current list of samples
-	 * for rendering or export.
+	 * Every thread records its samples into a ring buffer of its own, so recording
+	 * never takes a lock and threads don't contend with each other (e.g. when profiling
+	 * a ParallelForEach body). Only `Clear` touches all buffers: it merges what was
+	 * recorded since the previous call into the list returned by `GetCurrentSamples`.
+	 * IDs come from a relaxed atomic counter.
 	 *
 	 * The Profiler is designed for lightweight, per-frame performance measurement
 	 * and visualization, such as in an on-screen debug overlay.
@@ -116,28 +240,100 @@ namespace Mupfel {
 		static Profiler& Get();
 
 		/**
-		 * @brief Clears all currently stored profiling samples.
+		 * @brief Replaces the current samples with those completed since the previous call.
 		 *
 		 * This function should typically be called once per frame after
-		 * rendering the profiling overlay. It also resets the internal
-		 * sample ID counter.
+		 * rendering the profiling overlay, so the overlay always shows the last
+		 * whole frame. It also resets the internal sample ID counter.
+		 * Call it from one thread at a time.
 		 */
 		static void Clear();
 
 		/**
-		 * @brief Indicates whether the Profiler is currently clearing samples.
-		 * @return True if the Profiler is clearing its data.
+		 * @brief Returns a reference to the samples gathered by the last `Clear`.
+		 * @return Const reference to the current vector of ProfilingSamples, grouped by thread.
+		 */
+		static const std::vector<ProfilingSample>& GetCurrentSamples();
+
+		/**
+		 * @brief Number of samples lost so far because a thread's buffer was full.
 		 *
-		 * Used internally to prevent ProfilingSample instances from
-		 * submitting results while the buffer is being cleared.
+		 * A thread can hold `samplesPerThread` samples between two calls to `Clear`.
 		 */
-		static bool IsClearing();
+		static uint64_t GetDroppedSamples();
 
 		/**
-		 * @brief Returns a reference to the list of all recorded samples.
-		 * @return Const reference to the current vector of ProfilingSamples.
+		 * @brief Starts keeping the samples of the next \a frames frames for export.
+		 * @param frames Number of calls to `Clear` to capture.
+		 * @param max_samples Bound on the samples kept; the capture ends early once it is reached.
+		 *
+		 * Restarting discards a previous capture. The buffer is allocated up front, so a
+		 * running capture never allocates.
 		 */
-		static const std::vector<ProfilingSample>& GetCurrentSamples();
+		static void StartCapture(uint32_t frames, uint32_t max_samples = defaultCaptureSamples);
+
+		/** @brief Ends a running capture, keeping what it recorded so far. */
+		static void StopCapture();
+
+		/** @brief Whether a capture is still recording frames. */
+		static bool IsCapturing();
+
+		/** @brief Returns the samples of the current or last capture, in frame order. */
+		static const std::vector<CapturedSample>& GetCapturedSamples();
+
+		/**
+		 * @brief Writes the captured samples to \a path in the Chrome Trace Event format.
+		 * @return Nothing, or Error::FILE_NOT_FOUND if the file can't be written.
+		 *
+		 * The file opens in chrome://tracing and in the Perfetto UI, one track per thread.
+		 */
+		static Expected<void> WriteChromeTrace(const std::string& path);
+
+		/**
+		 * @brief Returns the statistics of every scope name seen, sorted by name.
+		 *
+		 * Samples are aggregated by name at every `Clear`, over the last
+		 * `statsWindowFrames` to 2 * `statsWindowFrames` frames. Percentiles come from a
+		 * LogHistogram, so they are accurate to about 1% and every scope takes
+		 * the same, constant amount of memory.
+		 */
+		static std::vector<ScopeStats> GetScopeStats();
+
+		/** @brief Returns the statistics of the scope called \a name, if it was seen. */
+		static std::optional<ScopeStats> GetScopeStats(std::string_view name);
+
+		/** @brief Forgets all scope statistics and counter totals, e.g. after a scene switch. */
+		static void ResetScopeStats();
+
+		/**
+		 * @brief Switches hardware counting in MUPFEL_PROFILE_COUNTERS scopes on or off.
+		 *
+		 * Off by default. Counting stays silent where PerfCounterGroup is unavailable;
+		 * check PerfCounterGroup::ForCurrentThread() to tell the user why.
+		 */
+		static void SetCountersEnabled(bool enabled);
+
+		static bool AreCountersEnabled();
+
+		/** @brief Returns the counter totals of every MUPFEL_PROFILE_COUNTERS scope, sorted by name. */
+		static std::vector<ScopeCounters> GetScopeCounters();
+
+		/**
+		 * @brief Remembers a MUPFEL_PROFILE_SCOPE call site.
+		 * @return The stored copy, valid for the lifetime of the program.
+		 *
+		 * The macro calls this once per call site, from a function-local static.
+		 */
+		static const ProfileScopeInfo& RegisterScope(const ProfileScopeInfo& info);
+
+		/** @brief Returns every call site registered so far, in registration order. */
+		static std::vector<ProfileScopeInfo> GetRegisteredScopes();
+
+		/** @brief The raw clock ProfileScope reads. */
+		static uint64_t Ticks()
+		{
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+		}
 
 		/**
 		 * @brief Generates a new unique profiling sample ID.
@@ -148,15 +344,77 @@ namespace Mupfel {
 		/** @brief Default destructor. */
 		~Profiler() = default;
 
+	public:
+		/** @brief Capacity of every thread's sample buffer. */
+		static constexpr uint32_t samplesPerThread = 4096;
+
+		/** @brief Default bound of a capture, about 12 MB of samples. */
+		static constexpr uint32_t defaultCaptureSamples = 256 * 1024;
+
+		/** @brief Frames after which the scope statistics drop their older half. */
+		static constexpr uint32_t statsWindowFrames = 600;
+
 	private:
+		friend class ProfileScope;
+		friend class CounterScope;
+
 		/**
-		 * @brief Adds a completed profiling sample to the internal sample list.
+		 * @brief One thread's samples: a single-producer, single-consumer ring.
+		 *
+		 * Only the owning thread advances `head`, only `Clear` advances `tail`,
+		 * so both sides get by with acquire/release loads and stores.
+		 */
+		struct ThreadBuffer
+		{
+			explicit ThreadBuffer(uint32_t in_thread);
+
+			std::vector<ProfilingSample> samples;
+			std::atomic<uint64_t> head = 0;
+			std::atomic<uint64_t> tail = 0;
+			std::atomic<uint64_t> dropped = 0;
+			uint32_t thread;
+		};
+
+		/**
+		 * @brief Adds a completed profiling sample to the calling thread's buffer.
 		 * @param sample The profiling sample to store.
 		 */
 		void AddSample(ProfilingSample&& sample);
 
+		/** @brief Adds a finished ProfileScope to the calling thread's buffer. */
+		void AddScope(const ProfileScopeInfo& info, uint64_t start, uint64_t end, uint32_t depth);
+
+		/** @brief Adds the counters of one finished CounterScope to its totals. */
+		void AddCounters(std::string_view name, const PerfCounterValues& values);
+
+		/** @brief Claims the next free slot of \a buffer, or returns nullptr (and counts a drop) when it is full. */
+		ProfilingSample* BeginWrite(ThreadBuffer& buffer);
+
+		/** @brief Converts Ticks() to the time base of Application::GetTime(). */
+		double TicksToSeconds(uint64_t ticks) const;
+
+		/** @brief The calling thread's buffer, registered on first use. */
+		ThreadBuffer& GetThreadBuffer();
+
+		/**
+		 * @brief Durations of one scope in nanoseconds, in two windows of `statsWindowFrames` frames.
+		 *
+		 * New samples go to `current`; when a window is over, `current` becomes `previous`,
+		 * so the statistics always cover between one and two windows.
+		 */
+		struct ScopeHistogram
+		{
+			LogHistogram current;
+			LogHistogram previous;
+		};
+
+		/** @brief Adds the merged samples to the scope statistics. */
+		void UpdateScopeStats();
+
+		static ScopeStats MakeScopeStats(std::string_view name, const ScopeHistogram& histogram);
+
 		/** @brief Private constructor (singleton pattern). */
-		Profiler() = default;
+		Profiler();
 
 		Profiler(const Profiler&) = delete;
 		Profiler& operator=(const Profiler&) = delete;
@@ -164,17 +422,85 @@ namespace Mupfel {
 		Profiler& operator=(Profiler&&) = delete;
 
 	private:
-		/** @brief Flag indicating whether the Profiler is currently being cleared. */
-		std::atomic<bool> is_clearing = false;
-
-		/** @brief Mutex to ensure thread-safe access to the sample list. */
+		/** @brief Guards `buffers`; taken once per thread on registration and by `Clear`. */
 		std::mutex mutex;
 
-		/** @brief Collection of all ProfilingSamples recorded during the frame. */
+		/** @brief Every thread's buffer. They are never freed, so thread-local pointers stay valid. */
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+		/** @brief Next sample ID. */
+		std::atomic<uint32_t> next_id = 0;
+
+		/** @brief Collection of all ProfilingSamples recorded during the last frame. */
 		std::vector<ProfilingSample> samples;
+
+		/** @brief Samples kept by the current or last capture; guarded by `mutex`. */
+		std::vector<CapturedSample> captured;
+
+		/** @brief Frames the running capture still records; 0 when not capturing. */
+		uint32_t capture_frames_left = 0;
+
+		/** @brief Frames the running capture has recorded so far. */
+		uint32_t capture_frame = 0;
+
+		/** @brief Statistics per scope name; guarded by `mutex`. */
+		std::map<std::string, ScopeHistogram, std::less<>> scope_stats;
+
+		/** @brief Frames recorded into the current statistics window. */
+		uint32_t stats_frame = 0;
+
+		/** @brief Runs and counter totals per MUPFEL_PROFILE_COUNTERS scope name; guarded by `mutex`. */
+		std::map<std::string, std::pair<uint64_t, PerfCounterValues>, std::less<>> scope_counters;
+
+		std::atomic<bool> counters_enabled = false;
+
+		/** @brief Registered call sites; a deque, so references to them stay valid. Guarded by `mutex`. */
+		std::deque<ProfileScopeInfo> scopes;
+
+		/** @brief Seconds per tick and the Application::GetTime() value of tick 0. */
+		double tick_period;
+		double tick_offset;
 	};
 
 }
 
+/**
+ * MUPFEL_PROFILING selects whether MUPFEL_PROFILE_SCOPE records anything. It defaults to on, except in
+ * Dist builds, where the macro expands to nothing.
+ */
+#ifndef MUPFEL_PROFILING
+#ifdef DIST
+#define MUPFEL_PROFILING 0
+#else
+#define MUPFEL_PROFILING 1
+#endif
+#endif
+
+#define MUPFEL_PROFILE_CONCAT_INNER(a, b) a##b
+#define MUPFEL_PROFILE_CONCAT(a, b) MUPFEL_PROFILE_CONCAT_INNER(a, b)
 
+/**
+ * Profiles the rest of the enclosing block under \a name, which must be a string literal.
+ * The call site is registered with the Profiler the first time it runs.
+ */
+#if MUPFEL_PROFILING
+#define MUPFEL_PROFILE_SCOPE(name)                                                                                     \
+	static const ::Mupfel::ProfileScopeInfo& MUPFEL_PROFILE_CONCAT(mupfel_profile_info_, __LINE__) =                   \
+		::Mupfel::Profiler::RegisterScope({name, __FILE__, __LINE__});                                                 \
+	::Mupfel::ProfileScope MUPFEL_PROFILE_CONCAT(mupfel_profile_scope_, __LINE__)(                                     \
+		MUPFEL_PROFILE_CONCAT(mupfel_profile_info_, __LINE__))
+#else
+#define MUPFEL_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
 
+/**
+ * Like MUPFEL_PROFILE_SCOPE, and additionally counts cycles, instructions and cache misses of the block
+ * while Profiler::SetCountersEnabled is on. Meant for a handful of hot, coarse scopes, not inner loops.
+ */
+#if MUPFEL_PROFILING
+#define MUPFEL_PROFILE_COUNTERS(name)                                                                                  \
+	MUPFEL_PROFILE_SCOPE(name);                                                                                        \
+	::Mupfel::CounterScope MUPFEL_PROFILE_CONCAT(mupfel_profile_counters_, __LINE__)(name)
+#else
+#define MUPFEL_PROFILE_COUNTERS(name) static_cast<void>(0)
+#endif
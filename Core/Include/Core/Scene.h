@@ -12,6 +12,7 @@ typedef uint32_t SceneHandle;
 
 /* Forward declaration to register it as a friend. */
 class Application;
+class Registry;
 
 class Scene
 {
@@ -29,6 +30,14 @@ public:
 	virtual void  OnRender() = 0;
 	virtual void  OnSwitchIn() = 0;
 	virtual void  OnSwitchOut() = 0;
+
+	/**
+	 * Builds the scene's entities into \a staging, on a worker thread, when the scene is streamed in with
+	 * `Application::QueueSceneStream`; they are merged into the scene over the next frames. Must only
+	 * touch \a staging and data nothing else writes to meanwhile. Does nothing by default.
+	 */
+	virtual void OnStage(Registry& staging) {}
+
 	SceneHandle	  GetHandle() const;
 	const Camera& GetCamera() const;
 
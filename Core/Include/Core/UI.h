@@ -1,9 +1,40 @@
 #pragma once
-#include <string>
+#include "Core/GUID.h"
+#include "Renderer/ImageManager.h"
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace Mupfel
 {
+
+/**
+ * Names a UI image by its path.
+ *
+ * The path is hashed once when the handle is created (at compile time for string literals), so the UI
+ * renderer finds the loaded image by that hash instead of hashing and comparing a std::string on every
+ * draw call. The path itself is only read the first time the image is used, to load it.
+ */
+class UIImage
+{
+public:
+	/** Hashes a string literal at compile time, e.g. `UI::Button(x, y, w, h, "Images/buttons/home.png")`. */
+	template <size_t N> consteval UIImage(const char (&in_path)[N]) : path(in_path, N - 1), hash(Hash::Compute(path))
+	{
+	}
+
+	/** Hashes a runtime path. `in_path` must outlive the draw call the handle is passed to. */
+	explicit constexpr UIImage(std::string_view in_path) : path(in_path), hash(Hash::Compute(in_path)) {}
+
+	constexpr std::string_view GetPath() const { return path; }
+
+	constexpr uint64_t GetHash() const { return hash; }
+
+private:
+	std::string_view path;
+	uint64_t		 hash;
+};
+
 class UI
 {
 public:
@@ -15,10 +46,24 @@ public:
 	 * \param y y-offset in screen space.
 	 * \param width The width of the button. This is independent of the used texture.
 	 * \param height The height of the button. This is independent of the used texture.
-	 * \param image_path Path to an image containing the button texture.
+	 * \param image A spritesheet with one row of three images: unhovered, hovered and pressed.
 	 * \return 0 if the cursor is not overlapping the button, 1 if the cursor is hovering over the button, 2 if the
 	 * button is pressed. 
 	 */
-	static uint32_t Button(float x, float y, float width, float height, const std::string& image_path);
+	static uint32_t Button(float x, float y, float width, float height, UIImage image);
+
+	/**
+	 * Draw an already loaded image as a screen-space quad.
+	 *
+	 * Cheap enough to be called tens of thousands of times per frame.
+	 *
+	 * \param x x-offset in screen space.
+	 * \param y y-offset in screen space.
+	 * \param width The width of the quad.
+	 * \param height The height of the quad.
+	 * \param image The image to draw, e.g. from `Images::Load`.
+	 * \param rotation Rotation around the quad's centre, in radians.
+	 */
+	static void Image(float x, float y, float width, float height, ImageHandle image, float rotation = 0.0f);
 };
 } // namespace Mupfel
@@ -1,10 +1,14 @@
 #pragma once
 #include "Components/ComponentIndex.h"
 #include "IComponentArray.h"
+#include "SparsePages.h"
+#include <algorithm>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <span>
 #include <vector>
 
@@ -13,6 +17,8 @@ namespace Mupfel
 
 template <typename FirstComponent, typename... Components> class View;
 class Registry;
+class Prefab;
+class TransformSystem;
 
 template <typename T>
 concept ComponentType = std::assignable_from<T&, T> && std::swappable<T>;
@@ -20,18 +26,26 @@ concept ComponentType = std::assignable_from<T&, T> && std::swappable<T>;
 /**
  * Host-memory, sparse-set storage for one component type `T`.
  *
- * `sparse[entity_index]` maps an entity to its slot in the parallel `dense`/`components` arrays
- * (or `IComponentArray::invalid_entry` if the entity has no component of this type). `Remove` is
+ * `sparse` maps an entity index to its slot in the parallel `dense`/`components` arrays (or
+ * `SparsePages::invalid_slot` if the entity has no component of this type). It is paged, so a type
+ * only a few entities have stays small however high their indices are. `Remove` is
  * O(1): it swaps the removed slot with the last slot in `dense`/`components`, so iteration order
  * over `components` is not stable across removals.
+ *
+ * Entities are created in index order, so a fresh array is in index order too, and arrays of different
+ * types line up. Removals and late inserts scramble that; `Defragment` restores it a step at a time,
+ * unless `Sort` or `Arrange` gave the array an order of its own. Such an order is its owner's to restore,
+ * see `OrderBroken`.
  */
 template <ComponentType T> class ComponentArray : public IComponentArray
 {
 	template <typename FirstComponent, typename... Components> friend class View;
 	friend class Registry;
+	friend class Prefab;
+	friend class TransformSystem;
 
 public:
-	/** Reserves `capacity` entries up front in `sparse`, `dense`, and `components`. */
+	/** Reserves `capacity` entries up front in `dense` and `components`; `sparse` allocates pages on demand. */
 	ComponentArray(uint32_t capacity = 1000);
 	~ComponentArray() override = default;
 
@@ -42,15 +56,35 @@ public:
 
 	size_t ComponentID() const final;
 
+	std::string_view ComponentName() const final;
+
+	/** Sums `sparse`, `dense` and `components`; every allocated page of `sparse` counts as used. */
+	MemoryUsage GetMemoryUsage() const final;
+
+	/** Frees the empty pages of `sparse` and shrinks `dense` and `components`. */
+	void ShrinkToFit() final;
+
 	/** Number of components currently stored. */
 	uint32_t Size() const final;
 
+	std::unique_ptr<IComponentArray> CreateEmpty() const final;
+
+	void CopyTo(IComponentArray& target, std::span<const Entity> from, std::span<const Entity> to,
+		std::vector<Entity>& copied) const final;
+
+	void CloneTo(IComponentArray& target, std::span<const Entity> to, uint32_t copies, uint32_t stride) const final;
+
+	bool Defragment(uint32_t indices) final;
+
 	/**
 	 * Raw access to the dense entity-index array (parallel to `components`), e.g. for
 	 * `View`/`Registry::ParallelForEach` iteration.
 	 */
 	std::span<const uint32_t> GetDense();
 
+	/** Raw access to the component data, parallel to `GetDense()`. */
+	std::span<const T> GetComponents() const;
+
 	T&	 Get(Entity e);
 	void Set(Entity e, T val);
 
@@ -63,51 +97,349 @@ public:
 	 */
 	void Insert(Entity e, T component);
 
+	/**
+	 * Bulk variant of `Insert`: inserts `data[i]` for `entities[i]`. New components are appended in
+	 * order, so `data` is copied in one piece when none of the entities has one yet.
+	 */
+	void InsertBulk(std::span<const Entity> entities, std::span<const T> data);
+
+	/**
+	 * Moves the components of \a order to the front, in that order: the `k`-th entity of \a order that has a
+	 * component ends up in slot `k`. Entities without one, and repeated ones, are skipped; the other
+	 * components end up behind them, in no particular order. `Defragment` leaves the new order alone, even
+	 * once an insert or removal broke it.
+	 */
+	void Arrange(std::span<const Entity> order);
+
+	/**
+	 * Sorts the components with \a compare, a strict weak order on `T`; `dense` follows and `sparse` is
+	 * patched. `Defragment` leaves the new order alone, like after `Arrange`.
+	 */
+	template <typename Compare>
+		requires std::strict_weak_order<Compare&, const T&, const T&>
+	void Sort(Compare compare);
+
+	/**
+	 * Whether an insert or removal may have broken the order the last `Sort`/`Arrange` gave the array. Stays
+	 * set until the next `Sort`/`Arrange` restores an order or `ReleaseOrder` gives it up.
+	 */
+	bool OrderBroken() const;
+
+	/** Gives up the order set by `Sort`/`Arrange`, so `Defragment` puts the array back in index order. */
+	void ReleaseOrder();
+
 private:
-	/** Entity index -> slot in `dense`/`components`, or `invalid_entry`. */
-	std::vector<size_t> sparse;
+	/** Swaps slots \a a and \a b of `dense`/`components` and patches `sparse` for both. */
+	void SwapSlots(uint32_t a, uint32_t b);
+
+	/** Called before \a index is appended to `dense`; notes if that breaks index order. */
+	void Appending(uint32_t index);
+
+	/**
+	 * Index order is (or may be) broken, and a `Defragment` pass in progress has to be repeated. So is an
+	 * order set by `Sort`/`Arrange`, see `OrderBroken`.
+	 */
+	void Disturb();
+
+	/**
+	 * Makes room for \a extra more components. Grows at least geometrically: an exact `reserve` per bulk
+	 * insert would reallocate on every one of them, and many small batches would turn quadratic.
+	 */
+	void Grow(size_t extra);
+
+private:
+	/** Entity index -> slot in `dense`/`components`, or `SparsePages::invalid_slot`. */
+	SparsePages sparse;
 	/** Slot -> owning entity index; parallel to `components`. */
 	std::vector<uint32_t> dense;
 	/** Component data, indexed by the same slot as `dense`. */
 	std::vector<T> components;
+
+	/** Whether `dense` is known to be in index order; `Defragment` has nothing to do then. */
+	bool ordered = true;
+	/** Set by `Sort`/`Arrange`: the order is the caller's, `Defragment` leaves it alone. */
+	bool custom_order = false;
+	/** See `OrderBroken`. */
+	bool order_broken = false;
+	/** Whether the `Defragment` pass in progress has seen no `Disturb` since it began. */
+	bool pass_clean = true;
+	/** The `Defragment` pass in progress: the next entity index to visit and the slot it belongs in. */
+	uint32_t defrag_index = 0;
+	uint32_t defrag_slot = 0;
 };
 
 template <ComponentType T> inline void ComponentArray<T>::Insert(Entity e, T component)
 {
 	/*
-		If the sparse array is too small, we resize it using the invalid_index as value.
-		We resize in powers of two for now.
-	*/
-	if (e.Index() >= sparse.size())
-	{
-		std::size_t new_size = (static_cast<std::size_t>(e.Index()) + 2) * 2;
-		sparse.resize(new_size, IComponentArray::invalid_entry);
-	}
-
-	/*
-		A value of "invalid_index" shows that the entity does not have the component yet.
+		A value of "invalid_slot" shows that the entity does not have the component yet.
 		If the entity already has a component of this type, we simply override it.
 	*/
-	if (sparse[e.Index()] != IComponentArray::invalid_entry)
+	const uint32_t slot = sparse.Find(e.Index());
+	if (slot != SparsePages::invalid_slot)
 	{
 		/* component already present. */
-		components[sparse[e.Index()]] = std::move(component);
+		components[slot] = std::move(component);
 		return;
 	}
 
 	/*
 		New entries of the component and dense vectors are always pushed at the end.
+		The page of the entity's index is allocated on first use.
 	*/
-	sparse[e.Index()] = dense.size();
+	Appending(e.Index());
+	sparse.Set(e.Index(), static_cast<uint32_t>(dense.size()));
 
 	/* The value at the index stores which entity uses the component */
 	dense.push_back(e.Index());
 	components.push_back(std::move(component));
 }
 
+template <ComponentType T>
+inline void ComponentArray<T>::InsertBulk(std::span<const Entity> entities, std::span<const T> data)
+{
+	assert(entities.size() == data.size() && "Every entity needs exactly one component!");
+
+	Grow(entities.size());
+
+	/* Sparse and dense first; entities that already have a component are overridden in place. */
+	bool overrides = false;
+	for (const Entity e : entities)
+	{
+		const uint32_t slot = sparse.Find(e.Index());
+		if (slot != SparsePages::invalid_slot)
+		{
+			overrides = true;
+			continue;
+		}
+		Appending(e.Index());
+		sparse.Set(e.Index(), static_cast<uint32_t>(dense.size()));
+		dense.push_back(e.Index());
+	}
+
+	if (!overrides)
+	{
+		components.insert(components.end(), data.begin(), data.end());
+		return;
+	}
+
+	/* New slots were handed out in order, so they are appended in order; everything else is overridden. */
+	components.reserve(dense.size());
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		const uint32_t slot = sparse.Get(entities[i].Index());
+		if (slot < components.size())
+		{
+			components[slot] = data[i];
+		}
+		else
+		{
+			components.push_back(data[i]);
+		}
+	}
+}
+
+template <ComponentType T> inline std::unique_ptr<IComponentArray> ComponentArray<T>::CreateEmpty() const
+{
+	return std::make_unique<ComponentArray<T>>(10);
+}
+
+template <ComponentType T>
+inline void ComponentArray<T>::CopyTo(IComponentArray& target, std::span<const Entity> from,
+	std::span<const Entity> to, std::vector<Entity>& copied) const
+{
+	assert(target.ComponentID() == ComponentID() && "Components can only be copied to an array of their type!");
+	assert(from.size() == to.size() && "Every source entity needs exactly one target entity!");
+
+	copied.clear();
+	std::vector<T> data;
+	for (size_t i = 0; i < from.size(); i++)
+	{
+		const uint32_t slot = sparse.Find(from[i].Index());
+		if (slot != SparsePages::invalid_slot)
+		{
+			copied.push_back(to[i]);
+			data.push_back(components[slot]);
+		}
+	}
+
+	static_cast<ComponentArray<T>&>(target).InsertBulk(copied, data);
+}
+
+template <ComponentType T>
+inline void ComponentArray<T>::CloneTo(IComponentArray& target, std::span<const Entity> to, uint32_t copies,
+	uint32_t stride) const
+{
+	assert(target.ComponentID() == ComponentID() && "Components can only be copied to an array of their type!");
+	assert(&target != this && "Components can't be cloned into their own array!");
+
+	ComponentArray<T>& out = static_cast<ComponentArray<T>&>(target);
+	out.Grow(dense.size() * copies);
+
+	/* Every copy is a run of new slots at the end, in the order of this array: the data goes in one piece. */
+	for (uint32_t k = 0; k < copies; k++)
+	{
+		const std::span<const Entity> copy = to.subspan(static_cast<size_t>(k) * stride, stride);
+		for (const uint32_t index : dense)
+		{
+			const uint32_t e = copy[index].Index();
+			assert(out.sparse.Find(e) == SparsePages::invalid_slot && "Target entity already has the component!");
+			out.Appending(e);
+			out.sparse.Set(e, static_cast<uint32_t>(out.dense.size()));
+			out.dense.push_back(e);
+		}
+		out.components.insert(out.components.end(), components.begin(), components.end());
+	}
+}
+
+template <ComponentType T> inline void ComponentArray<T>::Arrange(std::span<const Entity> order)
+{
+	Disturb();
+	custom_order = true;
+	order_broken = false;
+
+	uint32_t next = 0;
+	for (const Entity e : order)
+	{
+		const uint32_t slot = sparse.Find(e.Index());
+		/* A slot in front of `next` has been placed already. */
+		if (slot == SparsePages::invalid_slot || slot < next)
+		{
+			continue;
+		}
+		if (slot != next)
+		{
+			SwapSlots(slot, next);
+		}
+		next++;
+	}
+}
+
+template <ComponentType T>
+template <typename Compare>
+	requires std::strict_weak_order<Compare&, const T&, const T&>
+inline void ComponentArray<T>::Sort(Compare compare)
+{
+	Disturb();
+	custom_order = true;
+	order_broken = false;
+
+	/* Sort the slots, then gather both arrays in the new order: every component is moved exactly once. */
+	std::vector<uint32_t> slots(dense.size());
+	std::iota(slots.begin(), slots.end(), 0u);
+	std::ranges::sort(slots, [&](uint32_t a, uint32_t b) { return compare(components[a], components[b]); });
+
+	std::vector<uint32_t> sorted_dense;
+	std::vector<T>		  sorted_components;
+	sorted_dense.reserve(dense.capacity());
+	sorted_components.reserve(components.capacity());
+	for (const uint32_t slot : slots)
+	{
+		sorted_dense.push_back(dense[slot]);
+		sorted_components.push_back(std::move(components[slot]));
+	}
+	dense = std::move(sorted_dense);
+	components = std::move(sorted_components);
+
+	for (uint32_t slot = 0; slot < dense.size(); slot++)
+	{
+		sparse.Set(dense[slot], slot);
+	}
+}
+
+template <ComponentType T> inline bool ComponentArray<T>::OrderBroken() const { return order_broken; }
+
+template <ComponentType T> inline void ComponentArray<T>::ReleaseOrder()
+{
+	custom_order = false;
+	order_broken = false;
+}
+
+template <ComponentType T> inline bool ComponentArray<T>::Defragment(uint32_t indices)
+{
+	if (ordered || custom_order)
+	{
+		return true;
+	}
+
+	/* A pass walks the entity indices upwards and swaps each one's component into the next slot. */
+	if (defrag_index == 0 && defrag_slot == 0)
+	{
+		pass_clean = true;
+	}
+
+	const uint32_t extent = sparse.Extent();
+	const uint32_t stop = static_cast<uint32_t>(std::min<uint64_t>(extent, uint64_t{defrag_index} + indices));
+	for (; defrag_index < stop && defrag_slot < dense.size(); defrag_index++)
+	{
+		const uint32_t slot = sparse.Find(defrag_index);
+		if (slot == SparsePages::invalid_slot)
+		{
+			continue;
+		}
+
+		/* A removal moved it into the part that is done already: this pass can't finish in order. */
+		if (slot < defrag_slot)
+		{
+			pass_clean = false;
+			continue;
+		}
+		if (slot != defrag_slot)
+		{
+			SwapSlots(slot, defrag_slot);
+		}
+		defrag_slot++;
+	}
+
+	if (defrag_index < extent && defrag_slot < dense.size())
+	{
+		return false;
+	}
+
+	/* The pass is over; if the array changed under it, the next call starts another one. */
+	defrag_index = 0;
+	defrag_slot = 0;
+	ordered = pass_clean;
+	return ordered;
+}
+
+template <ComponentType T> inline void ComponentArray<T>::Appending(uint32_t index)
+{
+	if (!dense.empty() && index < dense.back())
+	{
+		Disturb();
+	}
+}
+
+template <ComponentType T> inline void ComponentArray<T>::Disturb()
+{
+	ordered = false;
+	pass_clean = false;
+	order_broken = custom_order;
+}
+
+template <ComponentType T> inline void ComponentArray<T>::SwapSlots(uint32_t a, uint32_t b)
+{
+	std::swap(dense[a], dense[b]);
+	std::swap(components[a], components[b]);
+	sparse.Set(dense[a], a);
+	sparse.Set(dense[b], b);
+}
+
+template <ComponentType T> inline void ComponentArray<T>::Grow(size_t extra)
+{
+	const size_t needed = dense.size() + extra;
+	if (needed <= dense.capacity() && needed <= components.capacity())
+	{
+		return;
+	}
+
+	const size_t capacity = std::max(needed, dense.capacity() * 2);
+	dense.reserve(capacity);
+	components.reserve(capacity);
+}
+
 template <ComponentType T> inline ComponentArray<T>::ComponentArray(uint32_t capacity)
 {
-	sparse.reserve(capacity);
 	dense.reserve(capacity);
 	components.reserve(capacity);
 }
@@ -119,36 +451,64 @@ template <ComponentType T> inline void ComponentArray<T>::Remove(Entity e)
 		return;
 	}
 
-	size_t comp_index = sparse[e.Index()];
-	size_t last_index = dense.size() - 1;
+	uint32_t comp_index = sparse.Get(e.Index());
+	uint32_t last_index = static_cast<uint32_t>(dense.size()) - 1;
+
+	/* Taking the last one keeps the order; any other moves the last one out of place. */
+	if (comp_index != last_index)
+	{
+		Disturb();
+	}
 
 	/* Swap the element that should be removed with the last one */
 	std::swap(dense[comp_index], dense[last_index]);
 	std::swap(components[comp_index], components[last_index]);
 
 	/* the component order changed, update the sparse list */
-	sparse[dense[comp_index]] = comp_index;
+	sparse.Set(dense[comp_index], comp_index);
 
 	/* Delete the last component */
 	components.pop_back();
 	dense.pop_back();
 
 	/* invalidate the component reference */
-	sparse[e.Index()] = IComponentArray::invalid_entry;
+	sparse.Reset(e.Index());
 }
 
 template <ComponentType T> inline bool ComponentArray<T>::Has(Entity e) const
 {
-	return e.Index() < sparse.size() && sparse[e.Index()] != IComponentArray::invalid_entry;
+	return sparse.Contains(e.Index());
 }
 
 template <ComponentType T> inline size_t ComponentArray<T>::ComponentID() const { return ComponentIndex::Index<T>(); }
 
+template <ComponentType T> inline std::string_view ComponentArray<T>::ComponentName() const
+{
+	return ComponentIndex::Name<T>();
+}
+
+template <ComponentType T> inline MemoryUsage ComponentArray<T>::GetMemoryUsage() const
+{
+	return sparse.GetMemoryUsage() + MemoryUsage::Of(dense) + MemoryUsage::Of(components);
+}
+
+template <ComponentType T> inline void ComponentArray<T>::ShrinkToFit()
+{
+	sparse.ShrinkToFit();
+	dense.shrink_to_fit();
+	components.shrink_to_fit();
+}
+
 template <ComponentType T> inline std::span<const uint32_t> ComponentArray<T>::GetDense()
 {
 	return {dense.data(), dense.size()};
 }
 
+template <ComponentType T> inline std::span<const T> ComponentArray<T>::GetComponents() const
+{
+	return {components.data(), components.size()};
+}
+
 template <ComponentType T> inline uint32_t ComponentArray<T>::Size() const
 {
 	return static_cast<uint32_t>(dense.size());
@@ -158,13 +518,13 @@ template <ComponentType T> inline T& ComponentArray<T>::Get(Entity e)
 {
 	assert(Has(e) && "Given Entity does not currently have a component of this type!");
 
-	return components[sparse[e.Index()]];
+	return components[sparse.Get(e.Index())];
 }
 
 template <ComponentType T> inline void ComponentArray<T>::Set(Entity e, T val)
 {
 	assert(Has(e) && "Given Entity does not currently have a component of this type!");
-	components[sparse[e.Index()]] = std::move(val);
+	components[sparse.Get(e.Index())] = std::move(val);
 }
 
 } // namespace Mupfel
@@ -1,15 +1,19 @@
 #pragma once
+#include "ComponentReflection.h"
 #include <cstdint>
 
 namespace Mupfel
 {
 class AnimationSystem;
 class ECSRenderer;
+class InstancePacker;
 
 struct Animation
 {
 	friend class AnimationSystem;
 	friend class ECSRenderer;
+	friend class InstancePacker;
+class InstancePacker;
 
 	Animation() = default;
 
@@ -26,4 +30,16 @@ private:
 	float	 elapsed = 0.0f;
 	uint32_t currentFrame = 0;
 };
+
+/** The playback state (`elapsed`, `currentFrame`) is left to the AnimationSystem; snapshots still keep it. */
+template <> struct ComponentReflection<Animation>
+{
+	static constexpr std::string_view		   name = "Animation";
+	static constexpr uint32_t				   version = 1;
+	static constexpr ComponentField<Animation> fields[] = {
+		{"firstFrame", &Animation::firstFrame},
+		{"frameCount", &Animation::frameCount},
+		{"fps", &Animation::fps},
+	};
+};
 } // namespace Mupfel
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <string_view>
 
 namespace Mupfel
 {
@@ -17,6 +18,35 @@ public:
 		return id;
 	}
 
+	/**
+	 * The unqualified name of `T` (e.g. "Transform"), for debug output. Taken from the compiler's
+	 * function signature, so it needs no registration.
+	 */
+	template <typename T> static std::string_view Name() noexcept
+	{
+#if defined(_MSC_VER)
+		std::string_view name = __FUNCSIG__;
+		const size_t	 begin = name.find("Name<") + 5;
+		name = name.substr(begin, name.rfind(">(") - begin);
+#else
+		std::string_view name = __PRETTY_FUNCTION__;
+		const size_t	 begin = name.find("T = ") + 4;
+		name = name.substr(begin, name.find_first_of(";]", begin) - begin);
+#endif
+		for (std::string_view prefix : {"struct ", "class "})
+		{
+			if (name.starts_with(prefix))
+			{
+				name.remove_prefix(prefix.size());
+			}
+		}
+		if (const size_t scope = name.rfind("::"); scope != std::string_view::npos && name.find('<') > scope)
+		{
+			name.remove_prefix(scope + 2);
+		}
+		return name;
+	}
+
 private:
 	static size_t Claim() noexcept
 	{
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace Mupfel
+{
+
+/** The value types a reflected field can have, in the order of `ComponentField::Member`. */
+enum class FieldType : uint8_t
+{
+	Float,
+	UInt32,
+	Int32,
+	Bool
+};
+
+/**
+ * A field of component `T`: its name in entity files and the inspector, and the member it maps to.
+ *
+ * A member pointer rather than a byte offset, as `offsetof` is only defined for standard-layout types
+ * and components with private members (`Movement`, `Animation`) aren't. It carries the type, and the
+ * offset, all the same.
+ */
+template <typename T> struct ComponentField
+{
+	using Member = std::variant<float T::*, uint32_t T::*, int32_t T::*, bool T::*>;
+
+	std::string_view key;
+	Member			 member;
+
+	constexpr FieldType Type() const { return static_cast<FieldType>(member.index()); }
+
+	/** The field of \a component, converted to double. */
+	double Get(const T& component) const
+	{
+		return std::visit([&](auto m) { return static_cast<double>(component.*m); }, member);
+	}
+
+	/** Sets the field of \a component to \a value, converted to the field's type. */
+	void Set(T& component, double value) const
+	{
+		std::visit(
+			[&](auto m)
+			{
+				using Value = std::remove_reference_t<decltype(component.*m)>;
+				component.*m = static_cast<Value>(value);
+			},
+			member);
+	}
+};
+
+/**
+ * Describes component `T` for serialization and the debug inspector. Specialize it right after the
+ * component, with
+ *
+ *     static constexpr std::string_view name;        -- the name in entity files and snapshots
+ *     static constexpr uint32_t version;             -- bump when the layout of `T` changes
+ *     static constexpr ComponentField<T> fields[];   -- the fields entity files and the inspector see
+ *
+ * The fields don't have to cover the whole component: binary snapshots copy trivially copyable
+ * components as they are, private state included.
+ */
+template <typename T> struct ComponentReflection;
+
+template <typename T>
+concept ReflectedComponent = requires {
+	{ ComponentReflection<T>::name } -> std::convertible_to<std::string_view>;
+	{ ComponentReflection<T>::version } -> std::convertible_to<uint32_t>;
+	{ std::span<const ComponentField<T>>(ComponentReflection<T>::fields) };
+};
+
+/** The fields of \a T, see `ComponentReflection`. */
+template <ReflectedComponent T> constexpr std::span<const ComponentField<T>> FieldsOf()
+{
+	return ComponentReflection<T>::fields;
+}
+
+/** A list of component types; `ForEach` calls `f.template operator()<T>()` for each of them in order. */
+template <typename... T> struct ComponentList
+{
+	template <typename F> static void ForEach(F&& f) { (f.template operator()<T>(), ...); }
+};
+
+} // namespace Mupfel
@@ -0,0 +1,18 @@
+#pragma once
+#include "Animation.h"
+#include "ComponentReflection.h"
+#include "Light.h"
+#include "Movement.h"
+#include "Texture.h"
+#include "Transform.h"
+
+namespace Mupfel
+{
+
+/**
+ * The engine's reflected components. Entity files, scene snapshots and the debug inspector handle all
+ * of them; add a component here once it has a `ComponentReflection`.
+ */
+using EngineComponents = ComponentList<Transform, Movement, Texture, Animation, Light>;
+
+} // namespace Mupfel
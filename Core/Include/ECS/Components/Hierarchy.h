@@ -0,0 +1,40 @@
+#pragma once
+#include "ECS/Entity.h"
+#include <vector>
+
+namespace Mupfel {
+
+	/**
+	 * Attaches an entity to `entity`: its `Transform` is then relative to the parent's `WorldTransform`.
+	 * This is what `TransformSystem` builds the hierarchy from; set it with `TransformSystem::Attach`,
+	 * which keeps the parent's `Children` in sync.
+	 */
+	struct Parent
+	{
+		Entity entity;
+	};
+
+	/** The entities attached to an entity, maintained by `TransformSystem::Attach`/`Detach`. */
+	struct Children
+	{
+		std::vector<Entity> entities;
+	};
+
+	/**
+	 * Where an entity of a hierarchy ends up: its `Transform` composed with those of all its ancestors.
+	 * Written by `TransformSystem`, read by the renderer in place of the `Transform`.
+	 */
+	struct alignas(16) WorldTransform
+	{
+		float pos_x = 0.0f;
+		float pos_y = 0.0f;
+		float pos_z = 0.0f;
+		float scale_x = 1.0f;
+		float scale_y = 1.0f;
+		float rotation = 0.0f;
+		/** cos and sin of `rotation`, so children don't evaluate them again. */
+		float cos_rotation = 1.0f;
+		float sin_rotation = 0.0f;
+	};
+
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "ComponentReflection.h"
 
 namespace Mupfel
 {
@@ -11,4 +12,16 @@ struct Light
 	float b = 0.0f;
 };
 
+template <> struct ComponentReflection<Light>
+{
+	static constexpr std::string_view	   name = "Light";
+	static constexpr uint32_t			   version = 1;
+	static constexpr ComponentField<Light> fields[] = {
+		{"ambientStrength", &Light::ambientStrength},
+		{"r", &Light::r},
+		{"g", &Light::g},
+		{"b", &Light::b},
+	};
+};
+
 } // namespace Mupfel
@@ -1,4 +1,5 @@
 #pragma once
+#include "ComponentReflection.h"
 
 namespace Mupfel {
 
@@ -79,4 +80,19 @@ namespace Mupfel {
          */
         float _pad0 = 0.0f;
     };
+
+    /** The padding isn't a field; snapshots copy it along with the rest. */
+    template <> struct ComponentReflection<Movement> {
+        static constexpr std::string_view name = "Movement";
+        static constexpr uint32_t version = 1;
+        static constexpr ComponentField<Movement> fields[] = {
+            {"velocity_x", &Movement::velocity_x},
+            {"velocity_y", &Movement::velocity_y},
+            {"velocity_z", &Movement::velocity_z},
+            {"angular_velocity", &Movement::angular_velocity},
+            {"initial_acceleration", &Movement::initial_acceleration},
+            {"acceleration_decay", &Movement::acceleration_decay},
+            {"friction", &Movement::friction},
+        };
+    };
 }
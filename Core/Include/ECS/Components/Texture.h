@@ -1,4 +1,6 @@
 #pragma once
+#include "ComponentReflection.h"
+#include <cstdint>
 
 namespace Mupfel
 {
@@ -9,5 +11,18 @@ struct Texture
 	uint32_t index = 0;
 	/** Texture repeat factor; values > 1 tile the texture (used by the ground). */
 	float uvScale = 1.0f;
+	/** Draw layer; lower layers are drawn first when instance sorting is enabled (see mupfel.ini). */
+	uint32_t layer = 0;
+};
+
+template <> struct ComponentReflection<Texture>
+{
+	static constexpr std::string_view		 name = "Texture";
+	static constexpr uint32_t				 version = 1;
+	static constexpr ComponentField<Texture> fields[] = {
+		{"index", &Texture::index},
+		{"uvScale", &Texture::uvScale},
+		{"layer", &Texture::layer},
+	};
 };
 } // namespace Mupfel
\ No newline at end of file
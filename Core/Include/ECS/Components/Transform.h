@@ -1,4 +1,5 @@
 #pragma once
+#include "ComponentReflection.h"
 
 namespace Mupfel {
 
@@ -12,6 +13,20 @@ namespace Mupfel {
 		float rotation = 0.0f;
 	};
 
+	template <> struct ComponentReflection<Transform>
+	{
+		static constexpr std::string_view		   name = "Transform";
+		static constexpr uint32_t				   version = 1;
+		static constexpr ComponentField<Transform> fields[] = {
+			{"pos_x", &Transform::pos_x},
+			{"pos_y", &Transform::pos_y},
+			{"pos_z", &Transform::pos_z},
+			{"scale_x", &Transform::scale_x},
+			{"scale_y", &Transform::scale_y},
+			{"rotation", &Transform::rotation},
+		};
+	};
+
 }
 
 
@@ -1,6 +1,9 @@
 #pragma once
 #include "Core/Event.h"
 #include "Entity.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 /**
  * This header defines some events used by the Registry.
@@ -69,4 +72,23 @@ public:
 	/** `ComponentIndex::Index` of the component type being removed. */
 	size_t comp_id;
 };
+
+/**
+ * Fired via `EventSystem::AddImmediateEvent` from `Registry::Instantiate`, once per call, instead of an
+ * `EntityCreatedEvent` per entity and a `ComponentAddedEvent` per component. Listeners that track
+ * entities by signature read the signatures from the registry.
+ */
+class PrefabInstantiatedEvent : public Event
+{
+public:
+	PrefabInstantiatedEvent(std::vector<Entity> in_entities, uint32_t in_stride)
+		: entities(std::move(in_entities)), stride(in_stride)
+	{
+	}
+
+	/** Every entity created, copy by copy: entity `i` of copy `k` is `entities[k * stride + i]`. */
+	std::vector<Entity> entities;
+	/** Entities per copy, the prefab's entity count. */
+	uint32_t stride;
+};
 } // namespace Mupfel
@@ -1,6 +1,7 @@
 #pragma once
 #include "Core/Event.h"
 #include "Core/EventBuffer.h"
+#include "Core/MemoryUsage.h"
 #include <bitset>
 #include <cstdint>
 #include <vector>
@@ -13,6 +14,7 @@ namespace Mupfel
 class EntityManager;
 template <typename FirstComponent, typename... Components> class View;
 class Registry;
+class Prefab;
 
 /**
  * This class defines the entity. It is basically just a wrapper around uint32_t.
@@ -29,6 +31,9 @@ class Entity
 	/* TODO: i do not want that! This is only because of the parallel view... */
 	friend class Registry;
 
+	/* Prefabs hand out their own, prefab-local entities. */
+	friend class Prefab;
+
 public:
 	/**
 	 * Due to the way how entity component checking is implemented (via a bitmask),
@@ -86,6 +91,15 @@ public:
 	/** Number of currently-live entities (created but not yet destroyed). */
 	uint32_t GetCurrentEntities() const;
 
+	/** Number of indices handed out so far, live or recycled. Every entity index is below it. */
+	uint32_t GetIndexCount() const;
+
+	/** Heap memory held by the free list and the alive flags. */
+	MemoryUsage GetMemoryUsage() const;
+
+	/** Trims the alive flags to `GetIndexCount()` and gives back unused capacity. */
+	void ShrinkToFit();
+
 private:
 	/** Number of currently-live entities. */
 	uint32_t current_entities;
@@ -1,15 +1,19 @@
 #pragma once
+#include "Core/MemoryUsage.h"
 #include "Entity.h"
 #include <cstdint>
 #include <cstddef>
-#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 
 namespace Mupfel
 {
 
 /**
  * Type-erased interface every `ComponentArray<T>` implements, so `Registry` can hold a
- * heterogeneous `component_buffer` of them and operate on an entity without knowing `T`.
+ * heterogeneous component buffer of them and operate on an entity without knowing `T`.
  */
 class IComponentArray
 {
@@ -27,7 +31,41 @@ public:
 
 	virtual size_t ComponentID() const = 0;
 
-	/** Sentinel used by sparse-set implementations to mark "no component". */
-	static constexpr size_t invalid_entry = std::numeric_limits<size_t>::max();
+	/** The component type's name, for debug output (see `ComponentIndex::Name`). */
+	virtual std::string_view ComponentName() const = 0;
+
+	/** Heap memory held by the array: `used` for the stored components, `reserved` for its capacity. */
+	virtual MemoryUsage GetMemoryUsage() const = 0;
+
+	/** Gives back the memory the array reserved beyond what its current components need. */
+	virtual void ShrinkToFit() = 0;
+
+	/** A new, empty array of the same component type, e.g. for another registry. */
+	virtual std::unique_ptr<IComponentArray> CreateEmpty() const = 0;
+
+	/**
+	 * Copies the component of every `from[i]` that has one into `target`, an array of the same type, for
+	 * `to[i]`, in one bulk insert. `copied` is set to the `to` entities that got a component.
+	 */
+	virtual void CopyTo(IComponentArray& target, std::span<const Entity> from, std::span<const Entity> to,
+		std::vector<Entity>& copied) const = 0;
+
+	/**
+	 * Bulk copy for prefabs: appends all components of this array `copies` times to `target`, an array of
+	 * the same type. Copy `k` of the component of entity index `i` goes to `to[k * stride + i]`; none of
+	 * those entities may have a component in `target` yet.
+	 */
+	virtual void CloneTo(IComponentArray& target, std::span<const Entity> to, uint32_t copies,
+		uint32_t stride) const = 0;
+
+	/**
+	 * One step of putting the components back in entity index order: visits up to `indices` entity indices
+	 * and swaps their components into place, resuming where the last step stopped. Arrays given an order of
+	 * their own (`ComponentArray::Sort`/`Arrange`) are left as they are, even once an insert or removal broke
+	 * it: only their owner knows how to restore it, see `ComponentArray::OrderBroken`.
+	 *
+	 * @return True once the array is in order (or keeps its own), false while there is work left.
+	 */
+	virtual bool Defragment(uint32_t indices) = 0;
 };
 } // namespace Mupfel
\ No newline at end of file
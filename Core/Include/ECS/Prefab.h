@@ -0,0 +1,95 @@
+#pragma once
+#include "ComponentArray.h"
+#include "ECS/Components/ComponentIndex.h"
+#include "Entity.h"
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Mupfel
+{
+
+class Registry;
+
+/**
+ * A group of entities with their components that `Registry::Instantiate` copies into a registry, as many
+ * times as needed.
+ *
+ * A prefab is a compact blueprint rather than a registry: its entities are local to it and numbered
+ * 0 to `GetEntityCount() - 1`, and it stores one column per component type. Instantiating copies each
+ * column in one piece per copy and remaps the local entities to the new ones, instead of running
+ * `AddComponent` per entity and component.
+ *
+ * Build one either with `CreateEntity`/`AddComponent`, like a registry, or by capturing entities of an
+ * existing registry.
+ */
+class Prefab
+{
+	friend class Registry;
+
+public:
+	Prefab() = default;
+
+	/**
+	 * Captures \a entities of \a source with all their components; local entity `i` is `entities[i]`.
+	 * `Parent` and `Children` links are kept as far as they stay within \a entities.
+	 */
+	Prefab(Registry& source, std::span<const Entity> entities);
+
+	Prefab(Prefab&&) = default;
+	Prefab& operator=(Prefab&&) = default;
+
+	/** Adds an entity to the prefab; the returned entity is only valid for this prefab. */
+	Entity CreateEntity();
+
+	/** Adds \a component to the prefab entity \a e; an existing component of type `T` is overwritten. */
+	template <typename T> void AddComponent(Entity e, T component);
+
+	/** The number of entities one instantiation creates. */
+	uint32_t GetEntityCount() const;
+
+	/** The signature of the prefab entity \a e. */
+	Entity::Signature GetSignature(Entity e) const;
+
+private:
+	/** The column for component type `T`, created on first use. */
+	template <typename T> ComponentArray<T>& GetColumn();
+
+	/**
+	 * After a capture of \a sources: hierarchy links to captured entities now name the local ones, links
+	 * to anything else are cut.
+	 */
+	void Relink(std::span<const Entity> sources);
+
+private:
+	/** Per-local-entity signature; its size is the entity count. */
+	std::vector<Entity::Signature> signatures;
+	/** Per-component-type columns keyed by local entity, indexed by `ComponentIndex`; empty slots are null. */
+	std::vector<std::unique_ptr<IComponentArray>> columns;
+};
+
+template <typename T> inline void Prefab::AddComponent(Entity e, T component)
+{
+	assert(e.Index() < signatures.size() && "Entity does not belong to this prefab!");
+
+	GetColumn<T>().Insert(e, std::move(component));
+	signatures[e.Index()].set(ComponentIndex::Index<T>());
+}
+
+template <typename T> inline ComponentArray<T>& Prefab::GetColumn()
+{
+	const size_t id = ComponentIndex::Index<T>();
+	if (id >= columns.size())
+	{
+		columns.resize(id + 1);
+	}
+	if (!columns[id])
+	{
+		columns[id] = std::make_unique<ComponentArray<T>>(10);
+	}
+	return *static_cast<ComponentArray<T>*>(columns[id].get());
+}
+
+} // namespace Mupfel
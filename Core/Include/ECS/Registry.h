@@ -2,15 +2,19 @@
 #include "Core/EventSystem.h"
 #include "Entity.h"
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <concepts>
 #include <functional>
 #include <future>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <typeindex>
 #include <vector>
 
 #include "ComponentArray.h"
+#include "Core/MemoryUsage.h"
 #include "Core/Scene.h"
 #include "Core/ThreadPool.h"
 #include "ECS/Components/ComponentIndex.h"
@@ -23,12 +27,48 @@ template <typename FirstComponent, typename... Components> class View;
 class CollisionSystem;
 class Application;
 class MovementSystem;
+class Prefab;
 class RayCastSystem;
+class SceneSnapshot;
+class TransformSystem;
+
+/** Memory held by the storage of one component type, see `Registry::GetMemoryUsage`. */
+struct ComponentMemoryUsage
+{
+	std::string_view name;
+	size_t			 componentID = 0;
+	/** Number of components stored. */
+	uint32_t	count = 0;
+	MemoryUsage	memory;
+};
+
+/** Memory held by a `Registry`: per-entity bookkeeping plus one entry per component type in use, over all scenes. */
+struct RegistryMemoryUsage
+{
+	/** Signatures, entity scenes and the `EntityManager`'s free list and alive flags. */
+	MemoryUsage						  entities;
+	std::vector<ComponentMemoryUsage> components;
+
+	MemoryUsage Total() const
+	{
+		MemoryUsage total = entities;
+		for (const ComponentMemoryUsage& c : components)
+		{
+			total += c.memory;
+		}
+		return total;
+	}
+};
 
 /**
  * A Registry holds a complete ECS context. It provides methods to create / destroy
  * entities, add / remove components and means to iterate over entities based on a set
  * of components.
+ *
+ * Component storage is partitioned by scene: every scene has its own component arrays, and an entity's
+ * components live in the arrays of its scene. Views and `ParallelForEach` only walk the active scene's
+ * arrays, so entities of other scenes cost nothing to iterate, and switching scenes just switches the
+ * partition.
  */
 class Registry
 {
@@ -36,7 +76,10 @@ class Registry
 	friend class CollisionSystem;
 	friend class MovementSystem;
 	friend class Renderer;
+	friend class Prefab;
 	friend class RayCastSystem;
+	friend class SceneSnapshot;
+	friend class TransformSystem;
 
 public:
 	/** Helper type for a unique ptr for component arrays. */
@@ -52,12 +95,62 @@ public:
 	/** Create an entity. Additonally, a "EntityCreatedEvent" event is fired to notify everyone. */
 	Entity CreateEntity();
 
+	/**
+	 * Bulk variant of `CreateEntity` for level loads: creates `count` entities, growing the per-entity
+	 * storage once. `EntityCreatedEvent` listeners are called for every entity, but the events are not
+	 * queued, so they don't show up in `EventSystem::GetEvents` next frame.
+	 */
+	std::vector<Entity> CreateEntities(uint32_t count);
+
+	/** Like `CreateEntities(count)`, but creates the entities in \a scene instead of the active scene. */
+	std::vector<Entity> CreateEntities(uint32_t count, SceneHandle scene);
+
+	/**
+	 * Copies \a entities of \a source with all their components into \a scene of this registry. Every
+	 * component type is copied in one bulk insert; like `CreateEntities` and `AddComponents`, the listeners
+	 * are called but no events are queued. Used to move entities staged in a separate registry (see
+	 * `SceneStreamer`) into the live one. Entities that are dead in \a source are skipped: nothing is created
+	 * for them, and their place in the result holds the entity of index 0, which is never alive.
+	 *
+	 * Components are copied as they are, so the `Parent` and `Children` links of the copies still name
+	 * entities of \a source. The caller relinks them once everything linked is merged, which may take several
+	 * calls (see `SceneStreamer::Relink`).
+	 *
+	 * \return The new entities, in the order of \a entities.
+	 */
+	std::vector<Entity> Merge(Registry& source, std::span<const Entity> entities, SceneHandle scene);
+
+	/**
+	 * Creates \a count copies of \a prefab in the active scene: every component type is copied in one piece
+	 * per copy, and a single `PrefabInstantiatedEvent` is fired instead of the per-entity and per-component
+	 * events.
+	 *
+	 * \return The new entities, copy by copy: prefab entity `i` of copy `k` is at `k * GetEntityCount() + i`.
+	 */
+	std::vector<Entity> Instantiate(const Prefab& prefab, uint32_t count = 1);
+
+	/** Like `Instantiate(prefab, count)`, but creates the copies in \a scene instead of the active scene. */
+	std::vector<Entity> Instantiate(const Prefab& prefab, uint32_t count, SceneHandle scene);
+
 	/** Destroy an entity. Additonally, a "EntityDestroyedEvent" event is fired to notify everyone. */
 	void DestroyEntity(Entity e);
 
 	/** Return the number of current entities in the registry. */
 	uint32_t GetCurrentEntities() const;
 
+	/** Every alive entity of the active scene, in index order. */
+	std::vector<Entity> GetActiveSceneEntities() const;
+
+	/** Reports the heap memory used and reserved by the entity bookkeeping and every component array. */
+	RegistryMemoryUsage GetMemoryUsage() const;
+
+	/**
+	 * Gives back reserved memory no current entity needs: trims the per-entity vectors behind the highest
+	 * entity index handed out and shrinks every component array. Storage grows again on demand, so this
+	 * is meant for after a level load or a mass destroy, not for every frame.
+	 */
+	void ShrinkToFit();
+
 	/**
 	 * @warning Asserts `index` refers to an entity that was created via `CreateEntity`.
 	 * @return The signature (which components it has) of the entity at `index`.
@@ -66,10 +159,13 @@ public:
 
 	/**
 	 * @warning Asserts `index` refers to an entity that was created via `CreateEntity`.
-	 * @return The scene mask (which scenes it belongs to) of the entity at `index`.
+	 * @return The scene mask (which scenes it belongs to) of the entity at `index`; empty once it is destroyed.
 	 */
 	Scene::SceneMask GetSceneMask(Entity entity) const;
 
+	/** The scene \a entity belongs to, `Scene::INVALID_HANDLE` if it isn't alive in this registry. */
+	SceneHandle GetScene(Entity entity) const;
+
 	/**
 	 * Sets the scene that `CreateEntity` assigns new entities to and that `view()`/`ParallelForEach`
 	 * filter on. Pushed down by `Application` on every scene switch, so the ECS never has to ask the
@@ -103,6 +199,12 @@ public:
 	 */
 	template <typename T> void AddComponent(Entity e, T component);
 
+	/**
+	 * Bulk variant of `AddComponent`: adds `components[i]` to `entities[i]`. Like `CreateEntities`, it calls
+	 * the `ComponentAddedEvent` listeners but doesn't queue the events. Dead entities are skipped.
+	 */
+	template <typename T> void AddComponents(std::span<const Entity> entities, std::span<const T> components);
+
 	/** Fires `ComponentRemovedEvent`, removes `e`'s component of type `T`, and updates `e`'s signature. */
 	template <typename T> void RemoveComponent(Entity e);
 
@@ -115,6 +217,40 @@ public:
 	/** Whether `e` currently has a component of type `T`. */
 	template <typename T> bool HasComponent(Entity e);
 
+	/**
+	 * Sorts the active scene's `T` components with \a compare, a strict weak order on `T`, so views led by
+	 * `T` visit them in that order. `Defragment` leaves the order alone, even once an insert or removal broke
+	 * it: sort again when `IsOrderBroken<T>` says so, or `ReleaseOrder<T>` to go back to index order.
+	 */
+	template <typename T, typename Compare>
+		requires std::strict_weak_order<Compare&, const T&, const T&>
+	void Sort(Compare compare);
+
+	/**
+	 * Puts the active scene's `T` components in the order of its `U` components: those of entities with a
+	 * `U` come first, in `U`'s order, so `view<U, T>` walks both arrays front to back. `Defragment` leaves
+	 * the order alone, like after `Sort`.
+	 */
+	template <typename T, typename U> void SortLike();
+
+	/** Whether an insert or removal broke the order `Sort`/`SortLike` last gave the active scene's `T`s. */
+	template <typename T> bool IsOrderBroken();
+
+	/** Hands the active scene's `T` components back to `Defragment`, which restores index order. */
+	template <typename T> void ReleaseOrder();
+
+	/**
+	 * Spends about \a budget seconds putting the active scene's component arrays back in entity index order,
+	 * where removals scrambled it, so the arrays line up for views again. Picks up where the last call
+	 * stopped; meant to be called once per frame. At least `defragSlice` indices are visited per call.
+	 *
+	 * \return True once every array of the active scene is in order, or in one set by `Sort`/`SortLike`.
+	 */
+	bool Defragment(double budget);
+
+	/** Entity indices `Defragment` visits between two looks at the clock. */
+	static constexpr uint32_t defragSlice = 4096;
+
 	/** The combined `Entity::Signature` bit for each of `Components...`, for signature comparisons. */
 	template <typename... Components> static inline Entity::Signature ComponentSignature()
 	{
@@ -131,11 +267,20 @@ public:
 	}
 
 private:
-	/** Returns (creating on first use) the `ComponentArray<T>` for component type `T`. */
+	/** The component arrays of \a scene, indexed by `ComponentIndex`; null where a type was never used there. */
+	std::vector<SafeComponentArrayPtr>& SceneBuffer(SceneHandle scene);
+
+	/** `CreateEntities` without the listeners: hands out \a count entities in \a scene with empty signatures. */
+	std::vector<Entity> AllocateEntities(uint32_t count, SceneHandle scene);
+
+	/** Returns (creating on first use) the `ComponentArray<T>` of the active scene. */
 	template <typename T> ComponentArray<T>& GetComponentArray();
 
-	/** Grows `component_buffer` if needed so `T`'s slot (`ComponentIndex::Index<T>()`) is valid. */
-	template <typename T> void resizeComponentBuffer();
+	/** Returns (creating on first use) the `ComponentArray<T>` of \a scene. */
+	template <typename T> ComponentArray<T>& GetComponentArray(SceneHandle scene);
+
+	/** Grows `scene`'s component buffer if needed so `T`'s slot (`ComponentIndex::Index<T>()`) is valid. */
+	template <typename T> void resizeComponentBuffer(SceneHandle scene);
 
 private:
 	/** Where entity/component lifecycle events are fired. */
@@ -146,12 +291,14 @@ private:
 	EntityManager entity_manager;
 	/** Per-entity-index signature, resized alongside entities. */
 	std::vector<Entity::Signature> signatures;
-	/** Per-entity-index scene membership, resized alongside entities. */
-	std::vector<Scene::SceneMask> sceneMask;
-	/** Per-component-type storage, indexed by `ComponentIndex`. */
-	std::vector<SafeComponentArrayPtr> component_buffer;
+	/** Per-entity-index scene, `Scene::INVALID_HANDLE` for dead indices; resized alongside entities. */
+	std::vector<SceneHandle> entity_scenes;
+	/** Per-scene, per-component-type storage: `component_buffers[scene][ComponentIndex]`. */
+	std::array<std::vector<SafeComponentArrayPtr>, Scene::MAX_SCENES> component_buffers;
 	/** Scene new entities are created in and that views filter on; owned here, set by `Application`. */
 	SceneHandle active_scene = 0;
+	/** The `ComponentIndex` of the array `Defragment` works on. */
+	size_t defrag_cursor = 0;
 };
 
 template <typename... Components, typename F>
@@ -162,6 +309,7 @@ inline void Registry::ParallelForEach(F&& function)
 	const uint32_t num_threads = std::max<uint32_t>(1u, static_cast<uint32_t>(pool.GetThreadCount()));
 
 	using BaseComponent = std::tuple_element_t<0, std::tuple<Components...>>;
+	/* The active scene's partition: every entity in it belongs to the active scene. */
 	auto&		   array = GetComponentArray<BaseComponent>();
 	const auto&	   dense = array.dense;
 	const uint32_t total = static_cast<uint32_t>(dense.size());
@@ -178,7 +326,6 @@ inline void Registry::ParallelForEach(F&& function)
 	jobs.reserve(num_threads);
 
 	const Entity::Signature required = Registry::ComponentSignature<Components...>();
-	const Scene::SceneMask	required_scene = Registry::GetActiveSceneMask();
 
 	for (uint32_t t = 0; t < num_threads; t++)
 	{
@@ -191,16 +338,15 @@ inline void Registry::ParallelForEach(F&& function)
 		}
 
 		jobs.push_back(pool.Enqueue(
-			[this, begin, end, function, &dense, required, required_scene, arrays]() mutable -> void
+			[this, begin, end, function, &dense, required, arrays]() mutable -> void
 			{
 				for (size_t i = begin; i < end; ++i)
 				{
-					Entity				   e{dense[i]};
-					const auto&			   sig = GetSignature(e);
-					const Scene::SceneMask scene_mask = GetSceneMask(e);
+					Entity		e{dense[i]};
+					const auto& sig = GetSignature(e);
 
 					/* check if the entity has all the needed components */
-					if (((sig & required) != required) || ((scene_mask & required_scene) != required_scene))
+					if ((sig & required) != required)
 						continue;
 
 					/* Call given function on the entity */
@@ -249,7 +395,7 @@ template <typename T> inline void Registry::AddComponent(Entity e, T component)
 		return;
 	}
 
-	ComponentArray<T>& storage = GetComponentArray<T>();
+	ComponentArray<T>& storage = GetComponentArray<T>(entity_scenes[e.Index()]);
 	storage.Insert(e, std::move(component));
 
 	/* Update the Entity Signature */
@@ -260,6 +406,58 @@ template <typename T> inline void Registry::AddComponent(Entity e, T component)
 	evt_system.AddImmediateEvent<ComponentAddedEvent>({e, signatures[e.Index()], id});
 }
 
+template <typename T>
+inline void Registry::AddComponents(std::span<const Entity> entities, std::span<const T> components)
+{
+	assert(entities.size() == components.size() && "Every entity needs exactly one component!");
+
+	/* Do not add components to dead entities! The common case, a fresh load, takes the span as it is. */
+	std::vector<Entity> alive_entities;
+	std::vector<T>		alive_components;
+	if (!std::ranges::all_of(entities, [this](Entity e) { return entity_manager.IsAlive(e); }))
+	{
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			if (entity_manager.IsAlive(entities[i]))
+			{
+				alive_entities.push_back(entities[i]);
+				alive_components.push_back(components[i]);
+			}
+		}
+		entities = alive_entities;
+		components = alive_components;
+	}
+
+	/* Every component goes to the partition of its entity's scene; a level load is a single run. */
+	for (size_t begin = 0; begin < entities.size();)
+	{
+		const SceneHandle scene = entity_scenes[entities[begin].Index()];
+		size_t			  end = begin + 1;
+		while (end < entities.size() && entity_scenes[entities[end].Index()] == scene)
+		{
+			end++;
+		}
+		GetComponentArray<T>(scene).InsertBulk(entities.subspan(begin, end - begin),
+			components.subspan(begin, end - begin));
+		begin = end;
+	}
+
+	/* Update the Entity Signatures */
+	const uint32_t id = static_cast<uint32_t>(ComponentIndex::Index<T>());
+	for (const Entity e : entities)
+	{
+		signatures[e.Index()].set(id);
+	}
+
+	if (evt_system.HasListeners<ComponentAddedEvent>())
+	{
+		for (const Entity e : entities)
+		{
+			evt_system.NotifyListeners<ComponentAddedEvent>({e, signatures[e.Index()], id});
+		}
+	}
+}
+
 template <typename T> inline void Registry::RemoveComponent(Entity e)
 {
 	/* Check if the entity has the component. */
@@ -268,7 +466,7 @@ template <typename T> inline void Registry::RemoveComponent(Entity e)
 		return;
 	}
 
-	ComponentArray<T>& storage = GetComponentArray<T>();
+	ComponentArray<T>& storage = GetComponentArray<T>(entity_scenes[e.Index()]);
 	size_t			   id = ComponentIndex::Index<T>();
 	/* Send a ComponentRemoved Event */
 	evt_system.AddImmediateEvent<ComponentRemovedEvent>({e, signatures[e.Index()], id});
@@ -279,35 +477,77 @@ template <typename T> inline void Registry::RemoveComponent(Entity e)
 	signatures[e.Index()].reset(id);
 }
 
-template <typename T> inline T& Registry::GetComponent(Entity e) { return GetComponentArray<T>().Get(e); }
+template <typename T, typename Compare>
+	requires std::strict_weak_order<Compare&, const T&, const T&>
+inline void Registry::Sort(Compare compare)
+{
+	GetComponentArray<T>().Sort(std::move(compare));
+}
+
+template <typename T, typename U> inline void Registry::SortLike()
+{
+	const std::vector<uint32_t>& leader = GetComponentArray<U>().dense;
+
+	std::vector<Entity> order;
+	order.reserve(leader.size());
+	for (const uint32_t index : leader)
+	{
+		order.push_back(Entity(index));
+	}
+	GetComponentArray<T>().Arrange(order);
+}
+
+template <typename T> inline bool Registry::IsOrderBroken() { return GetComponentArray<T>().OrderBroken(); }
+
+template <typename T> inline void Registry::ReleaseOrder() { GetComponentArray<T>().ReleaseOrder(); }
 
-template <typename T> inline void Registry::SetComponent(Entity e, T comp) { GetComponentArray<T>().Set(e, comp); }
+template <typename T> inline T& Registry::GetComponent(Entity e)
+{
+	return GetComponentArray<T>(entity_scenes[e.Index()]).Get(e);
+}
 
-template <typename T> inline bool Registry::HasComponent(Entity e) { return GetComponentArray<T>().Has(e); }
+template <typename T> inline void Registry::SetComponent(Entity e, T comp)
+{
+	GetComponentArray<T>(entity_scenes[e.Index()]).Set(e, comp);
+}
+
+template <typename T> inline bool Registry::HasComponent(Entity e)
+{
+	const SceneHandle scene = GetScene(e);
+	return (scene != Scene::INVALID_HANDLE) && GetComponentArray<T>(scene).Has(e);
+}
 
 template <typename T> inline ComponentArray<T>& Registry::GetComponentArray()
 {
+	return GetComponentArray<T>(active_scene);
+}
+
+template <typename T> inline ComponentArray<T>& Registry::GetComponentArray(SceneHandle scene)
+{
+	assert((scene < Scene::MAX_SCENES) && "Scene handle out of range!");
+
 	size_t comp_index = ComponentIndex::Index<T>();
 
-	resizeComponentBuffer<T>();
+	resizeComponentBuffer<T>(scene);
 
 	/* Create a new Component Array for the given Type if there is none */
-	if (!component_buffer[comp_index])
+	std::vector<SafeComponentArrayPtr>& buffer = component_buffers[scene];
+	if (!buffer[comp_index])
 	{
 		SafeComponentArrayPtr new_array = std::make_unique<ComponentArray<T>>(10);
-		component_buffer[comp_index] = std::move(new_array);
+		buffer[comp_index] = std::move(new_array);
 	}
 
-	return *static_cast<ComponentArray<T>*>(component_buffer[comp_index].get());
+	return *static_cast<ComponentArray<T>*>(buffer[comp_index].get());
 }
 
-template <typename T> inline void Registry::resizeComponentBuffer()
+template <typename T> inline void Registry::resizeComponentBuffer(SceneHandle scene)
 {
 	size_t comp_index = ComponentIndex::Index<T>();
 
-	if (comp_index >= component_buffer.size())
+	if (comp_index >= component_buffers[scene].size())
 	{
-		component_buffer.resize(comp_index + 1);
+		component_buffers[scene].resize(comp_index + 1);
 	}
 }
 
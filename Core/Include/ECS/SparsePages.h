@@ -0,0 +1,108 @@
+#pragma once
+#include "Core/MemoryUsage.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * The sparse half of a sparse set: maps an entity index to a 32-bit slot, in fixed-size pages that are
+ * only allocated once an index in their range is set.
+ *
+ * A flat table costs one entry per entity index up to the highest one stored, however few entities are
+ * stored. Paged, a component held by 50 entities spread over a 1M-entity world costs at most 50 pages
+ * plus the page table (8 bytes per `pageSize` indices). Lookups stay O(1): one load for the page, one
+ * for the slot. Pages are not freed when their last slot is reset, only by `ShrinkToFit`, so an
+ * index toggling in and out of a page doesn't reallocate it every time.
+ */
+class SparsePages
+{
+public:
+	/** Marks "no slot" in a page. */
+	static constexpr uint32_t invalid_slot = std::numeric_limits<uint32_t>::max();
+
+	/** Slots per page; 4 KiB pages. */
+	static constexpr uint32_t pageSize = 1024;
+
+	/** The slot stored for `index`, or `invalid_slot`. */
+	uint32_t Find(uint32_t index) const
+	{
+		const size_t page = index / pageSize;
+		return (page < pages.size() && pages[page]) ? pages[page][index % pageSize] : invalid_slot;
+	}
+
+	bool Contains(uint32_t index) const { return Find(index) != invalid_slot; }
+
+	/** One past the last index the page table covers: every stored index is below it. */
+	uint32_t Extent() const { return static_cast<uint32_t>(pages.size()) * pageSize; }
+
+	/** The slot stored for `index`. @warning Undefined unless `Contains(index)`. */
+	uint32_t Get(uint32_t index) const { return pages[index / pageSize][index % pageSize]; }
+
+	/** Stores `slot` for `index`, allocating its page if needed. */
+	void Set(uint32_t index, uint32_t slot)
+	{
+		const size_t page = index / pageSize;
+		if (page >= pages.size())
+		{
+			pages.resize(page + 1);
+		}
+		if (!pages[page])
+		{
+			pages[page] = std::make_unique_for_overwrite<uint32_t[]>(pageSize);
+			std::fill_n(pages[page].get(), pageSize, invalid_slot);
+			allocated++;
+		}
+		pages[page][index % pageSize] = slot;
+	}
+
+	/** Removes the slot of `index`, if any. Keeps the page. */
+	void Reset(uint32_t index)
+	{
+		const size_t page = index / pageSize;
+		if (page < pages.size() && pages[page])
+		{
+			pages[page][index % pageSize] = invalid_slot;
+		}
+	}
+
+	/** The allocated pages count as used; the page table as used up to its size. */
+	MemoryUsage GetMemoryUsage() const
+	{
+		const size_t page_bytes = allocated * pageSize * sizeof(uint32_t);
+		MemoryUsage	 table = MemoryUsage::Of(pages);
+		return {table.used + page_bytes, table.reserved + page_bytes};
+	}
+
+	/** Frees pages without a slot and trims the page table behind the last allocated page. */
+	void ShrinkToFit()
+	{
+		for (std::unique_ptr<uint32_t[]>& page : pages)
+		{
+			if (page && std::all_of(page.get(), page.get() + pageSize, [](uint32_t s) { return s == invalid_slot; }))
+			{
+				page.reset();
+				allocated--;
+			}
+		}
+
+		while (!pages.empty() && !pages.back())
+		{
+			pages.pop_back();
+		}
+		pages.shrink_to_fit();
+	}
+
+private:
+	/** Page `i` holds the slots of indices [i * pageSize, (i + 1) * pageSize); null until first used. */
+	std::vector<std::unique_ptr<uint32_t[]>> pages;
+	/** Number of non-null pages. */
+	size_t allocated = 0;
+};
+
+} // namespace Mupfel
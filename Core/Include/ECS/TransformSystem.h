@@ -0,0 +1,111 @@
+#pragma once
+#include "Core/EventSystem.h"
+#include "Core/Scene.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Hierarchy.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Entity.h"
+#include "ECS/Registry.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Computes the `WorldTransform` of every entity in a hierarchy of the active scene.
+ *
+ * An entity with a `Parent` is a node, and so is every entity some node names as its parent; nodes without a
+ * parent of their own are the roots. The hierarchy is flattened breadth-first into `order`, so every level is
+ * a contiguous run and every parent comes before its children, and the `Transform` and `WorldTransform`
+ * arrays are arranged in that order too. `Update` then walks the levels front to back, each one split across
+ * the thread pool once it is large enough: the nodes of one level only read the level above.
+ *
+ * A node is recomputed only if its `Transform` changed since the last `Update`, or its parent was
+ * recomputed; the flattening is redone only when a `Parent` is added or removed, a node is destroyed, a
+ * prefab with hierarchy links is instantiated, or the active scene changes. `Registry::Defragment` leaves the
+ * arrangement alone; when other entities' inserts and removals break it, `Update` arranges the arrays again.
+ *
+ * Keep the links consistent with `Attach`/`Detach` rather than adding `Parent` yourself: they keep the
+ * `Children` of the parent in sync, refuse cycles, and let a destroyed parent leave roots behind rather
+ * than stale links.
+ */
+class TransformSystem
+{
+public:
+	/** Levels with fewer nodes than this are computed on the calling thread. */
+	static constexpr uint32_t parallelThreshold = 4096;
+
+	TransformSystem(Registry& in_registry, EventSystem& in_evt_system, ThreadPool& in_pool);
+
+	/** Registers the listeners that flag structural changes; the system must outlive them being called. */
+	void Init();
+
+	/** Brings every `WorldTransform` of the active scene up to date. */
+	void Update();
+
+	/** Recomputes every node in the next `Update`, dirty or not. */
+	void Invalidate();
+
+	/** The number of nodes of the last flattening. */
+	uint32_t GetNodeCount() const;
+
+	/** The number of levels of the last flattening; a lone root is depth 1. */
+	uint32_t GetDepth() const;
+
+	/** The number of nodes the last `Update` recomputed. */
+	uint32_t GetUpdatedNodes() const;
+
+	/**
+	 * Attaches \a child to \a parent, detaching it from its current parent first.
+	 *
+	 * \return False, and nothing changes, if either is dead, they are in different scenes, or \a child is
+	 *         \a parent or one of its ancestors.
+	 */
+	static bool Attach(Registry& registry, Entity child, Entity parent);
+
+	/** Makes \a child a root again; a no-op if it has no parent. */
+	static void Detach(Registry& registry, Entity child);
+
+private:
+	/** Flattens the hierarchy of the active scene breadth-first; every node gets a `WorldTransform`. */
+	void Rebuild();
+
+	/** Computes the nodes `[begin, end)` of `order`, all on the same level; returns how many were dirty. */
+	uint32_t UpdateRange(uint32_t begin, uint32_t end);
+
+	/** The `WorldTransform` of the node at \a slot of `order`. */
+	WorldTransform& WorldAt(uint32_t slot);
+
+private:
+	static constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+	Registry&	 registry;
+	EventSystem& evt_system;
+	ThreadPool&	 pool;
+
+	/** Set by the listeners: the hierarchy has to be flattened again. */
+	bool		structure_dirty = true;
+	/** Every node is recomputed in the next `Update`. */
+	bool		force = true;
+	SceneHandle built_scene = Scene::INVALID_HANDLE;
+
+	/** Every node, level by level. */
+	std::vector<Entity> order;
+	/** Per node, the position of its parent in `order`, `noParent` for roots. */
+	std::vector<uint32_t> parents;
+	/** Level `l` is `order[level_begin[l], level_begin[l + 1])`. */
+	std::vector<uint32_t> level_begin;
+	/** Per node, its `Transform` as of the last time it was computed. */
+	std::vector<Transform> cache;
+	/** Per node, whether it was recomputed in this `Update`; bytes, as levels are written concurrently. */
+	std::vector<uint8_t> dirty;
+	uint32_t			 updated = 0;
+
+	/** The active scene's arrays, looked up once per `Update`. */
+	ComponentArray<Transform>*		locals = nullptr;
+	ComponentArray<WorldTransform>* worlds = nullptr;
+};
+
+} // namespace Mupfel
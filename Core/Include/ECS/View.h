@@ -16,6 +16,9 @@ namespace Mupfel
  * components. In the current implementation, the view internally iterates over
  * entities which have the FirstComponent and check if the other components are
  * present for that entity.
+ *
+ * Only the component arrays of the active scene are iterated (see `Registry`), so
+ * entities of other scenes are never visited.
  */
 template <typename FirstComponent, typename... Components>
 class View : public std::ranges::view_interface<View<FirstComponent, Components...>>
@@ -103,7 +106,6 @@ public:
 	 */
 	explicit View(Registry& in_reg)
 		: reg(&in_reg), required_signature(Registry::ComponentSignature<FirstComponent, Components...>()),
-		  required_scene(in_reg.GetActiveSceneMask()),
 		  base_component_array(&in_reg.GetComponentArray<FirstComponent>()),
 		  component_arrays(&in_reg.GetComponentArray<Components>()...)
 
@@ -120,11 +122,11 @@ public:
 
 private:
 	/**
-	 * Predicate stating whether or not the given entity has the wanted components AND
-	 * is part of the current scene.
+	 * Predicate stating whether or not the given entity has the wanted components. It
+	 * comes from the active scene's arrays, so it is part of the current scene.
 	 * 
 	 * \param e The entity to check.
-	 * \return True if the entity is part of the current scene AND has the wanted components, FALSE otherwise.
+	 * \return True if the entity has the wanted components, FALSE otherwise.
 	 */
 	bool Matches(Entity e) const;
 private:
@@ -132,8 +134,6 @@ private:
 	Registry* reg = nullptr;
 	/** Combined signature mask. */
 	Entity::Signature required_signature{};
-	/**  Scene mask. */
-	Scene::SceneMask						   required_scene{};
 	/**
 	 * The component array of the first provided component type.
 	 * Currently, this component array is iterated and the contained entities
@@ -148,11 +148,10 @@ private:
 template <typename FirstComponent, typename... Components>
 inline bool View<FirstComponent, Components...>::Matches(Entity e) const
 {
-	/* retrieve scene and signature from the entity. */
+	/* retrieve the signature from the entity. */
 	const Entity::Signature sig = reg->GetSignature(e);
-	const Scene::SceneMask	scene = reg->GetSceneMask(e);
 
-	return ((sig & required_signature) == required_signature) && ((scene & required_scene) == required_scene);
+	return (sig & required_signature) == required_signature;
 }
 
 } // namespace Mupfel
\ No newline at end of file
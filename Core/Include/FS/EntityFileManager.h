@@ -1,28 +1,32 @@
 #pragma once
 
 #include "FileManager.h"
-#include "ECS/Entity.h"
-#include <string>
-#include <unordered_map>
-#include "json.hpp"
+#include "EntityStreamLoader.h"
+#include <initializer_list>
+#include <string_view>
 
 namespace Mupfel {
 
 	class EntityFileManager : public FileManager
 	{
 	public:
-		typedef void (*ComponentLoader)(Entity e, nlohmann::json source);
-	public:
+		/**
+		 * Loads an entity file into the current registry, streaming it through `EntityStreamLoader`, or a
+		 * binary `SceneSnapshot` if \a file has the `.msnap` extension.
+		 */
 		virtual Handle Load(std::filesystem::path file) override;
+		/** Writes the active scene as a `SceneSnapshot` next to the handle's file, with the `.msnap` extension. */
 		virtual void Store(const Handle& handle) override;
-		virtual bool RegisterComponentLoader(std::string loader_name, ComponentLoader loader);
-	private:
-		static void LoadTransform(Entity e, nlohmann::json source);
-		static void LoadMovement(Entity e, nlohmann::json source);
-		static void LoadCollider(Entity e, nlohmann::json source);
+		/** Writes the active scene back to the handle's file as an entity file, see `EntityStreamLoader::Store`. */
+		void StoreEntityFile(const Handle& handle);
+		/** Makes components called \a name load as `T`, see `EntityStreamLoader::RegisterComponent`. */
+		template <typename T>
+		void RegisterComponent(std::string_view name, std::initializer_list<ComponentField<T>> fields)
+		{
+			loader.RegisterComponent<T>(name, fields);
+		}
 	private:
-		std::unordered_map<std::string, ComponentLoader> loaders;
+		EntityStreamLoader loader;
 	};
 
 }
-
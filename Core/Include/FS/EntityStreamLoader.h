@@ -0,0 +1,235 @@
+#pragma once
+#include "Core/Error.h"
+#include "ECS/Components/ComponentReflection.h"
+#include "ECS/Entity.h"
+#include "ECS/Registry.h"
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Loads and stores entity files, the JSON format `EntityFileManager` reads:
+ *
+ *     [ { "components": [ { "name": "Transform", "pos_x": 1.0, ... }, ... ] }, ... ]
+ *
+ * The file is parsed with nlohmann's SAX interface, so no document is ever built: every component is
+ * written straight into a typed staging column, and every `batchSize` entities the batch goes into the
+ * registry with `Registry::CreateEntities` and one `Registry::AddComponents` per component type. Memory
+ * use is bounded by the batch, not by the file.
+ *
+ * Component names are resolved once per component to a registered type; components of unregistered
+ * types and unknown fields are skipped. The engine's own components are registered by the constructor,
+ * from their `ComponentReflection`.
+ */
+class EntityStreamLoader
+{
+public:
+	/** Entities are created, and their components added, this many at a time. */
+	static constexpr uint32_t batchSize = 4096;
+
+	EntityStreamLoader();
+	~EntityStreamLoader();
+
+	/**
+	 * Makes components called \a name load and store as `T`, with \a fields. Registering a name a second time
+	 * replaces its fields.
+	 */
+	template <typename T> void RegisterComponent(std::string_view name, std::span<const ComponentField<T>> fields);
+
+	template <typename T>
+	void RegisterComponent(std::string_view name, std::initializer_list<ComponentField<T>> fields)
+	{
+		RegisterComponent<T>(name, std::span(fields.begin(), fields.size()));
+	}
+
+	/** Registers `T` under the name and with the fields of its `ComponentReflection`. */
+	template <ReflectedComponent T> void RegisterComponent();
+
+	/**
+	 * Loads every entity in \a file into \a registry.
+	 *
+	 * \return The number of entities created, `Error::FILE_NOT_FOUND` if \a file can't be opened, or
+	 * `Error::INVALID_FORMAT` if it isn't an entity file. Entities of batches finished before the error
+	 * stay in the registry.
+	 */
+	[[nodiscard]] Expected<uint32_t> Load(Registry& registry, const std::filesystem::path& file);
+
+	/** Like the file overload, reading from \a stream. */
+	[[nodiscard]] Expected<uint32_t> Load(Registry& registry, std::istream& stream);
+
+	/** Like the file overload, reading from \a bytes, e.g. a resource pack entry. */
+	[[nodiscard]] Expected<uint32_t> Load(Registry& registry, std::span<const std::byte> bytes);
+
+	/**
+	 * Writes every entity of \a registry's active scene to \a file, with the registered fields of its
+	 * components of registered types; what `Load` reads back.
+	 *
+	 * \return The number of entities written, or `Error::FILE_NOT_FOUND` if \a file can't be written.
+	 */
+	[[nodiscard]] Expected<uint32_t> Store(Registry& registry, const std::filesystem::path& file);
+
+	/** Like the file overload, writing to \a stream. */
+	[[nodiscard]] Expected<uint32_t> Store(Registry& registry, std::ostream& stream);
+
+private:
+	/** The components of one type in the current batch. */
+	class Column
+	{
+	public:
+		explicit Column(std::string in_name) : name(std::move(in_name)) {}
+		virtual ~Column() = default;
+
+		/** Starts a default-constructed component for the batch's entity \a ordinal. */
+		virtual void Begin(uint32_t ordinal) = 0;
+		/** Sets field \a key of the last component begun; false if the type has no such field. */
+		virtual bool Set(std::string_view key, double value) = 0;
+		/** Adds the batch's components to their entities in \a created, then empties the column. */
+		virtual void Flush(Registry& registry, std::span<const Entity> created) = 0;
+		/** Drops the batch's components. */
+		virtual void Clear() = 0;
+		/** Appends the JSON object of \a e's component to \a out; false if \a e has none. */
+		virtual bool Write(Registry& registry, Entity e, std::string& out) = 0;
+
+		const std::string name;
+	};
+
+	template <typename T> class TypedColumn;
+
+	/** The SAX handler; see EntityStreamLoader.cpp. */
+	class Handler;
+
+	/** Runs the SAX parser over \a input, which is anything `nlohmann::json::sax_parse` takes. */
+	template <typename... Input> Expected<uint32_t> Parse(Registry& registry, Input&&... input);
+
+	Column* FindColumn(std::string_view name) const;
+
+private:
+	std::vector<std::unique_ptr<Column>> columns;
+};
+
+template <typename T> class EntityStreamLoader::TypedColumn : public EntityStreamLoader::Column
+{
+public:
+	TypedColumn(std::string in_name, std::span<const ComponentField<T>> in_fields)
+		: Column(std::move(in_name)), fields(in_fields.begin(), in_fields.end())
+	{
+	}
+
+	void Begin(uint32_t ordinal) final
+	{
+		ordinals.push_back(ordinal);
+		components.emplace_back();
+	}
+
+	bool Set(std::string_view key, double value) final
+	{
+		for (const ComponentField<T>& field : fields)
+		{
+			if (field.key == key)
+			{
+				field.Set(components.back(), value);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Flush(Registry& registry, std::span<const Entity> created) final
+	{
+		owners.clear();
+		for (const uint32_t ordinal : ordinals)
+		{
+			owners.push_back(created[ordinal]);
+		}
+		registry.AddComponents<T>(owners, components);
+		Clear();
+	}
+
+	void Clear() final
+	{
+		ordinals.clear();
+		components.clear();
+	}
+
+	bool Write(Registry& registry, Entity e, std::string& out) final
+	{
+		if (!registry.HasComponent<T>(e))
+		{
+			return false;
+		}
+
+		const T& component = registry.GetComponent<T>(e);
+		std::format_to(std::back_inserter(out), "{{\"name\": \"{}\"", name);
+		for (const ComponentField<T>& field : fields)
+		{
+			std::format_to(std::back_inserter(out), ", \"{}\": ", field.key);
+			std::visit([&](auto member) { Append(out, component.*member); }, field.member);
+		}
+		out += '}';
+		return true;
+	}
+
+private:
+	/** Shortest representation that reads back to the same value; JSON has no NaN or infinity. */
+	static void Append(std::string& out, float value)
+	{
+		if (std::isfinite(value))
+		{
+			std::format_to(std::back_inserter(out), "{}", value);
+		}
+		else
+		{
+			out += "null";
+		}
+	}
+
+	static void Append(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+	static void Append(std::string& out, std::integral auto value)
+	{
+		std::format_to(std::back_inserter(out), "{}", value);
+	}
+
+	std::vector<ComponentField<T>> fields;
+	std::vector<uint32_t>		   ordinals;
+	std::vector<T>				   components;
+	/** Reused by `Flush`. */
+	std::vector<Entity> owners;
+};
+
+template <typename T>
+inline void EntityStreamLoader::RegisterComponent(std::string_view name, std::span<const ComponentField<T>> fields)
+{
+	auto column = std::make_unique<TypedColumn<T>>(std::string(name), fields);
+	for (std::unique_ptr<Column>& existing : columns)
+	{
+		if (existing->name == name)
+		{
+			existing = std::move(column);
+			return;
+		}
+	}
+	columns.push_back(std::move(column));
+}
+
+template <ReflectedComponent T> inline void EntityStreamLoader::RegisterComponent()
+{
+	RegisterComponent<T>(ComponentReflection<T>::name, FieldsOf<T>());
+}
+
+} // namespace Mupfel
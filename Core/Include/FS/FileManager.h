@@ -1,6 +1,7 @@
 #pragma once
 #include <filesystem>
 #include <cstdint>
+#include <utility>
 
 namespace Mupfel
 {
@@ -9,7 +10,13 @@ namespace Mupfel
 	{
 	public:
 		class Handle {
-			uint64_t id;
+		public:
+			Handle() = default;
+			explicit Handle(std::filesystem::path file) : file(std::move(file)) {}
+			/** The file this handle was loaded from. */
+			const std::filesystem::path& GetFile() const { return file; }
+		private:
+			uint64_t id = 0;
 			std::filesystem::path file;
 		};
 	public:
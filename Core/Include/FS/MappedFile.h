@@ -0,0 +1,43 @@
+#pragma once
+#include "Core/Error.h"
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Mupfel
+{
+
+/**
+ * A read-only memory mapping of a whole file. The pages are only read from disk when touched, and
+ * stay in the OS page cache across loads, so mapping a file that was read recently costs next to
+ * nothing. Move-only; the mapping lives as long as the object.
+ */
+class MappedFile
+{
+public:
+	/** Maps \a file; `Error::FILE_NOT_FOUND` if it can't be opened or mapped. */
+	[[nodiscard]] static Expected<MappedFile> Open(const std::filesystem::path& file);
+
+	MappedFile() = default;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	/** The file's bytes; empty for an empty file. */
+	std::span<const std::byte> Data() const { return {data, size}; }
+
+private:
+	void Close();
+
+private:
+	const std::byte* data = nullptr;
+	size_t			 size = 0;
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping_handle = nullptr;
+#endif
+};
+
+} // namespace Mupfel
@@ -0,0 +1,192 @@
+#pragma once
+#include "Core/Error.h"
+#include "ECS/Components/ComponentReflection.h"
+#include "ECS/Entity.h"
+#include "ECS/Registry.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Binary scene snapshots: every entity of the active scene with its components, stored column by
+ * column so a load is a handful of bulk copies instead of one parse and one `AddComponent` per
+ * component.
+ *
+ * File layout (host byte order, every offset 16-byte aligned):
+ *
+ *     SnapshotHeader
+ *     SnapshotColumn[columnCount]
+ *     per column: uint32_t entity[count]  -- position of the owning entity in the snapshot
+ *                 T        data[count]    -- the components, byte for byte
+ *
+ * A column is identified by its component name and carries its own version and element size. A
+ * column this build doesn't know, or knows in another version, is skipped on load; bump a column's
+ * version whenever the layout of its component changes. Only trivially copyable components can be
+ * stored, and they are stored as they are: a column is written with one copy per run of stored
+ * components in the dense array, a single one when the whole array is stored. `RegisterColumn` them
+ * once; the engine's own components are registered already, from their `ComponentReflection`.
+ */
+class SceneSnapshot
+{
+public:
+	static constexpr char	  magic[8] = {'M', 'U', 'P', 'F', 'S', 'N', 'A', 'P'};
+	static constexpr uint32_t formatVersion = 1;
+
+	struct SnapshotHeader
+	{
+		char	 magic[8];
+		uint32_t version;
+		uint32_t columnCount;
+		uint32_t entityCount;
+		uint32_t reserved;
+	};
+
+	struct SnapshotColumn
+	{
+		char	 name[32];
+		uint32_t version;
+		uint32_t elementSize;
+		uint32_t count;
+		uint32_t reserved;
+		/** Offsets from the start of the file. */
+		uint64_t entityOffset;
+		uint64_t dataOffset;
+	};
+
+	/**
+	 * Writes every entity of \a registry's active scene, and its components of all registered column
+	 * types, to \a file. Components of other types are left out.
+	 *
+	 * \return The number of entities written, or `Error::FILE_NOT_FOUND` if \a file can't be written.
+	 */
+	[[nodiscard]] static Expected<uint32_t> Store(Registry& registry, const std::filesystem::path& file);
+
+	/**
+	 * Memory-maps \a file and recreates its entities in \a registry's active scene, in the order they
+	 * were stored. Uses `Registry::CreateEntities` and `Registry::AddComponents`, so listeners are
+	 * called but no per-entity events are queued.
+	 *
+	 * \return The created entities, `Error::FILE_NOT_FOUND` if \a file can't be opened, or
+	 * `Error::INVALID_FORMAT` if it isn't a snapshot of this format version or is truncated.
+	 */
+	[[nodiscard]] static Expected<std::vector<Entity>> Load(Registry& registry, const std::filesystem::path& file);
+
+	/** Like the file overload, but reads from \a bytes, which must be 16-byte aligned. */
+	[[nodiscard]] static Expected<std::vector<Entity>> Load(Registry& registry, std::span<const std::byte> bytes);
+
+	/**
+	 * Makes component type `T` storable under \a name (at most 31 characters). Registering a name a
+	 * second time replaces its entry, e.g. to bump the version.
+	 */
+	template <typename T>
+		requires std::is_trivially_copyable_v<T>
+	static void RegisterColumn(std::string_view name, uint32_t version);
+
+	/** Registers `T` under the name and version of its `ComponentReflection`. */
+	template <ReflectedComponent T>
+		requires std::is_trivially_copyable_v<T>
+	static void RegisterColumn();
+
+private:
+	/** Marks entities that are not part of the snapshot in the index -> ordinal table. */
+	static constexpr uint32_t noOrdinal = std::numeric_limits<uint32_t>::max();
+
+	/** Type-erased access to one column type, instantiated by RegisterColumn. */
+	struct ColumnType
+	{
+		std::string name;
+		uint32_t	version = 0;
+		uint32_t	elementSize = 0;
+		size_t		componentID = 0;
+		/** Appends the ordinals and bytes of every component whose entity has an ordinal; returns the count. */
+		uint32_t (*write)(Registry& registry, const std::vector<uint32_t>& ordinals, std::vector<uint32_t>& entities,
+			std::vector<std::byte>& data) = nullptr;
+		/** Bulk-adds `entities.size()` components read from `data`. */
+		void (*load)(Registry& registry, std::span<const Entity> entities, const std::byte* data) = nullptr;
+	};
+
+	static std::vector<ColumnType>& ColumnTypes();
+
+	static void Register(ColumnType type);
+
+	template <typename T>
+	static uint32_t WriteColumn(Registry& registry, const std::vector<uint32_t>& ordinals,
+		std::vector<uint32_t>& entities, std::vector<std::byte>& data);
+
+	template <typename T>
+	static void LoadColumn(Registry& registry, std::span<const Entity> entities, const std::byte* data);
+};
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T>
+inline void SceneSnapshot::RegisterColumn(std::string_view name, uint32_t version)
+{
+	Register({
+		.name = std::string(name),
+		.version = version,
+		.elementSize = sizeof(T),
+		.componentID = ComponentIndex::Index<T>(),
+		.write = &SceneSnapshot::WriteColumn<T>,
+		.load = &SceneSnapshot::LoadColumn<T>,
+	});
+}
+
+template <ReflectedComponent T>
+	requires std::is_trivially_copyable_v<T>
+inline void SceneSnapshot::RegisterColumn()
+{
+	RegisterColumn<T>(ComponentReflection<T>::name, ComponentReflection<T>::version);
+}
+
+template <typename T>
+inline uint32_t SceneSnapshot::WriteColumn(Registry& registry, const std::vector<uint32_t>& ordinals,
+	std::vector<uint32_t>& entities, std::vector<std::byte>& data)
+{
+	ComponentArray<T>&		  array = registry.GetComponentArray<T>();
+	std::span<const uint32_t> dense = array.GetDense();
+	std::span<const T>		  components = array.GetComponents();
+
+	auto ordinal_of = [&](uint32_t index) { return (index < ordinals.size()) ? ordinals[index] : noOrdinal; };
+
+	uint32_t count = 0;
+	size_t	 begin = 0;
+	while (begin < dense.size())
+	{
+		/* Every run of stored components is copied at once; the active scene's array is a single run. */
+		size_t end = begin;
+		for (; end < dense.size() && ordinal_of(dense[end]) != noOrdinal; end++)
+		{
+			entities.push_back(ordinal_of(dense[end]));
+		}
+
+		if (end > begin)
+		{
+			const size_t at = data.size();
+			data.resize(at + (end - begin) * sizeof(T));
+			std::memcpy(data.data() + at, &components[begin], (end - begin) * sizeof(T));
+			count += static_cast<uint32_t>(end - begin);
+		}
+		begin = end + 1;
+	}
+	return count;
+}
+
+template <typename T>
+inline void SceneSnapshot::LoadColumn(Registry& registry, std::span<const Entity> entities, const std::byte* data)
+{
+	/* The data offset is 16-byte aligned within a page-aligned mapping, which covers every component. */
+	static_assert(alignof(T) <= 16);
+	registry.AddComponents<T>(entities, std::span<const T>(reinterpret_cast<const T*>(data), entities.size()));
+}
+
+} // namespace Mupfel
@@ -34,6 +34,7 @@
 /* Components */
 #include "ECS/Components/Animation.h"
 #include "ECS/Components/Collider.h"
+#include "ECS/Components/Hierarchy.h"
 #include "ECS/Components/Light.h"
 #include "ECS/Components/Movement.h"
 #include "ECS/Components/Texture.h"
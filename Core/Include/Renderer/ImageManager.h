@@ -8,6 +8,9 @@
 #pragma once
 #include "Core/Error.h"
 #include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -21,11 +24,22 @@ class DescriptorSet;
 class Pipeline;
 } // namespace Ping
 
+namespace spdlog
+{
+class logger;
+} // namespace spdlog
+
 namespace Mupfel
 {
 
 class ECSRenderer;
 class IMRenderer;
+class Application;
+class AsyncImageLoader;
+class TextureAtlas;
+class PingUploadDevice;
+struct ImageRequest;
+struct DecodedImage;
 
 typedef uint32_t ImageHandle;
 
@@ -41,6 +55,23 @@ struct ImageSpecification
 	uint32_t columns;
 };
 
+/**
+ * Where an `ImageHandle` lives on the GPU: the descriptor slot of its image, the first array layer and the
+ * part of that layer it covers, in normalized texture coordinates.
+ *
+ * Images with their own GPU image cover the whole of it. Small images loaded asynchronously share atlas
+ * pages instead, so many of them occupy a single descriptor slot.
+ */
+struct ImageRegion
+{
+	uint32_t slot = 0;
+	uint32_t layer = 0;
+	float	 u = 0.0f;
+	float	 v = 0.0f;
+	float	 width = 1.0f;
+	float	 height = 1.0f;
+};
+
 /**
  * The main image manager. It supports simple image and more advanced,
  * animated image.
@@ -49,8 +80,13 @@ class ImageManager
 {
 	friend class ECSRenderer;
 	friend class IMRenderer;
+	friend class Application;
+	friend class PingUploadDevice;
 
 public:
+	ImageManager();
+	~ImageManager();
+
 	/**
 	 * Try to load the image given by \a path.
 	 *
@@ -70,6 +106,28 @@ public:
 		const std::string		  path,
 		const ImageSpecification& spec);
 
+	/**
+	 * Asynchronous variant of `Load`: returns the handle right away and decodes the image on the thread
+	 * pool. Until the image has been uploaded (at the start of a later frame), the handle renders as the
+	 * default texture. If the image can't be loaded, the handle keeps showing the default texture.
+	 *
+	 * \param path Path to the image.
+	 * \return The handle the image will be available under.
+	 */
+	[[nodiscard]] ImageHandle LoadAsync(const std::string path);
+
+	/** Asynchronous variant of `LoadAnimated`, see `LoadAsync`. */
+	[[nodiscard]] ImageHandle LoadAnimatedAsync(const std::string path, const ImageSpecification& spec);
+
+	/** Asynchronous variant of `LoadSpriteSheet`, see `LoadAsync`. Returns `spec.rows * spec.columns` handles. */
+	[[nodiscard]] std::vector<ImageHandle> LoadSpriteSheetAsync(const std::string path, const ImageSpecification& spec);
+
+	/** Whether \a image has been uploaded, i.e. no longer renders as the default texture. */
+	[[nodiscard]] bool IsLoaded(ImageHandle image) const;
+
+	/** Where \a image currently lives on the GPU. Unknown handles map to the default texture. */
+	[[nodiscard]] ImageRegion GetRegion(ImageHandle image) const;
+
 	void Unload(const std::string path);
 
 	void Unload(ImageHandle image);
@@ -80,21 +138,107 @@ public:
 	 */
 	static constexpr uint32_t maxImageCount = 4096;
 
+	/** Upper bound for the pixel data `ProcessUploads` uploads per frame. */
+	static constexpr uint64_t uploadBudgetPerFrame = 32ull * 1024 * 1024;
+
+	/** Edge length of the atlas pages. */
+	static constexpr uint32_t atlasPageSize = 1024;
+
+	/**
+	 * Frames atlased images wait for more to share their pages with while decodes are still running. Once
+	 * the loader is idle, the pages are finished right away.
+	 */
+	static constexpr uint32_t atlasMaxWaitFrames = 30;
+
+	/** Asynchronously loaded images up to this size (in both dimensions) go into the atlas. */
+	static constexpr uint32_t maxAtlasImageSize = 256;
+
 private:
+	/** One image in an atlas page that has no GPU image yet. */
+	struct AtlasedImage
+	{
+		ImageHandle handle;
+		/** Where the image is on the page; the page index is in `layer`. */
+		ImageRegion region;
+	};
+
+	/** A finished atlas page that is being written to a file for Ping. */
+	struct PageUpload
+	{
+		uint32_t			  page;
+		std::filesystem::path file;
+		std::future<bool>	  written;
+	};
+
 	const std::vector<Ping::Image>& GetImages() const;
 
+	/** The region of every handle, indexed by handle. */
+	const std::vector<ImageRegion>& GetRegions() const;
+
+	/** Appends a GPU image and returns its slot. */
+	uint32_t AddImage(Ping::Image image);
+
+	/** Gives a freshly loaded image its handle, covering all of the image in \a slot. */
+	ImageHandle AddHandle(uint32_t slot);
+
+	/**
+	 * Creates the GPU image of \a image from the file the loader wrote it to. Images the loader kept in memory
+	 * go into the atlas instead, see `UploadAtlas`.
+	 */
+	void Place(const Ping::Device& device, const DecodedImage& image);
+
+	/**
+	 * Creates the images of the atlas pages whose files are written, which is when their images show. Then
+	 * finishes the open pages if the loader is idle or they waited `atlasMaxWaitFrames` frames, and writes
+	 * them to files on the thread pool.
+	 */
+	void UploadAtlas(const Ping::Device& device);
+
+	/**
+	 * Creates the images for the asynchronously decoded images that are ready. Called once per frame,
+	 * before rendering.
+	 */
+	void ProcessUploads(const Ping::Device& device);
+
+	/** Reserves the handles for \a request, remembers them under its path and starts decoding. */
+	std::vector<ImageHandle> Submit(ImageRequest request);
+
 private:
 	/**
-	 * This vector manages the RAII-based images.
-	 * ImageHandles directly translate to the vector index.
+	 * This vector manages the RAII-based images, indexed by descriptor slot.
+	 * The first one is the default texture.
 	 */
 	std::vector<Ping::Image> images;
+	/** ImageHandles directly translate to the index of this vector. */
+	std::vector<ImageRegion> regions;
+	/** Whether the image of a handle has been uploaded, indexed by handle. */
+	std::vector<bool> loaded;
 	/**
 	 * This map contains a path -> ImageHandle association.
 	 * Not used by the engine itself but useful for the user to
 	 * be able to reference images by the path.
 	 */
 	std::unordered_map<std::string, std::vector<ImageHandle>> imageHandleMap;
+	/**
+	 * Decodes asynchronous loads on the thread pool. Created on first use, so an engine that never loads
+	 * asynchronously never touches the pool from here.
+	 */
+	std::unique_ptr<AsyncImageLoader> loader;
+	/** Created together with `loader`; reports asynchronous loads that failed. */
+	std::shared_ptr<spdlog::logger> logger;
+	/**
+	 * Where the loader's workers write decoded images for Ping, which only loads images from files. Created
+	 * together with `loader`, removed with the manager.
+	 */
+	std::filesystem::path uploadDirectory;
+	/** Pixels of the atlased images; created together with `loader`, since only asynchronous loads use it. */
+	std::unique_ptr<TextureAtlas> atlas;
+	/** Atlased images whose pages have no GPU image yet. */
+	std::vector<AtlasedImage> atlasPending;
+	/** Frames the oldest image on an open atlas page has waited for its page to be finished. */
+	uint32_t atlasWaitFrames = 0;
+	/** Finished atlas pages on their way to a GPU image. */
+	std::vector<PageUpload> pageUploads;
 };
 
 } // namespace Mupfel
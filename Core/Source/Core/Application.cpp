@@ -2,6 +2,7 @@
 #include "Debug/DebugLayer.h"
 #include "DefaultScene.h"
 #include "ECS/Registry.h"
+#include "ECS/TransformSystem.h"
 #include "Logger.h"
 #include "Physics/PhysicsSimulation.h"
 #include "Ping/Device.h"
@@ -9,6 +10,8 @@
 #include "Profiler.h"
 #include "Renderer/AnimationSystem.h"
 #include "Renderer/Renderer.h"
+#include "ResourceManager.h"
+#include "SceneStreamer.h"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
@@ -42,13 +45,42 @@ void Mupfel::Application::QueueSceneSwitch(SceneHandle handle)
 	app.queued_scene = handle;
 }
 
+void Mupfel::Application::QueueSceneStream(SceneHandle handle)
+{
+	auto& app = Get();
+	if (handle >= Scene::MAX_SCENES || !app.scenes[handle])
+	{
+		return;
+	}
+
+	Scene* scene = app.scenes[handle].get();
+	if (!app.streamer->Begin(handle, [scene](Registry& staging) { scene->OnStage(staging); }))
+	{
+		app.logger->warn("Scene {} is still streaming in, not streaming scene {}.", app.streamer->GetScene(), handle);
+	}
+}
+
 SceneHandle Mupfel::Application::GetCurrentSceneHandle() { return Get().current_scene; }
 
 Camera& Mupfel::Application::GetCurrentSceneCamera() { return Get().scenes[Get().current_scene]->camera; }
 
-KeyAction Mupfel::Application::GetKey(Key k) { return Get().window.GetKey(k); }
+KeyAction Mupfel::Application::GetKey(Key k)
+{
+	if (IsHeadless())
+	{
+		return KeyAction::NONE;
+	}
+	return Get().window.GetKey(k);
+}
 
-KeyAction Mupfel::Application::GetMouseButton(MouseButton b) { return Get().window.GetMouseButton(b); }
+KeyAction Mupfel::Application::GetMouseButton(MouseButton b)
+{
+	if (IsHeadless())
+	{
+		return KeyAction::NONE;
+	}
+	return Get().window.GetMouseButton(b);
+}
 
 Application::Application()
 	: window(Window::GetInstance()), evt_system(), input_manager(evt_system),
@@ -76,33 +108,64 @@ bool Application::Init(const ApplicationSpecification& in_spec)
 	logger = Logger::Create(app.spec.name);
 	logger->info("{} initializing...", app.spec.name);
 
-	WindowSpecification window_spec;
-	window_spec.title = app.spec.name;
-
-	if (!Window::GetInstance().Init(window_spec))
+	if (!app.spec.resourcePack.empty())
 	{
-		logger->error("Window Initialization failed!");
-		return false;
+		resources = std::make_unique<ResourceManager>();
+		if (!resources->Load(app.spec.resourcePack))
+		{
+			logger->error("Could not mount the resource pack {}!", app.spec.resourcePack);
+			return false;
+		}
+		logger->info("Mounted the resource pack {} ({} files).", app.spec.resourcePack, resources->GetFileCount());
 	}
 
-	if (!Ping::Init())
+	if (app.spec.headless.enabled)
 	{
-		logger->error("Failed to initialize the RHI.");
-		return false;
+		if (!(app.spec.headless.tickRate > 0.0))
+		{
+			logger->error("Invalid headless tick rate {}, it must be positive!", app.spec.headless.tickRate);
+			return false;
+		}
+
+		/* No window, no RHI, no renderer: only the simulation runs. */
+		logger->info("Running headless at {} ticks per second{}.", app.spec.headless.tickRate,
+			app.spec.headless.unlimited ? " (unpaced)" : "");
 	}
+	else
+	{
+		WindowSpecification window_spec;
+		window_spec.title = app.spec.name;
 
-	gpu = std::make_unique<Ping::Device>(Ping::DeviceSpecification(), Window::GetInstance().GetGLFWHandle());
+		if (!Window::GetInstance().Init(window_spec))
+		{
+			logger->error("Window Initialization failed!");
+			return false;
+		}
 
-	renderer = std::make_unique<Renderer>();
-	if (!renderer->Init(*gpu, Window::GetInstance()))
-	{
-		logger->error("Renderer Initialization failed!");
-		return false;
+		if (!Ping::Init())
+		{
+			logger->error("Failed to initialize the RHI.");
+			return false;
+		}
+
+		gpu = std::make_unique<Ping::Device>(Ping::DeviceSpecification(), Window::GetInstance().GetGLFWHandle());
+
+		renderer = std::make_unique<Renderer>();
+		if (!renderer->Init(*gpu, Window::GetInstance()))
+		{
+			logger->error("Renderer Initialization failed!");
+			return false;
+		}
 	}
 
 	physics = std::make_unique<PhysicsSimulation>(registry, evt_system);
 	physics->Init();
 
+	transformSystem = std::make_unique<TransformSystem>(registry, evt_system, thread_pool);
+	transformSystem->Init();
+
+	streamer = std::make_unique<SceneStreamer>(thread_pool);
+
 	debug_layer = std::make_unique<DebugLayer>();
 	debug_layer->OnInit();
 
@@ -155,6 +218,11 @@ float Mupfel::Application::GetLastFrameTime() { return static_cast<float>(Get().
 
 int Mupfel::Application::GetCurrentRenderWidth()
 {
+	if (IsHeadless())
+	{
+		return 0;
+	}
+
 	int32_t width, height;
 	Get().window.GetFramebufferSize(width, height);
 
@@ -163,13 +231,20 @@ int Mupfel::Application::GetCurrentRenderWidth()
 
 int Mupfel::Application::GetCurrentRenderHeight()
 {
+	if (IsHeadless())
+	{
+		return 0;
+	}
+
 	int32_t width, height;
 	Get().window.GetFramebufferSize(width, height);
 
 	return height;
 }
 
-bool Mupfel::Application::IsWindowMinimized() { return Get().window.IsMinimized(); }
+bool Mupfel::Application::IsWindowMinimized() { return !IsHeadless() && Get().window.IsMinimized(); }
+
+bool Mupfel::Application::IsHeadless() { return Get().spec.headless.enabled; }
 
 bool Mupfel::Application::isDebugModeEnabled() { return Get().debugModeEnabled; }
 
@@ -179,24 +254,68 @@ InputManager& Mupfel::Application::GetCurrentInputManager() { return Get().input
 
 Registry& Mupfel::Application::GetCurrentRegistry() { return Get().registry; }
 
+/* Headless, there is no GPU to upload to: every image is the default one, handle 0. */
+
 Expected<ImageHandle> Mupfel::Application::LoadBasicImage(const std::string path)
 {
+	if (IsHeadless())
+	{
+		return ImageHandle{0};
+	}
 	return Get().image_manager.Load(*Get().gpu, path);
 }
 
 Expected<ImageHandle> Mupfel::Application::LoadAnimatedImage(const std::string path, const ImageSpecification& spec)
 {
+	if (IsHeadless())
+	{
+		return ImageHandle{0};
+	}
 	return Get().image_manager.LoadAnimated(*Get().gpu, path, spec);
 }
 
 Expected<std::vector<ImageHandle>>
 Mupfel::Application::LoadSpriteSheetImages(const std::string path, const ImageSpecification& spec)
 {
+	if (IsHeadless())
+	{
+		return std::vector<ImageHandle>(spec.rows * spec.columns, 0);
+	}
 	return Get().image_manager.LoadSpriteSheet(*Get().gpu, path, spec);
 }
 
+ImageHandle Mupfel::Application::LoadBasicImageAsync(const std::string path)
+{
+	if (IsHeadless())
+	{
+		return 0;
+	}
+	return Get().image_manager.LoadAsync(path);
+}
+
+ImageHandle Mupfel::Application::LoadAnimatedImageAsync(const std::string path, const ImageSpecification& spec)
+{
+	if (IsHeadless())
+	{
+		return 0;
+	}
+	return Get().image_manager.LoadAnimatedAsync(path, spec);
+}
+
+std::vector<ImageHandle>
+Mupfel::Application::LoadSpriteSheetImagesAsync(const std::string path, const ImageSpecification& spec)
+{
+	if (IsHeadless())
+	{
+		return std::vector<ImageHandle>(spec.rows * spec.columns, 0);
+	}
+	return Get().image_manager.LoadSpriteSheetAsync(path, spec);
+}
+
 ThreadPool& Mupfel::Application::GetCurrentThreadPool() { return Get().thread_pool; }
 
+const ResourceManager* Mupfel::Application::GetResourcePack() { return Get().resources.get(); }
+
 void Mupfel::Application::SetTimeScale(double time_scale) { Get().physics->SetTimeMultiplier(time_scale); }
 
 void Mupfel::Application::TogglePhysicsSingleStep() { Get().physics->ToggleSingleStep(); }
@@ -232,8 +351,72 @@ void Mupfel::Application::SwitchScene(SceneHandle new_scene)
 
 uint64_t Mupfel::Application::GetFrameCount() { return Get().frame_count; }
 
+void Application::UpdateSimulation(double timestep)
+{
+	/* Merge the next slices of a scene that is streaming in, and switch to it once it is complete. */
+	if (streamer->IsStreaming())
+	{
+		ProfilingSample prof("Scene Streaming");
+		const SceneHandle streamed = streamer->GetScene();
+		if (streamer->Update(registry, spec.sceneMergeBudget))
+		{
+			SwitchScene(streamed);
+		}
+	}
+
+	/* Check if a Scene switch is wanted. */
+	if (queued_scene != Scene::INVALID_HANDLE)
+	{
+		SwitchScene(queued_scene);
+		queued_scene = Scene::INVALID_HANDLE;
+	}
+
+	scenes[current_scene]->OnUpdate(timestep);
+
+	{
+		ProfilingSample prof("Layers - OnUpdate ");
+		/* Update all layers */
+		for (const std::unique_ptr<Layer>& layer : layerStack)
+		{
+			layer->OnUpdate(timestep);
+		}
+		debug_layer->OnUpdate(timestep);
+	}
+
+	{
+		ProfilingSample prof("Physics Update");
+		/* Update the Collision System */
+		physics->Update(timestep);
+	}
+
+	{
+		ProfilingSample prof("Animation Update");
+		/* Update the Collision System */
+		animationSystem->Update(timestep);
+	}
+
+	{
+		ProfilingSample prof("Transform Update");
+		/* After everything that moves entities, so the hierarchies see this frame's Transforms */
+		transformSystem->Update();
+	}
+
+	if (spec.defragmentBudget > 0.0)
+	{
+		ProfilingSample prof("Defragment");
+		/* Arrays in order cost next to nothing: only those removals scrambled use the budget */
+		registry.Defragment(spec.defragmentBudget);
+	}
+}
+
 void Application::Run()
 {
+	if (spec.headless.enabled)
+	{
+		RunHeadless();
+		return;
+	}
+
 	running = true;
 
 	double lastTime = Application::GetTime();
@@ -271,35 +454,12 @@ void Application::Run()
 			}
 		}
 
-		/* Check if a Scene switch is wanted. */
-		if (queued_scene != Scene::INVALID_HANDLE)
-		{
-			SwitchScene(queued_scene);
-			queued_scene = Scene::INVALID_HANDLE;
-		}
-
-		scenes[current_scene]->OnUpdate(timestep);
+		UpdateSimulation(timestep);
 
 		{
-			ProfilingSample prof("Layers - OnUpdate ");
-			/* Update all layers */
-			for (const std::unique_ptr<Layer>& layer : layerStack)
-			{
-				layer->OnUpdate(timestep);
-			}
-			debug_layer->OnUpdate(timestep);
-		}
-
-		{
-			ProfilingSample prof("Physics Update");
-			/* Update the Collision System */
-			physics->Update(timestep);
-		}
-
-		{
-			ProfilingSample prof("Animation Update");
-			/* Update the Collision System */
-			animationSystem->Update(timestep);
+			ProfilingSample prof("Image Uploads");
+			/* Images decoded in the background since last frame become visible from this frame on. */
+			image_manager.ProcessUploads(*gpu);
 		}
 
 		{
@@ -346,16 +506,85 @@ void Application::Run()
 	DeInit();
 }
 
+void Application::RunHeadless()
+{
+	running = true;
+
+	const HeadlessSpecification& headless = spec.headless;
+
+	/* Every frame advances the simulation by the same step, paced or not, so runs are reproducible. */
+	const double timestep = 1.0 / headless.tickRate;
+	const auto	 period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timestep));
+	auto		 next_tick = Clock::now();
+
+	while (running)
+	{
+		if (headless.maxFrames != 0 && frame_count >= headless.maxFrames)
+		{
+			Stop();
+			break;
+		}
+
+		Application::StartFrameTime();
+		frame_count++;
+
+		{
+			ProfilingSample prof("Application::RunHeadless()");
+
+			UpdateSimulation(timestep);
+
+			Profiler::Clear();
+
+			{
+				ProfilingSample prof2("Event System Update");
+				/* Update the EventSystem */
+				evt_system.Update();
+			}
+		}
+
+		Application::EndFrameTime();
+
+		if (!headless.unlimited)
+		{
+			/* Don't try to catch up on frames that ran late, just start counting from now. */
+			next_tick += period;
+			const Clock::time_point now = Clock::now();
+			if (next_tick < now)
+			{
+				next_tick = now;
+			}
+			else
+			{
+				std::this_thread::sleep_until(next_tick);
+			}
+		}
+	}
+
+	logger->info("Headless run finished after {} frames.", frame_count);
+
+	/* Exited Main Loop, clean everything up */
+	DeInit();
+}
+
 void Application::DeInit()
 {
+	/* Waits for a scene that is still being staged. */
+	streamer.reset();
+
 	physics->DeInit();
-	gpu->WaitForCommands();
-	Ping::Shutdown();
+	if (gpu)
+	{
+		gpu->WaitForCommands();
+		Ping::Shutdown();
+	}
 	animationSystem->Shutdown();
 
-	/* At the end, write the config. */
-	configManager.Set<int32_t>("windowWidth", window.GetWindowWidth());
-	configManager.Set<int32_t>("windowHeight", window.GetWindowHeight());
+	/* At the end, write the config. Headless, there is no window size to remember. */
+	if (!spec.headless.enabled)
+	{
+		configManager.Set<int32_t>("windowWidth", window.GetWindowWidth());
+		configManager.Set<int32_t>("windowHeight", window.GetWindowHeight());
+	}
 	configManager.SaveConfig("mupfel.ini");
 
 	logger->info("Wrote config to mupfel.ini.");
@@ -1,14 +1,17 @@
 #include "DebugLayer.h"
 #include "Core/Application.h"
+#include "Core/PerfCounters.h"
 #include "Core/Profiler.h"
 #include "ECS/Components/Collider.h"
-#include "ECS/Components/Movement.h"
-#include "ECS/Components/Transform.h"
+#include "ECS/Components/EngineComponents.h"
 #include "ECS/Registry.h"
 #include "ECS/View.h"
 #include <algorithm>
 #include <format>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
 #include "glm/glm.hpp"
 
 #include "imgui.h"
@@ -45,6 +48,26 @@ void Mupfel::DebugLayer::OnRender()
 	{
 		DrawPerformanceMetrics();
 	}
+	if (ImGui::CollapsingHeader("Scope Statistics"))
+	{
+		DrawScopeStats();
+	}
+	if (ImGui::CollapsingHeader("Hardware Counters"))
+	{
+		DrawHardwareCounters();
+	}
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		DrawMemoryUsage();
+	}
+	if (ImGui::CollapsingHeader("Entity Inspector"))
+	{
+		DrawEntityInspector();
+	}
+	if (ImGui::CollapsingHeader("Trace Capture"))
+	{
+		DrawTraceCapture();
+	}
 	if (ImGui::CollapsingHeader("Camera Controls"))
 	{
 		DrawCameraControls();
@@ -61,8 +84,9 @@ void Mupfel::DebugLayer::DrawPerformanceMetrics()
 
 	if (!local.empty())
 	{
-		// Sortiere stabil nach Startzeit (aufsteigend)
-		std::ranges::stable_sort(local, {}, &ProfilingSample::id);
+		/* Per thread in start order, parents before their children. MUPFEL_PROFILE_SCOPE samples carry no ID. */
+		std::ranges::sort(
+			local, {}, [](const ProfilingSample& s) { return std::tuple(s.thread, s.start_time, s.depth); });
 
 		std::string t;
 		uint32_t	offset = 200;
@@ -77,6 +101,239 @@ void Mupfel::DebugLayer::DrawPerformanceMetrics()
 	}
 }
 
+void Mupfel::DebugLayer::DrawScopeStats()
+{
+	if (ImGui::Button("Reset"))
+	{
+		Profiler::ResetScopeStats();
+	}
+
+	const std::vector<ScopeStats> stats = Profiler::GetScopeStats();
+
+	if (!ImGui::BeginTable("ScopeStats", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		return;
+	}
+
+	for (const char* header : {"Scope", "min", "mean", "p50", "p95", "p99", "max"})
+	{
+		ImGui::TableSetupColumn(header);
+	}
+	ImGui::TableHeadersRow();
+
+	for (const ScopeStats& s : stats)
+	{
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::Text("%.*s", static_cast<int>(s.name.size()), s.name.data());
+
+		for (double value : {s.min_ms, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms})
+		{
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", value);
+		}
+	}
+
+	ImGui::EndTable();
+}
+
+void Mupfel::DebugLayer::DrawHardwareCounters()
+{
+	bool enabled = Profiler::AreCountersEnabled();
+	if (ImGui::Checkbox("Count", &enabled))
+	{
+		Profiler::SetCountersEnabled(enabled);
+	}
+
+	const PerfCounterGroup& group = PerfCounterGroup::ForCurrentThread();
+	if (!group.GetError().empty())
+	{
+		ImGui::TextWrapped("Unavailable: %s", group.GetError().c_str());
+	}
+
+	const std::vector<ScopeCounters> counters = Profiler::GetScopeCounters();
+
+	if (!ImGui::BeginTable("ScopeCounters", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		return;
+	}
+
+	for (const char* header : {"Scope", "IPC", "kcycles", "LLC miss", "br miss"})
+	{
+		ImGui::TableSetupColumn(header);
+	}
+	ImGui::TableHeadersRow();
+
+	/* Everything but IPC per run of the scope. */
+	for (const ScopeCounters& c : counters)
+	{
+		const double runs = static_cast<double>(std::max<uint64_t>(c.count, 1));
+
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::Text("%.*s", static_cast<int>(c.name.size()), c.name.data());
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", c.total.Ipc());
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", static_cast<double>(c.total.cycles) / runs / 1000.0);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.0f", static_cast<double>(c.total.llcMisses) / runs);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.0f", static_cast<double>(c.total.branchMisses) / runs);
+	}
+
+	ImGui::EndTable();
+}
+
+void Mupfel::DebugLayer::DrawMemoryUsage()
+{
+	Application& app = Application::Get();
+
+	if (ImGui::Button("Shrink to fit"))
+	{
+		app.registry.ShrinkToFit();
+		app.evt_system.ShrinkToFit();
+	}
+
+	const RegistryMemoryUsage registry = app.registry.GetMemoryUsage();
+	const MemoryUsage		  events = app.evt_system.GetMemoryUsage();
+
+	if (!ImGui::BeginTable("MemoryUsage", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+	{
+		return;
+	}
+
+	for (const char* header : {"Storage", "count", "used KiB", "reserved KiB"})
+	{
+		ImGui::TableSetupColumn(header);
+	}
+	ImGui::TableHeadersRow();
+
+	/* Event buffers have no meaningful count, they are cleared every frame. */
+	auto row = [](std::string_view name, const std::string& count, const MemoryUsage& memory)
+	{
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::Text("%.*s", static_cast<int>(name.size()), name.data());
+		ImGui::TableNextColumn();
+		ImGui::Text("%s", count.c_str());
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", static_cast<double>(memory.used) / 1024.0);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", static_cast<double>(memory.reserved) / 1024.0);
+	};
+
+	row("Entities", std::to_string(app.registry.GetCurrentEntities()), registry.entities);
+	for (const ComponentMemoryUsage& c : registry.components)
+	{
+		row(c.name, std::to_string(c.count), c.memory);
+	}
+	row("Events", "", events);
+	row("Total", "", registry.Total() + events);
+
+	ImGui::EndTable();
+}
+
+/** A tree node with an editor for every reflected field of \a e's `T`, if it has one. */
+template <Mupfel::ReflectedComponent T> static void InspectComponent(Mupfel::Registry& registry, Mupfel::Entity e)
+{
+	using namespace Mupfel;
+
+	if (!registry.HasComponent<T>(e) || !ImGui::TreeNode(ComponentReflection<T>::name.data()))
+	{
+		return;
+	}
+
+	/* Edited in place, like SetComponent does; no event is sent. */
+	T& component = registry.GetComponent<T>(e);
+	for (const ComponentField<T>& field : FieldsOf<T>())
+	{
+		const std::string label(field.key);
+		std::visit(
+			[&](auto member)
+			{
+				auto& value = component.*member;
+				using Value = std::remove_reference_t<decltype(value)>;
+				if constexpr (std::is_same_v<Value, float>)
+				{
+					ImGui::DragFloat(label.c_str(), &value, 0.1f);
+				}
+				else if constexpr (std::is_same_v<Value, bool>)
+				{
+					ImGui::Checkbox(label.c_str(), &value);
+				}
+				else
+				{
+					ImGui::InputScalar(
+						label.c_str(), std::is_signed_v<Value> ? ImGuiDataType_S32 : ImGuiDataType_U32, &value);
+				}
+			},
+			field.member);
+	}
+	ImGui::TreePop();
+}
+
+void Mupfel::DebugLayer::DrawEntityInspector()
+{
+	Registry& registry = Application::GetCurrentRegistry();
+
+	/* Only gathered while the inspector is open. */
+	const std::vector<Entity> entities = registry.GetActiveSceneEntities();
+	if (entities.empty())
+	{
+		ImGui::Text("No entities in the active scene");
+		return;
+	}
+
+	ImGui::SliderInt("Entity", &inspected_entity, 0, static_cast<int>(entities.size()) - 1);
+	inspected_entity = std::clamp(inspected_entity, 0, static_cast<int>(entities.size()) - 1);
+
+	const Entity e = entities[inspected_entity];
+	ImGui::Text("Index %u", e.Index());
+
+	EngineComponents::ForEach([&]<typename T>() { InspectComponent<T>(registry, e); });
+}
+
+void Mupfel::DebugLayer::DrawTraceCapture()
+{
+	static constexpr const char* trace_path = "mupfel_trace.json";
+
+	ImGui::InputInt("Frames", &trace_frames);
+	trace_frames = std::clamp(trace_frames, 1, 10000);
+
+	if (Profiler::IsCapturing())
+	{
+		ImGui::Text("Capturing... %zu samples", Profiler::GetCapturedSamples().size());
+		if (ImGui::Button("Stop"))
+		{
+			Profiler::StopCapture();
+		}
+		return;
+	}
+
+	if (ImGui::Button("Capture"))
+	{
+		Profiler::StartCapture(static_cast<uint32_t>(trace_frames));
+		trace_status.clear();
+	}
+
+	if (!Profiler::GetCapturedSamples().empty())
+	{
+		ImGui::SameLine();
+		if (ImGui::Button("Save Trace"))
+		{
+			/* Open the file in ui.perfetto.dev or chrome://tracing. */
+			trace_status = Profiler::WriteChromeTrace(trace_path) ? std::format("Saved to {}", trace_path)
+																   : std::format("Unable to write {}", trace_path);
+		}
+	}
+
+	if (!trace_status.empty())
+	{
+		ImGui::Text("%s", trace_status.c_str());
+	}
+}
+
 void Mupfel::DebugLayer::DrawCameraControls()
 {
 	Camera &current_cam = Application::GetCurrentSceneCamera();
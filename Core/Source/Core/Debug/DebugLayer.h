@@ -1,6 +1,7 @@
 #pragma once
 #include "Core/Layer.h"
 #include <cstdint>
+#include <string>
 
 namespace Mupfel {
 	class DebugLayer : public Layer
@@ -12,6 +13,11 @@ namespace Mupfel {
 	private:
 		void DrawPerformanceMetrics();
 		void DrawCameraControls();
+		void DrawTraceCapture();
+		void DrawScopeStats();
+		void DrawHardwareCounters();
+		void DrawMemoryUsage();
+		void DrawEntityInspector();
 	private:
 		static const uint32_t anchor_x = 10;
 		static const uint32_t anchor_y = 70;
@@ -22,6 +28,9 @@ namespace Mupfel {
 		bool single_stepping = false;
 		bool show_entity_index = false;
 		float cell_size_pow = 8;
+		int trace_frames = 120;
+		int inspected_entity = 0;
+		std::string trace_status;
 	};
 }
 
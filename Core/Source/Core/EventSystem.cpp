@@ -21,4 +21,35 @@ void Mupfel::EventSystem::Update()
 	/* Update the event counters */
 	events_last_frame = events_this_frame;
 	events_this_frame = 0;
+}
+
+Mupfel::MemoryUsage Mupfel::EventSystem::GetMemoryUsage() const
+{
+	MemoryUsage usage;
+	for (const EventBufferArray& buffers : event_buffer_array)
+	{
+		usage += MemoryUsage::Of(buffers);
+		for (const auto& e : buffers)
+		{
+			if (e)
+			{
+				usage += e->GetMemoryUsage();
+			}
+		}
+	}
+	return usage;
+}
+
+void Mupfel::EventSystem::ShrinkToFit()
+{
+	for (EventBufferArray& buffers : event_buffer_array)
+	{
+		for (auto& e : buffers)
+		{
+			if (e)
+			{
+				e->ShrinkToFit();
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "LogHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace Mupfel;
+
+void Mupfel::LogHistogram::Record(uint64_t value)
+{
+	counts[BucketIndex(value)]++;
+	count++;
+	min = std::min(min, value);
+	max = std::max(max, value);
+	sum += static_cast<double>(value);
+}
+
+void Mupfel::LogHistogram::Merge(const LogHistogram& other)
+{
+	for (uint32_t i = 0; i < bucketCount; i++)
+	{
+		counts[i] += other.counts[i];
+	}
+	count += other.count;
+	min = std::min(min, other.min);
+	max = std::max(max, other.max);
+	sum += other.sum;
+}
+
+void Mupfel::LogHistogram::Clear() { *this = LogHistogram{}; }
+
+uint64_t Mupfel::LogHistogram::GetCount() const { return count; }
+
+uint64_t Mupfel::LogHistogram::GetMin() const { return (count > 0) ? min : 0; }
+
+uint64_t Mupfel::LogHistogram::GetMax() const { return max; }
+
+double Mupfel::LogHistogram::GetMean() const { return (count > 0) ? sum / static_cast<double>(count) : 0.0; }
+
+uint64_t Mupfel::LogHistogram::GetPercentile(double percentile) const
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	/* The rank of the wanted value, 1-based: p50 of 4 values is the 2nd. */
+	const double   fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+	const uint64_t rank =
+		std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+
+	/* The extremes are known exactly. */
+	if (rank == 1)
+	{
+		return min;
+	}
+	if (rank >= count)
+	{
+		return max;
+	}
+
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < bucketCount; i++)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+		{
+			return std::clamp(BucketValue(i), min, max);
+		}
+	}
+
+	return max;
+}
+
+uint32_t Mupfel::LogHistogram::BucketIndex(uint64_t value)
+{
+	if (value < subBuckets)
+	{
+		return static_cast<uint32_t>(value);
+	}
+
+	const uint32_t exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+	if (exponent > maxExponent)
+	{
+		return bucketCount - 1;
+	}
+
+	/* The top subBucketBits bits below the leading one pick the linear bucket within the power of two. */
+	const uint32_t sub = static_cast<uint32_t>(value >> (exponent - subBucketBits)) - subBuckets;
+	return subBuckets + (exponent - subBucketBits) * subBuckets + sub;
+}
+
+uint64_t Mupfel::LogHistogram::BucketValue(uint32_t index)
+{
+	if (index < subBuckets)
+	{
+		return index;
+	}
+
+	const uint32_t shift = (index - subBuckets) / subBuckets;
+	const uint64_t sub = (index - subBuckets) % subBuckets;
+	const uint64_t lowest = (subBuckets + sub) << shift;
+	return lowest + ((1ull << shift) >> 1);
+}
@@ -0,0 +1,191 @@
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Mupfel;
+
+double Mupfel::PerfCounterValues::Ipc() const
+{
+	return cycles ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0;
+}
+
+PerfCounterValues Mupfel::PerfCounterValues::Scaled() const
+{
+	/* Nothing to make up for if the group ran all the time, or never (then there is nothing to scale). */
+	if (timeRunning == 0 || timeRunning >= timeEnabled)
+	{
+		return *this;
+	}
+
+	const double scale = static_cast<double>(timeEnabled) / static_cast<double>(timeRunning);
+	auto		 scaled = [scale](uint64_t value) { return static_cast<uint64_t>(static_cast<double>(value) * scale); };
+
+	return {
+		.cycles = scaled(cycles),
+		.instructions = scaled(instructions),
+		.llcMisses = scaled(llcMisses),
+		.branchMisses = scaled(branchMisses),
+		.timeEnabled = timeEnabled,
+		.timeRunning = timeEnabled,
+	};
+}
+
+PerfCounterValues Mupfel::PerfCounterValues::operator-(const PerfCounterValues& other) const
+{
+	/* Raw totals only grow; this keeps values read on different threads or out of order from wrapping around. */
+	auto difference = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+
+	return {
+		.cycles = difference(cycles, other.cycles),
+		.instructions = difference(instructions, other.instructions),
+		.llcMisses = difference(llcMisses, other.llcMisses),
+		.branchMisses = difference(branchMisses, other.branchMisses),
+		.timeEnabled = difference(timeEnabled, other.timeEnabled),
+		.timeRunning = difference(timeRunning, other.timeRunning),
+	};
+}
+
+PerfCounterValues& Mupfel::PerfCounterValues::operator+=(const PerfCounterValues& other)
+{
+	cycles += other.cycles;
+	instructions += other.instructions;
+	llcMisses += other.llcMisses;
+	branchMisses += other.branchMisses;
+	timeEnabled += other.timeEnabled;
+	timeRunning += other.timeRunning;
+	return *this;
+}
+
+#ifdef __linux__
+
+/* Layout of a read() on the group leader with the read_format below. */
+struct GroupReadBuffer
+{
+	uint64_t count;
+	uint64_t time_enabled;
+	uint64_t time_running;
+	uint64_t values[static_cast<uint32_t>(PerfCounter::Count)];
+};
+
+static int OpenEvent(uint32_t type, uint64_t config, int group_fd)
+{
+	perf_event_attr attr{};
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	/* User space only: that is what we want to measure, and it is all perf_event_paranoid = 2 permits. */
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	/* The leader starts disabled and enables the whole group once every member is in. */
+	attr.disabled = (group_fd == -1) ? 1 : 0;
+
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+Mupfel::PerfCounterGroup::PerfCounterGroup()
+{
+	fds.fill(-1);
+
+	static constexpr uint64_t configs[counterCount] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES,
+	};
+	static constexpr const char* names[counterCount] = {"cycles", "instructions", "LLC misses", "branch misses"};
+
+	for (uint32_t i = 0; i < counterCount; i++)
+	{
+		const int fd = OpenEvent(PERF_TYPE_HARDWARE, configs[i], fds[0]);
+		if (fd == -1)
+		{
+			error += std::format("{}{}: {}", error.empty() ? "" : "; ", names[i], std::strerror(errno));
+			if (i == 0)
+			{
+				/* Without a leader there is no group. */
+				return;
+			}
+			continue;
+		}
+
+		fds[i] = fd;
+		slots[i] = opened++;
+	}
+
+	ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+Mupfel::PerfCounterGroup::~PerfCounterGroup()
+{
+	for (int fd : fds)
+	{
+		if (fd != -1)
+		{
+			close(fd);
+		}
+	}
+}
+
+PerfCounterValues Mupfel::PerfCounterGroup::Read() const
+{
+	GroupReadBuffer buffer{};
+	if (fds[0] == -1 || read(fds[0], &buffer, sizeof(buffer)) <= 0 || buffer.count != opened)
+	{
+		return {};
+	}
+
+	auto value = [&](PerfCounter counter) -> uint64_t
+	{
+		const uint32_t i = static_cast<uint32_t>(counter);
+		return (fds[i] == -1) ? 0 : buffer.values[slots[i]];
+	};
+
+	/* Unscaled: scaling the totals by their ratio would skew every difference taken from them. */
+	return {
+		.cycles = value(PerfCounter::Cycles),
+		.instructions = value(PerfCounter::Instructions),
+		.llcMisses = value(PerfCounter::LlcMisses),
+		.branchMisses = value(PerfCounter::BranchMisses),
+		.timeEnabled = buffer.time_enabled,
+		.timeRunning = buffer.time_running,
+	};
+}
+
+#else
+
+Mupfel::PerfCounterGroup::PerfCounterGroup()
+	: error("hardware counters are only supported on Linux")
+{
+	fds.fill(-1);
+}
+
+Mupfel::PerfCounterGroup::~PerfCounterGroup() = default;
+
+PerfCounterValues Mupfel::PerfCounterGroup::Read() const { return {}; }
+
+#endif
+
+bool Mupfel::PerfCounterGroup::IsAvailable() const { return fds[0] != -1; }
+
+bool Mupfel::PerfCounterGroup::Has(PerfCounter counter) const
+{
+	return counter != PerfCounter::Count && fds[static_cast<uint32_t>(counter)] != -1;
+}
+
+const std::string& Mupfel::PerfCounterGroup::GetError() const { return error; }
+
+PerfCounterGroup& Mupfel::PerfCounterGroup::ForCurrentThread()
+{
+	thread_local PerfCounterGroup group;
+	return group;
+}
@@ -2,6 +2,10 @@
 #include "Application.h"
 #include <iostream>
 #include <iomanip>
+#include <format>
+#include <algorithm>
+#include <fstream>
+#include <set>
 
 using namespace Mupfel;
 
@@ -12,11 +16,6 @@ using namespace Mupfel;
  */
 thread_local uint32_t scope = 0;
 
-/**
- * @brief Global sample counter used to assign unique IDs to profiling samples.
- */
-static uint32_t sample_id = 0;
-
 ProfilingSample::ProfilingSample(std::string_view in_name) : name(in_name), active(true), depth(0), end_time(0.0f), id(0)
 {
 	start_time = Application::GetTime();
@@ -39,11 +38,12 @@ ProfilingSample::~ProfilingSample()
 		scope--;
 	}
 
-	if (!Profiler::IsClearing())
-	{
-		Profiler::Get().AddSample(std::move(*this));
-	}
-	
+	Profiler::Get().AddSample(std::move(*this));
+}
+
+Mupfel::ProfilingSample::ProfilingSample() noexcept
+	: id(0), start_time(0.0), end_time(0.0), active(false), depth(0)
+{
 }
 
 Mupfel::ProfilingSample::ProfilingSample(ProfilingSample&& other) noexcept :
@@ -52,7 +52,8 @@ Mupfel::ProfilingSample::ProfilingSample(ProfilingSample&& other) noexcept :
 	end_time(other.end_time),
 	active(other.active),
 	depth(other.depth),
-	id(other.id)
+	id(other.id),
+	thread(other.thread)
 {
 	other.active = false;
 }
@@ -66,6 +67,7 @@ ProfilingSample& Mupfel::ProfilingSample::operator=(ProfilingSample&& other) noe
 		active = other.active;
 		depth = other.depth;
 		id = other.id;
+		thread = other.thread;
 		other.active = false; 
 	}
 	return *this;
@@ -77,7 +79,8 @@ Mupfel::ProfilingSample::ProfilingSample(const ProfilingSample& other) noexcept
 	end_time(other.end_time),
 	active(false),
 	depth(other.depth),
-	id(other.id)
+	id(other.id),
+	thread(other.thread)
 {
 
 }
@@ -90,11 +93,62 @@ ProfilingSample& Mupfel::ProfilingSample::operator=(const ProfilingSample& other
 		end_time = other.end_time;
 		depth = other.depth;
 		id = other.id;
+		thread = other.thread;
 		active = false;
 	}
 	return *this;
 }
 
+Mupfel::ProfileScope::ProfileScope(const ProfileScopeInfo& in_info) noexcept
+	: info(in_info), start(Profiler::Ticks()), depth(scope)
+{
+	scope++;
+}
+
+Mupfel::ProfileScope::~ProfileScope()
+{
+	const uint64_t end = Profiler::Ticks();
+
+	if (scope > 0)
+	{
+		scope--;
+	}
+
+	Profiler::Get().AddScope(info, start, end, depth);
+}
+
+Mupfel::CounterScope::CounterScope(std::string_view in_name)
+	: name(in_name), active(Profiler::AreCountersEnabled())
+{
+	if (active)
+	{
+		start = PerfCounterGroup::ForCurrentThread().Read();
+	}
+}
+
+Mupfel::CounterScope::~CounterScope()
+{
+	if (!active)
+	{
+		return;
+	}
+
+	const PerfCounterValues end = PerfCounterGroup::ForCurrentThread().Read();
+	if (end.cycles > 0)
+	{
+		Profiler::Get().AddCounters(name, (end - start).Scaled());
+	}
+}
+
+Mupfel::Profiler::Profiler()
+{
+	using Period = std::chrono::steady_clock::period;
+	tick_period = static_cast<double>(Period::num) / static_cast<double>(Period::den);
+
+	/* Both clocks are steady_clock, so one reading pins the offset for good. */
+	tick_offset = Application::GetTime() - static_cast<double>(Ticks()) * tick_period;
+}
+
 Profiler& Profiler::Get()
 {
 	static Profiler* inst = new Profiler();
@@ -102,16 +156,160 @@ Profiler& Profiler::Get()
 }
 
 void Profiler::Clear() {
-	std::scoped_lock lock(Get().mutex);
-	Get().is_clearing = true;
-	Get().samples.clear();
-	Get().is_clearing = false;
-	sample_id = 0;
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	profiler.samples.clear();
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : profiler.buffers)
+	{
+		const uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+
+		for (; tail < head; tail++)
+		{
+			profiler.samples.push_back(buffer->samples[tail % samplesPerThread]);
+		}
+
+		/* Hands the copied slots back to the owning thread. */
+		buffer->tail.store(tail, std::memory_order_release);
+	}
+
+	profiler.next_id.store(0, std::memory_order_relaxed);
+
+	profiler.UpdateScopeStats();
+
+	if (profiler.capture_frames_left == 0)
+	{
+		return;
+	}
+
+	for (const ProfilingSample& sample : profiler.samples)
+	{
+		if (profiler.captured.size() == profiler.captured.capacity())
+		{
+			/* The buffer is full, end the capture rather than growing it. */
+			profiler.capture_frames_left = 1;
+			break;
+		}
+
+		profiler.captured.push_back(
+			{sample.name, sample.start_time, sample.end_time, sample.thread, sample.depth, profiler.capture_frame});
+	}
+
+	profiler.capture_frame++;
+	profiler.capture_frames_left--;
+}
+
+void Mupfel::Profiler::StartCapture(uint32_t frames, uint32_t max_samples)
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	profiler.captured.clear();
+	profiler.captured.shrink_to_fit();
+	profiler.captured.reserve(max_samples);
+	profiler.capture_frames_left = frames;
+	profiler.capture_frame = 0;
+}
+
+void Mupfel::Profiler::StopCapture()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+	profiler.capture_frames_left = 0;
+}
+
+bool Mupfel::Profiler::IsCapturing()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+	return profiler.capture_frames_left > 0;
+}
+
+const std::vector<CapturedSample>& Mupfel::Profiler::GetCapturedSamples()
+{
+	return Get().captured;
+}
+
+/**
+ * @brief Writes \a text as a JSON string literal.
+ */
+static void WriteJsonString(std::ostream& out, std::string_view text)
+{
+	out << '"';
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '"':
+			out << "\\\"";
+			break;
+		case '\\':
+			out << "\\\\";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				out << std::format("\\u{:04x}", static_cast<unsigned char>(c));
+			}
+			else
+			{
+				out << c;
+			}
+		}
+	}
+	out << '"';
 }
 
-bool Mupfel::Profiler::IsClearing()
+Expected<void> Mupfel::Profiler::WriteChromeTrace(const std::string& path)
 {
-	return Get().is_clearing;
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	std::ofstream out(path, std::ios::trunc);
+
+	if (!out)
+	{
+		return std::unexpected<Error>(Error::FILE_NOT_FOUND);
+	}
+
+	/* Complete ("X") events with microsecond timestamps; nesting is recovered by the viewer from the times. */
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	std::set<uint32_t> threads;
+	bool			   first = true;
+
+	for (const CapturedSample& sample : profiler.captured)
+	{
+		out << (first ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(out, sample.name);
+		out << std::format(
+			",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"frame\":{},\"depth\":{}}}}}",
+			sample.thread, sample.start_time * 1e6, (sample.end_time - sample.start_time) * 1e6, sample.frame,
+			sample.depth);
+
+		threads.insert(sample.thread);
+		first = false;
+	}
+
+	/* Metadata events name the tracks. */
+	for (uint32_t thread : threads)
+	{
+		out << (first ? "\n" : ",\n")
+			<< std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},", thread)
+			<< std::format("\"args\":{{\"name\":\"Thread {}\"}}}}", thread);
+		first = false;
+	}
+
+	out << "\n]}\n";
+
+	if (!out)
+	{
+		return std::unexpected<Error>(Error::FILE_NOT_FOUND);
+	}
+
+	return {};
 }
 
 const std::vector<ProfilingSample>& Mupfel::Profiler::GetCurrentSamples()
@@ -119,17 +317,230 @@ const std::vector<ProfilingSample>& Mupfel::Profiler::GetCurrentSamples()
 	return Get().samples;
 }
 
+uint64_t Mupfel::Profiler::GetDroppedSamples()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	uint64_t dropped = 0;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : profiler.buffers)
+	{
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
+
 uint32_t Mupfel::Profiler::GetId()
 {
-	std::scoped_lock lock(Get().mutex);
-	uint32_t new_id = sample_id;
-	sample_id++;
-	return new_id;
+	return Get().next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+Mupfel::Profiler::ThreadBuffer::ThreadBuffer(uint32_t in_thread)
+	: samples(samplesPerThread, ProfilingSample{}), thread(in_thread)
+{
 }
 
 void Mupfel::Profiler::AddSample(ProfilingSample&& sample)
+{
+	ThreadBuffer&	 buffer = GetThreadBuffer();
+	ProfilingSample* slot = BeginWrite(buffer);
+
+	if (!slot)
+	{
+		return;
+	}
+
+	*slot = sample;
+	slot->thread = buffer.thread;
+
+	/* Publishes the slot to Clear. */
+	buffer.head.store(buffer.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Mupfel::Profiler::AddScope(const ProfileScopeInfo& info, uint64_t start, uint64_t end, uint32_t depth)
+{
+	ThreadBuffer&	 buffer = GetThreadBuffer();
+	ProfilingSample* slot = BeginWrite(buffer);
+
+	if (!slot)
+	{
+		return;
+	}
+
+	slot->name = info.name;
+	slot->id = 0;
+	slot->start_time = TicksToSeconds(start);
+	slot->end_time = TicksToSeconds(end);
+	slot->depth = depth;
+	slot->thread = buffer.thread;
+
+	buffer.head.store(buffer.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+ProfilingSample* Mupfel::Profiler::BeginWrite(ThreadBuffer& buffer)
+{
+	const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	if (head - buffer.tail.load(std::memory_order_acquire) >= samplesPerThread)
+	{
+		/* Nobody called Clear for a while; keep the older samples. */
+		buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	return &buffer.samples[head % samplesPerThread];
+}
+
+double Mupfel::Profiler::TicksToSeconds(uint64_t ticks) const
+{
+	return static_cast<double>(ticks) * tick_period + tick_offset;
+}
+
+Mupfel::Profiler::ThreadBuffer& Mupfel::Profiler::GetThreadBuffer()
+{
+	/* Set the first time the calling thread completes a sample. */
+	thread_local ThreadBuffer* thread_buffer = nullptr;
+
+	if (!thread_buffer)
+	{
+		std::scoped_lock lock(mutex);
+		const uint32_t thread = static_cast<uint32_t>(buffers.size());
+		thread_buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>(thread)).get();
+	}
+
+	return *thread_buffer;
+}
+
+std::vector<ScopeStats> Mupfel::Profiler::GetScopeStats()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	std::vector<ScopeStats> stats;
+	stats.reserve(profiler.scope_stats.size());
+
+	for (const auto& [name, histogram] : profiler.scope_stats)
+	{
+		stats.push_back(MakeScopeStats(name, histogram));
+	}
+
+	return stats;
+}
+
+std::optional<ScopeStats> Mupfel::Profiler::GetScopeStats(std::string_view name)
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	auto it = profiler.scope_stats.find(name);
+	if (it == profiler.scope_stats.end())
+	{
+		return std::nullopt;
+	}
+
+	return MakeScopeStats(it->first, it->second);
+}
+
+void Mupfel::Profiler::ResetScopeStats()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	profiler.scope_stats.clear();
+	profiler.stats_frame = 0;
+	profiler.scope_counters.clear();
+}
+
+void Mupfel::Profiler::SetCountersEnabled(bool enabled)
+{
+	Get().counters_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Mupfel::Profiler::AreCountersEnabled() { return Get().counters_enabled.load(std::memory_order_relaxed); }
+
+std::vector<ScopeCounters> Mupfel::Profiler::GetScopeCounters()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+
+	std::vector<ScopeCounters> counters;
+	counters.reserve(profiler.scope_counters.size());
+
+	for (const auto& [name, totals] : profiler.scope_counters)
+	{
+		counters.push_back({.name = name, .count = totals.first, .total = totals.second});
+	}
+
+	return counters;
+}
+
+void Mupfel::Profiler::AddCounters(std::string_view name, const PerfCounterValues& values)
 {
 	std::scoped_lock lock(mutex);
-	sample.active = false;
-	samples.push_back(std::move(sample));
+
+	auto it = scope_counters.find(name);
+	if (it == scope_counters.end())
+	{
+		it = scope_counters.emplace(std::string(name), std::pair<uint64_t, PerfCounterValues>{}).first;
+	}
+
+	it->second.first++;
+	it->second.second += values;
+}
+
+void Mupfel::Profiler::UpdateScopeStats()
+{
+	if (++stats_frame > statsWindowFrames)
+	{
+		for (auto& [name, histogram] : scope_stats)
+		{
+			histogram.previous = histogram.current;
+			histogram.current.Clear();
+		}
+		stats_frame = 1;
+	}
+
+	for (const ProfilingSample& sample : samples)
+	{
+		auto it = scope_stats.find(sample.name);
+		if (it == scope_stats.end())
+		{
+			it = scope_stats.emplace(std::string(sample.name), ScopeHistogram{}).first;
+		}
+
+		const double duration_ns = std::max(0.0, (sample.end_time - sample.start_time) * 1e9);
+		it->second.current.Record(static_cast<uint64_t>(duration_ns));
+	}
+}
+
+ScopeStats Mupfel::Profiler::MakeScopeStats(std::string_view name, const ScopeHistogram& histogram)
+{
+	LogHistogram both = histogram.previous;
+	both.Merge(histogram.current);
+
+	constexpr double ns_to_ms = 1e-6;
+
+	return {
+		.name = name,
+		.count = both.GetCount(),
+		.min_ms = static_cast<double>(both.GetMin()) * ns_to_ms,
+		.mean_ms = both.GetMean() * ns_to_ms,
+		.p50_ms = static_cast<double>(both.GetPercentile(50.0)) * ns_to_ms,
+		.p95_ms = static_cast<double>(both.GetPercentile(95.0)) * ns_to_ms,
+		.p99_ms = static_cast<double>(both.GetPercentile(99.0)) * ns_to_ms,
+		.max_ms = static_cast<double>(both.GetMax()) * ns_to_ms,
+	};
+}
+
+const ProfileScopeInfo& Mupfel::Profiler::RegisterScope(const ProfileScopeInfo& info)
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+	return profiler.scopes.emplace_back(info);
+}
+
+std::vector<ProfileScopeInfo> Mupfel::Profiler::GetRegisteredScopes()
+{
+	Profiler& profiler = Get();
+	std::scoped_lock lock(profiler.mutex);
+	return {profiler.scopes.begin(), profiler.scopes.end()};
 }
@@ -1,19 +1,364 @@
 #include "ResourceManager.h"
-#include <filesystem>
-#include <string>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <lz4.h>
+#include <system_error>
+#include <zstd.h>
 
 using namespace Mupfel;
 
+static size_t AlignUp(size_t offset) { return (offset + 15) & ~size_t{15}; }
+
+/** Compresses \a data; false if the codec failed or the result isn't smaller. */
+static bool Compress(ResourceManager::Compression compression, std::span<const std::byte> data,
+	std::vector<std::byte>& blob)
+{
+	switch (compression)
+	{
+	case ResourceManager::Compression::LZ4:
+	{
+		if (data.size() > LZ4_MAX_INPUT_SIZE)
+		{
+			return false;
+		}
+		blob.resize(LZ4_compressBound(static_cast<int>(data.size())));
+		const int size = LZ4_compress_default(reinterpret_cast<const char*>(data.data()),
+			reinterpret_cast<char*>(blob.data()), static_cast<int>(data.size()), static_cast<int>(blob.size()));
+		blob.resize(std::max(size, 0));
+		break;
+	}
+	case ResourceManager::Compression::Zstd:
+	{
+		blob.resize(ZSTD_compressBound(data.size()));
+		const size_t size = ZSTD_compress(blob.data(), blob.size(), data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+		blob.resize(ZSTD_isError(size) ? 0 : size);
+		break;
+	}
+	default:
+		return false;
+	}
+
+	return !blob.empty() && blob.size() < data.size();
+}
+
+/** Decompresses \a blob into \a out, which is exactly as large as the original data. */
+static bool Decompress(ResourceManager::Compression compression, std::span<const std::byte> blob,
+	std::span<std::byte> out)
+{
+	switch (compression)
+	{
+	case ResourceManager::Compression::LZ4:
+	{
+		if (blob.size() > std::numeric_limits<int>::max() || out.size() > std::numeric_limits<int>::max())
+		{
+			return false;
+		}
+		const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(blob.data()),
+			reinterpret_cast<char*>(out.data()), static_cast<int>(blob.size()), static_cast<int>(out.size()));
+		return size >= 0 && static_cast<size_t>(size) == out.size();
+	}
+	case ResourceManager::Compression::Zstd:
+	{
+		const size_t size = ZSTD_decompress(out.data(), out.size(), blob.data(), blob.size());
+		return !ZSTD_isError(size) && size == out.size();
+	}
+	default:
+		return false;
+	}
+}
+
 Mupfel::ResourceManager::ResourceManager() {}
 
-Mupfel::ResourceManager::~ResourceManager() { resourceFile.close(); }
+Mupfel::ResourceManager::~ResourceManager() {}
+
+bool Mupfel::ResourceManager::Load(const std::filesystem::path& file)
+{
+	Unload();
+
+	Expected<MappedFile> mapped = MappedFile::Open(file);
+	if (!mapped)
+	{
+		return false;
+	}
+	std::span<const std::byte> bytes = mapped->Data();
+
+	PackHeader header;
+	if (bytes.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	auto in_bounds = [&](uint64_t offset, uint64_t size)
+	{ return offset <= bytes.size() && size <= bytes.size() - offset; };
+
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion ||
+		!in_bounds(sizeof(header), uint64_t{header.entryCount} * sizeof(PackEntry)) ||
+		!in_bounds(header.namesOffset, header.namesSize))
+	{
+		return false;
+	}
+
+	/* The entry table directly follows the 32-byte header, so it can be used in place. */
+	std::span<const PackEntry> table(
+		reinterpret_cast<const PackEntry*>(bytes.data() + sizeof(header)), header.entryCount);
+	std::span<const char> name_block(reinterpret_cast<const char*>(bytes.data() + header.namesOffset),
+		header.namesSize);
+
+	for (const PackEntry& entry : table)
+	{
+		const bool known = entry.compression == Compression::None || entry.compression == Compression::LZ4 ||
+						   entry.compression == Compression::Zstd;
+		if (!known || !in_bounds(entry.offset, entry.size) ||
+			uint64_t{entry.nameOffset} + entry.nameLength > name_block.size() ||
+			(entry.compression == Compression::None && entry.size != entry.rawSize))
+		{
+			return false;
+		}
+	}
+
+	pack = std::move(*mapped);
+	entries = table;
+	names = name_block;
+
+	/* The lookup relies on the order, so a pack that isn't sorted is rejected rather than half-found. */
+	auto order = [this](const PackEntry& a, const PackEntry& b)
+	{ return a.hash != b.hash ? a.hash < b.hash : GetName(a) < GetName(b); };
+	if (!std::is_sorted(entries.begin(), entries.end(), order))
+	{
+		Unload();
+		return false;
+	}
+
+	decompressed.resize(entries.size());
+	return true;
+}
+
+bool Mupfel::ResourceManager::Save(const std::filesystem::path& file)
+{
+	/* Every entry that ends up in the pack, pointing either into the loaded pack or to an added file. */
+	struct Source
+	{
+		std::string_view		   name;
+		uint64_t				   hash;
+		std::span<const std::byte> blob;
+		uint64_t				   rawSize;
+		Compression				   compression;
+	};
+	std::vector<Source> sources;
+
+	for (const PendingFile& added : pending)
+	{
+		sources.push_back({added.name, Hash(added.name), added.blob, added.rawSize, added.compression});
+	}
+	for (const PackEntry& entry : entries)
+	{
+		const std::string_view name = GetName(entry);
+		if (std::ranges::none_of(pending, [&](const PendingFile& added) { return added.name == name; }))
+		{
+			sources.push_back({name, entry.hash, GetBlob(entry), entry.rawSize, entry.compression});
+		}
+	}
+
+	std::ranges::sort(sources, [](const Source& a, const Source& b)
+		{ return a.hash != b.hash ? a.hash < b.hash : a.name < b.name; });
+
+	/* Lay the pack out: header, entry table, names, then the blobs, 16-byte aligned. */
+	PackHeader header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = formatVersion;
+	header.entryCount = static_cast<uint32_t>(sources.size());
+	header.namesOffset = sizeof(PackHeader) + sources.size() * sizeof(PackEntry);
+
+	std::vector<PackEntry> table(sources.size());
+	std::string			   name_block;
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		table[i].hash = sources[i].hash;
+		table[i].nameOffset = static_cast<uint32_t>(name_block.size());
+		table[i].nameLength = static_cast<uint32_t>(sources[i].name.size());
+		name_block += sources[i].name;
+	}
+	header.namesSize = name_block.size();
+
+	size_t offset = AlignUp(header.namesOffset + header.namesSize);
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		table[i].offset = offset;
+		table[i].size = sources[i].blob.size();
+		table[i].rawSize = sources[i].rawSize;
+		table[i].compression = sources[i].compression;
+		offset = AlignUp(offset + sources[i].blob.size());
+	}
+
+	/* Write next to the target first: the blobs of the loaded pack may come from the file being replaced. */
+	std::filesystem::path temporary = file;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			return false;
+		}
+
+		size_t written = 0;
+		auto   write = [&](const void* bytes, size_t size, size_t at)
+		{
+			static constexpr char padding[16] = {};
+			out.write(padding, static_cast<std::streamsize>(at - written));
+			out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+			written = at + size;
+		};
+
+		write(&header, sizeof(header), 0);
+		write(table.data(), table.size() * sizeof(PackEntry), sizeof(header));
+		write(name_block.data(), name_block.size(), header.namesOffset);
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			write(sources[i].blob.data(), sources[i].blob.size(), table[i].offset);
+		}
+
+		if (!out)
+		{
+			return false;
+		}
+	}
+
+	/* The mapping has to go before the file under it can be replaced (on Windows). */
+	Unload();
+
+	std::error_code error;
+	std::filesystem::rename(temporary, file, error);
+	if (error)
+	{
+		return false;
+	}
+
+	pending.clear();
+	return Load(file);
+}
+
+std::span<const std::byte> Mupfel::ResourceManager::GetFile(std::string_view name) const
+{
+	const int64_t index = Find(name);
+	if (index < 0)
+	{
+		return {};
+	}
+
+	const PackEntry& entry = entries[index];
+	if (entry.compression == Compression::None)
+	{
+		return GetBlob(entry);
+	}
+
+	std::scoped_lock lock(decompressMutex);
+
+	if (!decompressed[index])
+	{
+		auto buffer = std::make_unique_for_overwrite<std::byte[]>(entry.rawSize);
+		if (!Decompress(entry.compression, GetBlob(entry), {buffer.get(), entry.rawSize}))
+		{
+			return {};
+		}
+		decompressed[index] = std::move(buffer);
+	}
+
+	return {decompressed[index].get(), entry.rawSize};
+}
+
+bool Mupfel::ResourceManager::Contains(std::string_view name) const { return Find(name) >= 0; }
+
+uint32_t Mupfel::ResourceManager::GetFileCount() const { return static_cast<uint32_t>(entries.size()); }
+
+bool Mupfel::ResourceManager::AddFile(const std::string& file, Compression compression)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		return false;
+	}
+
+	const std::vector<char> data{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+	return AddFile(std::filesystem::path(file).generic_string(), std::as_bytes(std::span(data)), compression);
+}
+
+bool Mupfel::ResourceManager::AddFile(std::string_view name, std::span<const std::byte> data,
+	Compression compression)
+{
+	if (name.empty())
+	{
+		return false;
+	}
+
+	PendingFile added{.name = std::string(name), .rawSize = data.size()};
+	if (compression != Compression::None && Compress(compression, data, added.blob))
+	{
+		added.compression = compression;
+	}
+	else
+	{
+		added.blob.assign(data.begin(), data.end());
+	}
+
+	/* Adding a name twice keeps the last one. */
+	auto it = std::ranges::find(pending, added.name, &PendingFile::name);
+	if (it != pending.end())
+	{
+		*it = std::move(added);
+	}
+	else
+	{
+		pending.push_back(std::move(added));
+	}
+	return true;
+}
+
+uint64_t Mupfel::ResourceManager::Hash(std::string_view name)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : name)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+int64_t Mupfel::ResourceManager::Find(std::string_view name) const
+{
+	const uint64_t hash = Hash(name);
+	auto it = std::ranges::lower_bound(entries, hash, {}, &PackEntry::hash);
 
-bool Mupfel::ResourceManager::Load(std::string_view file, std::string_view key)
-{ return true; }
+	/* Colliding hashes sit next to each other. */
+	for (; it != entries.end() && it->hash == hash; ++it)
+	{
+		if (GetName(*it) == name)
+		{
+			return it - entries.begin();
+		}
+	}
+	return -1;
+}
 
-bool Mupfel::ResourceManager::Save(std::string_view file, std::string_view key)
-{ return true; }
+std::string_view Mupfel::ResourceManager::GetName(const PackEntry& entry) const
+{
+	return {names.data() + entry.nameOffset, entry.nameLength};
+}
 
-ResourceManager::SafeBufferPtr Mupfel::ResourceManager::GetFile(std::string_view file) { return SafeBufferPtr(); }
+std::span<const std::byte> Mupfel::ResourceManager::GetBlob(const PackEntry& entry) const
+{
+	return pack.Data().subspan(entry.offset, entry.size);
+}
 
-bool Mupfel::ResourceManager::AddFile(const std::string& file) { return false; }
+void Mupfel::ResourceManager::Unload()
+{
+	std::scoped_lock lock(decompressMutex);
+	decompressed.clear();
+	entries = {};
+	names = {};
+	pack = MappedFile();
+}
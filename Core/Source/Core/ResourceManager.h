@@ -1,37 +1,142 @@
 #pragma once
-#include <array>
+#include "FS/MappedFile.h"
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
+#include <filesystem>
 #include <memory>
-#include <streambuf>
+#include <mutex>
+#include <span>
+#include <string>
 #include <string_view>
-#include <map>
 #include <vector>
 
 namespace Mupfel
 {
-class ResourceManager : public std::streambuf
+
+/**
+ * A resource pack: many files in one, opened with a single memory mapping.
+ *
+ * File layout (host byte order):
+ *
+ *     PackHeader
+ *     PackEntry[entryCount]  -- sorted by name hash, then by name
+ *     char names[]           -- the entry names back to back, not terminated
+ *     blobs                  -- one per entry, 16-byte aligned
+ *
+ * Entries are looked up by name with a binary search over the hashes. An uncompressed entry is handed
+ * out as a view into the mapping; a compressed one is decompressed on first access and kept until the
+ * next `Load`. Either way `GetFile` never copies more than once, and it is safe to call from several
+ * threads at the same time (e.g. from the image decoders on the thread pool).
+ *
+ * Packs are built with `AddFile` and `Save`. Names are the paths the engine asks for, e.g.
+ * "Assets/player.png", so a mounted pack can stand in for the files on disk.
+ */
+class ResourceManager
 {
-	using SafeBufferPtr = std::shared_ptr<std::vector<uint8_t>>;
-	static constexpr uint32_t MAX_FILE_NAME_LENGTH = 256;
+public:
+	/** How an entry's blob is stored. Entries that don't get smaller are stored uncompressed. */
+	enum class Compression : uint32_t
+	{
+		None = 0,
+		/** Fast to decompress; for data that is read often, like images. */
+		LZ4 = 1,
+		/** Smaller than LZ4 but slower to decompress; for large, rarely read data. */
+		Zstd = 2
+	};
+
+	static constexpr char	  magic[8] = {'M', 'U', 'P', 'F', 'P', 'A', 'C', 'K'};
+	static constexpr uint32_t formatVersion = 1;
+
+	struct PackHeader
+	{
+		char	 magic[8];
+		uint32_t version;
+		uint32_t entryCount;
+		/** Offset and size of the names block, from the start of the file. */
+		uint64_t namesOffset;
+		uint64_t namesSize;
+	};
+
+	struct PackEntry
+	{
+		uint64_t	hash;
+		/** Offset of the blob from the start of the file, and its size as stored. */
+		uint64_t	offset;
+		uint64_t	size;
+		/** Size after decompression; equals `size` for uncompressed entries. */
+		uint64_t	rawSize;
+		/** Offset of the name within the names block, and its length. */
+		uint32_t	nameOffset;
+		uint32_t	nameLength;
+		Compression compression;
+		uint32_t	reserved;
+	};
 
 public:
 	ResourceManager();
 	~ResourceManager();
-	bool		  Load(std::string_view file, std::string_view key);
-	bool		  Save(std::string_view file, std::string_view key);
-	SafeBufferPtr GetFile(std::string_view file);
-	bool		  AddFile(const std::string& file);
+
+	/**
+	 * Maps the pack \a file, replacing the one loaded before. Files added with `AddFile` are kept.
+	 *
+	 * \return False if \a file can't be opened or isn't a pack of this format version.
+	 */
+	bool Load(const std::filesystem::path& file);
+
+	/**
+	 * Writes the entries of the loaded pack together with the added files to \a file, then loads it.
+	 * Added files replace entries of the same name. \a file may be the loaded pack itself.
+	 */
+	bool Save(const std::filesystem::path& file);
+
+	/**
+	 * The contents of \a name, valid until the next `Load` or `Save`. Empty if the pack has no such entry
+	 * or it fails to decompress; use `Contains` to tell an empty file apart.
+	 */
+	std::span<const std::byte> GetFile(std::string_view name) const;
+
+	/** Whether the loaded pack has an entry called \a name. */
+	bool Contains(std::string_view name) const;
+
+	/** Number of entries in the loaded pack. */
+	uint32_t GetFileCount() const;
+
+	/** Reads \a file from disk and adds it to the next `Save`, named by its path as given. */
+	bool AddFile(const std::string& file, Compression compression = Compression::None);
+
+	/** Adds \a data to the next `Save` under \a name. */
+	bool AddFile(std::string_view name, std::span<const std::byte> data, Compression compression = Compression::None);
 
 private:
-	struct Resource
+	/** An added file, compressed already. */
+	struct PendingFile
 	{
-		uint32_t							   offset = 0;
-		uint32_t							   size = 0;
+		std::string			   name;
+		std::vector<std::byte> blob;
+		uint64_t			   rawSize = 0;
+		Compression			   compression = Compression::None;
 	};
 
-	std::map<std::string, Resource> fileMap;
-	std::ifstream							  resourceFile;
+	/** 64-bit FNV-1a; stored in the pack, so it must never change for a format version. */
+	static uint64_t Hash(std::string_view name);
+
+	/** Index of \a name in `entries`, or -1. */
+	int64_t Find(std::string_view name) const;
+
+	std::string_view GetName(const PackEntry& entry) const;
+
+	std::span<const std::byte> GetBlob(const PackEntry& entry) const;
+
+	void Unload();
+
+private:
+	MappedFile										  pack;
+	std::span<const PackEntry>						  entries;
+	std::span<const char>							  names;
+	/** Decompressed entries, indexed like `entries`; filled on first access. */
+	mutable std::vector<std::unique_ptr<std::byte[]>> decompressed;
+	mutable std::mutex								  decompressMutex;
+	std::vector<PendingFile>						  pending;
 };
 
 } // namespace Mupfel
@@ -0,0 +1,152 @@
+#include "SceneStreamer.h"
+#include "ECS/Components/Hierarchy.h"
+#include <algorithm>
+#include <chrono>
+#include <span>
+
+using namespace Mupfel;
+
+Mupfel::SceneStreamer::SceneStreamer(ThreadPool& in_pool) : pool(in_pool) {}
+
+Mupfel::SceneStreamer::~SceneStreamer()
+{
+	/* The job writes to the staging registry, which goes away with us. */
+	if (job.valid())
+	{
+		job.wait();
+	}
+}
+
+bool Mupfel::SceneStreamer::Begin(SceneHandle in_scene, StageFunction stage)
+{
+	if (IsStreaming())
+	{
+		return false;
+	}
+
+	scene = in_scene;
+	staging_events = std::make_unique<EventSystem>();
+	staging = std::make_unique<Registry>(*staging_events, pool);
+
+	job = pool.Enqueue(
+		[registry = staging.get(), stage = std::move(stage)]
+		{
+			stage(*registry);
+		});
+	return true;
+}
+
+bool Mupfel::SceneStreamer::Update(Registry& target, double budget)
+{
+	if (!IsStreaming())
+	{
+		return false;
+	}
+
+	if (job.valid())
+	{
+		if (job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return false;
+		}
+
+		try
+		{
+			job.get();
+		}
+		catch (...)
+		{
+			Finish();
+			throw;
+		}
+
+		staged = staging->GetActiveSceneEntities();
+		merged = 0;
+		targets.clear();
+		targets.reserve(staged.size());
+	}
+
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point deadline =
+		Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budget));
+
+	do
+	{
+		const size_t count = std::min<size_t>(sliceSize, staged.size() - merged);
+		const std::vector<Entity> created = target.Merge(*staging, std::span(staged).subspan(merged, count), scene);
+		targets.insert(targets.end(), created.begin(), created.end());
+		merged += count;
+	} while (merged < staged.size() && Clock::now() < deadline);
+
+	if (merged < staged.size())
+	{
+		return false;
+	}
+
+	Relink(target);
+	Finish();
+	return true;
+}
+
+bool Mupfel::SceneStreamer::IsStreaming() const { return staging != nullptr; }
+
+SceneHandle Mupfel::SceneStreamer::GetScene() const { return scene; }
+
+uint32_t Mupfel::SceneStreamer::GetRemaining() const
+{
+	return job.valid() ? 0 : static_cast<uint32_t>(staged.size() - merged);
+}
+
+void Mupfel::SceneStreamer::Relink(Registry& target)
+{
+	/* `staged` is in index order: a staged entity's position, and so its merged entity, is a binary search away. */
+	auto merged_of = [this](Entity e) -> const Entity*
+	{
+		const auto it = std::ranges::lower_bound(staged, e);
+		return (it != staged.end() && *it == e) ? &targets[it - staged.begin()] : nullptr;
+	};
+
+	const Entity::Signature linked = Registry::ComponentSignature<Parent, Children>();
+	for (size_t i = 0; i < staged.size(); i++)
+	{
+		const Entity::Signature sig = staging->GetSignature(staged[i]);
+		if ((sig & linked).none())
+		{
+			continue;
+		}
+
+		if (sig.test(ComponentIndex::Index<Parent>()))
+		{
+			Parent&		  parent = target.GetComponent<Parent>(targets[i]);
+			const Entity* merged_parent = merged_of(parent.entity);
+			if (merged_parent)
+			{
+				parent.entity = *merged_parent;
+			}
+			else
+			{
+				target.RemoveComponent<Parent>(targets[i]);
+			}
+		}
+
+		if (sig.test(ComponentIndex::Index<Children>()))
+		{
+			std::vector<Entity>& children = target.GetComponent<Children>(targets[i]).entities;
+			std::erase_if(children, [&](Entity child) { return merged_of(child) == nullptr; });
+			for (Entity& child : children)
+			{
+				child = *merged_of(child);
+			}
+		}
+	}
+}
+
+void Mupfel::SceneStreamer::Finish()
+{
+	scene = Scene::INVALID_HANDLE;
+	staging.reset();
+	staging_events.reset();
+	staged.clear();
+	targets.clear();
+	merged = 0;
+}
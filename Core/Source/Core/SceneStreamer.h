@@ -0,0 +1,88 @@
+#pragma once
+#include "Core/EventSystem.h"
+#include "Core/Scene.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Entity.h"
+#include "ECS/Registry.h"
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Streams a scene into the live registry without a frame hitch.
+ *
+ * `Begin` runs the scene's stage function on the thread pool, which builds its entities in a staging
+ * `Registry` with its own `EventSystem`; the live registry isn't touched. Once that is done, `Update`,
+ * called once per frame on the main thread, moves the staged entities over with `Registry::Merge`,
+ * `sliceSize` entities at a time, until the frame's time budget is used up. At least one slice is
+ * merged per frame, so every stream finishes.
+ *
+ * `Parent` and `Children` links between staged entities are carried over: once the last slice is merged,
+ * they are pointed at the merged entities.
+ *
+ * The stage function runs on a pool thread: it may only use the staging registry and data nobody
+ * writes to in the meantime, and it must not wait for other pool jobs (e.g. `ParallelForEach`).
+ */
+class SceneStreamer
+{
+public:
+	using StageFunction = std::function<void(Registry& staging)>;
+
+	/** Staged entities are merged this many at a time. */
+	static constexpr uint32_t sliceSize = 1024;
+
+	explicit SceneStreamer(ThreadPool& in_pool);
+
+	/** Waits for a stage function that is still running. */
+	~SceneStreamer();
+
+	/**
+	 * Starts staging \a scene: \a stage is queued on the thread pool.
+	 *
+	 * \return False, and nothing is queued, if a stream is still in flight.
+	 */
+	bool Begin(SceneHandle scene, StageFunction stage);
+
+	/**
+	 * Merges staged entities into \a scene of \a target for about \a budget seconds; does nothing while
+	 * the stage function is still running.
+	 *
+	 * \return True in the frame the last staged entity was merged; the streamer is idle again after it.
+	 */
+	bool Update(Registry& target, double budget);
+
+	/** Whether a stream has begun and not been merged completely. */
+	bool IsStreaming() const;
+
+	/** The scene being streamed, `Scene::INVALID_HANDLE` if none is. */
+	SceneHandle GetScene() const;
+
+	/** Staged entities that are still to be merged; 0 while the stage function runs. */
+	uint32_t GetRemaining() const;
+
+private:
+	/** Points the hierarchy links of the merged entities, which still name staged ones, at merged ones. */
+	void Relink(Registry& target);
+
+	/** Drops the staging registry and goes back to idle. */
+	void Finish();
+
+private:
+	ThreadPool&					 pool;
+	SceneHandle					 scene = Scene::INVALID_HANDLE;
+	std::unique_ptr<EventSystem> staging_events;
+	std::unique_ptr<Registry>	 staging;
+	std::future<void>			 job;
+	/** Every entity of the staging registry, once the stage function is done; merged front to back. */
+	std::vector<Entity> staged;
+	/** The entity each of `staged` was merged as, so far. */
+	std::vector<Entity> targets;
+	size_t				merged = 0;
+};
+
+} // namespace Mupfel
@@ -2,7 +2,12 @@
 #include "Renderer/Renderer.h"
 #include "Application.h"
 
-uint32_t Mupfel::UI::Button(float x, float y, float width, float height, const std::string& image_path)
+uint32_t Mupfel::UI::Button(float x, float y, float width, float height, UIImage image)
 {
-	return Application::Get().renderer->uiRenderer->Button(x, y, width, height, image_path);
+	return Application::Get().renderer->uiRenderer->Button(x, y, width, height, image);
+}
+
+void Mupfel::UI::Image(float x, float y, float width, float height, ImageHandle image, float rotation)
+{
+	Application::Get().renderer->uiRenderer->Image(x, y, width, height, image, rotation);
 }
@@ -56,3 +56,21 @@ void Mupfel::EntityManager::DestroyEntity(Entity e)
 }
 
 uint32_t Mupfel::EntityManager::GetCurrentEntities() const { return current_entities; }
+
+uint32_t Mupfel::EntityManager::GetIndexCount() const { return next_entity_index; }
+
+MemoryUsage Mupfel::EntityManager::GetMemoryUsage() const
+{
+	return MemoryUsage::Of(freeList) + MemoryUsage::Of(alive);
+}
+
+void Mupfel::EntityManager::ShrinkToFit()
+{
+	if (next_entity_index < alive.size())
+	{
+		alive.resize(next_entity_index);
+	}
+
+	alive.shrink_to_fit();
+	freeList.shrink_to_fit();
+}
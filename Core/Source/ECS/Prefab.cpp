@@ -0,0 +1,138 @@
+#include "Prefab.h"
+#include "Registry.h"
+#include "ECS/Components/Hierarchy.h"
+#include <unordered_map>
+
+using namespace Mupfel;
+
+Mupfel::Prefab::Prefab(Registry& source, std::span<const Entity> entities)
+{
+	std::vector<Entity> local;
+	local.reserve(entities.size());
+	for (const Entity e : entities)
+	{
+		local.push_back(CreateEntity());
+		signatures.back() = source.GetSignature(e);
+	}
+
+	/* The components live in the partitions of the entities' scenes. */
+	Scene::SceneMask scenes;
+	for (const Entity e : entities)
+	{
+		const SceneHandle scene = source.GetScene(e);
+		if (scene != Scene::INVALID_HANDLE)
+		{
+			scenes.set(scene);
+		}
+	}
+
+	std::vector<Entity> copied;
+	for (SceneHandle scene = 0; scene < Scene::MAX_SCENES; scene++)
+	{
+		if (!scenes.test(scene))
+		{
+			continue;
+		}
+
+		const std::vector<Registry::SafeComponentArrayPtr>& buffer = source.component_buffers[scene];
+		if (columns.size() < buffer.size())
+		{
+			columns.resize(buffer.size());
+		}
+
+		for (size_t id = 0; id < buffer.size(); id++)
+		{
+			const IComponentArray* from = buffer[id].get();
+			if (!from || from->Size() == 0)
+			{
+				continue;
+			}
+
+			if (!columns[id])
+			{
+				columns[id] = from->CreateEmpty();
+			}
+			from->CopyTo(*columns[id], entities, local, copied);
+		}
+	}
+
+	Relink(entities);
+
+	/* Types none of the entities had leave no column behind. */
+	for (std::unique_ptr<IComponentArray>& column : columns)
+	{
+		if (column && column->Size() == 0)
+		{
+			column.reset();
+		}
+	}
+}
+
+void Mupfel::Prefab::Relink(std::span<const Entity> sources)
+{
+	const size_t parent_id = ComponentIndex::Index<Parent>();
+	const size_t children_id = ComponentIndex::Index<Children>();
+	const bool	 has_parents = parent_id < columns.size() && columns[parent_id];
+	const bool	 has_children = children_id < columns.size() && columns[children_id];
+	if (!has_parents && !has_children)
+	{
+		return;
+	}
+
+	std::unordered_map<uint32_t, uint32_t> local_of;
+	for (uint32_t i = 0; i < sources.size(); i++)
+	{
+		local_of.emplace(sources[i].Index(), i);
+	}
+
+	if (has_parents)
+	{
+		ComponentArray<Parent>& column = GetColumn<Parent>();
+		std::vector<Entity>		cut;
+		for (size_t slot = 0; slot < column.dense.size(); slot++)
+		{
+			const auto it = local_of.find(column.components[slot].entity.Index());
+			if (it == local_of.end())
+			{
+				cut.push_back(Entity(column.dense[slot]));
+				continue;
+			}
+			column.components[slot].entity = Entity(it->second);
+		}
+
+		/* Their parent stays behind: in every copy they are roots. */
+		for (const Entity e : cut)
+		{
+			column.Remove(e);
+			signatures[e.Index()].reset(parent_id);
+		}
+	}
+
+	if (has_children)
+	{
+		for (Children& children : GetColumn<Children>().components)
+		{
+			std::erase_if(children.entities, [&](Entity child) { return !local_of.contains(child.Index()); });
+			for (Entity& child : children.entities)
+			{
+				child = Entity(local_of.at(child.Index()));
+			}
+		}
+	}
+}
+
+Entity Mupfel::Prefab::CreateEntity()
+{
+	const Entity e(static_cast<uint32_t>(signatures.size()));
+	signatures.push_back(Entity::Signature(0x0));
+	return e;
+}
+
+uint32_t Mupfel::Prefab::GetEntityCount() const { return static_cast<uint32_t>(signatures.size()); }
+
+Entity::Signature Mupfel::Prefab::GetSignature(Entity e) const
+{
+	assert(e.Index() < signatures.size() && "Entity does not belong to this prefab!");
+
+	return signatures[e.Index()];
+}
@@ -1,5 +1,10 @@
 #include "Registry.h"
+#include "Prefab.h"
+#include "ECS/Components/Hierarchy.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <iterator>
 
 using namespace Mupfel;
 
@@ -18,17 +23,17 @@ Entity Registry::CreateEntity()
 		signatures[e.Index()] = 0x0;
 	}
 
-	/* Update the scene mask of the Entity */
-	if (sceneMask.size() <= e.Index()) [[unlikely]]
+	/* Update the scene of the Entity */
+	if (entity_scenes.size() <= e.Index()) [[unlikely]]
 	{
-		sceneMask.resize((sceneMask.size() + 1) * 2, Scene::SceneMask(0x0));
+		entity_scenes.resize((entity_scenes.size() + 1) * 2, Scene::INVALID_HANDLE);
 	}
 
 	/*
 	 * Must happen after the resize, not as its else-branch: an entity that triggers the grow needs
-	 * its mask set too, and a zero mask means "in no scene at all" (unlike a zero signature).
+	 * its scene set too, and the fill value means "in no scene at all" (unlike a zero signature).
 	 */
-	sceneMask[e.Index()] = SceneMask(active_scene);
+	entity_scenes[e.Index()] = active_scene;
 
 	/* Entity is created successfully, notify everyone */
 	evt_system.AddImmediateEvent<EntityCreatedEvent>(e);
@@ -36,6 +41,255 @@ Entity Registry::CreateEntity()
 	return e;
 }
 
+std::vector<Entity> Mupfel::Registry::CreateEntities(uint32_t count) { return CreateEntities(count, active_scene); }
+
+std::vector<Entity> Mupfel::Registry::CreateEntities(uint32_t count, SceneHandle scene)
+{
+	std::vector<Entity> out = AllocateEntities(count, scene);
+
+	if (evt_system.HasListeners<EntityCreatedEvent>())
+	{
+		for (const Entity e : out)
+		{
+			evt_system.NotifyListeners<EntityCreatedEvent>(e);
+		}
+	}
+
+	return out;
+}
+
+std::vector<Entity> Mupfel::Registry::AllocateEntities(uint32_t count, SceneHandle scene)
+{
+	assert((scene < Scene::MAX_SCENES) && "Scene handle out of range!");
+
+	std::vector<Entity> out;
+	out.reserve(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		out.push_back(entity_manager.CreateEntity());
+	}
+
+	/*
+		Every index handed out so far is below the index count. Unlike CreateEntity, grow both vectors to
+		exactly that: the batch size is known, and doubling a million 32-byte signatures costs more than it saves.
+	*/
+	const size_t needed = entity_manager.GetIndexCount();
+	if (signatures.size() < needed)
+	{
+		signatures.resize(needed, Entity::Signature(0x0));
+	}
+	if (entity_scenes.size() < needed)
+	{
+		entity_scenes.resize(needed, Scene::INVALID_HANDLE);
+	}
+
+	for (const Entity e : out)
+	{
+		signatures[e.Index()] = 0x0;
+		entity_scenes[e.Index()] = scene;
+	}
+
+	return out;
+}
+
+std::vector<Entity> Mupfel::Registry::Merge(Registry& source, std::span<const Entity> entities, SceneHandle scene)
+{
+	auto is_alive = [&source](Entity e) { return source.entity_manager.IsAlive(e); };
+
+	/* Dead entities are in no scene and have nothing to copy, so they aren't merged. Usually all are alive. */
+	std::span<const Entity> from = entities;
+	std::vector<Entity>		alive;
+	if (!std::ranges::all_of(entities, is_alive))
+	{
+		std::ranges::copy_if(entities, std::back_inserter(alive), is_alive);
+		from = alive;
+	}
+	const std::vector<Entity> to = CreateEntities(static_cast<uint32_t>(from.size()), scene);
+
+	/* The source components live in the partitions of their entities' scenes, usually all in one. */
+	Scene::SceneMask source_scenes;
+	for (const Entity e : from)
+	{
+		source_scenes.set(source.entity_scenes[e.Index()]);
+	}
+
+	std::vector<SafeComponentArrayPtr>& buffer = SceneBuffer(scene);
+	std::vector<Entity>					copied;
+	for (SceneHandle from_scene = 0; from_scene < Scene::MAX_SCENES; from_scene++)
+	{
+		if (!source_scenes.test(from_scene))
+		{
+			continue;
+		}
+
+		const std::vector<SafeComponentArrayPtr>& from_buffer = source.component_buffers[from_scene];
+		if (buffer.size() < from_buffer.size())
+		{
+			buffer.resize(from_buffer.size());
+		}
+
+		for (size_t id = 0; id < from_buffer.size(); id++)
+		{
+			const IComponentArray* from_array = from_buffer[id].get();
+			if (!from_array || from_array->Size() == 0)
+			{
+				continue;
+			}
+
+			if (!buffer[id])
+			{
+				buffer[id] = from_array->CreateEmpty();
+			}
+			from_array->CopyTo(*buffer[id], from, to, copied);
+
+			for (const Entity e : copied)
+			{
+				signatures[e.Index()].set(id);
+			}
+
+			if (evt_system.HasListeners<ComponentAddedEvent>())
+			{
+				for (const Entity e : copied)
+				{
+					evt_system.NotifyListeners<ComponentAddedEvent>({e, signatures[e.Index()], id});
+				}
+			}
+		}
+	}
+
+	if (from.size() == entities.size())
+	{
+		return to;
+	}
+
+	/* No registry hands out index 0, so it can't be mistaken for a merged entity. */
+	std::vector<Entity> created(entities.size(), Entity(0));
+	for (size_t i = 0, next = 0; i < entities.size(); i++)
+	{
+		if (is_alive(entities[i]))
+		{
+			created[i] = to[next++];
+		}
+	}
+	return created;
+}
+
+std::vector<Entity> Mupfel::Registry::Instantiate(const Prefab& prefab, uint32_t count)
+{
+	return Instantiate(prefab, count, active_scene);
+}
+
+std::vector<Entity> Mupfel::Registry::Instantiate(const Prefab& prefab, uint32_t count, SceneHandle scene)
+{
+	const uint32_t		stride = prefab.GetEntityCount();
+	std::vector<Entity> created = AllocateEntities(stride * count, scene);
+
+	std::vector<SafeComponentArrayPtr>& buffer = SceneBuffer(scene);
+	if (buffer.size() < prefab.columns.size())
+	{
+		buffer.resize(prefab.columns.size());
+	}
+
+	for (size_t id = 0; id < prefab.columns.size(); id++)
+	{
+		const IComponentArray* column = prefab.columns[id].get();
+		if (!column)
+		{
+			continue;
+		}
+
+		if (!buffer[id])
+		{
+			buffer[id] = column->CreateEmpty();
+		}
+		column->CloneTo(*buffer[id], created, count, stride);
+	}
+
+	/* Hierarchy links name prefab entities; every copy's links now name the entities of that copy. */
+	auto in_copy = [&](uint32_t copy, Entity local)
+	{
+		return created[static_cast<size_t>(copy) * stride + local.Index()];
+	};
+
+	const size_t parent_id = ComponentIndex::Index<Parent>();
+	if (parent_id < prefab.columns.size() && prefab.columns[parent_id])
+	{
+		const auto&			   column = static_cast<const ComponentArray<Parent>&>(*prefab.columns[parent_id]);
+		ComponentArray<Parent>& links = GetComponentArray<Parent>(scene);
+		for (uint32_t k = 0; k < count; k++)
+		{
+			for (size_t slot = 0; slot < column.dense.size(); slot++)
+			{
+				links.Get(in_copy(k, Entity(column.dense[slot]))).entity = in_copy(k, column.components[slot].entity);
+			}
+		}
+	}
+
+	const size_t children_id = ComponentIndex::Index<Children>();
+	if (children_id < prefab.columns.size() && prefab.columns[children_id])
+	{
+		const auto&				 column = static_cast<const ComponentArray<Children>&>(*prefab.columns[children_id]);
+		ComponentArray<Children>& links = GetComponentArray<Children>(scene);
+		for (uint32_t k = 0; k < count; k++)
+		{
+			for (size_t slot = 0; slot < column.dense.size(); slot++)
+			{
+				std::vector<Entity>& children = links.Get(in_copy(k, Entity(column.dense[slot]))).entities;
+				for (Entity& child : children)
+				{
+					child = in_copy(k, child);
+				}
+			}
+		}
+	}
+
+	/* The new entities' signatures are all empty, so the prefab's are simply copied over. */
+	for (size_t i = 0; i < created.size(); i++)
+	{
+		signatures[created[i].Index()] = prefab.signatures[i % stride];
+	}
+
+	evt_system.AddImmediateEvent<PrefabInstantiatedEvent>({created, stride});
+
+	return created;
+}
+
+bool Mupfel::Registry::Defragment(double budget)
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point deadline =
+		Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budget));
+
+	const std::vector<SafeComponentArrayPtr>& buffer = component_buffers[active_scene];
+	if (buffer.empty())
+	{
+		return true;
+	}
+
+	/*
+		Round robin over the arrays. One in order is passed in no time, so only slices of work check the
+		deadline: a call always gets through at least one, and ends once every array in a row is in order.
+	*/
+	for (size_t in_order = 0; in_order < buffer.size();)
+	{
+		defrag_cursor %= buffer.size();
+		IComponentArray* array = buffer[defrag_cursor].get();
+		if (array && !array->Defragment(defragSlice))
+		{
+			in_order = 0;
+			if (Clock::now() >= deadline)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		defrag_cursor++;
+		in_order++;
+	}
+	return true;
+}
+
 void Registry::DestroyEntity(Entity e)
 {
 	/* Check if the entity is alive. */
@@ -47,10 +301,11 @@ void Registry::DestroyEntity(Entity e)
 	/* Create an Entity Destroyed Event to give all Listeners time to react */
 	evt_system.AddImmediateEvent<EntityDestroyedEvent>(e);
 
-	/* We have to remove the entity from all component lists */
-	for (uint32_t i = 0; i < component_buffer.size(); i++)
+	/* We have to remove the entity from all component lists of its scene */
+	const std::vector<SafeComponentArrayPtr>& buffer = component_buffers[entity_scenes[e.Index()]];
+	for (uint32_t i = 0; i < buffer.size(); i++)
 	{
-		IComponentArray* storage = component_buffer[i].get();
+		IComponentArray* storage = buffer[i].get();
 
 		if (!storage || !storage->Has(e))
 		{
@@ -63,11 +318,87 @@ void Registry::DestroyEntity(Entity e)
 
 	entity_manager.DestroyEntity(e);
 	signatures[e.Index()].reset();
-	sceneMask[e.Index()].reset();
+	entity_scenes[e.Index()] = Scene::INVALID_HANDLE;
 }
 
 uint32_t Registry::GetCurrentEntities() const { return entity_manager.GetCurrentEntities(); }
 
+std::vector<Entity> Mupfel::Registry::GetActiveSceneEntities() const
+{
+	const uint32_t index_count = entity_manager.GetIndexCount();
+
+	/* Dead indices are in no scene. */
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < index_count; i++)
+	{
+		if (entity_scenes[i] == active_scene)
+		{
+			entities.push_back(Entity(i));
+		}
+	}
+	return entities;
+}
+
+RegistryMemoryUsage Mupfel::Registry::GetMemoryUsage() const
+{
+	RegistryMemoryUsage usage;
+	usage.entities = MemoryUsage::Of(signatures) + MemoryUsage::Of(entity_scenes) + entity_manager.GetMemoryUsage();
+
+	/* One entry per component type, summed over the scene partitions. */
+	for (const std::vector<SafeComponentArrayPtr>& buffer : component_buffers)
+	{
+		for (const SafeComponentArrayPtr& storage : buffer)
+		{
+			if (!storage)
+			{
+				continue;
+			}
+
+			const size_t id = storage->ComponentID();
+			auto		 entry = std::ranges::find(usage.components, id, &ComponentMemoryUsage::componentID);
+			if (entry == usage.components.end())
+			{
+				usage.components.push_back({.name = storage->ComponentName(), .componentID = id});
+				entry = usage.components.end() - 1;
+			}
+			entry->count += storage->Size();
+			entry->memory += storage->GetMemoryUsage();
+		}
+	}
+
+	std::ranges::sort(usage.components, {}, &ComponentMemoryUsage::componentID);
+	return usage;
+}
+
+void Mupfel::Registry::ShrinkToFit()
+{
+	/* CreateEntity grows both vectors again once an index beyond their size is handed out. */
+	const size_t needed = entity_manager.GetIndexCount();
+	if (needed < signatures.size())
+	{
+		signatures.resize(needed);
+	}
+	if (needed < entity_scenes.size())
+	{
+		entity_scenes.resize(needed);
+	}
+
+	signatures.shrink_to_fit();
+	entity_scenes.shrink_to_fit();
+	entity_manager.ShrinkToFit();
+
+	for (const std::vector<SafeComponentArrayPtr>& buffer : component_buffers)
+	{
+		for (const SafeComponentArrayPtr& storage : buffer)
+		{
+			if (storage)
+			{
+				storage->ShrinkToFit();
+			}
+		}
+	}
+}
+
 Entity::Signature Registry::GetSignature(Entity entity) const
 {
 	assert((entity.Index() < signatures.size()) && "Given Entity was not created correctly!");
@@ -77,9 +408,22 @@ Entity::Signature Registry::GetSignature(Entity entity) const
 
 Scene::SceneMask Mupfel::Registry::GetSceneMask(Entity entity) const
 {
-	assert((entity.Index() < sceneMask.size()) && "Given Entity was not created correctly!");
+	assert((entity.Index() < entity_scenes.size()) && "Given Entity was not created correctly!");
+
+	const SceneHandle scene = entity_scenes[entity.Index()];
+	return (scene == Scene::INVALID_HANDLE) ? Scene::SceneMask() : SceneMask(scene);
+}
+
+SceneHandle Mupfel::Registry::GetScene(Entity entity) const
+{
+	return (entity.Index() < entity_scenes.size()) ? entity_scenes[entity.Index()] : Scene::INVALID_HANDLE;
+}
+
+std::vector<Registry::SafeComponentArrayPtr>& Mupfel::Registry::SceneBuffer(SceneHandle scene)
+{
+	assert((scene < Scene::MAX_SCENES) && "Scene handle out of range!");
 
-	return sceneMask[entity.Index()];
+	return component_buffers[scene];
 }
 
 void Mupfel::Registry::SetActiveScene(SceneHandle scene)
@@ -0,0 +1,364 @@
+#include "TransformSystem.h"
+#include "ECS/ECSEvents.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <utility>
+
+using namespace Mupfel;
+
+namespace
+{
+
+const Transform identity{};
+
+bool Same(const Transform& a, const Transform& b)
+{
+	return a.pos_x == b.pos_x && a.pos_y == b.pos_y && a.pos_z == b.pos_z && a.scale_x == b.scale_x &&
+		   a.scale_y == b.scale_y && a.rotation == b.rotation;
+}
+
+WorldTransform Root(const Transform& local)
+{
+	WorldTransform world;
+	world.pos_x = local.pos_x;
+	world.pos_y = local.pos_y;
+	world.pos_z = local.pos_z;
+	world.scale_x = local.scale_x;
+	world.scale_y = local.scale_y;
+	world.rotation = local.rotation;
+	world.cos_rotation = std::cos(local.rotation);
+	world.sin_rotation = std::sin(local.rotation);
+	return world;
+}
+
+/** \a local placed in the frame of \a parent: scaled by it, then rotated by it, then moved to it. */
+WorldTransform Compose(const WorldTransform& parent, const Transform& local)
+{
+	const float x = parent.scale_x * local.pos_x;
+	const float y = parent.scale_y * local.pos_y;
+
+	WorldTransform world;
+	world.pos_x = parent.pos_x + parent.cos_rotation * x - parent.sin_rotation * y;
+	world.pos_y = parent.pos_y + parent.sin_rotation * x + parent.cos_rotation * y;
+	world.pos_z = parent.pos_z + local.pos_z;
+	world.scale_x = parent.scale_x * local.scale_x;
+	world.scale_y = parent.scale_y * local.scale_y;
+	world.rotation = parent.rotation + local.rotation;
+	world.cos_rotation = std::cos(world.rotation);
+	world.sin_rotation = std::sin(world.rotation);
+	return world;
+}
+
+} // namespace
+
+Mupfel::TransformSystem::TransformSystem(Registry& in_registry, EventSystem& in_evt_system, ThreadPool& in_pool)
+	: registry(in_registry), evt_system(in_evt_system), pool(in_pool)
+{
+}
+
+void Mupfel::TransformSystem::Init()
+{
+	const size_t			parent_id = ComponentIndex::Index<Parent>();
+	const size_t			world_id = ComponentIndex::Index<WorldTransform>();
+	const Entity::Signature linked = Registry::ComponentSignature<Parent, Children, WorldTransform>();
+
+	evt_system.RegisterListener<ComponentAddedEvent>(
+		[this, parent_id](const ComponentAddedEvent& event)
+		{
+			if (event.comp_id == parent_id)
+			{
+				structure_dirty = true;
+			}
+		});
+
+	evt_system.RegisterListener<ComponentRemovedEvent>(
+		[this, parent_id, world_id](const ComponentRemovedEvent& event)
+		{
+			if (event.comp_id == parent_id || event.comp_id == world_id)
+			{
+				structure_dirty = true;
+			}
+		});
+
+	evt_system.RegisterListener<EntityDestroyedEvent>(
+		[this, linked](const EntityDestroyedEvent& event)
+		{
+			const Entity::Signature sig = registry.GetSignature(event.e);
+			if ((sig & linked).none())
+			{
+				return;
+			}
+			structure_dirty = true;
+
+			/* The children become roots, rather than children of whatever entity gets the index next. */
+			if (registry.HasComponent<Children>(event.e))
+			{
+				const std::vector<Entity> children = registry.GetComponent<Children>(event.e).entities;
+				for (const Entity child : children)
+				{
+					if (registry.HasComponent<Parent>(child) && registry.GetComponent<Parent>(child).entity == event.e)
+					{
+						registry.RemoveComponent<Parent>(child);
+					}
+				}
+			}
+			Detach(registry, event.e);
+		});
+
+	evt_system.RegisterListener<PrefabInstantiatedEvent>(
+		[this, parent_id](const PrefabInstantiatedEvent& event)
+		{
+			/* Every copy has the same signatures: the first one tells. */
+			const size_t count = std::min<size_t>(event.stride, event.entities.size());
+			for (size_t i = 0; i < count; i++)
+			{
+				if (registry.GetSignature(event.entities[i]).test(parent_id))
+				{
+					structure_dirty = true;
+					return;
+				}
+			}
+		});
+}
+
+void Mupfel::TransformSystem::Update()
+{
+	if (structure_dirty || registry.GetActiveScene() != built_scene)
+	{
+		Rebuild();
+		structure_dirty = false;
+	}
+
+	locals = &registry.GetComponentArray<Transform>(built_scene);
+	worlds = &registry.GetComponentArray<WorldTransform>(built_scene);
+	updated = 0;
+
+	/* Other entities' components coming and going can move nodes out of place; `Defragment` leaves that to us. */
+	if (locals->OrderBroken() || worlds->OrderBroken())
+	{
+		worlds->Arrange(order);
+		locals->Arrange(order);
+	}
+
+	const uint32_t				   num_threads = std::max<uint32_t>(1u, static_cast<uint32_t>(pool.GetThreadCount()));
+	std::vector<std::future<uint32_t>> jobs;
+
+	/* A level only reads the one above it, which is complete once all its jobs are. */
+	for (size_t level = 0; level + 1 < level_begin.size(); level++)
+	{
+		const uint32_t begin = level_begin[level];
+		const uint32_t end = level_begin[level + 1];
+
+		if (end - begin < parallelThreshold || num_threads == 1)
+		{
+			updated += UpdateRange(begin, end);
+			continue;
+		}
+
+		const uint32_t chunk = (end - begin + num_threads - 1) / num_threads;
+		jobs.clear();
+		for (uint32_t first = begin; first < end; first += chunk)
+		{
+			const uint32_t last = std::min(first + chunk, end);
+			jobs.push_back(pool.Enqueue([this, first, last] { return UpdateRange(first, last); }));
+		}
+		for (std::future<uint32_t>& job : jobs)
+		{
+			updated += job.get();
+		}
+	}
+
+	force = false;
+}
+
+void Mupfel::TransformSystem::Invalidate() { force = true; }
+
+uint32_t Mupfel::TransformSystem::GetNodeCount() const { return static_cast<uint32_t>(order.size()); }
+
+uint32_t Mupfel::TransformSystem::GetDepth() const
+{
+	return level_begin.empty() ? 0 : static_cast<uint32_t>(level_begin.size() - 1);
+}
+
+uint32_t Mupfel::TransformSystem::GetUpdatedNodes() const { return updated; }
+
+bool Mupfel::TransformSystem::Attach(Registry& registry, Entity child, Entity parent)
+{
+	const SceneHandle scene = registry.GetScene(child);
+	if (scene == Scene::INVALID_HANDLE || registry.GetScene(parent) != scene)
+	{
+		return false;
+	}
+
+	/* Links only ever pass Attach, so walking up from the parent always ends. */
+	for (Entity ancestor = parent;;)
+	{
+		if (ancestor == child)
+		{
+			return false;
+		}
+		if (!registry.HasComponent<Parent>(ancestor))
+		{
+			break;
+		}
+		ancestor = registry.GetComponent<Parent>(ancestor).entity;
+	}
+
+	Detach(registry, child);
+	registry.AddComponent<Parent>(child, Parent{parent});
+	if (!registry.HasComponent<Children>(parent))
+	{
+		registry.AddComponent<Children>(parent, Children{});
+	}
+	registry.GetComponent<Children>(parent).entities.push_back(child);
+	return true;
+}
+
+void Mupfel::TransformSystem::Detach(Registry& registry, Entity child)
+{
+	if (!registry.HasComponent<Parent>(child))
+	{
+		return;
+	}
+
+	const Entity parent = registry.GetComponent<Parent>(child).entity;
+	if (registry.HasComponent<Children>(parent))
+	{
+		std::erase(registry.GetComponent<Children>(parent).entities, child);
+	}
+	registry.RemoveComponent<Parent>(child);
+}
+
+void Mupfel::TransformSystem::Rebuild()
+{
+	built_scene = registry.GetActiveScene();
+	order.clear();
+	parents.clear();
+	level_begin.clear();
+
+	/* Every link of the active scene as (parent, child), grouped by parent. */
+	std::vector<std::pair<Entity, Entity>> links;
+	for (auto [child, parent] : registry.view<Parent>())
+	{
+		links.emplace_back(parent.entity, child);
+	}
+	std::ranges::sort(links);
+
+	auto in_scene = [this](Entity e) { return registry.GetScene(e) == built_scene; };
+
+	/*
+		The roots: parents that aren't attached to an entity of this scene themselves. A child whose parent
+		is dead or elsewhere is a root of its own.
+	*/
+	for (size_t begin = 0; begin < links.size();)
+	{
+		const Entity parent = links[begin].first;
+		size_t		 end = begin + 1;
+		while (end < links.size() && links[end].first == parent)
+		{
+			end++;
+		}
+
+		if (!in_scene(parent))
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				order.push_back(links[i].second);
+			}
+		}
+		else if (!registry.HasComponent<Parent>(parent) || !in_scene(registry.GetComponent<Parent>(parent).entity))
+		{
+			order.push_back(parent);
+		}
+		begin = end;
+	}
+	parents.assign(order.size(), noParent);
+
+	/* Breadth first: the children of one level, parent by parent, make up the next. */
+	level_begin.push_back(0);
+	for (uint32_t begin = 0; begin < order.size();)
+	{
+		const uint32_t end = static_cast<uint32_t>(order.size());
+		level_begin.push_back(end);
+
+		for (uint32_t slot = begin; slot < end; slot++)
+		{
+			const auto children =
+				std::ranges::equal_range(links, order[slot], {}, [](const auto& link) { return link.first; });
+			for (const auto& link : children)
+			{
+				order.push_back(link.second);
+				parents.push_back(slot);
+			}
+		}
+		begin = end;
+	}
+	if (order.empty())
+	{
+		level_begin.clear();
+	}
+
+	std::vector<Entity> missing;
+	for (const Entity e : order)
+	{
+		if (!registry.HasComponent<WorldTransform>(e))
+		{
+			missing.push_back(e);
+		}
+	}
+	const std::vector<WorldTransform> blank(missing.size());
+	registry.AddComponents<WorldTransform>(missing, blank);
+
+	/* Slot `i` of both arrays is node `i`, as long as every node has a `Transform`. */
+	registry.GetComponentArray<WorldTransform>(built_scene).Arrange(order);
+	registry.GetComponentArray<Transform>(built_scene).Arrange(order);
+
+	cache.assign(order.size(), Transform{});
+	dirty.assign(order.size(), 0);
+	force = true;
+}
+
+uint32_t Mupfel::TransformSystem::UpdateRange(uint32_t begin, uint32_t end)
+{
+	const std::vector<uint32_t>&  local_dense = locals->dense;
+	const std::vector<Transform>& local_data = locals->components;
+
+	uint32_t count = 0;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		const Entity e = order[i];
+
+		const Transform* local = &identity;
+		if (i < local_dense.size() && local_dense[i] == e.Index())
+		{
+			local = &local_data[i];
+		}
+		else if (locals->Has(e))
+		{
+			local = &locals->Get(e);
+		}
+
+		const uint32_t parent = parents[i];
+		const bool	   changed = force || (parent != noParent && dirty[parent]) || !Same(*local, cache[i]);
+		dirty[i] = changed ? 1 : 0;
+		if (!changed)
+		{
+			continue;
+		}
+
+		cache[i] = *local;
+		WorldAt(i) = (parent == noParent) ? Root(*local) : Compose(WorldAt(parent), *local);
+		count++;
+	}
+	return count;
+}
+
+WorldTransform& Mupfel::TransformSystem::WorldAt(uint32_t slot)
+{
+	if (slot < worlds->dense.size() && worlds->dense[slot] == order[slot].Index())
+	{
+		return worlds->components[slot];
+	}
+	return worlds->Get(order[slot]);
+}
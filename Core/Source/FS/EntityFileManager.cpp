@@ -3,86 +3,56 @@
 #include <iostream>
 #include "ECS/Registry.h"
 #include "Core/Application.h"
-#include "ECS/Components/Transform.h"
-#include "ECS/Components/Movement.h"
-#include "ECS/Components/Collider.h"
+#include "Core/ResourceManager.h"
+#include "SceneSnapshot.h"
 
 using namespace Mupfel;
-using json = nlohmann::json;
 
 FileManager::Handle Mupfel::EntityFileManager::Load(std::filesystem::path file)
 {
-	json data;
-	std::ifstream file_stream(file);
-	try {
-		data = json::parse(file_stream);
-	}
-	catch (...)
-	{
-
-	}
+	/* Files in the mounted resource pack take precedence over the ones on disk. */
+	const ResourceManager* pack = Application::GetResourcePack();
+	const bool			   packed = pack && pack->Contains(file.generic_string());
 
-	RegisterComponentLoader("Transform", EntityFileManager::LoadTransform);
-	RegisterComponentLoader("Movement", EntityFileManager::LoadMovement);
-	RegisterComponentLoader("Collider", EntityFileManager::LoadCollider);
+	Registry& registry = Application::GetCurrentRegistry();
 
-	for (auto ent : data)
+	if (file.extension() == ".msnap")
 	{
-
-		/* Create an Entity */
-		Entity e = Application::GetCurrentRegistry().CreateEntity();
-
-		for (auto comp : ent["components"])
+		auto loaded = packed ? SceneSnapshot::Load(registry, pack->GetFile(file.generic_string()))
+							 : SceneSnapshot::Load(registry, file);
+		if (!loaded)
 		{
-
-			auto loader = loaders.find(comp["name"]);
-			if (loader != loaders.end())
-			{
-				loader->second(e, comp);
-			}
+			std::cerr << "Could not load scene snapshot " << file << std::endl;
 		}
+		return Handle(file);
 	}
-	
-	return Handle();
-}
 
-void Mupfel::EntityFileManager::Store(const FileManager::Handle& handle)
-{
-}
-
-bool Mupfel::EntityFileManager::RegisterComponentLoader(std::string loader_name, ComponentLoader loader)
-{
-	auto pair =  loaders.insert({ loader_name, loader });
+	auto loaded = packed ? loader.Load(registry, pack->GetFile(file.generic_string())) : loader.Load(registry, file);
+	if (!loaded)
+	{
+		std::cerr << "Could not load entity file " << file << std::endl;
+	}
 
-	return pair.second;
+	return Handle(file);
 }
 
-void Mupfel::EntityFileManager::LoadTransform(Entity e, nlohmann::json source)
+void Mupfel::EntityFileManager::Store(const FileManager::Handle& handle)
 {
-	Transform t;
-	t.pos_x = source["pos_x"];
-	t.pos_y = source["pos_y"];
-	t.pos_z = source["pos_z"];
-	t.scale_x = source["scale_x"];
-	t.scale_y = source["scale_y"];
-	t.rotation = source["rotation"];
-	Application::GetCurrentRegistry().AddComponent<Transform>(e, t);
-}
+	std::filesystem::path snapshot = handle.GetFile();
+	snapshot.replace_extension(".msnap");
 
-void Mupfel::EntityFileManager::LoadMovement(Entity e, nlohmann::json source)
-{
-	Movement m;
-	m.velocity_x = source["velocity_x"];
-	m.velocity_y = source["velocity_y"];
-	Application::GetCurrentRegistry().AddComponent<Movement>(e, m);
+	auto stored = SceneSnapshot::Store(Application::GetCurrentRegistry(), snapshot);
+	if (!stored)
+	{
+		std::cerr << "Could not store scene snapshot " << snapshot << std::endl;
+	}
 }
 
-void Mupfel::EntityFileManager::LoadCollider(Entity e, nlohmann::json source)
+void Mupfel::EntityFileManager::StoreEntityFile(const FileManager::Handle& handle)
 {
-
-	if (source["type"] == "Circle" && source.contains("radius"))
+	auto stored = loader.Store(Application::GetCurrentRegistry(), handle.GetFile());
+	if (!stored)
 	{
-		
+		std::cerr << "Could not store entity file " << handle.GetFile() << std::endl;
 	}
-	
 }
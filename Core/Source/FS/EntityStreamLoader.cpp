@@ -0,0 +1,291 @@
+#include "EntityStreamLoader.h"
+#include "ECS/Components/EngineComponents.h"
+#include "json.hpp"
+#include <fstream>
+#include <ostream>
+
+using namespace Mupfel;
+using json = nlohmann::json;
+
+/**
+ * Walks the SAX events of an entity file. Only four nesting levels matter:
+ *
+ *     depth 1  the array of entities
+ *     depth 2  an entity object
+ *     depth 3  its "components" array
+ *     depth 4  a component object, whose scalar fields are read
+ *
+ * Every other object or array (an entity's "tags", a component's nested data, ...) is skipped as a
+ * whole.
+ */
+class Mupfel::EntityStreamLoader::Handler
+{
+public:
+	Handler(EntityStreamLoader& in_loader, Registry& in_registry) : loader(in_loader), registry(in_registry) {}
+
+	bool null() { return true; }
+	bool boolean(bool value) { return Scalar(value ? 1.0 : 0.0); }
+	bool number_integer(json::number_integer_t value) { return Scalar(static_cast<double>(value)); }
+	bool number_unsigned(json::number_unsigned_t value) { return Scalar(static_cast<double>(value)); }
+	bool number_float(json::number_float_t value, const json::string_t&) { return Scalar(value); }
+	bool binary(json::binary_t&) { return true; }
+
+	bool string(json::string_t& value)
+	{
+		if (skip_depth == 0 && depth == 4 && current_key == "name" && !named)
+		{
+			/* Resolved once per component; everything after this goes straight into the column. */
+			named = true;
+			column = loader.FindColumn(value);
+			if (column)
+			{
+				column->Begin(ordinal);
+				for (const auto& [pending_key, pending_value] : pending)
+				{
+					column->Set(pending_key, pending_value);
+				}
+			}
+			pending.clear();
+		}
+		return true;
+	}
+
+	bool start_object(size_t) { return Open(depth == 1 || depth == 3); }
+	bool start_array(size_t) { return Open(depth == 0 || (depth == 2 && current_key == "components")); }
+
+	bool key(json::string_t& value)
+	{
+		if (skip_depth == 0)
+		{
+			current_key = value;
+		}
+		return true;
+	}
+
+	bool end_object()
+	{
+		if (Close())
+		{
+			if (depth == 3)
+			{
+				/* End of a component. A component without a name isn't added. */
+				column = nullptr;
+				named = false;
+				pending.clear();
+			}
+			else if (depth == 1 && ++ordinal == batchSize)
+			{
+				Flush();
+			}
+		}
+		return true;
+	}
+
+	bool end_array()
+	{
+		Close();
+		return true;
+	}
+
+	bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&)
+	{
+		failed = true;
+		return false;
+	}
+
+	/** Creates the batch's entities and adds the components of every column. */
+	void Flush()
+	{
+		if (ordinal == 0)
+		{
+			return;
+		}
+
+		const std::vector<Entity> created = registry.CreateEntities(ordinal);
+		for (const std::unique_ptr<Column>& c : loader.columns)
+		{
+			c->Flush(registry, created);
+		}
+		total += ordinal;
+		ordinal = 0;
+	}
+
+	/** Drops the components of the unfinished batch. */
+	void Discard()
+	{
+		for (const std::unique_ptr<Column>& c : loader.columns)
+		{
+			c->Clear();
+		}
+		ordinal = 0;
+	}
+
+	bool	 failed = false;
+	uint32_t total = 0;
+
+private:
+	bool Open(bool expected)
+	{
+		depth++;
+		if (skip_depth == 0 && !expected)
+		{
+			/* Anything but an array of entities at the top is not an entity file. */
+			if (depth == 1)
+			{
+				failed = true;
+				return false;
+			}
+			skip_depth = depth;
+		}
+		current_key.clear();
+		return true;
+	}
+
+	/** Leaves the current object or array; true if it was one of the four levels that matter. */
+	bool Close()
+	{
+		const bool skipped = skip_depth != 0;
+		if (depth == skip_depth)
+		{
+			skip_depth = 0;
+		}
+		depth--;
+		return !skipped;
+	}
+
+	bool Scalar(double value)
+	{
+		if (skip_depth != 0 || depth != 4)
+		{
+			return true;
+		}
+
+		if (column)
+		{
+			column->Set(current_key, value);
+		}
+		else if (!named)
+		{
+			/* Fields before the component's name are kept until the name says where they go. */
+			pending.emplace_back(current_key, value);
+		}
+		return true;
+	}
+
+	EntityStreamLoader&	loader;
+	Registry&			registry;
+	uint32_t			depth = 0;
+	/** The depth of the object or array being skipped, 0 if none is. */
+	uint32_t			skip_depth = 0;
+	/** Position of the current entity in the batch. */
+	uint32_t			ordinal = 0;
+	std::string			current_key;
+	/** The column of the current component, once its name was read; null for unregistered types. */
+	Column*				column = nullptr;
+	bool				named = false;
+
+	/** Fields read before the component's name. */
+	std::vector<std::pair<std::string, double>> pending;
+};
+
+Mupfel::EntityStreamLoader::EntityStreamLoader()
+{
+	EngineComponents::ForEach([this]<typename T>() { RegisterComponent<T>(); });
+}
+
+Mupfel::EntityStreamLoader::~EntityStreamLoader() {}
+
+Expected<uint32_t> Mupfel::EntityStreamLoader::Load(Registry& registry, const std::filesystem::path& file)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+	return Load(registry, stream);
+}
+
+Expected<uint32_t> Mupfel::EntityStreamLoader::Load(Registry& registry, std::istream& stream)
+{
+	return Parse(registry, stream);
+}
+
+Expected<uint32_t> Mupfel::EntityStreamLoader::Load(Registry& registry, std::span<const std::byte> bytes)
+{
+	const char* text = reinterpret_cast<const char*>(bytes.data());
+	return Parse(registry, text, text + bytes.size());
+}
+
+Expected<uint32_t> Mupfel::EntityStreamLoader::Store(Registry& registry, const std::filesystem::path& file)
+{
+	std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+	return Store(registry, stream);
+}
+
+Expected<uint32_t> Mupfel::EntityStreamLoader::Store(Registry& registry, std::ostream& stream)
+{
+	const std::vector<Entity> entities = registry.GetActiveSceneEntities();
+
+	/* One entity per line, built in a reused buffer. */
+	std::string line;
+	stream << "[\n";
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		line.assign("\t{\"components\": [");
+		bool first = true;
+		for (const std::unique_ptr<Column>& column : columns)
+		{
+			const size_t mark = line.size();
+			line.append(first ? "" : ", ");
+			if (column->Write(registry, entities[i], line))
+			{
+				first = false;
+			}
+			else
+			{
+				line.resize(mark);
+			}
+		}
+		line.append((i + 1 < entities.size()) ? "]},\n" : "]}\n");
+		stream.write(line.data(), static_cast<std::streamsize>(line.size()));
+	}
+	stream << "]\n";
+
+	if (!stream)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+	return static_cast<uint32_t>(entities.size());
+}
+
+template <typename... Input>
+Expected<uint32_t> Mupfel::EntityStreamLoader::Parse(Registry& registry, Input&&... input)
+{
+	Handler	   handler(*this, registry);
+	const bool parsed = json::sax_parse(std::forward<Input>(input)..., &handler);
+
+	if (!parsed || handler.failed)
+	{
+		handler.Discard();
+		return std::unexpected(Error::INVALID_FORMAT);
+	}
+
+	handler.Flush();
+	return handler.total;
+}
+
+EntityStreamLoader::Column* Mupfel::EntityStreamLoader::FindColumn(std::string_view name) const
+{
+	for (const std::unique_ptr<Column>& column : columns)
+	{
+		if (column->name == name)
+		{
+			return column.get();
+		}
+	}
+	return nullptr;
+}
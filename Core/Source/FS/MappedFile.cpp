@@ -0,0 +1,152 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Mupfel;
+
+#ifdef _WIN32
+
+Expected<MappedFile> Mupfel::MappedFile::Open(const std::filesystem::path& file)
+{
+	HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	MappedFile mapped;
+	mapped.file_handle = handle;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size))
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	/* An empty file can't be mapped, but it is a valid (empty) result. */
+	if (size.QuadPart == 0)
+	{
+		return mapped;
+	}
+
+	mapped.mapping_handle = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapped.mapping_handle)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	void* view = MapViewOfFile(mapped.mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	mapped.data = static_cast<const std::byte*>(view);
+	mapped.size = static_cast<size_t>(size.QuadPart);
+	return mapped;
+}
+
+void Mupfel::MappedFile::Close()
+{
+	if (data)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mapping_handle)
+	{
+		CloseHandle(mapping_handle);
+	}
+	if (file_handle)
+	{
+		CloseHandle(file_handle);
+	}
+	data = nullptr;
+	size = 0;
+	mapping_handle = nullptr;
+	file_handle = nullptr;
+}
+
+#else
+
+Expected<MappedFile> Mupfel::MappedFile::Open(const std::filesystem::path& file)
+{
+	const int fd = open(file.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	MappedFile mapped;
+
+	/* An empty file can't be mapped, but it is a valid (empty) result. */
+	if (info.st_size > 0)
+	{
+		/* The whole file is about to be read: map it in one go instead of faulting in page by page. */
+		int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		flags |= MAP_POPULATE;
+#endif
+		void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, flags, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			close(fd);
+			return std::unexpected(Error::FILE_NOT_FOUND);
+		}
+
+		mapped.data = static_cast<const std::byte*>(view);
+		mapped.size = static_cast<size_t>(info.st_size);
+	}
+
+	/* The mapping keeps the file alive on its own. */
+	close(fd);
+	return mapped;
+}
+
+void Mupfel::MappedFile::Close()
+{
+	if (data)
+	{
+		munmap(const_cast<std::byte*>(data), size);
+	}
+	data = nullptr;
+	size = 0;
+}
+
+#endif
+
+Mupfel::MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& Mupfel::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+#ifdef _WIN32
+		file_handle = std::exchange(other.file_handle, nullptr);
+		mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+	}
+	return *this;
+}
+
+Mupfel::MappedFile::~MappedFile() { Close(); }
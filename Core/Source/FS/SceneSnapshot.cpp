@@ -0,0 +1,214 @@
+#include "SceneSnapshot.h"
+#include "ECS/Components/EngineComponents.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+using namespace Mupfel;
+
+static size_t AlignUp(size_t offset) { return (offset + 15) & ~size_t{15}; }
+
+std::vector<SceneSnapshot::ColumnType>& Mupfel::SceneSnapshot::ColumnTypes()
+{
+	static std::vector<ColumnType> types;
+	return types;
+}
+
+void Mupfel::SceneSnapshot::Register(ColumnType type)
+{
+	assert(type.name.size() < sizeof(SnapshotColumn::name) && "Column names are limited to 31 characters!");
+
+	std::vector<ColumnType>& types = ColumnTypes();
+	auto it = std::ranges::find(types, type.name, &ColumnType::name);
+	if (it != types.end())
+	{
+		*it = std::move(type);
+	}
+	else
+	{
+		types.push_back(std::move(type));
+	}
+}
+
+/* The engine's own components, registered before the first Store or Load. */
+static void RegisterEngineColumns()
+{
+	static const bool registered = []
+	{
+		EngineComponents::ForEach([]<typename T>() { SceneSnapshot::RegisterColumn<T>(); });
+		return true;
+	}();
+	(void)registered;
+}
+
+Expected<uint32_t> Mupfel::SceneSnapshot::Store(Registry& registry, const std::filesystem::path& file)
+{
+	RegisterEngineColumns();
+
+	/* Number the entities of the active scene in index order; the ordinals are what the columns refer to. */
+	const std::vector<Entity> stored = registry.GetActiveSceneEntities();
+	const uint32_t			  entity_count = static_cast<uint32_t>(stored.size());
+
+	std::vector<uint32_t> ordinals(stored.empty() ? 0 : stored.back().Index() + 1, noOrdinal);
+	for (uint32_t i = 0; i < entity_count; i++)
+	{
+		ordinals[stored[i].Index()] = i;
+	}
+
+	struct PendingColumn
+	{
+		const ColumnType*	   type;
+		std::vector<uint32_t>  entities;
+		std::vector<std::byte> data;
+		uint32_t			   count;
+	};
+	std::vector<PendingColumn> columns;
+
+	for (const ColumnType& type : ColumnTypes())
+	{
+		/* Don't create the arrays of types the active scene never used. */
+		const auto& buffer = registry.component_buffers[registry.GetActiveScene()];
+		if (type.componentID >= buffer.size() || !buffer[type.componentID])
+		{
+			continue;
+		}
+
+		PendingColumn column{.type = &type};
+		column.count = type.write(registry, ordinals, column.entities, column.data);
+		if (column.count > 0)
+		{
+			columns.push_back(std::move(column));
+		}
+	}
+
+	/* Lay the file out: header, column table, then every column's entities and data, 16-byte aligned. */
+	SnapshotHeader header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = formatVersion;
+	header.columnCount = static_cast<uint32_t>(columns.size());
+	header.entityCount = entity_count;
+
+	std::vector<SnapshotColumn> table(columns.size());
+	size_t						offset = AlignUp(sizeof(SnapshotHeader) + table.size() * sizeof(SnapshotColumn));
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		SnapshotColumn& entry = table[i];
+		std::memcpy(entry.name, columns[i].type->name.c_str(), columns[i].type->name.size() + 1);
+		entry.version = columns[i].type->version;
+		entry.elementSize = columns[i].type->elementSize;
+		entry.count = columns[i].count;
+		entry.entityOffset = offset;
+		offset = AlignUp(offset + columns[i].entities.size() * sizeof(uint32_t));
+		entry.dataOffset = offset;
+		offset = AlignUp(offset + columns[i].data.size());
+	}
+
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+
+	size_t written = 0;
+	auto   write = [&](const void* bytes, size_t size, size_t at)
+	{
+		static constexpr char padding[16] = {};
+		out.write(padding, static_cast<std::streamsize>(at - written));
+		out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+		written = at + size;
+	};
+
+	write(&header, sizeof(header), 0);
+	write(table.data(), table.size() * sizeof(SnapshotColumn), sizeof(header));
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		write(columns[i].entities.data(), columns[i].entities.size() * sizeof(uint32_t), table[i].entityOffset);
+		write(columns[i].data.data(), columns[i].data.size(), table[i].dataOffset);
+	}
+
+	if (!out)
+	{
+		return std::unexpected(Error::FILE_NOT_FOUND);
+	}
+	return entity_count;
+}
+
+Expected<std::vector<Entity>> Mupfel::SceneSnapshot::Load(Registry& registry, const std::filesystem::path& file)
+{
+	Expected<MappedFile> mapped = MappedFile::Open(file);
+	if (!mapped)
+	{
+		return std::unexpected(mapped.error());
+	}
+	return Load(registry, mapped->Data());
+}
+
+Expected<std::vector<Entity>> Mupfel::SceneSnapshot::Load(Registry& registry, std::span<const std::byte> bytes)
+{
+	RegisterEngineColumns();
+
+	SnapshotHeader header;
+	if (bytes.size() < sizeof(header))
+	{
+		return std::unexpected(Error::INVALID_FORMAT);
+	}
+	std::memcpy(&header, bytes.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion ||
+		bytes.size() < sizeof(header) + static_cast<size_t>(header.columnCount) * sizeof(SnapshotColumn))
+	{
+		return std::unexpected(Error::INVALID_FORMAT);
+	}
+
+	std::vector<SnapshotColumn> table(header.columnCount);
+	std::memcpy(table.data(), bytes.data() + sizeof(header), table.size() * sizeof(SnapshotColumn));
+
+	/* Validate everything before the registry is touched, so a broken file leaves it as it was. */
+	auto in_bounds = [&](uint64_t offset, uint64_t size)
+	{ return offset <= bytes.size() && size <= bytes.size() - offset; };
+	for (SnapshotColumn& column : table)
+	{
+		column.name[sizeof(column.name) - 1] = '\0';
+		if (!in_bounds(column.entityOffset, uint64_t{column.count} * sizeof(uint32_t)) ||
+			!in_bounds(column.dataOffset, uint64_t{column.count} * column.elementSize) ||
+			column.entityOffset % 4 != 0 || column.dataOffset % 16 != 0)
+		{
+			return std::unexpected(Error::INVALID_FORMAT);
+		}
+
+		const uint32_t* ordinals = reinterpret_cast<const uint32_t*>(bytes.data() + column.entityOffset);
+		if (std::any_of(ordinals, ordinals + column.count, [&](uint32_t o) { return o >= header.entityCount; }))
+		{
+			return std::unexpected(Error::INVALID_FORMAT);
+		}
+	}
+
+	const std::vector<Entity> entities = registry.CreateEntities(header.entityCount);
+
+	std::vector<Entity> owners;
+	for (const SnapshotColumn& column : table)
+	{
+		/* Unknown columns, and columns of another version, are skipped. */
+		const std::vector<ColumnType>& types = ColumnTypes();
+		auto type = std::ranges::find(types, std::string_view(column.name), &ColumnType::name);
+		if (type == types.end() || type->version != column.version || type->elementSize != column.elementSize)
+		{
+			continue;
+		}
+
+		const uint32_t* ordinals = reinterpret_cast<const uint32_t*>(bytes.data() + column.entityOffset);
+		owners.clear();
+		owners.reserve(column.count);
+		for (uint32_t i = 0; i < column.count; i++)
+		{
+			owners.push_back(entities[ordinals[i]]);
+		}
+
+		type->load(registry, owners, bytes.data() + column.dataOffset);
+	}
+
+	return entities;
+}
@@ -33,11 +33,11 @@ void PhysicsSimulation::Update(double elapsedTime)
 		return;
 	}
 	{
-		ProfilingSample prof("Movement Update");
+		MUPFEL_PROFILE_COUNTERS("Movement Update");
 		MovementSystem::Update(elapsedTime * time_multi);
 	}
 	{
-		ProfilingSample prof("Collision Update");
+		MUPFEL_PROFILE_SCOPE("Collision Update");
 		collision_system->Update();
 	}
 	
@@ -5,8 +5,10 @@
 
 bool Mupfel::AnimationSystem::Init() { return true; }
 
-void Mupfel::AnimationSystem::Update(double timestep) {
-	Mupfel::Registry& registry = Mupfel::Application::GetCurrentRegistry();
+void Mupfel::AnimationSystem::Update(double timestep) { Advance(Mupfel::Application::GetCurrentRegistry(), timestep); }
+
+void Mupfel::AnimationSystem::Advance(Registry& registry, double timestep)
+{
 	for (auto [e, animation] : registry.view<Animation>())
 	{
 		animation.elapsed += static_cast<float>(timestep);
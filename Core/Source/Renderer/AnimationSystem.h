@@ -2,11 +2,16 @@
 
 namespace Mupfel
 {
+class Registry;
+
 class AnimationSystem
 {
 public:
 	bool Init();
 	void Update(double timestep);
 	void Shutdown();
+
+	/** Advances every Animation in `registry` by `timestep` seconds; what `Update` does to the current scene. */
+	static void Advance(Registry& registry, double timestep);
 };
 } // namespace Mupfel
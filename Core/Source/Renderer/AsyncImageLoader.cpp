@@ -0,0 +1,233 @@
+#include "AsyncImageLoader.h"
+#include "Core/ResourceManager.h"
+#include "Core/ThreadPool.h"
+#include "PngWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+/* Ping compiles its own copy of stb_image; STB_IMAGE_STATIC keeps this one private to this file. */
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+using namespace Mupfel;
+
+static constexpr uint32_t bytes_per_pixel = 4;
+
+uint32_t Mupfel::ImageRequest::HandleCount() const
+{
+	return (kind == ImageRequestKind::SpriteSheet) ? spec.rows * spec.columns : 1;
+}
+
+uint64_t Mupfel::DecodeResult::ByteSize() const
+{
+	uint64_t size = 0;
+	if (images)
+	{
+		for (const DecodedImage& image : images.value())
+		{
+			size += static_cast<uint64_t>(image.width) * image.height * bytes_per_pixel;
+		}
+	}
+	return size;
+}
+
+Mupfel::AsyncImageLoader::~AsyncImageLoader()
+{
+	for (std::future<DecodeResult>& decode : inFlight)
+	{
+		decode.wait();
+	}
+}
+
+void Mupfel::AsyncImageLoader::Submit(ImageRequest request)
+{
+	if (uploadDirectory.empty())
+	{
+		inFlight.push_back(pool.Enqueue(&AsyncImageLoader::Decode, std::move(request)));
+		return;
+	}
+
+	inFlight.push_back(pool.Enqueue(
+		[directory = uploadDirectory, keep_image = keep](ImageRequest in_request)
+		{
+			DecodeResult result = Decode(std::move(in_request));
+			WriteFiles(result, directory, keep_image);
+			return result;
+		},
+		std::move(request)));
+}
+
+uint32_t Mupfel::AsyncImageLoader::Collect(ImageUploadDevice& device, uint64_t byte_budget)
+{
+	batch.clear();
+	uint64_t bytes = 0;
+
+	while (!inFlight.empty() && (batch.empty() || bytes < byte_budget))
+	{
+		/* Stop at the first request that is still decoding, so uploads keep submission order. */
+		if (inFlight.front().wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			break;
+		}
+
+		batch.push_back(inFlight.front().get());
+		inFlight.pop_front();
+		bytes += batch.back().ByteSize();
+	}
+
+	if (!batch.empty())
+	{
+		device.UploadBatch(batch);
+	}
+
+	return static_cast<uint32_t>(batch.size());
+}
+
+void Mupfel::AsyncImageLoader::Flush(ImageUploadDevice& device)
+{
+	for (std::future<DecodeResult>& decode : inFlight)
+	{
+		decode.wait();
+	}
+
+	Collect(device);
+}
+
+uint32_t Mupfel::AsyncImageLoader::Pending() const { return static_cast<uint32_t>(inFlight.size()); }
+
+DecodeResult Mupfel::AsyncImageLoader::Decode(ImageRequest request)
+{
+	if (request.pack && request.pack->Contains(request.path))
+	{
+		/* Straight from the pack's mapping, no copy of the encoded image. */
+		const std::span<const std::byte> packed = request.pack->GetFile(request.path);
+		const std::span<const uint8_t>	 encoded(reinterpret_cast<const uint8_t*>(packed.data()), packed.size());
+
+		Expected<std::vector<DecodedImage>> images = DecodeMemory(encoded, request);
+		return {std::move(request), std::move(images)};
+	}
+
+	std::ifstream file(request.path, std::ios::binary);
+
+	if (!file)
+	{
+		return {std::move(request), std::unexpected<Error>(Error::FILE_NOT_FOUND)};
+	}
+
+	const std::vector<uint8_t> encoded{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+	Expected<std::vector<DecodedImage>> images = DecodeMemory(encoded, request);
+	return {std::move(request), std::move(images)};
+}
+
+void Mupfel::AsyncImageLoader::WriteFiles(
+	DecodeResult&									result,
+	const std::filesystem::path&					directory,
+	const std::function<bool(const DecodedImage&)>& keep_image)
+{
+	if (!result.images)
+	{
+		return;
+	}
+
+	for (DecodedImage& image : result.images.value())
+	{
+		if (keep_image && keep_image(image))
+		{
+			continue;
+		}
+
+		const std::filesystem::path file = directory / (std::to_string(image.handle) + ".png");
+		if (!WritePng(file, image.width, image.height, image.pixels))
+		{
+			/* Nobody would delete the files written so far, as the result fails as a whole. */
+			std::error_code error;
+			for (const DecodedImage& written : result.images.value())
+			{
+				if (!written.file.empty())
+				{
+					std::filesystem::remove(written.file, error);
+				}
+			}
+			std::filesystem::remove(file, error);
+			result.images = std::unexpected<Error>(Error::WRITE_FAILED);
+			return;
+		}
+
+		image.file = file;
+		image.pixels = {};
+	}
+}
+
+Expected<std::vector<DecodedImage>> Mupfel::AsyncImageLoader::DecodeMemory(
+	std::span<const uint8_t> encoded,
+	const ImageRequest&		 request)
+{
+	int		 width = 0;
+	int		 height = 0;
+	int		 channels = 0;
+	stbi_uc* pixels = stbi_load_from_memory(
+		encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha);
+
+	if (!pixels)
+	{
+		return std::unexpected<Error>(Error::INVALID_FORMAT);
+	}
+
+	const uint32_t w = static_cast<uint32_t>(width);
+	const uint32_t h = static_cast<uint32_t>(height);
+
+	std::vector<DecodedImage> images;
+
+	if (request.kind != ImageRequestKind::SpriteSheet)
+	{
+		DecodedImage& image = images.emplace_back();
+		image.handle = request.firstHandle;
+		image.width = w;
+		image.height = h;
+		image.spec = (request.kind == ImageRequestKind::Animated) ? request.spec : ImageSpecification{1, 1};
+		image.pixels.assign(pixels, pixels + static_cast<size_t>(w) * h * bytes_per_pixel);
+	}
+	else if (request.spec.rows == 0 || request.spec.columns == 0 || w < request.spec.columns ||
+			 h < request.spec.rows)
+	{
+		stbi_image_free(pixels);
+		return std::unexpected<Error>(Error::INVALID_FORMAT);
+	}
+	else
+	{
+		/* Cut the sheet row-major into frames of equal size; leftover pixels at the right/bottom edge are dropped. */
+		const uint32_t frame_w = w / request.spec.columns;
+		const uint32_t frame_h = h / request.spec.rows;
+		const size_t   frame_row_bytes = static_cast<size_t>(frame_w) * bytes_per_pixel;
+
+		images.reserve(request.HandleCount());
+
+		for (uint32_t row = 0; row < request.spec.rows; row++)
+		{
+			for (uint32_t column = 0; column < request.spec.columns; column++)
+			{
+				DecodedImage& image = images.emplace_back();
+				image.handle = request.firstHandle + static_cast<uint32_t>(images.size() - 1);
+				image.width = frame_w;
+				image.height = frame_h;
+				image.pixels.resize(frame_row_bytes * frame_h);
+
+				for (uint32_t y = 0; y < frame_h; y++)
+				{
+					const size_t src_y = static_cast<size_t>(row) * frame_h + y;
+					const size_t src = (src_y * w + column * frame_w) * bytes_per_pixel;
+					std::memcpy(image.pixels.data() + y * frame_row_bytes, pixels + src, frame_row_bytes);
+				}
+			}
+		}
+	}
+
+	stbi_image_free(pixels);
+	return images;
+}
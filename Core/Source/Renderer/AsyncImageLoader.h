@@ -0,0 +1,159 @@
+#pragma once
+#include "Core/Error.h"
+#include "Renderer/ImageManager.h"
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Mupfel
+{
+
+class ThreadPool;
+class ResourceManager;
+
+/** What an `ImageRequest` turns into once uploaded, mirroring the synchronous `ImageManager` loaders. */
+enum class ImageRequestKind : uint8_t
+{
+	/** One image (`ImageManager::Load`). */
+	Basic,
+	/** One layered image with `rows * columns` frames (`ImageManager::LoadAnimated`). */
+	Animated,
+	/** `rows * columns` independent images cut from one file (`ImageManager::LoadSpriteSheet`). */
+	SpriteSheet
+};
+
+struct ImageRequest
+{
+	std::string		   path;
+	ImageRequestKind   kind = ImageRequestKind::Basic;
+	ImageSpecification spec{1, 1};
+	/** The first of the handles reserved for this request; sprite sheets own `rows * columns` consecutive ones. */
+	ImageHandle firstHandle = 0;
+	/** If set and it contains `path`, the image is read from this pack instead of the file system. */
+	const ResourceManager* pack = nullptr;
+
+	/** Number of handles (and thus images) the request produces. */
+	uint32_t HandleCount() const;
+};
+
+/** CPU-side result of decoding one image: tightly packed RGBA8 pixels. */
+struct DecodedImage
+{
+	ImageHandle			  handle = 0;
+	uint32_t			  width = 0;
+	uint32_t			  height = 0;
+	/** Frame grid of an animated image (1 x 1 otherwise); `width`/`height` are those of the whole image. */
+	ImageSpecification	  spec{1, 1};
+	std::vector<uint8_t>  pixels;
+	/** If not empty, the pixels were written to this PNG file instead and `pixels` is empty. */
+	std::filesystem::path file;
+};
+
+/** A finished request: its decoded images, one per reserved handle, or why decoding failed. */
+struct DecodeResult
+{
+	ImageRequest						  request;
+	Expected<std::vector<DecodedImage>> images;
+
+	/** Bytes of pixel data this result uploads, whether they are still in memory or in a file. */
+	uint64_t ByteSize() const;
+};
+
+/**
+ * The receiving end of `AsyncImageLoader::Collect`, i.e. the GPU device. The engine implements it on top
+ * of `Ping::Device`; tests implement it with a fake that just records what it got, so the decode stage
+ * runs headless.
+ */
+class ImageUploadDevice
+{
+public:
+	virtual ~ImageUploadDevice() = default;
+
+	/**
+	 * Uploads one frame's worth of finished requests, ordered by handle.
+	 * Failed requests must still fill their slots, since their handles are in use already.
+	 */
+	virtual void UploadBatch(std::span<DecodeResult> batch) = 0;
+};
+
+/**
+ * Decodes images on the `ThreadPool` and hands them to an `ImageUploadDevice` in batches.
+ *
+ * `Submit` only enqueues the decode and returns. `Collect`, called once per frame, passes every request
+ * that has finished decoding to the device in a single `UploadBatch` call. Results are released strictly
+ * in submission order, even if a later decode finishes first, so handles reserved in order are filled in
+ * order.
+ *
+ * Ping creates images from files only. Given an upload directory, the workers therefore also write the
+ * decoded images out as PNG files (see `WritePng`), except for those `keep` accepts, which stay in memory.
+ */
+class AsyncImageLoader
+{
+public:
+	/**
+	 * \param in_upload_directory Where decoded images are written to; if empty, all of them stay in memory.
+	 * \param in_keep Says which images stay in memory even with an upload directory. Runs on the workers.
+	 */
+	explicit AsyncImageLoader(
+		ThreadPool&								 in_pool,
+		std::filesystem::path					 in_upload_directory = {},
+		std::function<bool(const DecodedImage&)> in_keep = {})
+		: pool(in_pool), uploadDirectory(std::move(in_upload_directory)), keep(std::move(in_keep))
+	{
+	}
+
+	/** Drains the outstanding decodes (without uploading them), so no worker outlives the loader. */
+	~AsyncImageLoader();
+
+	/** Starts decoding `request` on the thread pool. */
+	void Submit(ImageRequest request);
+
+	/**
+	 * Uploads finished requests, in submission order, until about `byte_budget` bytes of pixels went out
+	 * this call (at least one request is uploaded if any is ready). Never blocks on a decode.
+	 *
+	 * \return The number of requests uploaded.
+	 */
+	uint32_t Collect(ImageUploadDevice& device, uint64_t byte_budget = UINT64_MAX);
+
+	/** Blocks until every submitted request has been decoded, then uploads all of them. */
+	void Flush(ImageUploadDevice& device);
+
+	/** Number of submitted requests that have not been uploaded yet. */
+	uint32_t Pending() const;
+
+	/** Decodes `request` on the calling thread. This is what the pool workers run. */
+	static DecodeResult Decode(ImageRequest request);
+
+	/**
+	 * Writes every image of \a result that \a keep_image doesn't accept to `<directory>/<handle>.png` and
+	 * drops its pixels. If a file can't be written, the whole result fails with `Error::WRITE_FAILED`.
+	 */
+	static void WriteFiles(
+		DecodeResult&									result,
+		const std::filesystem::path&					directory,
+		const std::function<bool(const DecodedImage&)>&	keep_image);
+
+	/**
+	 * Decodes an encoded image (any format stb_image reads) from memory into RGBA8.
+	 * Sprite sheets are cut into `spec.rows * spec.columns` images on the way.
+	 */
+	static Expected<std::vector<DecodedImage>> DecodeMemory(
+		std::span<const uint8_t> encoded,
+		const ImageRequest&		 request);
+
+private:
+	ThreadPool&								 pool;
+	std::filesystem::path					 uploadDirectory;
+	std::function<bool(const DecodedImage&)> keep;
+	std::deque<std::future<DecodeResult>>	 inFlight;
+	/** Reused across `Collect` calls. */
+	std::vector<DecodeResult> batch;
+};
+
+} // namespace Mupfel
@@ -0,0 +1,200 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+using namespace Mupfel;
+
+Mupfel::AtlasPacker::AtlasPacker(uint32_t page_width, uint32_t page_height, uint32_t in_padding)
+	: pageWidth(page_width), pageHeight(page_height), padding(in_padding)
+{
+	assert(page_width > 0 && page_height > 0);
+}
+
+std::optional<AtlasRect> Mupfel::AtlasPacker::Insert(uint32_t width, uint32_t height)
+{
+	if (width == 0 || height == 0 || width > pageWidth || height > pageHeight)
+	{
+		return std::nullopt;
+	}
+
+	for (uint32_t p = firstOpenPage; p < pages.size(); p++)
+	{
+		uint32_t index = 0;
+		uint32_t y = 0;
+		if (FindPosition(pages[p], width, height, index, y))
+		{
+			const uint32_t x = pages[p].skyline[index].x;
+			Place(pages[p], index, y, width, height);
+			return AtlasRect{p, x, y, width, height};
+		}
+	}
+
+	/* A fresh page fits anything that passed the size check above. */
+	AddPage();
+	const uint32_t p = static_cast<uint32_t>(pages.size() - 1);
+	Place(pages[p], 0, 0, width, height);
+	return AtlasRect{p, 0, 0, width, height};
+}
+
+uint32_t Mupfel::AtlasPacker::InsertBatch(std::span<const AtlasRect> sizes, std::span<AtlasRect> out)
+{
+	assert(out.size() >= sizes.size());
+
+	std::vector<uint32_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0u);
+
+	/* Tallest first, then widest: every row of the skyline then starts with its tallest member. */
+	std::ranges::sort(
+		order,
+		[&](uint32_t a, uint32_t b)
+		{
+			if (sizes[a].height != sizes[b].height)
+			{
+				return sizes[a].height > sizes[b].height;
+			}
+			return sizes[a].width > sizes[b].width;
+		});
+
+	uint32_t placed = 0;
+	for (uint32_t i : order)
+	{
+		std::optional<AtlasRect> rect = Insert(sizes[i].width, sizes[i].height);
+		out[i] = rect.value_or(AtlasRect{});
+		placed += rect.has_value() ? 1 : 0;
+	}
+
+	return placed;
+}
+
+void Mupfel::AtlasPacker::Clear()
+{
+	pages.clear();
+	firstOpenPage = 0;
+}
+
+void Mupfel::AtlasPacker::ClosePages() { firstOpenPage = static_cast<uint32_t>(pages.size()); }
+
+uint32_t Mupfel::AtlasPacker::GetPageCount() const { return static_cast<uint32_t>(pages.size()); }
+
+float Mupfel::AtlasPacker::GetOccupancy() const
+{
+	if (pages.empty())
+	{
+		return 0.0f;
+	}
+
+	uint64_t used = 0;
+	for (const Page& page : pages)
+	{
+		used += page.usedArea;
+	}
+
+	return static_cast<float>(static_cast<double>(used) /
+							  (static_cast<double>(pageWidth) * pageHeight * static_cast<double>(pages.size())));
+}
+
+bool Mupfel::AtlasPacker::FindPosition(
+	const Page& page,
+	uint32_t	width,
+	uint32_t	height,
+	uint32_t&	best_index,
+	uint32_t&	best_y) const
+{
+	const std::vector<Segment>& skyline = page.skyline;
+
+	uint32_t best_gap = std::numeric_limits<uint32_t>::max();
+	best_y = std::numeric_limits<uint32_t>::max();
+
+	for (uint32_t i = 0; i < skyline.size(); i++)
+	{
+		const uint32_t x = skyline[i].x;
+		if (x + width > pageWidth)
+		{
+			/* Segments are sorted by x, so no later one fits either. */
+			break;
+		}
+
+		/* The rectangle rests on the highest segment it spans. */
+		const uint32_t span = std::min(width + padding, pageWidth - x);
+		uint32_t	   y = 0;
+		uint32_t	   covered = 0;
+		for (uint32_t j = i; covered < span; j++)
+		{
+			y = std::max(y, skyline[j].y);
+			covered = skyline[j].x + skyline[j].width - x;
+		}
+
+		if (y + height > pageHeight)
+		{
+			continue;
+		}
+
+		/* Lowest position wins; among equals the one that fills its segment most snugly. */
+		const uint32_t gap = (skyline[i].width > span) ? skyline[i].width - span : 0;
+		if (y < best_y || (y == best_y && gap < best_gap))
+		{
+			best_index = i;
+			best_y = y;
+			best_gap = gap;
+		}
+	}
+
+	return best_y != std::numeric_limits<uint32_t>::max();
+}
+
+void Mupfel::AtlasPacker::Place(Page& page, uint32_t index, uint32_t y, uint32_t width, uint32_t height)
+{
+	std::vector<Segment>& skyline = page.skyline;
+
+	const uint32_t x = skyline[index].x;
+	const uint32_t span = std::min(width + padding, pageWidth - x);
+	const uint32_t top = y + std::min(height + padding, pageHeight - y);
+
+	skyline.insert(skyline.begin() + index, Segment{x, top, span});
+
+	/* Cut away whatever the new segment now covers. */
+	const uint32_t end = x + span;
+	uint32_t	   next = index + 1;
+	while (next < skyline.size() && skyline[next].x < end)
+	{
+		Segment& segment = skyline[next];
+		if (segment.x + segment.width <= end)
+		{
+			skyline.erase(skyline.begin() + next);
+			continue;
+		}
+
+		segment.width -= end - segment.x;
+		segment.x = end;
+		break;
+	}
+
+	/* Merge neighbours of equal height, so the skyline stays short. */
+	for (uint32_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	page.usedArea += static_cast<uint64_t>(width) * height;
+}
+
+void Mupfel::AtlasPacker::AddPage()
+{
+	Page& page = pages.emplace_back();
+	page.skyline.push_back(Segment{0, 0, pageWidth});
+
+	if (pages.size() - firstOpenPage > max_open_pages)
+	{
+		firstOpenPage++;
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Mupfel
+{
+
+/** Where a rectangle ended up: page index and top-left corner in pixels. */
+struct AtlasRect
+{
+	uint32_t page = 0;
+	uint32_t x = 0;
+	uint32_t y = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+/**
+ * Packs rectangles into fixed-size atlas pages with the skyline bottom-left heuristic.
+ *
+ * Every page keeps its "skyline", the upper contour of everything placed so far, as a list of horizontal
+ * segments. A rectangle goes where its bottom edge would sit lowest on that contour (ties broken by the
+ * narrower remaining gap), so packing is online: rectangles can be added one by one as images arrive.
+ * When no open page has room, a new page is started. `InsertBatch` additionally sorts by height first,
+ * which packs noticeably tighter when all rectangles are known up front.
+ *
+ * The packer only does the bookkeeping, it never touches pixels (see `TextureAtlas`).
+ */
+class AtlasPacker
+{
+public:
+	/**
+	 * \param page_width Width of every page in pixels.
+	 * \param page_height Height of every page in pixels.
+	 * \param in_padding Empty pixels kept to the right of and below every rectangle, against filtering bleed.
+	 */
+	AtlasPacker(uint32_t page_width, uint32_t page_height, uint32_t in_padding = 1);
+
+	/**
+	 * Places a `width` x `height` rectangle.
+	 *
+	 * \return Its position, or std::nullopt if it is larger than a page.
+	 */
+	std::optional<AtlasRect> Insert(uint32_t width, uint32_t height);
+
+	/**
+	 * Places many rectangles at once, tallest first. `out[i]` receives the position of `sizes[i]`; rectangles
+	 * that don't fit a page get a zero-sized `AtlasRect`.
+	 *
+	 * \return The number of rectangles placed.
+	 */
+	uint32_t InsertBatch(std::span<const AtlasRect> sizes, std::span<AtlasRect> out);
+
+	/** Forgets every placement; keeps the page size. */
+	void Clear();
+
+	/** Counts every page as full, so the next rectangle starts a new one. Placements are kept. */
+	void ClosePages();
+
+	uint32_t GetPageCount() const;
+
+	/** Fraction of the allocated pages' area covered by rectangles (padding excluded). */
+	float GetOccupancy() const;
+
+private:
+	/** One horizontal piece of a page's skyline: columns [x, x + width) are filled up to row y. */
+	struct Segment
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+	struct Page
+	{
+		std::vector<Segment> skyline;
+		uint64_t			 usedArea = 0;
+	};
+
+	/** Finds the best spot on `page` for a padded rectangle, or returns false. */
+	bool FindPosition(const Page& page, uint32_t width, uint32_t height, uint32_t& best_index, uint32_t& best_y) const;
+
+	/** Raises the skyline of `page` under a padded rectangle placed at segment `index`, height `y`. */
+	void Place(Page& page, uint32_t index, uint32_t y, uint32_t width, uint32_t height);
+
+	void AddPage();
+
+private:
+	uint32_t		  pageWidth;
+	uint32_t		  pageHeight;
+	uint32_t		  padding;
+	std::vector<Page> pages;
+	/**
+	 * Only the newest `max_open_pages` pages are searched; older ones count as full. Keeps the insertion
+	 * cost flat however many pages there are, at the price of leaving a few holes in old pages.
+	 */
+	static constexpr uint32_t max_open_pages = 4;
+	uint32_t				  firstOpenPage = 0;
+};
+
+} // namespace Mupfel
@@ -1,16 +1,17 @@
 #include "ECSRenderer.h"
 #include "Core/Application.h"
+#include "Core/Profiler.h"
 #include "ImageManager.h"
+#include "InstancePacker.h"
 #include "Quad.h"
 
-#include "ECS/Components/Animation.h"
 #include "ECS/Components/Light.h"
-#include "ECS/Components/Texture.h"
 #include "ECS/Components/Transform.h"
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 struct UniformBufferObject
 {
@@ -20,22 +21,6 @@ struct UniformBufferObject
 	glm::vec4 cameraPos;
 };
 
-struct TextureInstance
-{
-	float	 pos_x = 0.0f;
-	float	 pos_y = 0.0f;
-	float	 pos_z = 0.0f;
-	float	 _pad0;
-	float	 scale_x = 1.0f;
-	float	 scale_y = 1.0f;
-	float	 rotation = 0.0f;
-	uint32_t index = 1;
-	float	 uvScale = 1.0f;
-	uint32_t emitsLight = 0;
-	uint32_t frame = 0;
-	float	 _pad1;
-};
-
 struct LightInstance
 {
 	glm::vec3 colorRGB;
@@ -212,6 +197,10 @@ bool Mupfel::ECSRenderer::Init(const Ping::Device& device, Ping::Format swapChai
 
 	UpdateSamplerDescriptors(device);
 
+	/* instanceSorting in mupfel.ini: 0 = packing order, 1 = radix sort every frame, 2 = incremental (default). */
+	const int32_t sorting = Application::GetConfigEntry<int32_t>("instanceSorting").value_or(2);
+	sorter.SetMode(static_cast<InstanceSorter::Mode>(std::clamp(sorting, 0, 2)));
+
 	return true;
 }
 
@@ -315,43 +304,27 @@ void Mupfel::ECSRenderer::EnsureLightCapacity(const Ping::Device& device, uint32
 
 void Mupfel::ECSRenderer::SyncRenderableObjects(const Ping::Device& device, uint32_t frame_index)
 {
+	MUPFEL_PROFILE_COUNTERS("Instance Packing");
+
 	Mupfel::Registry& registry = Mupfel::Application::GetCurrentRegistry();
 	EnsureTransformCapacity(device, registry.GetCurrentEntities());
 
-	uint32_t buffer_index = 0;
-
 	TextureInstance* buffer = static_cast<TextureInstance*>(textureInstanceBuffers[frame_index].GetMappedPtr());
+	const std::vector<ImageRegion>& regions = Application::GetCurrentImageManager().GetRegions();
 
-	for (auto [e, texture, transform] : registry.view<Mupfel::Texture, Mupfel::Transform>())
+	/* Only quads inside the camera frustum are packed, so the instance count handed to DrawIndexed
+	 * scales with what is on screen rather than with the size of the world. */
+	if (sorter.GetMode() == InstanceSorter::Mode::Off)
 	{
-		buffer[buffer_index].index = texture.index;
-		buffer[buffer_index].uvScale = texture.uvScale;
-		buffer[buffer_index].pos_x = transform.pos_x;
-		buffer[buffer_index].pos_y = transform.pos_y;
-		buffer[buffer_index].pos_z = transform.pos_z;
-		buffer[buffer_index].rotation = transform.rotation;
-		buffer[buffer_index].scale_x = transform.scale_x;
-		buffer[buffer_index].scale_y = transform.scale_y;
-
-		/* TODO: check if GetSignature might be more performant! */
-		if (registry.HasComponent<Mupfel::Light>(e))
-		{
-			buffer[buffer_index].emitsLight = 1;
-		}
-
-		if (registry.HasComponent<Mupfel::Animation>(e))
-		{
-			buffer[buffer_index].frame = registry.GetComponent<Mupfel::Animation>(e).currentFrame;
-		}
-		else
-		{
-			buffer[buffer_index].frame = 0; // static: layer 0
-		}
-
-		buffer_index++;
+		drawable_entities = InstancePacker::Pack(registry, frustum, {buffer, transformCapacity}, regions);
+		return;
 	}
 
-	drawable_entities = buffer_index;
+	/* Sorting needs the whole frame's instances first, so pack into host memory and let the sorter
+	 * write the mapped buffer in draw order. */
+	staging.resize(transformCapacity);
+	drawable_entities = InstancePacker::Pack(registry, frustum, staging, regions);
+	sorter.Sort({staging.data(), drawable_entities}, {buffer, transformCapacity});
 }
 
 void Mupfel::ECSRenderer::SyncLights(const Ping::Device& device, uint32_t frame_index)
@@ -359,8 +332,9 @@ void Mupfel::ECSRenderer::SyncLights(const Ping::Device& device, uint32_t frame_
 	Mupfel::Registry& registry = Mupfel::Application::GetCurrentRegistry();
 	uint32_t		  buffer_index = 0;
 
-	for (auto [e, light, transform] : registry.view<Mupfel::Light, Mupfel::Transform>())
+	for (auto [e, light, local] : registry.view<Mupfel::Light, Mupfel::Transform>())
 	{
+		const Mupfel::Transform transform = InstancePacker::Placement(registry, e, local);
 
 		EnsureLightCapacity(device, buffer_index + 1);
 		LightInstance* buffer = static_cast<LightInstance*>(lightInstanceBuffers[frame_index].GetMappedPtr());
@@ -389,26 +363,18 @@ void Mupfel::ECSRenderer::UpdateMVP(Ping::Buffer& uniform_buffer)
 	int32_t height = Application::GetCurrentRenderHeight();
 	Camera	cam = Application::GetCurrentSceneCamera();
 
-	glm::vec3 cameraTarget = glm::vec3(cam.target_x, cam.target_y, cam.target_z);
-
-
-	glm::vec3 eye =
-		cameraTarget + cam.distance * glm::vec3(
-											glm::cos(cam.pitch) * glm::cos(cam.yaw),
-														glm::cos(cam.pitch) * glm::sin(cam.yaw), glm::sin(cam.pitch));
+	const float			 aspect = static_cast<float>(width) / static_cast<float>(height);
+	const CameraMatrices matrices = CameraMatrices::FromCamera(cam, aspect);
 
 	UniformBufferObject ubo{};
-	ubo.view = lookAt(eye, cameraTarget, glm::vec3(0.0f, 0.0f, 1.0f));
-	const float aspect = static_cast<float>(width) / static_cast<float>(height);
-	const float half_height = cam.distance * glm::tan(glm::radians(45.0f) * 0.5f);
-	const float half_width = half_height * aspect;
-
-	ubo.proj = glm::ortho(-half_width, half_width, -half_height, half_height, 0.1f, 500.0f);
-
-	ubo.proj[1][1] *= -1;
+	ubo.view = matrices.view;
+	ubo.proj = matrices.proj;
 	ubo.cameraRight = glm::vec4(-glm::sin(cam.yaw), glm::cos(cam.yaw), 0.0f, 0.0f);
-	ubo.cameraPos = glm::vec4(eye, 1.0f);
+	ubo.cameraPos = glm::vec4(matrices.eye, 1.0f);
 	std::memcpy(uniform_buffer.GetMappedPtr(), &ubo, sizeof(UniformBufferObject));
+
+	/* The packing stage culls against exactly the matrices the shader receives. */
+	frustum = Frustum::FromViewProjection(matrices.proj * matrices.view);
 }
 
 void Mupfel::ECSRenderer::UpdateSamplerDescriptors(const Ping::Device& device)
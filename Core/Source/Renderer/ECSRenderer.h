@@ -2,6 +2,8 @@
 #include "Ping/Buffer.h"
 #include "Ping/Pipeline.h"
 #include "Ping/Sampler.h"
+#include "Frustum.h"
+#include "InstanceSorter.h"
 #include "SubRenderer.h"
 #include "Logger.h"
 #include <optional>
@@ -59,6 +61,12 @@ private:
 	std::vector<Ping::Sampler>			samplers;
 	std::optional<Ping::DescriptorSets> samplerDescriptorSets;
 	uint32_t							currentImageCount = 0;
+	/** Camera frustum of the current frame, refreshed by `UpdateMVP` before instances are packed. */
+	Frustum frustum;
+	/** Orders the packed instances by layer, depth and texture before upload. */
+	InstanceSorter sorter;
+	/** Host-side packing target while sorting is enabled; the sorter copies it into the mapped buffer. */
+	std::vector<TextureInstance> staging;
 
 };
 
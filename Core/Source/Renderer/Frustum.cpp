@@ -0,0 +1,91 @@
+#include "Frustum.h"
+#include "Renderer/Camera.h"
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Mupfel;
+
+CameraMatrices Mupfel::CameraMatrices::FromCamera(const Camera& cam, float aspect)
+{
+	glm::vec3 cameraTarget = glm::vec3(cam.target_x, cam.target_y, cam.target_z);
+
+	CameraMatrices m;
+	m.eye = cameraTarget + cam.distance * glm::vec3(
+											  glm::cos(cam.pitch) * glm::cos(cam.yaw),
+											  glm::cos(cam.pitch) * glm::sin(cam.yaw), glm::sin(cam.pitch));
+
+	m.view = glm::lookAt(m.eye, cameraTarget, glm::vec3(0.0f, 0.0f, 1.0f));
+
+	const float half_height = cam.distance * glm::tan(glm::radians(45.0f) * 0.5f);
+	const float half_width = half_height * aspect;
+
+	m.proj = glm::ortho(-half_width, half_width, -half_height, half_height, 0.1f, 500.0f);
+	m.proj[1][1] *= -1;
+
+	return m;
+}
+
+Mupfel::Frustum::Frustum() : planes{} {}
+
+Frustum Mupfel::Frustum::FromViewProjection(const glm::mat4& m)
+{
+	/* glm is column-major: row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i]). */
+	auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+	const glm::vec4 r0 = row(0);
+	const glm::vec4 r1 = row(1);
+	const glm::vec4 r2 = row(2);
+	const glm::vec4 r3 = row(3);
+
+	/* Left, right, bottom, top, near (z >= 0 for zero-to-one depth), far. The y flip in the
+	 * projection only swaps which of bottom/top is which, so it needs no special handling. */
+	const std::array<glm::vec4, 6> raw = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2};
+
+	Frustum f;
+	for (size_t i = 0; i < raw.size(); i++)
+	{
+		const float len = glm::length(glm::vec3(raw[i]));
+		const float inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+
+		f.planes[i] = {raw[i].x * inv, raw[i].y * inv, raw[i].z * inv, raw[i].w * inv};
+	}
+
+	return f;
+}
+
+Frustum::Containment Mupfel::Frustum::ClassifyBox(const glm::vec3& min, const glm::vec3& max) const
+{
+	Containment result = Containment::Inside;
+
+	for (const Plane& p : planes)
+	{
+		/* The box corner furthest along the plane normal ("positive vertex") decides whether the box is
+		 * outside, the opposite corner whether it is completely inside. */
+		const float px = p.nx >= 0.0f ? max.x : min.x;
+		const float py = p.ny >= 0.0f ? max.y : min.y;
+		const float pz = p.nz >= 0.0f ? max.z : min.z;
+
+		if (p.nx * px + p.ny * py + p.nz * pz + p.d < 0.0f)
+		{
+			return Containment::Outside;
+		}
+
+		const float nx = p.nx >= 0.0f ? min.x : max.x;
+		const float ny = p.ny >= 0.0f ? min.y : max.y;
+		const float nz = p.nz >= 0.0f ? min.z : max.z;
+
+		if (p.nx * nx + p.ny * ny + p.nz * nz + p.d < 0.0f)
+		{
+			result = Containment::Intersecting;
+		}
+	}
+
+	return result;
+}
+
+float Mupfel::Frustum::QuadRadius(float scale_x, float scale_y)
+{
+	/* The unit quad spans [-0.5, 0.5], so its half diagonal is half the length of the scale vector. */
+	return 0.5f * std::sqrt(scale_x * scale_x + scale_y * scale_y);
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace Mupfel
+{
+
+class Camera;
+
+/**
+ * View and projection of a scene camera, exactly as the ECS shader receives them. Shared by
+ * `ECSRenderer::UpdateMVP` (which uploads it) and `Frustum` (which culls against it), so the CPU
+ * culling stage can never disagree with what the GPU actually draws.
+ */
+struct CameraMatrices
+{
+	glm::mat4 view;
+	glm::mat4 proj;
+	glm::vec3 eye;
+
+	/**
+	 * Builds the orbiting orthographic camera used by the ECS renderer.
+	 *
+	 * \param cam The scene camera.
+	 * \param aspect Render width divided by render height.
+	 */
+	static CameraMatrices FromCamera(const Camera& cam, float aspect);
+};
+
+/**
+ * The six world-space clip planes of a view-projection matrix, used to reject instances before they
+ * are packed into the instance buffer.
+ *
+ * Planes are stored normalized with their normals pointing into the frustum, so the signed distance
+ * of a point to a plane is `dot(n, p) + d` and a point is inside when all six distances are >= 0.
+ */
+class Frustum
+{
+public:
+	/** Result of a box test: the box is either completely outside, straddles a plane, or is fully inside. */
+	enum class Containment : uint8_t
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+public:
+	/** An all-accepting frustum (every test passes). */
+	Frustum();
+
+	/**
+	 * Extracts the planes from `proj * view` (Gribb/Hartmann). Assumes Vulkan's [0, 1] clip depth,
+	 * which is what `GLM_FORCE_DEPTH_ZERO_TO_ONE` gives us everywhere in the renderer.
+	 */
+	static Frustum FromViewProjection(const glm::mat4& view_proj);
+
+	/** Whether a sphere around (`x`, `y`, `z`) with `radius` touches the frustum. */
+	bool IntersectsSphere(float x, float y, float z, float radius) const
+	{
+		for (const Plane& p : planes)
+		{
+			if (p.nx * x + p.ny * y + p.nz * z + p.d < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Classifies the axis-aligned box [`min`, `max`] against the frustum. */
+	Containment ClassifyBox(const glm::vec3& min, const glm::vec3& max) const;
+
+	/**
+	 * Bounding-sphere radius of a unit quad scaled by (`scale_x`, `scale_y`). Independent of the
+	 * quad's rotation, so it stays valid for spinning sprites.
+	 */
+	static float QuadRadius(float scale_x, float scale_y);
+
+private:
+	struct Plane
+	{
+		float nx = 0.0f;
+		float ny = 0.0f;
+		float nz = 0.0f;
+		float d = 1.0f;
+	};
+
+	std::array<Plane, 6> planes;
+};
+
+} // namespace Mupfel
@@ -1,25 +1,15 @@
 #include "IMRenderer.h"
 #include "Core/Application.h"
 #include <cassert>
+#include <string>
 #include "Quad.h"
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-struct TextureInstance
-{
-	float	 pos_x = 0.0f;
-	float	 pos_y = 0.0f;
-	float	 width = 1.0f;
-	float	 height = 1.0f;
-	float	 rotation = 0.0f;
-	uint32_t index = 1;
-	float	 uvScale = 1.0f;
-	float	 _pad0;
-};
-
-static const uint32_t default_entity_capacity = 1000;
+/* The batch grows the instance buffers geometrically, so this only sets where it starts. */
+static const uint32_t default_instance_capacity = 4096;
 
 bool Mupfel::IMRenderer::Init(const Ping::Device& device, Ping::Format swapChainFormat)
 {
@@ -74,11 +64,11 @@ bool Mupfel::IMRenderer::Init(const Ping::Device& device, Ping::Format swapChain
 
 		/* Create transform buffers to render entities */
 		textureInstanceBuffers.emplace_back(device.CreateBuffer(
-			sizeof(TextureInstance) * default_entity_capacity, Ping::BufferUsage::StorageBuffer,
+			sizeof(UIInstance) * default_instance_capacity, Ping::BufferUsage::StorageBuffer,
 			Ping::MemoryProperty::HostVisible | Ping::MemoryProperty::HostCoherent |
 				Ping::MemoryProperty::DeviceLocal));
 	}
-	transformCapacity = default_entity_capacity;
+	transformCapacity = default_instance_capacity;
 
 	index_buffer = std::move(device.CreateBuffer(
 		sizeof(uint16_t) * quadIndices.size(), Ping::BufferUsage::IndexBuffer | Ping::BufferUsage::TransferDst,
@@ -123,11 +113,15 @@ bool Mupfel::IMRenderer::Init(const Ping::Device& device, Ping::Format swapChain
 
 void Mupfel::IMRenderer::PreUser(const Ping::Device& device, Ping::CommandBuffer& current_command_buffer)
 {
-	drawable_items = 0;
+	batch.Begin(
+		static_cast<float>(Application::GetCurrentRenderWidth()),
+		static_cast<float>(Application::GetCurrentRenderHeight()));
 }
 
 void Mupfel::IMRenderer::PostUser(const Ping::Device& device, Ping::CommandBuffer& current_command_buffer)
 {
+	drawable_items = batch.Size();
+
 	/* If there are no objects to draw, we can early exit. */
 
 	if (drawable_items == 0)
@@ -136,6 +130,11 @@ void Mupfel::IMRenderer::PostUser(const Ping::Device& device, Ping::CommandBuffe
 		return;
 	}
 
+	/* The whole frame is known now, so the instance buffers are resized at most once and filled with
+	 * one copy per allocator page. */
+	EnsureTransformCapacity(drawable_items);
+	batch.CopyTo({static_cast<UIInstance*>(textureInstanceBuffers[frameIndex].GetMappedPtr()), transformCapacity});
+
 	current_command_buffer.BindPipeline(pipeline.value());
 
 	if (samplerDescriptorSets.has_value())
@@ -156,17 +155,16 @@ void Mupfel::IMRenderer::PostUser(const Ping::Device& device, Ping::CommandBuffe
 	IncrementFrameIndex();
 }
 
-uint32_t Mupfel::IMRenderer::Button(float x, float y, float width, float height, const std::string& image_path)
+uint32_t Mupfel::IMRenderer::Button(float x, float y, float width, float height, UIImage image)
 {
-	if (!UploadImage(image_path))
+	const std::array<ImageHandle, 3>* states = GetButtonImages(image);
+	if (!states)
 	{
 		/* Something went wrong uploading the image. */
 		return 0;
 	}
-	auto it = images.find(image_path);
-	assert(it->second.size() == 3);
 
-	ImageHandle image_h = it->second[0];
+	ImageHandle image_h = (*states)[0];
 
 	uint32_t return_value = 0;
 
@@ -181,53 +179,62 @@ uint32_t Mupfel::IMRenderer::Button(float x, float y, float width, float height,
 		/* The button is released. TODO: this search is linear currently! */
 		if (Application::GetCurrentInputManager().CheckUserInput(UserInput::LEFT_MOUSE_CLICK))
 		{
-			image_h = it->second[2];
+			image_h = (*states)[2];
 			return_value = 3;
 		}
 		else if (Application::GetMouseButton(MouseButton::MOUSE_BUTTON_LEFT) == KeyAction::PRESSED)
 		{
-			image_h = it->second[2];
+			image_h = (*states)[2];
 			return_value = 2;
 		}
 		else
 		{
-			image_h = it->second[1];
+			image_h = (*states)[1];
 			return_value = 1;
 		}
 	}
 
-	PushObject(x, y, width, height, 0.0f, image_h, 1.0f);
+	batch.Push(x, y, width, height, 0.0f, Application::GetCurrentImageManager().GetRegion(image_h), 1.0f);
 
 	return return_value;
 }
 
-bool Mupfel::IMRenderer::UploadImage(const std::string& image_path)
+void Mupfel::IMRenderer::Image(float x, float y, float width, float height, ImageHandle image, float rotation)
+{
+	batch.Push(x, y, width, height, rotation, Application::GetCurrentImageManager().GetRegion(image), 1.0f);
+}
+
+const std::array<ImageHandle, 3>* Mupfel::IMRenderer::GetButtonImages(UIImage image)
 {
 	/* Check if the given texture was already used before. */
-	auto it = images.find(image_path);
+	auto it = buttons.find(image.GetHash());
 
-	if (it == images.end())
+	if (it != buttons.end())
 	{
-		/* Load it from disk. The image needs to be a spritesheet with one row, containing 3 images, in the following
-		 * order:
-		 * 1. The unhovered button.
-		 * 2. The hovered button.
-		 * 3. The pressed button.
-		 */
-		auto image_handles = Application::LoadSpriteSheetImages(image_path, {.rows = 1, .columns = 3});
-
-		if (!image_handles)
-		{
-			return false;
-		}
+		return &it->second;
+	}
 
-		images[image_path] = image_handles.value();
+	/* Load it from disk. The image needs to be a spritesheet with one row, containing 3 images, in the following
+	 * order:
+	 * 1. The unhovered button.
+	 * 2. The hovered button.
+	 * 3. The pressed button.
+	 */
+	auto image_handles =
+		Application::LoadSpriteSheetImages(std::string(image.GetPath()), {.rows = 1, .columns = 3});
+
+	if (!image_handles)
+	{
+		return nullptr;
 	}
 
-	/* We should only get here if the image upload succeeded... */
-	assert(images.find(image_path) != images.end());
+	assert(image_handles.value().size() == 3);
 
-	return true;
+	auto [inserted, _] = buttons.emplace(
+		image.GetHash(),
+		std::array<ImageHandle, 3>{image_handles.value()[0], image_handles.value()[1], image_handles.value()[2]});
+
+	return &inserted->second;
 }
 
 void Mupfel::IMRenderer::UpdateSamplerDescriptors(const Ping::Device& device)
@@ -269,7 +276,7 @@ void Mupfel::IMRenderer::EnsureTransformCapacity(uint32_t required_capacity)
 	for (uint32_t i = 0; i < framesInFlight; i++)
 	{
 		textureInstanceBuffers.emplace_back(device->CreateBuffer(
-			sizeof(TextureInstance) * new_capacity, Ping::BufferUsage::StorageBuffer,
+			sizeof(UIInstance) * new_capacity, Ping::BufferUsage::StorageBuffer,
 			Ping::MemoryProperty::HostVisible | Ping::MemoryProperty::HostCoherent |
 				Ping::MemoryProperty::DeviceLocal));
 	}
@@ -279,38 +286,3 @@ void Mupfel::IMRenderer::EnsureTransformCapacity(uint32_t required_capacity)
 
 	transformCapacity = new_capacity;
 }
-
-void Mupfel::IMRenderer::PushObject(
-	float	 x,
-	float	 y,
-	float	 width,
-	float	 height,
-	float	 rotation,
-	uint32_t index,
-	float	 uv_scale)
-{
-	EnsureTransformCapacity(drawable_items + 1);
-
-	const float screen_w = static_cast<float>(Application::GetCurrentRenderWidth());
-	const float screen_h = static_cast<float>(Application::GetCurrentRenderHeight());
-
-	if (screen_w <= 0.0f || screen_h <= 0.0f)
-	{
-		return;
-	}
-
-	/* The quad spans [-0.5, 0.5] around its centre, so convert the top-left pixel rect
-	 * into an NDC centre plus an NDC extent. Framebuffer Y and GLFW cursor Y both point
-	 * down, so no flip is needed. */
-	TextureInstance t{};
-	t.pos_x = ((x + width * 0.5f) / screen_w) * 2.0f - 1.0f;
-	t.pos_y = ((y + height * 0.5f) / screen_h) * 2.0f - 1.0f;
-	t.width = (width / screen_w) * 2.0f;
-	t.height = -(height / screen_h) * 2.0f;
-	t.rotation = rotation;
-	t.index = index;
-	t.uvScale = uv_scale;
-
-	static_cast<TextureInstance*>(textureInstanceBuffers[frameIndex].GetMappedPtr())[drawable_items] = t;
-	++drawable_items;
-}
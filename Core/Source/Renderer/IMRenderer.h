@@ -1,8 +1,10 @@
 #pragma once
+#include "Core/UI.h"
 #include "ImageManager.h"
 #include "Logger.h"
 #include "SubRenderer.h"
-#include <string>
+#include "UIBatch.h"
+#include <array>
 #include <unordered_map>
 #include <vector>
 
@@ -26,31 +28,36 @@ public:
 	 * \param y y-offset in screen space.
 	 * \param width The width of the button. This is independent of the used texture.
 	 * \param height The height of the button. This is independent of the used texture.
-	 * \param image_path Path to an image containing the button texture.
+	 * \param image A spritesheet with one row of three images: unhovered, hovered and pressed.
 	 * \return 0 if the cursor is not overlapping the button, 1 if the cursor is hovering over the button, 2 if the
 	 * button is pressed.
 	 */
-	uint32_t Button(float x, float y, float width, float height, const std::string& image_path);
+	uint32_t Button(float x, float y, float width, float height, UIImage image);
+
+	/** Queue an already loaded image as a screen-space quad, see `UI::Image`. */
+	void Image(float x, float y, float width, float height, ImageHandle image, float rotation);
 
 private:
-	bool UploadImage(const std::string& image_path);
+	/** The three button states of `image`, loading the spritesheet on first use. Null if loading failed. */
+	const std::array<ImageHandle, 3>* GetButtonImages(UIImage image);
 	void UpdateSamplerDescriptors(const Ping::Device& device);
 	void EnsureTransformCapacity(uint32_t required_capacity);
-	void PushObject(
-		float				x,
-		float				y,
-		float				width,
-		float				height,
-		float				rotation,
-		uint32_t			index,
-		float				uv_scale);
 
 private:
 	static constexpr uint32_t								  samplerSetIndex = 0;
 	static constexpr uint32_t								  transformSetIndex = 1;
 	static constexpr uint32_t								  max_textures = 4096;
 	Logger::SafeLoggerPtr									  logger;
-	std::unordered_map<std::string, std::vector<ImageHandle>> images;
+
+	/** `UIImage` hashes are already well mixed, so the map uses them as they are. */
+	struct PrehashedKey
+	{
+		size_t operator()(uint64_t hash) const { return static_cast<size_t>(hash); }
+	};
+	/** Button spritesheets by `UIImage` hash. */
+	std::unordered_map<uint64_t, std::array<ImageHandle, 3>, PrehashedKey> buttons;
+	/** This frame's quads; copied into `textureInstanceBuffers[frameIndex]` once in `PostUser`. */
+	UIBatch batch;
 	std::optional<Ping::Pipeline>							  pipeline;
 	/** One host-visible vertex buffer per frame in flight. */
 	std::vector<Ping::Buffer> vertex_buffers;
@@ -1,14 +1,85 @@
 #include "ImageManager.h"
+#include "AsyncImageLoader.h"
+#include "Core/Application.h"
+#include "Core/Logger.h"
+#include "Core/ThreadPool.h"
 #include "Ping/Device.h"
 #include "Ping/Image.h"
+#include "PngWriter.h"
 #include "Renderer/Renderer.h"
+#include "TextureAtlas.h"
+#include <chrono>
+#include <format>
 #include <optional>
+#include <random>
+#include <system_error>
 
 using namespace Mupfel;
 
-Expected<ImageHandle> Mupfel::ImageManager::Load(const Ping::Device& device, const std::string path)
+namespace Mupfel
+{
+
+/** Places decoded images through Ping: small ones go into the atlas, the rest get images of their own. */
+class PingUploadDevice : public ImageUploadDevice
+{
+public:
+	PingUploadDevice(const Ping::Device& in_device, ImageManager& in_manager)
+		: device(in_device), manager(in_manager)
+	{
+	}
+
+	void UploadBatch(std::span<DecodeResult> batch) final
+	{
+		for (DecodeResult& result : batch)
+		{
+			if (!result.images)
+			{
+				/* The handles keep the region of the default texture they were reserved with. */
+				manager.logger->error(
+					"Unable to load image {}, falling back to the default texture.", result.request.path);
+
+				const ImageHandle first = result.request.firstHandle;
+				for (uint32_t i = 0; i < result.request.HandleCount(); i++)
+				{
+					manager.loaded[first + i] = true;
+				}
+				continue;
+			}
+
+			for (const DecodedImage& image : result.images.value())
+			{
+				manager.Place(device, image);
+			}
+		}
+	}
+
+private:
+	const Ping::Device& device;
+	ImageManager&		manager;
+};
+
+} // namespace Mupfel
+
+Mupfel::ImageManager::ImageManager() = default;
+
+Mupfel::ImageManager::~ImageManager()
 {
+	/* Workers may still be writing into the upload directory; the loader waits for its own on destruction. */
+	loader.reset();
+	for (PageUpload& upload : pageUploads)
+	{
+		upload.written.wait();
+	}
+
+	if (!uploadDirectory.empty())
+	{
+		std::error_code error;
+		std::filesystem::remove_all(uploadDirectory, error);
+	}
+}
 
+Expected<ImageHandle> Mupfel::ImageManager::Load(const Ping::Device& device, const std::string path)
+{
 	if (imageHandleMap.contains(path) && (imageHandleMap[path].size() > 0))
 	{
 		/* Image is already loaded. */
@@ -22,13 +93,10 @@ Expected<ImageHandle> Mupfel::ImageManager::Load(const Ping::Device& device, con
 		return std::unexpected<Error>(Error::FILE_NOT_FOUND);
 	}
 
-	ImageHandle handle = static_cast<uint32_t>(images.size());
-
-	images.emplace_back(std::move(image.value()));
+	ImageHandle handle = AddHandle(AddImage(std::move(image.value())));
 
 	imageHandleMap[path].push_back(handle);
 
-
 	return handle;
 }
 
@@ -50,9 +118,7 @@ Expected<ImageHandle> Mupfel::ImageManager::LoadAnimated(
 		return std::unexpected<Error>(Error::FILE_NOT_FOUND);
 	}
 
-	ImageHandle handle = static_cast<uint32_t>(images.size());
-
-	images.emplace_back(std::move(image.value()));
+	ImageHandle handle = AddHandle(AddImage(std::move(image.value())));
 
 	imageHandleMap[path].push_back(handle);
 
@@ -84,13 +150,10 @@ Expected<std::vector<ImageHandle>> Mupfel::ImageManager::LoadSpriteSheet(
 	}
 
 	std::vector<ImageHandle> handles;
-	ImageHandle				 handle = static_cast<uint32_t>(images.size());
 
 	for (uint32_t i = 0; i < created_images.value().size(); i++)
 	{
-		handles.push_back(handle);
-		images.emplace_back(std::move(created_images.value()[i]));
-		handle = static_cast<uint32_t>(images.size());
+		handles.push_back(AddHandle(AddImage(std::move(created_images.value()[i]))));
 	}
 
 	imageHandleMap[path] = handles;
@@ -98,6 +161,211 @@ Expected<std::vector<ImageHandle>> Mupfel::ImageManager::LoadSpriteSheet(
 	return handles;
 }
 
+ImageHandle Mupfel::ImageManager::LoadAsync(const std::string path)
+{
+	return Submit({.path = path, .kind = ImageRequestKind::Basic}).front();
+}
+
+ImageHandle Mupfel::ImageManager::LoadAnimatedAsync(const std::string path, const ImageSpecification& spec)
+{
+	return Submit({.path = path, .kind = ImageRequestKind::Animated, .spec = spec}).front();
+}
+
+std::vector<ImageHandle> Mupfel::ImageManager::LoadSpriteSheetAsync(
+	const std::string		  path,
+	const ImageSpecification& spec)
+{
+	return Submit({.path = path, .kind = ImageRequestKind::SpriteSheet, .spec = spec});
+}
+
+bool Mupfel::ImageManager::IsLoaded(ImageHandle image) const { return image < loaded.size() && loaded[image]; }
+
+ImageRegion Mupfel::ImageManager::GetRegion(ImageHandle image) const
+{
+	return (image < regions.size()) ? regions[image] : ImageRegion{};
+}
+
+void Mupfel::ImageManager::ProcessUploads(const Ping::Device& device)
+{
+	if (!loader)
+	{
+		return;
+	}
+
+	if (loader->Pending() > 0)
+	{
+		PingUploadDevice upload_device{device, *this};
+		loader->Collect(upload_device, uploadBudgetPerFrame);
+	}
+
+	UploadAtlas(device);
+}
+
+std::vector<ImageHandle> Mupfel::ImageManager::Submit(ImageRequest request)
+{
+	if (imageHandleMap.contains(request.path) && (imageHandleMap[request.path].size() > 0))
+	{
+		/* Image is already loaded or on its way. */
+		return imageHandleMap[request.path];
+	}
+
+	/* Until the upload, the reserved handles show the default texture in slot 0. */
+	std::vector<ImageHandle> handles(request.HandleCount());
+	for (ImageHandle& handle : handles)
+	{
+		handle = static_cast<ImageHandle>(regions.size());
+		regions.emplace_back();
+		loaded.push_back(false);
+	}
+
+	request.firstHandle = handles.front();
+	request.pack = Application::GetResourcePack();
+	imageHandleMap[request.path] = handles;
+
+	if (!loader)
+	{
+		logger = Logger::Create("Image Manager");
+		atlas = std::make_unique<TextureAtlas>(atlasPageSize, maxAtlasImageSize);
+
+		/* Several engines may run side by side, each removes its own directory. */
+		std::error_code error;
+		uploadDirectory = std::filesystem::temp_directory_path(error) /
+						  std::format("mupfel-uploads-{:08x}", std::random_device{}());
+		if (!std::filesystem::create_directories(uploadDirectory, error))
+		{
+			/* Every write into it fails, so the images fall back to the default texture one by one. */
+			logger->error("Unable to create {} for asynchronous image loads.", uploadDirectory.string());
+		}
+
+		/* Whatever the atlas takes stays in memory, everything else goes to a file for Ping. */
+		loader = std::make_unique<AsyncImageLoader>(
+			Application::GetCurrentThreadPool(), uploadDirectory,
+			[](const DecodedImage& image) { return TextureAtlas::Fits(image, maxAtlasImageSize); });
+	}
+	loader->Submit(std::move(request));
+
+	return handles;
+}
+
+uint32_t Mupfel::ImageManager::AddImage(Ping::Image image)
+{
+	images.emplace_back(std::move(image));
+	return static_cast<uint32_t>(images.size() - 1);
+}
+
+ImageHandle Mupfel::ImageManager::AddHandle(uint32_t slot)
+{
+	regions.push_back({.slot = slot});
+	loaded.push_back(true);
+	return static_cast<ImageHandle>(regions.size() - 1);
+}
+
+void Mupfel::ImageManager::Place(const Ping::Device& device, const DecodedImage& image)
+{
+	loaded[image.handle] = true;
+
+	if (image.file.empty())
+	{
+		if (std::optional<ImageRegion> region = atlas->Insert(image))
+		{
+			/* Shown once its page has an image, see `UploadAtlas`. */
+			atlasPending.push_back({.handle = image.handle, .region = region.value()});
+			loaded[image.handle] = false;
+		}
+		else
+		{
+			logger->error("No upload file for handle {}, falling back to the default texture.", image.handle);
+		}
+		return;
+	}
+
+	/* Animated images are cut into their frames by Ping, just like synchronously loaded ones. */
+	std::optional<Ping::Image> created =
+		device.CreateImage(image.file.string(), Ping::ImageUsage::Sampled, image.spec.rows, image.spec.columns);
+
+	std::error_code error;
+	std::filesystem::remove(image.file, error);
+
+	if (!created.has_value())
+	{
+		logger->error("Unable to create image for handle {}, falling back to the default texture.", image.handle);
+		return;
+	}
+
+	regions[image.handle] = {.slot = AddImage(std::move(created.value()))};
+}
+
+void Mupfel::ImageManager::UploadAtlas(const Ping::Device& device)
+{
+	/* Pages are written in the order they were finished, so their images come in page order, too. */
+	while (!pageUploads.empty() &&
+		   pageUploads.front().written.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		PageUpload upload = std::move(pageUploads.front());
+		pageUploads.erase(pageUploads.begin());
+
+		std::optional<Ping::Image> created;
+		if (upload.written.get())
+		{
+			created = device.CreateImage(upload.file.string(), Ping::ImageUsage::Sampled);
+		}
+
+		std::error_code error;
+		std::filesystem::remove(upload.file, error);
+
+		if (!created.has_value())
+		{
+			logger->error("Unable to create atlas page {}, falling back to the default texture.", upload.page);
+		}
+
+		const std::optional<uint32_t> slot =
+			created.has_value() ? std::optional(AddImage(std::move(created.value()))) : std::nullopt;
+
+		std::erase_if(
+			atlasPending,
+			[&](const AtlasedImage& image)
+			{
+				if (image.region.layer != upload.page)
+				{
+					return false;
+				}
+
+				if (slot.has_value())
+				{
+					regions[image.handle] = image.region;
+					regions[image.handle].slot = slot.value();
+					regions[image.handle].layer = 0;
+				}
+				loaded[image.handle] = true;
+				return true;
+			});
+	}
+
+	if (atlas->GetPageCount() == atlas->GetFinishedPageCount())
+	{
+		return;
+	}
+
+	/* The fewer pages the images are spread over, the fewer descriptor slots they use: wait for more. */
+	if (loader->Pending() > 0 && ++atlasWaitFrames < atlasMaxWaitFrames)
+	{
+		return;
+	}
+	atlasWaitFrames = 0;
+
+	for (AtlasPage& page : atlas->FinishPages())
+	{
+		const std::filesystem::path file = uploadDirectory / std::format("atlas-{}.png", page.index);
+		const uint32_t				size = atlas->GetPageSize();
+
+		pageUploads.push_back(
+			{.page = page.index,
+			 .file = file,
+			 .written = Application::GetCurrentThreadPool().Enqueue(
+				 [file, size, pixels = std::move(page.pixels)]() { return WritePng(file, size, size, pixels); })});
+	}
+}
+
 void Mupfel::ImageManager::Unload(const std::string path)
 {
 	if (!imageHandleMap.contains(path))
@@ -115,3 +383,5 @@ void Mupfel::ImageManager::Unload(ImageHandle image) {}
 
 const std::vector<Ping::Image>& Mupfel::ImageManager::GetImages() const
 { return images; }
+
+const std::vector<ImageRegion>& Mupfel::ImageManager::GetRegions() const { return regions; }
@@ -0,0 +1,115 @@
+#include "InstancePacker.h"
+#include "ECS/Components/Animation.h"
+#include "ECS/Components/Hierarchy.h"
+#include "ECS/Components/Light.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+
+using namespace Mupfel;
+
+uint32_t Mupfel::InstancePacker::Pack(
+	Registry&					 registry,
+	const Frustum&				 frustum,
+	std::span<TextureInstance>	 out,
+	std::span<const ImageRegion> regions)
+{
+	uint32_t buffer_index = 0;
+
+	for (auto [e, texture, transform] : registry.view<Texture, Transform>())
+	{
+		if (buffer_index >= out.size())
+		{
+			break;
+		}
+
+		const Transform placed = Placement(registry, e, transform);
+
+		/* Off-screen quads never reach the instance buffer, so they cost neither upload nor vertex work. */
+		if (!frustum.IntersectsSphere(
+				placed.pos_x, placed.pos_y, placed.pos_z, Frustum::QuadRadius(placed.scale_x, placed.scale_y)))
+		{
+			continue;
+		}
+
+		Write(registry, e, texture, placed, regions, out[buffer_index]);
+		buffer_index++;
+	}
+
+	return buffer_index;
+}
+
+uint32_t Mupfel::InstancePacker::Pack(
+	Registry&					 registry,
+	std::span<const Entity>		 entities,
+	std::span<TextureInstance>	 out,
+	std::span<const ImageRegion> regions)
+{
+	uint32_t buffer_index = 0;
+
+	for (Entity e : entities)
+	{
+		if (buffer_index >= out.size())
+		{
+			break;
+		}
+
+		Write(
+			registry, e, registry.GetComponent<Texture>(e),
+			Placement(registry, e, registry.GetComponent<Transform>(e)), regions, out[buffer_index]);
+		buffer_index++;
+	}
+
+	return buffer_index;
+}
+
+Transform Mupfel::InstancePacker::Placement(Registry& registry, Entity e, const Transform& transform)
+{
+	if (!registry.GetSignature(e).test(ComponentIndex::Index<WorldTransform>()))
+	{
+		return transform;
+	}
+
+	const WorldTransform& world = registry.GetComponent<WorldTransform>(e);
+	return Transform{world.pos_x, world.pos_y, world.pos_z, world.scale_x, world.scale_y, world.rotation};
+}
+
+void Mupfel::InstancePacker::Write(
+	Registry&					 registry,
+	Entity						 e,
+	const Texture&				 texture,
+	const Transform&			 transform,
+	std::span<const ImageRegion> regions,
+	TextureInstance&			 instance)
+{
+	const ImageRegion region =
+		(texture.index < regions.size()) ? regions[texture.index] : ImageRegion{.slot = texture.index};
+
+	instance.index = region.slot;
+	instance.uv_u = region.u;
+	instance.uv_v = region.v;
+	instance.uv_width = region.width;
+	instance.uv_height = region.height;
+	instance.layer = texture.layer;
+	instance.uvScale = texture.uvScale;
+	instance.pos_x = transform.pos_x;
+	instance.pos_y = transform.pos_y;
+	instance.pos_z = transform.pos_z;
+	instance.rotation = transform.rotation;
+	instance.scale_x = transform.scale_x;
+	instance.scale_y = transform.scale_y;
+
+	/* One signature load answers both component checks. */
+	const Entity::Signature sig = registry.GetSignature(e);
+
+	instance.emitsLight = sig.test(ComponentIndex::Index<Light>()) ? 1 : 0;
+
+	if (sig.test(ComponentIndex::Index<Animation>()))
+	{
+		instance.frame = region.layer + registry.GetComponent<Animation>(e).currentFrame;
+	}
+	else
+	{
+		instance.frame = region.layer; // static: the image's first layer
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "ECS/Entity.h"
+#include "Frustum.h"
+#include "Renderer/ImageManager.h"
+#include <cstdint>
+#include <span>
+
+namespace Mupfel
+{
+
+class Registry;
+struct Texture;
+struct Transform;
+
+/**
+ * One drawable quad as the ECS vertex shader reads it (`TextureInstance` in ecs.slang, std430).
+ * Keep both definitions in sync.
+ */
+struct TextureInstance
+{
+	float	 pos_x = 0.0f;
+	float	 pos_y = 0.0f;
+	float	 pos_z = 0.0f;
+	/** Draw layer, only read by `InstanceSorter` (the shader ignores it). */
+	uint32_t layer = 0;
+	float	 scale_x = 1.0f;
+	float	 scale_y = 1.0f;
+	float	 rotation = 0.0f;
+	uint32_t index = 1;
+	float	 uvScale = 1.0f;
+	uint32_t emitsLight = 0;
+	uint32_t frame = 0;
+	float	 _pad1;
+	/** The part of the texture layer the quad shows (u, v, width, height), see `ImageRegion`. */
+	float	 uv_u = 0.0f;
+	float	 uv_v = 0.0f;
+	float	 uv_width = 1.0f;
+	float	 uv_height = 1.0f;
+};
+
+static_assert((sizeof(TextureInstance) == 64), "TextureInstance must match the std430 layout in ecs.slang!");
+
+/**
+ * Turns drawable (`Texture` + `Transform`) entities into `TextureInstance`s for the ECS renderer. Entities
+ * in a hierarchy are drawn where their `WorldTransform` puts them.
+ *
+ * Lives apart from `ECSRenderer` and has no GPU dependency, so the CPU side of a frame (culling +
+ * packing) can be benchmarked and tested without a window or a Vulkan device.
+ */
+class InstancePacker
+{
+public:
+	/**
+	 * Packs every drawable entity of the active scene whose quad touches `frustum` into `out`.
+	 *
+	 * `Texture::index` is an `ImageHandle`; `regions` (see `ImageManager::GetRegions`) resolves it to the
+	 * descriptor slot, layer and UV rectangle the shader samples. Handles outside `regions` are taken to be
+	 * slots already, showing all of layer 0.
+	 *
+	 * \return The number of instances written. Stops early once `out` is full.
+	 */
+	static uint32_t Pack(
+		Registry&					 registry,
+		const Frustum&				 frustum,
+		std::span<TextureInstance>	 out,
+		std::span<const ImageRegion> regions = {});
+
+	/**
+	 * Packs the given drawable entities (e.g. the result of a `VisibilityGrid` query) into `out`, in
+	 * order, without any further culling. `regions` as above.
+	 *
+	 * \return The number of instances written. Stops early once `out` is full.
+	 */
+	static uint32_t Pack(
+		Registry&					 registry,
+		std::span<const Entity>		 entities,
+		std::span<TextureInstance>	 out,
+		std::span<const ImageRegion> regions = {});
+
+	/**
+	 * Where \a e is drawn: its `WorldTransform` if it is part of a hierarchy (see `TransformSystem`),
+	 * \a transform, its own `Transform`, otherwise.
+	 */
+	static Transform Placement(Registry& registry, Entity e, const Transform& transform);
+
+private:
+	static void Write(
+		Registry&					 registry,
+		Entity						 e,
+		const Texture&				 texture,
+		const Transform&			 transform,
+		std::span<const ImageRegion> regions,
+		TextureInstance&			 instance);
+};
+
+} // namespace Mupfel
@@ -0,0 +1,188 @@
+#include "InstanceSorter.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <numeric>
+
+using namespace Mupfel;
+
+void Mupfel::InstanceSorter::SetMode(Mode in_mode) { mode = in_mode; }
+
+InstanceSorter::Mode Mupfel::InstanceSorter::GetMode() const { return mode; }
+
+bool Mupfel::InstanceSorter::LastSortFellBack() const { return fell_back; }
+
+uint64_t Mupfel::InstanceSorter::MakeKey(const TextureInstance& instance)
+{
+	/* Map the float onto an unsigned integer with the same ordering: flip every bit of negatives
+	 * (so larger magnitudes sort first) and only the sign bit of positives. */
+	const uint32_t bits = std::bit_cast<uint32_t>(instance.pos_z);
+	const uint32_t depth = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+	const uint64_t layer = std::min<uint32_t>(instance.layer, 0xFFu);
+	const uint64_t texture = instance.index & 0xFFFu;
+
+	return (layer << 44) | (static_cast<uint64_t>(depth) << 12) | texture;
+}
+
+void Mupfel::InstanceSorter::Sort(std::span<const TextureInstance> in, std::span<TextureInstance> out)
+{
+	const uint32_t count = static_cast<uint32_t>(in.size());
+	fell_back = false;
+
+	if (mode == Mode::Off || count < 2)
+	{
+		std::copy(in.begin(), in.end(), out.begin());
+		return;
+	}
+
+	keys.resize(count);
+
+	if (mode == Mode::Incremental && !order.empty())
+	{
+		SeedFromPreviousOrder(count);
+
+		/* Compute the keys in input order (sequential reads of the wide instances), then permute the
+		 * narrow keys into last frame's order. */
+		scratch_keys.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			scratch_keys[i] = MakeKey(in[i]);
+		}
+		for (uint32_t i = 0; i < count; i++)
+		{
+			keys[i] = scratch_keys[order[i]];
+		}
+
+		/* Linear budget: a coherent frame needs only a handful of moves per instance. */
+		if (!InsertionSort(count))
+		{
+			fell_back = true;
+			RadixSort();
+		}
+	}
+	else
+	{
+		order.resize(count);
+		std::iota(order.begin(), order.end(), 0u);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			keys[i] = MakeKey(in[i]);
+		}
+
+		RadixSort();
+	}
+
+	/* Gather in draw order. `out` is usually mapped GPU memory, so it is written strictly sequentially. */
+	for (uint32_t i = 0; i < count; i++)
+	{
+		out[i] = in[order[i]];
+	}
+}
+
+void Mupfel::InstanceSorter::RadixSort()
+{
+	const uint32_t count = static_cast<uint32_t>(keys.size());
+
+	scratch_keys.resize(count);
+	scratch_order.resize(count);
+
+	/* One read of the keys builds the histograms of every digit. */
+	std::array<std::array<uint32_t, bucket_count>, digit_count> histograms{};
+	for (uint64_t key : keys)
+	{
+		for (uint32_t d = 0; d < digit_count; d++)
+		{
+			histograms[d][(key >> (d * digit_bits)) & (bucket_count - 1)]++;
+		}
+	}
+
+	for (uint32_t d = 0; d < digit_count; d++)
+	{
+		auto& histogram = histograms[d];
+
+		/* Every key has the same digit here, so this pass would not move anything. */
+		if (std::ranges::any_of(histogram, [count](uint32_t n) { return n == count; }))
+		{
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t& bucket : histogram)
+		{
+			const uint32_t n = bucket;
+			bucket = offset;
+			offset += n;
+		}
+
+		const uint32_t shift = d * digit_bits;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint32_t dst = histogram[(keys[i] >> shift) & (bucket_count - 1)]++;
+			scratch_keys[dst] = keys[i];
+			scratch_order[dst] = order[i];
+		}
+
+		keys.swap(scratch_keys);
+		order.swap(scratch_order);
+	}
+}
+
+bool Mupfel::InstanceSorter::InsertionSort(uint64_t budget)
+{
+	const uint32_t count = static_cast<uint32_t>(keys.size());
+	uint64_t	   moves = 0;
+
+	for (uint32_t i = 1; i < count; i++)
+	{
+		const uint64_t key = keys[i];
+		const uint32_t index = order[i];
+		uint32_t	   j = i;
+
+		while (j > 0 && keys[j - 1] > key)
+		{
+			keys[j] = keys[j - 1];
+			order[j] = order[j - 1];
+			j--;
+
+			if (++moves > budget)
+			{
+				keys[j] = key;
+				order[j] = index;
+				return false;
+			}
+		}
+
+		keys[j] = key;
+		order[j] = index;
+	}
+
+	return true;
+}
+
+void Mupfel::InstanceSorter::SeedFromPreviousOrder(uint32_t count)
+{
+	seen.assign(count, 0);
+
+	/* Compact last frame's order in place, keeping only indices that still exist. */
+	uint32_t kept = 0;
+	for (uint32_t index : order)
+	{
+		if (index < count)
+		{
+			order[kept++] = index;
+			seen[index] = 1;
+		}
+	}
+	order.resize(kept);
+
+	/* Instances that weren't there last frame go to the end; the insertion sort moves them into place. */
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (!seen[i])
+		{
+			order.push_back(i);
+		}
+	}
+}
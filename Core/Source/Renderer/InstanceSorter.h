@@ -0,0 +1,88 @@
+#pragma once
+#include "InstancePacker.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Reorders packed `TextureInstance`s by (layer, depth, texture) before they are uploaded, so that
+ * sprites are drawn layer by layer and back to front, and consecutive instances tend to sample the
+ * same texture.
+ *
+ * Keys are 52 bits wide (8 bit layer, 32 bit depth, 12 bit texture index) and sorted with an LSD radix
+ * sort over 11 bit digits (five passes); digits that are identical for every key are skipped, so e.g. a
+ * scene without layers never pays for the layer pass.
+ *
+ * In `Mode::Incremental` the sorter exploits frame-to-frame coherence: it starts from last frame's
+ * order and repairs it with a bounded insertion sort, which is linear when little moved. If the
+ * repair exceeds its budget (camera cut, scene switch) it falls back to the radix sort.
+ */
+class InstanceSorter
+{
+public:
+	enum class Mode : uint8_t
+	{
+		/** Instances are uploaded in packing order. */
+		Off,
+		/** Full radix sort every frame. */
+		Radix,
+		/** Repair last frame's order, fall back to the radix sort when that gets expensive. */
+		Incremental
+	};
+
+public:
+	explicit InstanceSorter(Mode in_mode = Mode::Incremental) : mode(in_mode) {}
+
+	void SetMode(Mode in_mode);
+	Mode GetMode() const;
+
+	/**
+	 * Writes `in` to `out` in sorted order (or unchanged order for `Mode::Off`).
+	 *
+	 * \warning `out` must hold at least `in.size()` instances and must not alias `in`.
+	 */
+	void Sort(std::span<const TextureInstance> in, std::span<TextureInstance> out);
+
+	/** Whether the last incremental `Sort` had to fall back to a full radix sort. */
+	bool LastSortFellBack() const;
+
+	/** The sort key of one instance: layer, then depth (ascending z), then texture index. */
+	static uint64_t MakeKey(const TextureInstance& instance);
+
+private:
+	/** Sorts `keys`/`order` (both already filled, in any order) with the LSD radix sort. */
+	void RadixSort();
+
+	/**
+	 * Insertion-sorts `keys`/`order` in place, giving up after `budget` element moves.
+	 * \return False if the budget ran out (the arrays are then partially sorted, but still a permutation).
+	 */
+	bool InsertionSort(uint64_t budget);
+
+	/** Seeds `order` from last frame's order, dropping indices that no longer exist and appending new ones. */
+	void SeedFromPreviousOrder(uint32_t count);
+
+private:
+	static constexpr uint32_t key_bits = 52;
+	static constexpr uint32_t digit_bits = 11;
+	static constexpr uint32_t digit_count = (key_bits + digit_bits - 1) / digit_bits;
+	static constexpr uint32_t bucket_count = 1u << digit_bits;
+
+	Mode mode;
+	bool fell_back = false;
+
+	/** Sort keys, permuted together with `order`. */
+	std::vector<uint64_t> keys;
+	/** Indices into the unsorted input; after sorting, `order[i]` is the instance drawn i-th. */
+	std::vector<uint32_t> order;
+	/** Ping-pong buffers for the radix passes. */
+	std::vector<uint64_t> scratch_keys;
+	std::vector<uint32_t> scratch_order;
+	/** Marks which input indices the previous-order seed already placed. */
+	std::vector<uint8_t> seen;
+};
+
+} // namespace Mupfel
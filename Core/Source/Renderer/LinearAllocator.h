@@ -0,0 +1,140 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Mupfel
+{
+
+/**
+ * Per-frame bump allocator for trivially copyable `T` (e.g. draw instances).
+ *
+ * `Allocate` only advances an offset into the current page; when a page is full a new one is chained
+ * instead of reallocating, so pointers handed out earlier in the frame stay valid. `Reset` releases
+ * everything at once. If a frame needed more than one page, `Reset` replaces them with a single page of
+ * the combined size, so after the first large frame the allocator settles on one contiguous block and
+ * never allocates again.
+ */
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+class LinearAllocator
+{
+public:
+	explicit LinearAllocator(uint32_t page_capacity = 4096) : pageCapacity(page_capacity) {}
+
+	/** Returns storage for one `T`, valid until the next `Reset`. The contents are uninitialized. */
+	T* Allocate();
+
+	/** Releases all allocations of this frame. */
+	void Reset();
+
+	/** Number of `T`s allocated since the last `Reset`. */
+	uint32_t Size() const { return size; }
+
+	/** Total number of `T`s the allocator can hold before it has to allocate another page. */
+	uint32_t Capacity() const;
+
+	/** Calls `f(std::span<const T>)` for every used page, in allocation order. */
+	template <typename F> void ForEachBlock(F&& f) const;
+
+private:
+	struct Page
+	{
+		std::unique_ptr<T[]> data;
+		uint32_t			 capacity = 0;
+		uint32_t			 used = 0;
+	};
+
+	void AddPage(uint32_t capacity);
+
+private:
+	std::vector<Page> pages;
+	/** Index of the page `Allocate` currently bumps in. */
+	uint32_t current = 0;
+	uint32_t size = 0;
+	uint32_t pageCapacity;
+};
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+inline T* LinearAllocator<T>::Allocate()
+{
+	if (pages.empty())
+	{
+		AddPage(pageCapacity);
+	}
+
+	if (pages[current].used == pages[current].capacity)
+	{
+		/* Pages behind `current` may still be left over from an earlier frame. */
+		if (++current == pages.size())
+		{
+			AddPage(pageCapacity);
+		}
+	}
+
+	Page& page = pages[current];
+	size++;
+	return &page.data[page.used++];
+}
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+inline void LinearAllocator<T>::Reset()
+{
+	if (pages.size() > 1)
+	{
+		/* Coalesce, so that next frame the same amount of data fits into one block. */
+		const uint32_t capacity = Capacity();
+		pages.clear();
+		AddPage(capacity);
+	}
+
+	for (Page& page : pages)
+	{
+		page.used = 0;
+	}
+
+	current = 0;
+	size = 0;
+}
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+inline uint32_t LinearAllocator<T>::Capacity() const
+{
+	uint32_t capacity = 0;
+	for (const Page& page : pages)
+	{
+		capacity += page.capacity;
+	}
+	return capacity;
+}
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+template <typename F>
+inline void LinearAllocator<T>::ForEachBlock(F&& f) const
+{
+	for (const Page& page : pages)
+	{
+		if (page.used == 0)
+		{
+			break;
+		}
+		f(std::span<const T>(page.data.get(), page.used));
+	}
+}
+
+template <typename T>
+	requires std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>
+inline void LinearAllocator<T>::AddPage(uint32_t capacity)
+{
+	assert(capacity > 0);
+	pages.push_back(Page{std::make_unique_for_overwrite<T[]>(capacity), capacity, 0});
+}
+
+} // namespace Mupfel
@@ -0,0 +1,121 @@
+#include "PngWriter.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+using namespace Mupfel;
+
+static constexpr uint32_t bytes_per_pixel = 4;
+
+/* Largest payload of a stored deflate block, its length has to fit 16 bits. */
+static constexpr size_t max_stored_block = 65535;
+
+static constexpr std::array<uint32_t, 256> crc_table = []
+{
+	std::array<uint32_t, 256> table{};
+	for (uint32_t n = 0; n < 256; n++)
+	{
+		uint32_t c = n;
+		for (uint32_t k = 0; k < 8; k++)
+		{
+			c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+		}
+		table[n] = c;
+	}
+	return table;
+}();
+
+static void AppendBigEndian(std::vector<uint8_t>& out, uint32_t value)
+{
+	out.push_back(static_cast<uint8_t>(value >> 24));
+	out.push_back(static_cast<uint8_t>(value >> 16));
+	out.push_back(static_cast<uint8_t>(value >> 8));
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+/* Appends a chunk: length, type, data and the CRC over type and data. */
+static void AppendChunk(std::vector<uint8_t>& out, std::string_view type, std::span<const uint8_t> data)
+{
+	AppendBigEndian(out, static_cast<uint32_t>(data.size()));
+	const size_t crc_start = out.size();
+	out.insert(out.end(), type.begin(), type.end());
+	out.insert(out.end(), data.begin(), data.end());
+
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = crc_start; i < out.size(); i++)
+	{
+		crc = crc_table[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+	}
+	AppendBigEndian(out, crc ^ 0xFFFFFFFFu);
+}
+
+bool Mupfel::WritePng(
+	const std::filesystem::path& path,
+	uint32_t					 width,
+	uint32_t					 height,
+	std::span<const uint8_t>	 pixels)
+{
+	const size_t row_bytes = static_cast<size_t>(width) * bytes_per_pixel;
+	if (width == 0 || height == 0 || pixels.size() < row_bytes * height)
+	{
+		return false;
+	}
+
+	/* Every scanline starts with its filter type, 0 (none). */
+	std::vector<uint8_t> scanlines;
+	scanlines.reserve((row_bytes + 1) * height);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		scanlines.push_back(0);
+		scanlines.insert(scanlines.end(), pixels.begin() + y * row_bytes, pixels.begin() + (y + 1) * row_bytes);
+	}
+
+	/* zlib stream of stored blocks: header, blocks with their length and its complement, Adler-32. */
+	std::vector<uint8_t> zlib = {0x78, 0x01};
+	zlib.reserve(2 + scanlines.size() + (scanlines.size() / max_stored_block + 1) * 5 + 4);
+	uint32_t a = 1;
+	uint32_t b = 0;
+	for (size_t offset = 0; offset < scanlines.size(); offset += max_stored_block)
+	{
+		const size_t   length = std::min(max_stored_block, scanlines.size() - offset);
+		const uint16_t len = static_cast<uint16_t>(length);
+		const bool	   last = offset + length == scanlines.size();
+
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(static_cast<uint8_t>(len));
+		zlib.push_back(static_cast<uint8_t>(len >> 8));
+		zlib.push_back(static_cast<uint8_t>(~len));
+		zlib.push_back(static_cast<uint8_t>(~len >> 8));
+		zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + length);
+
+		/* The sums can't overflow within 5552 bytes, so the modulo is only taken once per run. */
+		for (size_t run = offset; run < offset + length; run += 5552)
+		{
+			for (size_t i = run; i < std::min(run + 5552, offset + length); i++)
+			{
+				a += scanlines[i];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+	}
+	AppendBigEndian(zlib, (b << 16) | a);
+
+	/* Width, height, 8 bits per channel, color type 6 (RGBA), default compression, filtering, no interlace. */
+	std::vector<uint8_t> header;
+	AppendBigEndian(header, width);
+	AppendBigEndian(header, height);
+	header.insert(header.end(), {8, 6, 0, 0, 0});
+
+	std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	AppendChunk(png, "IHDR", header);
+	AppendChunk(png, "IDAT", zlib);
+	AppendChunk(png, "IEND", {});
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace Mupfel
+{
+
+/**
+ * Writes `width` x `height` tightly packed RGBA8 \a pixels to \a path as a PNG.
+ *
+ * The image data is stored, not compressed: the files only carry decoded pixels from the worker threads to
+ * Ping, which loads images from paths only, and are deleted right after. Storing keeps writing (and
+ * Ping's inflate) at the speed of a copy.
+ *
+ * \return false if the file couldn't be written.
+ */
+bool WritePng(const std::filesystem::path& path, uint32_t width, uint32_t height, std::span<const uint8_t> pixels);
+
+} // namespace Mupfel
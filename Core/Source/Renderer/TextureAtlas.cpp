@@ -0,0 +1,78 @@
+#include "TextureAtlas.h"
+#include <cstring>
+
+using namespace Mupfel;
+
+static constexpr uint32_t bytes_per_pixel = 4;
+
+Mupfel::TextureAtlas::TextureAtlas(uint32_t in_page_size, uint32_t in_max_image_size)
+	: packer(in_page_size, in_page_size), pageSize(in_page_size), maxImageSize(in_max_image_size)
+{
+}
+
+bool Mupfel::TextureAtlas::Fits(const DecodedImage& image, uint32_t max_image_size)
+{
+	return image.spec.rows == 1 && image.spec.columns == 1 && image.width > 0 && image.height > 0 &&
+		   image.width <= max_image_size && image.height <= max_image_size;
+}
+
+bool Mupfel::TextureAtlas::Accepts(const DecodedImage& image) const { return Fits(image, maxImageSize); }
+
+std::optional<ImageRegion> Mupfel::TextureAtlas::Insert(const DecodedImage& image)
+{
+	if (!Accepts(image))
+	{
+		return std::nullopt;
+	}
+
+	std::optional<AtlasRect> rect = packer.Insert(image.width, image.height);
+	if (!rect)
+	{
+		return std::nullopt;
+	}
+
+	/* New pages start out fully transparent. */
+	pages.resize(packer.GetPageCount());
+	std::vector<uint8_t>& pixels = pages[rect->page];
+	pixels.resize(static_cast<size_t>(pageSize) * pageSize * bytes_per_pixel, 0);
+
+	const size_t row_bytes = static_cast<size_t>(image.width) * bytes_per_pixel;
+	uint8_t*	 page = pixels.data();
+
+	for (uint32_t y = 0; y < image.height; y++)
+	{
+		const size_t dst = (static_cast<size_t>(rect->y + y) * pageSize + rect->x) * bytes_per_pixel;
+		std::memcpy(page + dst, image.pixels.data() + y * row_bytes, row_bytes);
+	}
+
+	const float scale = 1.0f / static_cast<float>(pageSize);
+
+	ImageRegion region;
+	region.layer = rect->page;
+	region.u = static_cast<float>(rect->x) * scale;
+	region.v = static_cast<float>(rect->y) * scale;
+	region.width = static_cast<float>(rect->width) * scale;
+	region.height = static_cast<float>(rect->height) * scale;
+	return region;
+}
+
+std::vector<AtlasPage> Mupfel::TextureAtlas::FinishPages()
+{
+	packer.ClosePages();
+
+	std::vector<AtlasPage> finished;
+	for (uint32_t page = finishedPages; page < pages.size(); page++)
+	{
+		finished.push_back({.index = page, .pixels = std::move(pages[page])});
+		pages[page] = {};
+	}
+	finishedPages = static_cast<uint32_t>(pages.size());
+
+	return finished;
+}
+
+uint32_t Mupfel::TextureAtlas::GetPageCount() const { return packer.GetPageCount(); }
+
+uint32_t Mupfel::TextureAtlas::GetFinishedPageCount() const { return finishedPages; }
+
+uint32_t Mupfel::TextureAtlas::GetPageSize() const { return pageSize; }
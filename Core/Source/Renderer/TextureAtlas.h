@@ -0,0 +1,74 @@
+#pragma once
+#include "AsyncImageLoader.h"
+#include "AtlasPacker.h"
+#include "Renderer/ImageManager.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Mupfel
+{
+
+/** A page handed out by `TextureAtlas::FinishPages`. */
+struct AtlasPage
+{
+	uint32_t			 index = 0;
+	std::vector<uint8_t> pixels;
+};
+
+/**
+ * CPU side of the sprite atlas: packs small decoded images into square RGBA8 pages with an `AtlasPacker`
+ * and copies their pixels in.
+ *
+ * Every page becomes a GPU image of its own, so all sprites on it share a single slot of the renderers'
+ * texture descriptor arrays. A page is uploaded once, when `FinishPages` closes it: nothing is inserted
+ * into it afterwards, so its image never has to be written again while frames in flight sample it.
+ */
+class TextureAtlas
+{
+public:
+	/**
+	 * \param in_page_size Edge length of every page in pixels.
+	 * \param in_max_image_size Images with a larger edge are left to get an image of their own.
+	 */
+	explicit TextureAtlas(uint32_t in_page_size = 1024, uint32_t in_max_image_size = 256);
+
+	/** Whether `image` is a single frame with no edge larger than \a max_image_size. */
+	static bool Fits(const DecodedImage& image, uint32_t max_image_size);
+
+	/** Whether `image` is a single, small enough frame to be atlased. */
+	bool Accepts(const DecodedImage& image) const;
+
+	/**
+	 * Packs `image` and copies its pixels into the page it landed on.
+	 *
+	 * \return Its page (as `layer`) and UV rectangle; `slot` is left for the caller. std::nullopt if
+	 * `Accepts(image)` is false.
+	 */
+	std::optional<ImageRegion> Insert(const DecodedImage& image);
+
+	/**
+	 * Closes every page that has images on it, so later inserts start new pages, and hands out their RGBA8
+	 * pixels. The atlas keeps no copy.
+	 *
+	 * \return The pages closed by this call, in page order.
+	 */
+	std::vector<AtlasPage> FinishPages();
+
+	uint32_t GetPageCount() const;
+
+	/** Pages before this index have been handed out by `FinishPages`. */
+	uint32_t GetFinishedPageCount() const;
+
+	uint32_t GetPageSize() const;
+
+private:
+	AtlasPacker packer;
+	/** Pixels of every page, indexed by page; empty once finished. */
+	std::vector<std::vector<uint8_t>> pages;
+	uint32_t						  finishedPages = 0;
+	uint32_t						  pageSize;
+	uint32_t						  maxImageSize;
+};
+
+} // namespace Mupfel
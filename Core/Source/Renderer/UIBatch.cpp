@@ -0,0 +1,63 @@
+#include "UIBatch.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Mupfel;
+
+void Mupfel::UIBatch::Begin(float screen_width, float screen_height)
+{
+	instances.Reset();
+
+	const bool has_area = screen_width > 0.0f && screen_height > 0.0f;
+	ndc_scale_x = has_area ? 2.0f / screen_width : 0.0f;
+	ndc_scale_y = has_area ? 2.0f / screen_height : 0.0f;
+}
+
+void Mupfel::UIBatch::Push(
+	float			   x,
+	float			   y,
+	float			   width,
+	float			   height,
+	float			   rotation,
+	const ImageRegion& region,
+	float			   uv_scale)
+{
+	if (ndc_scale_x == 0.0f)
+	{
+		return;
+	}
+
+	/* The quad spans [-0.5, 0.5] around its centre, so convert the top-left pixel rect
+	 * into an NDC centre plus an NDC extent. Framebuffer Y and GLFW cursor Y both point
+	 * down, so no flip is needed. */
+	UIInstance& t = *instances.Allocate();
+	t.pos_x = (x + width * 0.5f) * ndc_scale_x - 1.0f;
+	t.pos_y = (y + height * 0.5f) * ndc_scale_y - 1.0f;
+	t.width = width * ndc_scale_x;
+	t.height = -height * ndc_scale_y;
+	t.rotation = rotation;
+	t.index = region.slot;
+	t.uvScale = uv_scale;
+	t.layer = region.layer;
+	t.uv_u = region.u;
+	t.uv_v = region.v;
+	t.uv_width = region.width;
+	t.uv_height = region.height;
+}
+
+uint32_t Mupfel::UIBatch::Size() const { return instances.Size(); }
+
+uint32_t Mupfel::UIBatch::CopyTo(std::span<UIInstance> out) const
+{
+	uint32_t written = 0;
+
+	instances.ForEachBlock(
+		[&](std::span<const UIInstance> block)
+		{
+			const size_t n = std::min(block.size(), out.size() - written);
+			std::memcpy(out.data() + written, block.data(), n * sizeof(UIInstance));
+			written += static_cast<uint32_t>(n);
+		});
+
+	return written;
+}
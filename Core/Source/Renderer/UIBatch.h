@@ -0,0 +1,77 @@
+#pragma once
+#include "LinearAllocator.h"
+#include "Renderer/ImageManager.h"
+#include <cstdint>
+#include <span>
+
+namespace Mupfel
+{
+
+/**
+ * One UI quad as the immediate-mode vertex shader reads it (`TextureInstance` in im.slang, std430).
+ * Keep both definitions in sync.
+ */
+struct UIInstance
+{
+	float	 pos_x = 0.0f;
+	float	 pos_y = 0.0f;
+	float	 width = 1.0f;
+	float	 height = 1.0f;
+	float	 rotation = 0.0f;
+	uint32_t index = 1;
+	float	 uvScale = 1.0f;
+	uint32_t layer = 0;
+	/** See `ImageRegion`. */
+	float uv_u = 0.0f;
+	float uv_v = 0.0f;
+	float uv_width = 1.0f;
+	float uv_height = 1.0f;
+};
+
+static_assert((sizeof(UIInstance) == 48), "UIInstance must match the std430 layout in im.slang!");
+
+/**
+ * CPU side of the immediate-mode renderer: collects one frame's UI quads, already converted to NDC, in a
+ * `LinearAllocator`.
+ *
+ * Building a frame touches neither the GPU nor `Application`, so the instance buffer only has to be
+ * sized and filled once per frame (see `IMRenderer::PostUser`), and command building can be benchmarked
+ * headless.
+ */
+class UIBatch
+{
+public:
+	/** Starts a new frame for a framebuffer of the given size in pixels, dropping the previous quads. */
+	void Begin(float screen_width, float screen_height);
+
+	/**
+	 * Appends a quad given by its top-left corner and size in pixels, showing `region` of the image arrays.
+	 * Quads pushed while the framebuffer has no area (e.g. minimized window) are dropped.
+	 */
+	void Push(
+		float			   x,
+		float			   y,
+		float			   width,
+		float			   height,
+		float			   rotation,
+		const ImageRegion& region,
+		float			   uv_scale);
+
+	/** Number of quads pushed since `Begin`. */
+	uint32_t Size() const;
+
+	/**
+	 * Copies the frame's quads into `out` in push order.
+	 *
+	 * \return The number of quads written, at most `out.size()`.
+	 */
+	uint32_t CopyTo(std::span<UIInstance> out) const;
+
+private:
+	LinearAllocator<UIInstance> instances;
+	/** Pixel -> NDC scale factors (2 / screen size), 0 while the framebuffer has no area. */
+	float ndc_scale_x = 0.0f;
+	float ndc_scale_y = 0.0f;
+};
+
+} // namespace Mupfel
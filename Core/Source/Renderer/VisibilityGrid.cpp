@@ -0,0 +1,172 @@
+#include "VisibilityGrid.h"
+#include "InstancePacker.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/**
+ * How many cells of \a cell_size cover \a extent, at most \a max_cells. Decided in float, so an extent far
+ * beyond the cap (or a non-finite one) never reaches an out-of-range integer conversion.
+ */
+uint32_t CellsFor(float extent, float cell_size, uint32_t max_cells)
+{
+	const float cells = extent / cell_size;
+	return (cells < static_cast<float>(max_cells - 1)) ? static_cast<uint32_t>(cells) + 1 : max_cells;
+}
+
+/** The cell \a offset from the grid origin falls into, clamped to [0, \a cells). */
+uint32_t CellOf(float offset, float cell_size, uint32_t cells)
+{
+	const float cell = offset / cell_size;
+	if (!(cell < static_cast<float>(cells)))
+	{
+		return cells - 1;
+	}
+	return (cell > 0.0f) ? static_cast<uint32_t>(cell) : 0;
+}
+
+} // namespace
+
+Mupfel::VisibilityGrid::VisibilityGrid(float in_cell_size) : cell_size(std::max(in_cell_size, 0.001f)) {}
+
+void Mupfel::VisibilityGrid::Build(Registry& registry)
+{
+	unsorted.clear();
+	unsorted_bounds.clear();
+	cell_of.clear();
+
+	/* Pass 1: snapshot bounds and find the extent of the grid. */
+	float min_x = std::numeric_limits<float>::max();
+	float min_y = std::numeric_limits<float>::max();
+	float max_x = std::numeric_limits<float>::lowest();
+	float max_y = std::numeric_limits<float>::lowest();
+
+	for (auto [e, texture, local] : registry.view<Texture, Transform>())
+	{
+		const Transform transform = InstancePacker::Placement(registry, e, local);
+		unsorted.push_back(e);
+		unsorted_bounds.emplace_back(
+			transform.pos_x, transform.pos_y, transform.pos_z,
+			Frustum::QuadRadius(transform.scale_x, transform.scale_y));
+
+		min_x = std::min(min_x, transform.pos_x);
+		min_y = std::min(min_y, transform.pos_y);
+		max_x = std::max(max_x, transform.pos_x);
+		max_y = std::max(max_y, transform.pos_y);
+	}
+
+	if (unsorted.empty())
+	{
+		entities.clear();
+		bounds.clear();
+		cells.clear();
+		cells_x = 0;
+		cells_y = 0;
+		return;
+	}
+
+	origin_x = min_x;
+	origin_y = min_y;
+	cells_x = CellsFor(max_x - min_x, cell_size, max_cells_per_axis);
+	cells_y = CellsFor(max_y - min_y, cell_size, max_cells_per_axis);
+
+	/* Where the cell count is capped, the cells grow instead, so the grid still spans every entity. */
+	const float size_x = std::max(cell_size, (max_x - min_x) / static_cast<float>(cells_x));
+	const float size_y = std::max(cell_size, (max_y - min_y) / static_cast<float>(cells_y));
+
+	cells.assign(static_cast<size_t>(cells_x) * cells_y, Cell{});
+
+	/* Pass 2: count entities per cell. */
+	cell_of.reserve(unsorted.size());
+	for (const glm::vec4& b : unsorted_bounds)
+	{
+		const uint32_t cx = CellOf(b.x - origin_x, size_x, cells_x);
+		const uint32_t cy = CellOf(b.y - origin_y, size_y, cells_y);
+		const uint32_t c = cy * cells_x + cx;
+
+		cell_of.push_back(c);
+		cells[c].end++;
+	}
+
+	/* Prefix sum turns the counts into [begin, end) ranges; `end` doubles as the scatter cursor below. */
+	uint32_t running = 0;
+	for (Cell& cell : cells)
+	{
+		const uint32_t count = cell.end;
+		cell.begin = running;
+		cell.end = running;
+		cell.min = glm::vec3(std::numeric_limits<float>::max());
+		cell.max = glm::vec3(std::numeric_limits<float>::lowest());
+		running += count;
+	}
+
+	/* Pass 3: scatter into cell order and grow each cell's box / radius. */
+	entities.assign(unsorted.size(), unsorted.front());
+	bounds.resize(unsorted.size());
+
+	for (size_t i = 0; i < unsorted.size(); i++)
+	{
+		Cell&			 cell = cells[cell_of[i]];
+		const glm::vec4& b = unsorted_bounds[i];
+
+		entities[cell.end] = unsorted[i];
+		bounds[cell.end] = b;
+		cell.end++;
+
+		cell.min = glm::vec3(std::min(cell.min.x, b.x), std::min(cell.min.y, b.y), std::min(cell.min.z, b.z));
+		cell.max = glm::vec3(std::max(cell.max.x, b.x), std::max(cell.max.y, b.y), std::max(cell.max.z, b.z));
+		cell.max_radius = std::max(cell.max_radius, b.w);
+	}
+}
+
+void Mupfel::VisibilityGrid::Query(const Frustum& frustum, std::vector<Entity>& out) const
+{
+	for (uint32_t cy = 0; cy < cells_y; cy++)
+	{
+		for (uint32_t cx = 0; cx < cells_x; cx++)
+		{
+			const Cell& cell = cells[cy * cells_x + cx];
+
+			if (cell.begin == cell.end)
+			{
+				continue;
+			}
+
+			/* The box around the entity centers, grown by the largest radius, bounds every quad. */
+			const glm::vec3 r(cell.max_radius);
+			const glm::vec3 min = cell.min - r;
+			const glm::vec3 max = cell.max + r;
+
+			switch (frustum.ClassifyBox(min, max))
+			{
+			case Frustum::Containment::Outside:
+				break;
+			case Frustum::Containment::Inside:
+				out.insert(out.end(), entities.begin() + cell.begin, entities.begin() + cell.end);
+				break;
+			case Frustum::Containment::Intersecting:
+				for (uint32_t i = cell.begin; i < cell.end; i++)
+				{
+					const glm::vec4& b = bounds[i];
+					if (frustum.IntersectsSphere(b.x, b.y, b.z, b.w))
+					{
+						out.push_back(entities[i]);
+					}
+				}
+				break;
+			}
+		}
+	}
+}
+
+uint32_t Mupfel::VisibilityGrid::Size() const { return static_cast<uint32_t>(entities.size()); }
+
+uint32_t Mupfel::VisibilityGrid::GetCellCount() const { return static_cast<uint32_t>(cells.size()); }
@@ -0,0 +1,81 @@
+#pragma once
+#include "ECS/Entity.h"
+#include "Frustum.h"
+#include <cstdint>
+#include <vector>
+
+namespace Mupfel
+{
+
+class Registry;
+
+/**
+ * A uniform 2D grid over the x/y plane that buckets every drawable (`Texture` + `Transform`) entity of
+ * the active scene, so culling can reject or accept whole cells with one box test instead of testing
+ * every instance.
+ *
+ * The grid snapshots positions at `Build` time: it is meant for largely static content (level
+ * geometry, props) and must be rebuilt after those entities move. Building is a counting sort over
+ * the entities (three linear passes, no per-cell allocations), so rebuilding on demand is cheap.
+ */
+class VisibilityGrid
+{
+public:
+	/**
+	 * \param in_cell_size Edge length of one grid cell in world units. Worlds wider than
+	 * `max_cells_per_axis` cells get larger ones.
+	 */
+	explicit VisibilityGrid(float in_cell_size = 16.0f);
+
+	/** Rebuckets every drawable entity of `registry`'s active scene. */
+	void Build(Registry& registry);
+
+	/**
+	 * Appends every bucketed entity whose bounds touch `frustum` to `out`. Cells fully inside the
+	 * frustum are appended wholesale, straddling cells fall back to a per-instance sphere test.
+	 */
+	void Query(const Frustum& frustum, std::vector<Entity>& out) const;
+
+	/** Number of entities bucketed by the last `Build`. */
+	uint32_t Size() const;
+
+	/** Number of cells (including empty ones) allocated by the last `Build`. */
+	uint32_t GetCellCount() const;
+
+private:
+	struct Cell
+	{
+		/** Range [begin, end) into `entities`/`bounds`. */
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		/** Bounds of the entity centers in this cell; tighter than the cell, and exact where it was grown. */
+		glm::vec3 min{0.0f};
+		glm::vec3 max{0.0f};
+		/** Largest instance radius in this cell, by which the cell box is grown. */
+		float max_radius = 0.0f;
+	};
+
+	/**
+	 * Upper bound for cells along one axis, so a single far-away entity can't explode the grid. Past it,
+	 * `Build` makes the cells larger than `cell_size`.
+	 */
+	static constexpr uint32_t max_cells_per_axis = 1024;
+
+	float	 cell_size;
+	float	 origin_x = 0.0f;
+	float	 origin_y = 0.0f;
+	uint32_t cells_x = 0;
+	uint32_t cells_y = 0;
+
+	std::vector<Cell> cells;
+	/** Bucketed entities, sorted by cell. */
+	std::vector<Entity> entities;
+	/** Parallel to `entities`: position (xyz) and bounding radius (w) at build time. */
+	std::vector<glm::vec4> bounds;
+	/** Build scratch, kept across builds to avoid reallocating: entities/bounds/cell in view order. */
+	std::vector<Entity>	   unsorted;
+	std::vector<glm::vec4> unsorted_bounds;
+	std::vector<uint32_t>  cell_of;
+};
+
+} // namespace Mupfel
@@ -40,6 +40,19 @@ Deps = {
         relpath = "Vendor/Sources/box2d-3.1.1",
         url     = "https://github.com/erincatto/box2d/archive/refs/tags/v3.1.1.zip",
     },
+    -- LZ4 is one .c/.h pair upstream, so it's fetched as loose files like Catch2 below. Both codecs
+    -- back the per-entry compression of resource packs (Core/Source/Core/ResourceManager.h).
+    lz4 = {
+        relpath      = "Vendor/Sources/lz4-1.10.0",
+        single_files = {
+            "https://raw.githubusercontent.com/lz4/lz4/v1.10.0/lib/lz4.c",
+            "https://raw.githubusercontent.com/lz4/lz4/v1.10.0/lib/lz4.h",
+        },
+    },
+    zstd = {
+        relpath = "Vendor/Sources/zstd-1.5.6",
+        url     = "https://github.com/facebook/zstd/archive/refs/tags/v1.5.6.zip",
+    },
     nanobench = {
         relpath     = "Vendor/Sources/nanobench",
         url         = "https://raw.githubusercontent.com/martinus/nanobench/v4.3.11/src/include/nanobench.h",
@@ -134,6 +147,8 @@ function build_externals()
     fetch_dependency("nanobench")
     fetch_dependency("catch2")
     fetch_dependency("box2d")
+    fetch_dependency("lz4")
+    fetch_dependency("zstd")
     if os.target() == "windows" then
         fetch_dependency("glfw")
     end
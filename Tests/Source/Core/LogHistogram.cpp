@@ -0,0 +1,93 @@
+#include "Core/LogHistogram.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* The exact value at a percentile, with the same rank definition as LogHistogram. */
+static uint64_t ExactPercentile(const std::vector<uint64_t>& sorted, double percentile)
+{
+	const double   position = std::ceil(percentile / 100.0 * static_cast<double>(sorted.size()));
+	const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(position));
+	return sorted[rank - 1];
+}
+
+TEST_CASE("Log histogram", "[histogram]")
+{
+	Mupfel::LogHistogram histogram;
+
+	SECTION("An empty histogram reports zeros")
+	{
+		REQUIRE(histogram.GetCount() == 0);
+		REQUIRE(histogram.GetMin() == 0);
+		REQUIRE(histogram.GetMax() == 0);
+		REQUIRE(histogram.GetPercentile(99.0) == 0);
+	}
+
+	SECTION("Small values are counted exactly")
+	{
+		for (uint64_t v = 0; v < Mupfel::LogHistogram::subBuckets; v++)
+		{
+			histogram.Record(v);
+		}
+
+		REQUIRE(histogram.GetPercentile(50.0) == 31);
+		REQUIRE(histogram.GetPercentile(100.0) == 63);
+		REQUIRE(histogram.GetMin() == 0);
+		REQUIRE(histogram.GetMean() == 31.5);
+	}
+
+	SECTION("Percentiles of frame-time-like data are within 1%")
+	{
+		/* Log-normal durations around 2ms with a heavy tail, in nanoseconds. */
+		std::mt19937						rng(7);
+		std::lognormal_distribution<double> duration(std::log(2.0e6), 0.6);
+
+		std::vector<uint64_t> values(100000);
+		for (uint64_t& v : values)
+		{
+			v = static_cast<uint64_t>(duration(rng));
+			histogram.Record(v);
+		}
+		std::ranges::sort(values);
+
+		for (double p : {1.0, 50.0, 90.0, 95.0, 99.0, 99.9})
+		{
+			const double exact = static_cast<double>(ExactPercentile(values, p));
+			const double estimate = static_cast<double>(histogram.GetPercentile(p));
+			REQUIRE(std::abs(estimate - exact) <= exact * 0.01);
+		}
+
+		REQUIRE(histogram.GetMin() == values.front());
+		REQUIRE(histogram.GetMax() == values.back());
+		REQUIRE(histogram.GetPercentile(100.0) == values.back());
+	}
+
+	SECTION("Huge values are clamped into the last bucket")
+	{
+		histogram.Record(UINT64_MAX / 2);
+		histogram.Record(1000);
+
+		REQUIRE(histogram.GetCount() == 2);
+		REQUIRE(histogram.GetMax() == UINT64_MAX / 2);
+		REQUIRE(histogram.GetPercentile(100.0) <= UINT64_MAX / 2);
+	}
+
+	SECTION("Merging equals recording into one histogram")
+	{
+		Mupfel::LogHistogram other;
+		for (uint64_t v = 1; v <= 1000; v++)
+		{
+			((v % 2) ? histogram : other).Record(v * 1000);
+		}
+		histogram.Merge(other);
+
+		REQUIRE(histogram.GetCount() == 1000);
+		REQUIRE(histogram.GetMin() == 1000);
+		REQUIRE(histogram.GetMax() == 1000000);
+		REQUIRE(histogram.GetPercentile(50.0) >= 495000);
+		REQUIRE(histogram.GetPercentile(50.0) <= 505000);
+	}
+}
@@ -0,0 +1,91 @@
+#include "Core/PerfCounters.h"
+#include "Core/Profiler.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <vector>
+
+/* Runs in any environment: where counters can't be opened, everything must read as zero instead. */
+TEST_CASE("Hardware performance counters", "[perf_counters]")
+{
+	Mupfel::PerfCounterGroup& group = Mupfel::PerfCounterGroup::ForCurrentThread();
+
+	SECTION("Counts grow, or stay zero when unavailable")
+	{
+		const Mupfel::PerfCounterValues before = group.Read();
+
+		volatile uint64_t sum = 0;
+		for (uint64_t i = 0; i < 1000000; i++)
+		{
+			sum = sum + i;
+		}
+
+		const Mupfel::PerfCounterValues delta = group.Read() - before;
+
+		if (group.IsAvailable())
+		{
+			REQUIRE(group.Has(Mupfel::PerfCounter::Cycles));
+			REQUIRE(delta.cycles > 0);
+			if (group.Has(Mupfel::PerfCounter::Instructions))
+			{
+				REQUIRE(delta.instructions > 1000000);
+				REQUIRE(delta.Ipc() > 0.0);
+			}
+		}
+		else
+		{
+			REQUIRE_FALSE(group.GetError().empty());
+			REQUIRE_FALSE(group.Has(Mupfel::PerfCounter::Cycles));
+			REQUIRE(delta.cycles == 0);
+			REQUIRE(delta.Ipc() == 0.0);
+		}
+	}
+
+	SECTION("Differences are scaled by their own share of the PMU")
+	{
+		/* The group ran all of the first 1000 ns, then only 100 of the next 400. */
+		const Mupfel::PerfCounterValues before{
+			.cycles = 5000, .instructions = 8000, .timeEnabled = 1000, .timeRunning = 1000};
+		const Mupfel::PerfCounterValues after{
+			.cycles = 5200, .instructions = 8300, .timeEnabled = 1400, .timeRunning = 1100};
+
+		const Mupfel::PerfCounterValues delta = (after - before).Scaled();
+		REQUIRE(delta.cycles == 800);
+		REQUIRE(delta.instructions == 1200);
+		REQUIRE(delta.timeEnabled == 400);
+		REQUIRE(delta.timeRunning == 400);
+		REQUIRE(delta.Scaled().cycles == 800);
+
+		/* Subtracted the wrong way round, nothing wraps. */
+		const Mupfel::PerfCounterValues backwards = before - after;
+		REQUIRE(backwards.cycles == 0);
+		REQUIRE(backwards.instructions == 0);
+		REQUIRE(backwards.Scaled().cycles == 0);
+	}
+
+	SECTION("Counter scopes record only while enabled")
+	{
+		Mupfel::Profiler::ResetScopeStats();
+
+		{
+			Mupfel::CounterScope scope("Counted Off");
+		}
+
+		Mupfel::Profiler::SetCountersEnabled(true);
+		{
+			Mupfel::CounterScope scope("Counted On");
+		}
+		Mupfel::Profiler::SetCountersEnabled(false);
+
+		const std::vector<Mupfel::ScopeCounters> counters = Mupfel::Profiler::GetScopeCounters();
+		if (group.IsAvailable())
+		{
+			REQUIRE(counters.size() == 1);
+			REQUIRE(counters[0].name == "Counted On");
+			REQUIRE(counters[0].count == 1);
+		}
+		else
+		{
+			REQUIRE(counters.empty());
+		}
+	}
+}
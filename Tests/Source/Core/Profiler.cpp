@@ -0,0 +1,129 @@
+#include "Core/Profiler.h"
+#include "catch_amalgamated.hpp"
+#include "json.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+static void RecordFrame()
+{
+	Mupfel::ProfilingSample outer("outer");
+	{
+		Mupfel::ProfilingSample inner("inner \"quoted\"");
+	}
+}
+
+TEST_CASE("Profiler trace capture", "[profiler]")
+{
+	/* Start from an empty frame. */
+	Mupfel::Profiler::Clear();
+
+	SECTION("Samples of every thread are merged at Clear")
+	{
+		RecordFrame();
+		std::thread worker(RecordFrame);
+		worker.join();
+		Mupfel::Profiler::Clear();
+
+		const auto& samples = Mupfel::Profiler::GetCurrentSamples();
+		REQUIRE(samples.size() == 4);
+		REQUIRE(samples[0].thread != samples[3].thread);
+
+		Mupfel::Profiler::Clear();
+		REQUIRE(Mupfel::Profiler::GetCurrentSamples().empty());
+	}
+
+	SECTION("A capture keeps exactly the requested frames")
+	{
+		Mupfel::Profiler::StartCapture(2);
+
+		for (uint32_t frame = 0; frame < 3; frame++)
+		{
+			RecordFrame();
+			Mupfel::Profiler::Clear();
+		}
+
+		REQUIRE_FALSE(Mupfel::Profiler::IsCapturing());
+
+		const auto& captured = Mupfel::Profiler::GetCapturedSamples();
+		REQUIRE(captured.size() == 4);
+		REQUIRE(captured[0].frame == 0);
+		REQUIRE(captured[3].frame == 1);
+	}
+
+	SECTION("A capture ends at its sample bound")
+	{
+		Mupfel::Profiler::StartCapture(100, 3);
+
+		RecordFrame();
+		Mupfel::Profiler::Clear();
+		REQUIRE(Mupfel::Profiler::IsCapturing());
+
+		RecordFrame();
+		Mupfel::Profiler::Clear();
+		REQUIRE_FALSE(Mupfel::Profiler::IsCapturing());
+		REQUIRE(Mupfel::Profiler::GetCapturedSamples().size() == 3);
+	}
+
+	SECTION("The Chrome trace holds one complete event per sample")
+	{
+		Mupfel::Profiler::StartCapture(1);
+		RecordFrame();
+		Mupfel::Profiler::Clear();
+
+		const std::string path = (std::filesystem::temp_directory_path() / "mupfel_trace.json").string();
+		REQUIRE(Mupfel::Profiler::WriteChromeTrace(path).has_value());
+
+		std::ifstream  file(path);
+		nlohmann::json trace = nlohmann::json::parse(file);
+
+		uint32_t complete = 0;
+		uint32_t metadata = 0;
+		for (const auto& event : trace["traceEvents"])
+		{
+			if (event["ph"] == "X")
+			{
+				complete++;
+				REQUIRE(event["dur"].get<double>() >= 0.0);
+				REQUIRE(event["args"]["frame"] == 0);
+			}
+			else if (event["ph"] == "M")
+			{
+				metadata++;
+			}
+		}
+
+		REQUIRE(complete == 2);
+		REQUIRE(metadata == 1);
+		REQUIRE(trace["traceEvents"][0]["name"] == "inner \"quoted\"");
+		REQUIRE(trace["traceEvents"][0]["args"]["depth"] == 1);
+	}
+
+	SECTION("Scope statistics aggregate across frames")
+	{
+		Mupfel::Profiler::ResetScopeStats();
+
+		for (uint32_t frame = 0; frame < 10; frame++)
+		{
+			RecordFrame();
+			Mupfel::Profiler::Clear();
+		}
+
+		auto outer = Mupfel::Profiler::GetScopeStats("outer");
+		REQUIRE(outer.has_value());
+		REQUIRE(outer->count == 10);
+		REQUIRE(outer->min_ms <= outer->p50_ms);
+		REQUIRE(outer->p50_ms <= outer->p99_ms);
+		REQUIRE(outer->p99_ms <= outer->max_ms);
+
+		REQUIRE(Mupfel::Profiler::GetScopeStats().size() == 2);
+		REQUIRE_FALSE(Mupfel::Profiler::GetScopeStats("missing").has_value());
+	}
+
+	SECTION("Writing to an unusable path reports an error")
+	{
+		REQUIRE(Mupfel::Profiler::WriteChromeTrace("does/not/exist/trace.json").error() ==
+				Mupfel::Error::FILE_NOT_FOUND);
+	}
+}
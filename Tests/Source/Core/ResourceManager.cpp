@@ -1,17 +1,120 @@
 #include "catch_amalgamated.hpp"
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
 #include "Core/ResourceManager.h"
 
-TEST_CASE("Basic Resource Manager Test")
+using namespace Mupfel;
+
+static std::span<const std::byte> Bytes(const std::string& text) { return std::as_bytes(std::span(text)); }
+
+static std::string Text(std::span<const std::byte> bytes)
+{
+	return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+TEST_CASE("Resource pack", "[resource_pack]")
 {
-	/* Create the resource file */
-	Mupfel::ResourceManager resource_manager;
-	if (!std::filesystem::exists("test.res"))
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "mupfel_test.res";
+	std::filesystem::remove(file);
+
+	/* Compressible and incompressible data, the latter stored as is whatever the compression asked for. */
+	std::string repeated;
+	for (int i = 0; i < 1000; i++)
 	{
-		resource_manager.Save("test.res", "");
+		repeated += "Mupfel resource pack ";
 	}
-	else
+	const std::string small = "{}";
+
+	ResourceManager resources;
+	REQUIRE(resources.AddFile("Data/level.json", Bytes(repeated), ResourceManager::Compression::LZ4));
+	REQUIRE(resources.AddFile("Shaders/ecs.spv", Bytes(repeated), ResourceManager::Compression::Zstd));
+	REQUIRE(resources.AddFile("Data/empty.json", Bytes(small), ResourceManager::Compression::LZ4));
+	REQUIRE(resources.AddFile("Assets/player.png", Bytes(repeated)));
+	REQUIRE(resources.Save(file));
+
+	SECTION("Round trip")
 	{
-		resource_manager.Load("test.res", "");
+		ResourceManager loaded;
+		REQUIRE(loaded.Load(file));
+		REQUIRE(loaded.GetFileCount() == 4);
+
+		REQUIRE(Text(loaded.GetFile("Data/level.json")) == repeated);
+		REQUIRE(Text(loaded.GetFile("Shaders/ecs.spv")) == repeated);
+		REQUIRE(Text(loaded.GetFile("Data/empty.json")) == small);
+		REQUIRE(Text(loaded.GetFile("Assets/player.png")) == repeated);
+
+		REQUIRE_FALSE(loaded.Contains("Assets/enemy.png"));
+		REQUIRE(loaded.GetFile("Assets/enemy.png").empty());
+
+		/* Compressed entries are decompressed once, then handed out again. */
+		REQUIRE(loaded.GetFile("Data/level.json").data() == loaded.GetFile("Data/level.json").data());
+	}
+
+	SECTION("Compression shrinks the pack")
+	{
+		const auto size = std::filesystem::file_size(file);
+		REQUIRE(size < 2 * repeated.size());
 	}
+
+	SECTION("Save keeps the loaded entries and replaces added ones")
+	{
+		REQUIRE(resources.AddFile("Data/level.json", Bytes(small)));
+		REQUIRE(resources.AddFile("Data/new.json", Bytes(small), ResourceManager::Compression::Zstd));
+		REQUIRE(resources.Save(file));
+
+		REQUIRE(resources.GetFileCount() == 5);
+		REQUIRE(Text(resources.GetFile("Data/level.json")) == small);
+		REQUIRE(Text(resources.GetFile("Data/new.json")) == small);
+		REQUIRE(Text(resources.GetFile("Shaders/ecs.spv")) == repeated);
+	}
+
+	SECTION("Files from disk are named by their path")
+	{
+		const std::filesystem::path source = std::filesystem::temp_directory_path() / "mupfel_test.txt";
+		std::ofstream(source) << repeated;
+
+		REQUIRE(resources.AddFile(source.string(), ResourceManager::Compression::LZ4));
+		REQUIRE(resources.Save(file));
+		REQUIRE(Text(resources.GetFile(source.generic_string())) == repeated);
+		REQUIRE_FALSE(resources.AddFile("does/not/exist.png"));
+
+		std::filesystem::remove(source);
+	}
+
+	SECTION("Broken packs are rejected")
+	{
+		std::vector<char> bytes(std::filesystem::file_size(file));
+		std::ifstream(file, std::ios::binary).read(bytes.data(), bytes.size());
+
+		SECTION("Wrong magic")
+		{
+			bytes[0] = 'X';
+		}
+
+		SECTION("Truncated")
+		{
+			bytes.resize(bytes.size() - 16);
+		}
+
+		SECTION("Entries out of order")
+		{
+			ResourceManager::PackEntry first;
+			std::memcpy(&first, bytes.data() + sizeof(ResourceManager::PackHeader), sizeof(first));
+			first.hash = UINT64_MAX;
+			std::memcpy(bytes.data() + sizeof(ResourceManager::PackHeader), &first, sizeof(first));
+		}
+
+		std::ofstream(file, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+
+		ResourceManager broken;
+		REQUIRE_FALSE(broken.Load(file));
+		REQUIRE(broken.GetFileCount() == 0);
+	}
+
+	REQUIRE_FALSE(ResourceManager().Load(std::filesystem::temp_directory_path() / "mupfel_missing.res"));
+
+	std::filesystem::remove(file);
 }
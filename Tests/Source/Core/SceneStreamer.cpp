@@ -0,0 +1,170 @@
+#include "Core/EventSystem.h"
+#include "Core/SceneStreamer.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Hierarchy.h"
+#include "ECS/Components/Movement.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/ECSEvents.h"
+#include "ECS/Registry.h"
+#include "ECS/TransformSystem.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace Mupfel;
+
+TEST_CASE("Scene streaming", "[scene_streamer]")
+{
+	EventSystem	  event_system;
+	ThreadPool	  thread_pool{2};
+	Registry	  registry{event_system, thread_pool};
+	SceneStreamer streamer{thread_pool};
+
+	const SceneHandle scene = 3;
+	const uint32_t	  count = SceneStreamer::sliceSize * 3 + 5;
+
+	/* Every entity gets a Transform, every second one a Movement. */
+	auto stage = [&](Registry& staging)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Entity	  e = staging.CreateEntity();
+			Transform t;
+			t.pos_x = static_cast<float>(i);
+			staging.AddComponent<Transform>(e, t);
+			if (i % 2 == 0)
+			{
+				Movement m;
+				m.velocity_x = static_cast<float>(i);
+				staging.AddComponent<Movement>(e, m);
+			}
+		}
+	};
+
+	/* Something already lives in the registry; the streamed entities go next to it. */
+	Entity existing = registry.CreateEntity();
+	registry.AddComponent<Transform>(existing, Transform{.pos_x = -1.0f});
+
+	SECTION("Merged in slices")
+	{
+		uint32_t added = 0;
+		event_system.RegisterListener<ComponentAddedEvent>([&](const ComponentAddedEvent&) { added++; });
+
+		REQUIRE(streamer.Begin(scene, stage));
+		REQUIRE(streamer.IsStreaming());
+		REQUIRE_FALSE(streamer.Begin(scene, stage));
+
+		/* With no budget, every frame merges exactly one slice. */
+		uint32_t frames = 1;
+		while (!streamer.Update(registry, 0.0))
+		{
+			REQUIRE(streamer.GetRemaining() <= count);
+			frames++;
+		}
+		REQUIRE(frames >= 4);
+		REQUIRE_FALSE(streamer.IsStreaming());
+		REQUIRE(streamer.GetScene() == Scene::INVALID_HANDLE);
+
+		REQUIRE(registry.GetCurrentEntities() == count + 1);
+		REQUIRE(added == count + (count + 1) / 2);
+
+		registry.SetActiveScene(scene);
+		const std::vector<Entity> streamed = registry.GetActiveSceneEntities();
+		REQUIRE(streamed.size() == count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			REQUIRE(registry.GetComponent<Transform>(streamed[i]).pos_x == static_cast<float>(i));
+			REQUIRE(registry.HasComponent<Movement>(streamed[i]) == (i % 2 == 0));
+			REQUIRE(registry.GetSignature(streamed[i]).test(ComponentIndex::Index<Transform>()));
+		}
+		REQUIRE(registry.GetSceneMask(existing) == Registry::SceneMask(0));
+	}
+
+	SECTION("Merged within the budget")
+	{
+		/* Once staged, everything fits into one frame's budget: nothing is ever left half-merged. */
+		REQUIRE(streamer.Begin(scene, stage));
+		while (!streamer.Update(registry, 10.0))
+		{
+			REQUIRE(streamer.GetRemaining() == 0);
+			REQUIRE(registry.GetCurrentEntities() == 1);
+		}
+		REQUIRE(registry.GetCurrentEntities() == count + 1);
+	}
+
+	SECTION("Hierarchy links follow the merged entities")
+	{
+		/* Every entity is attached to the first one, across slices. */
+		REQUIRE(streamer.Begin(scene,
+			[&](Registry& staging)
+			{
+				stage(staging);
+				const std::vector<Entity> staged = staging.GetActiveSceneEntities();
+				for (size_t i = 1; i < staged.size(); i++)
+				{
+					TransformSystem::Attach(staging, staged[i], staged[0]);
+				}
+			}));
+		while (!streamer.Update(registry, 0.0))
+		{
+		}
+
+		registry.SetActiveScene(scene);
+		const std::vector<Entity> streamed = registry.GetActiveSceneEntities();
+		REQUIRE(registry.GetComponent<Children>(streamed[0]).entities.size() == count - 1);
+		REQUIRE(registry.GetComponent<Children>(streamed[0]).entities.back() == streamed.back());
+		for (uint32_t i = 1; i < count; i++)
+		{
+			REQUIRE(registry.GetComponent<Parent>(streamed[i]).entity == streamed[0]);
+		}
+	}
+
+	SECTION("Dead entities aren't merged")
+	{
+		EventSystem staging_events;
+		Registry	staging{staging_events, thread_pool};
+
+		const Entity dead = staging.CreateEntity();
+		const Entity alive = staging.CreateEntity();
+		staging.AddComponent<Transform>(dead, Transform{.pos_x = 1.0f});
+		staging.AddComponent<Transform>(alive, Transform{.pos_x = 2.0f});
+		staging.DestroyEntity(dead);
+
+		const uint32_t			  before = registry.GetCurrentEntities();
+		const std::vector<Entity> merged = registry.Merge(staging, std::vector<Entity>{dead, alive, dead}, scene);
+		REQUIRE(merged.size() == 3);
+		REQUIRE(merged[0].Index() == 0);
+		REQUIRE(merged[2].Index() == 0);
+		REQUIRE(registry.GetComponent<Transform>(merged[1]).pos_x == 2.0f);
+		REQUIRE(registry.GetCurrentEntities() == before + 1);
+
+		/* Only dead ones. */
+		staging.DestroyEntity(alive);
+		REQUIRE(registry.Merge(staging, std::vector<Entity>{alive}, scene)[0].Index() == 0);
+		REQUIRE(registry.GetCurrentEntities() == before + 1);
+	}
+
+	SECTION("Failing stage function")
+	{
+		REQUIRE(streamer.Begin(scene, [](Registry&) { throw std::runtime_error("stage failed"); }));
+
+		bool thrown = false;
+		while (!thrown)
+		{
+			try
+			{
+				streamer.Update(registry, 0.0);
+			}
+			catch (const std::runtime_error&)
+			{
+				thrown = true;
+			}
+		}
+		REQUIRE_FALSE(streamer.IsStreaming());
+		REQUIRE(registry.GetCurrentEntities() == 1);
+
+		/* The streamer can be used again. */
+		REQUIRE(streamer.Begin(scene, stage));
+	}
+}
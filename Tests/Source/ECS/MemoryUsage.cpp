@@ -0,0 +1,93 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace Mupfel;
+
+static const ComponentMemoryUsage* FindComponent(const RegistryMemoryUsage& usage, std::string_view name)
+{
+	auto it = std::ranges::find(usage.components, name, &ComponentMemoryUsage::name);
+	return (it == usage.components.end()) ? nullptr : &*it;
+}
+
+TEST_CASE("Component type names", "[memory]")
+{
+	REQUIRE(ComponentIndex::Name<Transform>() == "Transform");
+	REQUIRE(ComponentIndex::Name<Texture>() == "Texture");
+}
+
+TEST_CASE("Registry memory usage", "[memory]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{2};
+	Registry	registry{event_system, thread_pool};
+
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		Entity e = registry.CreateEntity();
+		registry.AddComponent<Transform>(e, Transform{});
+		if (i % 2 == 0)
+		{
+			registry.AddComponent<Texture>(e, Texture{i, 1.0f, 0});
+		}
+		entities.push_back(e);
+	}
+
+	const RegistryMemoryUsage before = registry.GetMemoryUsage();
+
+	const ComponentMemoryUsage* transforms = FindComponent(before, "Transform");
+	const ComponentMemoryUsage* textures = FindComponent(before, "Texture");
+	REQUIRE(transforms != nullptr);
+	REQUIRE(textures != nullptr);
+	REQUIRE(transforms->count == 1000);
+	REQUIRE(textures->count == 500);
+	REQUIRE(transforms->memory.used >= 1000 * sizeof(Transform));
+	REQUIRE(transforms->memory.reserved >= transforms->memory.used);
+	REQUIRE(before.Total().used > before.entities.used);
+
+	SECTION("ShrinkToFit gives back capacity and keeps the components")
+	{
+		/* Destroy the upper half: the arrays stay sized for all 1000 entities until they are shrunk. */
+		for (uint32_t i = 500; i < 1000; i++)
+		{
+			registry.DestroyEntity(entities[i]);
+		}
+
+		registry.ShrinkToFit();
+
+		const RegistryMemoryUsage after = registry.GetMemoryUsage();
+		REQUIRE(after.Total().reserved < before.Total().reserved);
+		REQUIRE(FindComponent(after, "Transform")->count == 500);
+		REQUIRE(FindComponent(after, "Transform")->memory.used == FindComponent(after, "Transform")->memory.reserved);
+
+		for (uint32_t i = 0; i < 500; i += 2)
+		{
+			REQUIRE(registry.HasComponent<Texture>(entities[i]));
+			REQUIRE(registry.GetComponent<Texture>(entities[i]).index == i);
+		}
+
+		/* Storage grows again on demand. */
+		Entity e = registry.CreateEntity();
+		registry.AddComponent<Texture>(e, Texture{4242, 1.0f, 0});
+		REQUIRE(registry.GetComponent<Texture>(e).index == 4242);
+	}
+
+	SECTION("Event buffers keep their capacity until shrunk")
+	{
+		event_system.Update();
+		event_system.Update();
+
+		const MemoryUsage events = event_system.GetMemoryUsage();
+		REQUIRE(events.reserved > events.used);
+
+		event_system.ShrinkToFit();
+		REQUIRE(event_system.GetMemoryUsage().reserved < events.reserved);
+	}
+}
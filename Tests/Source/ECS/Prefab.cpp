@@ -0,0 +1,120 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Movement.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/ECSEvents.h"
+#include "ECS/Prefab.h"
+#include "ECS/Registry.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace Mupfel;
+
+TEST_CASE("Prefab instantiation", "[prefab]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{1};
+	Registry	registry{event_system, thread_pool};
+
+	/* Three entities: a root with Transform + Movement, two children with Transform + Texture. */
+	Prefab prefab;
+	Entity root = prefab.CreateEntity();
+	prefab.AddComponent<Transform>(root, Transform{.pos_x = 1.0f});
+	Movement m;
+	m.velocity_x = 2.0f;
+	prefab.AddComponent<Movement>(root, m);
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		Entity child = prefab.CreateEntity();
+		prefab.AddComponent<Transform>(child, Transform{.pos_x = static_cast<float>(i + 10)});
+		prefab.AddComponent<Texture>(child, Texture{i, 1.0f});
+	}
+	REQUIRE(prefab.GetEntityCount() == 3);
+
+	/* Recycled indices in the registry: the copies don't get contiguous entities. */
+	std::vector<Entity> existing;
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		existing.push_back(registry.CreateEntity());
+		registry.AddComponent<Transform>(existing.back(), Transform{.pos_x = -1.0f});
+	}
+	registry.DestroyEntity(existing[2]);
+	registry.DestroyEntity(existing[5]);
+
+	uint32_t instantiated = 0;
+	uint32_t created = 0;
+	uint32_t added = 0;
+	event_system.RegisterListener<PrefabInstantiatedEvent>([&](const PrefabInstantiatedEvent&) { instantiated++; });
+	event_system.RegisterListener<EntityCreatedEvent>([&](const EntityCreatedEvent&) { created++; });
+	event_system.RegisterListener<ComponentAddedEvent>([&](const ComponentAddedEvent&) { added++; });
+
+	SECTION("Copies and remaps every entity")
+	{
+		const uint32_t			  copies = 50;
+		const std::vector<Entity> entities = registry.Instantiate(prefab, copies, 2);
+
+		REQUIRE(entities.size() == copies * 3);
+		REQUIRE(registry.GetCurrentEntities() == 6 + copies * 3);
+		REQUIRE(instantiated == 1);
+		REQUIRE(created == 0);
+		REQUIRE(added == 0);
+
+		/* Queued for the next frame like every immediate event, with the new entities. */
+		event_system.Update();
+		REQUIRE(event_system.GetEvents<PrefabInstantiatedEvent>().size() == 1);
+		REQUIRE(event_system.GetEvents<PrefabInstantiatedEvent>()[0].entities == entities);
+		REQUIRE(event_system.GetEvents<PrefabInstantiatedEvent>()[0].stride == 3);
+
+		for (uint32_t k = 0; k < copies; k++)
+		{
+			const Entity r = entities[k * 3];
+			REQUIRE(registry.GetComponent<Transform>(r).pos_x == 1.0f);
+			REQUIRE(registry.GetComponent<Movement>(r).velocity_x == 2.0f);
+			REQUIRE_FALSE(registry.HasComponent<Texture>(r));
+			REQUIRE(registry.GetSignature(r) == prefab.GetSignature(root));
+			REQUIRE(registry.GetSceneMask(r) == Registry::SceneMask(2));
+
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				const Entity c = entities[k * 3 + 1 + i];
+				REQUIRE(registry.GetComponent<Transform>(c).pos_x == static_cast<float>(i + 10));
+				REQUIRE(registry.GetComponent<Texture>(c).index == i);
+				REQUIRE_FALSE(registry.HasComponent<Movement>(c));
+			}
+		}
+
+		/* The copies are independent of each other and of the prefab. */
+		registry.GetComponent<Transform>(entities[0]).pos_x = 5.0f;
+		REQUIRE(registry.GetComponent<Transform>(entities[3]).pos_x == 1.0f);
+		REQUIRE(registry.GetComponent<Transform>(existing[0]).pos_x == -1.0f);
+
+		registry.DestroyEntity(entities[0]);
+		REQUIRE(registry.GetComponent<Transform>(entities[3]).pos_x == 1.0f);
+	}
+
+	SECTION("Captured from a registry")
+	{
+		const std::vector<Entity> source = {existing[4], existing[1]};
+		registry.AddComponent<Movement>(existing[4], m);
+
+		const Prefab			  captured(registry, source);
+		const std::vector<Entity> entities = registry.Instantiate(captured, 2);
+
+		REQUIRE(captured.GetEntityCount() == 2);
+		REQUIRE(entities.size() == 4);
+		REQUIRE(registry.HasComponent<Movement>(entities[0]));
+		REQUIRE_FALSE(registry.HasComponent<Movement>(entities[1]));
+		REQUIRE(registry.HasComponent<Movement>(entities[2]));
+		REQUIRE(registry.GetComponent<Transform>(entities[3]).pos_x == -1.0f);
+		REQUIRE(registry.GetSceneMask(entities[0]) == registry.GetActiveSceneMask());
+	}
+
+	SECTION("Empty prefab")
+	{
+		const Prefab empty;
+		REQUIRE(registry.Instantiate(empty, 10).empty());
+		REQUIRE(registry.GetCurrentEntities() == 6);
+	}
+}
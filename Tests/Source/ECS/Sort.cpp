@@ -0,0 +1,210 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Movement.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/** The entity indices in the order a view led by `T` visits them. */
+template <typename T> std::vector<uint32_t> VisitOrder(Registry& registry)
+{
+	std::vector<uint32_t> order;
+	for (auto [e, component] : registry.view<T>())
+	{
+		order.push_back(e.Index());
+	}
+	return order;
+}
+
+} // namespace
+
+TEST_CASE("Sorting and defragmenting component arrays", "[sort]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{1};
+	Registry	registry{event_system, thread_pool};
+
+	/* Both components carry the entity's index, so mixed-up slots show. */
+	auto add_transform = [&](Entity e)
+	{
+		registry.AddComponent<Transform>(e, Transform{.pos_x = static_cast<float>(e.Index())});
+	};
+	auto add_movement = [&](Entity e)
+	{
+		Movement m;
+		m.velocity_x = static_cast<float>(e.Index());
+		registry.AddComponent<Movement>(e, m);
+	};
+
+	/* Every entity has a Transform, every second one a Movement. */
+	const uint32_t		count = 20000;
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		entities.push_back(registry.CreateEntity());
+		add_transform(entities.back());
+		if (i % 2 == 0)
+		{
+			add_movement(entities.back());
+		}
+	}
+
+	/* Random removals and re-adds scramble both arrays. */
+	std::mt19937							rng(7);
+	std::uniform_int_distribution<uint32_t> pick(0, count - 1);
+	for (uint32_t i = 0; i < count * 2; i++)
+	{
+		const Entity e = entities[pick(rng)];
+		if (registry.HasComponent<Movement>(e))
+		{
+			registry.RemoveComponent<Movement>(e);
+			registry.RemoveComponent<Transform>(e);
+		}
+		else
+		{
+			add_transform(e);
+			add_movement(e);
+		}
+	}
+	REQUIRE_FALSE(std::ranges::is_sorted(VisitOrder<Transform>(registry)));
+
+	auto entity_at = [&](uint32_t index) { return *std::ranges::find(entities, index, &Entity::Index); };
+
+	/* Whatever the order, every entity still finds its own components. */
+	auto check_components = [&]
+	{
+		for (auto [e, t, m] : registry.view<Transform, Movement>())
+		{
+			REQUIRE(t.pos_x == m.velocity_x);
+		}
+		for (const Entity e : entities)
+		{
+			if (registry.HasComponent<Transform>(e))
+			{
+				REQUIRE(registry.GetComponent<Transform>(e).pos_x == static_cast<float>(e.Index()));
+			}
+		}
+	};
+
+	SECTION("Sort by component")
+	{
+		registry.Sort<Transform>([](const Transform& a, const Transform& b) { return a.pos_x > b.pos_x; });
+
+		std::vector<float> xs;
+		for (auto [e, t] : registry.view<Transform>())
+		{
+			xs.push_back(t.pos_x);
+		}
+		REQUIRE(std::ranges::is_sorted(xs, std::greater<>{}));
+		check_components();
+
+		/* A sorted array is left alone. */
+		while (!registry.Defragment(0.0))
+		{
+		}
+		std::vector<float> after;
+		for (auto [e, t] : registry.view<Transform>())
+		{
+			after.push_back(t.pos_x);
+		}
+		REQUIRE(after == xs);
+	}
+
+	SECTION("Sort, then churn, then Defragment")
+	{
+		auto descending = [](const Transform& a, const Transform& b) { return a.pos_x > b.pos_x; };
+		registry.Sort<Transform>(descending);
+		registry.SortLike<Movement, Transform>();
+		REQUIRE_FALSE(registry.IsOrderBroken<Transform>());
+
+		/* Removing from the middle breaks the sorted order; restoring it is up to whoever sorted. */
+		registry.RemoveComponent<Transform>(entity_at(VisitOrder<Transform>(registry)[10]));
+		registry.RemoveComponent<Movement>(entity_at(VisitOrder<Movement>(registry)[10]));
+		REQUIRE(registry.IsOrderBroken<Transform>());
+		REQUIRE(registry.IsOrderBroken<Movement>());
+
+		const std::vector<uint32_t> broken = VisitOrder<Transform>(registry);
+		while (!registry.Defragment(0.0))
+		{
+		}
+		REQUIRE(VisitOrder<Transform>(registry) == broken);
+
+		registry.Sort<Transform>(descending);
+		REQUIRE_FALSE(registry.IsOrderBroken<Transform>());
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Transform>(registry), std::greater<>{}));
+
+		/* Given up, the order is Defragment's again. */
+		registry.ReleaseOrder<Movement>();
+		REQUIRE_FALSE(registry.IsOrderBroken<Movement>());
+		while (!registry.Defragment(0.0))
+		{
+		}
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Movement>(registry)));
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Transform>(registry), std::greater<>{}));
+		check_components();
+	}
+
+	SECTION("Sort like another array")
+	{
+		registry.SortLike<Transform, Movement>();
+
+		/* Entities with a Movement lead the Transforms, in the Movements' order. */
+		const std::vector<uint32_t> movements = VisitOrder<Movement>(registry);
+		const std::vector<uint32_t> transforms = VisitOrder<Transform>(registry);
+		REQUIRE(std::ranges::equal(movements, std::span(transforms).first(movements.size())));
+		check_components();
+	}
+
+	SECTION("Defragment a step at a time")
+	{
+		/* With no budget, each call visits one slice of indices. */
+		uint32_t calls = 1;
+		while (!registry.Defragment(0.0))
+		{
+			calls++;
+		}
+		REQUIRE(calls > 2);
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Transform>(registry)));
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Movement>(registry)));
+		check_components();
+
+		/* In order, it is done right away; a removal in the middle starts it over. */
+		REQUIRE(registry.Defragment(0.0));
+		registry.RemoveComponent<Transform>(entity_at(VisitOrder<Transform>(registry)[10]));
+		REQUIRE_FALSE(std::ranges::is_sorted(VisitOrder<Transform>(registry)));
+		while (!registry.Defragment(0.0))
+		{
+		}
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Transform>(registry)));
+	}
+
+	SECTION("Changes during a pass")
+	{
+		REQUIRE_FALSE(registry.Defragment(0.0));
+
+		/* Removed from the part that is done, added out of order: the pass in progress can't count. */
+		const Entity moved = entity_at(VisitOrder<Transform>(registry)[1]);
+		registry.RemoveComponent<Transform>(moved);
+		registry.RemoveComponent<Movement>(moved);
+		add_transform(moved);
+		add_movement(moved);
+
+		while (!registry.Defragment(0.0))
+		{
+		}
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Transform>(registry)));
+		REQUIRE(std::ranges::is_sorted(VisitOrder<Movement>(registry)));
+		check_components();
+	}
+}
@@ -0,0 +1,73 @@
+#include "ECS/SparsePages.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+
+using namespace Mupfel;
+
+TEST_CASE("Sparse pages", "[sparse_pages]")
+{
+	SparsePages pages;
+
+	SECTION("Empty")
+	{
+		REQUIRE_FALSE(pages.Contains(0));
+		REQUIRE(pages.Find(123456) == SparsePages::invalid_slot);
+		REQUIRE(pages.GetMemoryUsage().reserved == 0);
+	}
+
+	SECTION("Set, find and reset")
+	{
+		pages.Set(7, 0);
+		pages.Set(SparsePages::pageSize * 100 + 3, 1);
+
+		REQUIRE(pages.Get(7) == 0);
+		REQUIRE(pages.Find(SparsePages::pageSize * 100 + 3) == 1);
+		REQUIRE_FALSE(pages.Contains(8));
+		REQUIRE_FALSE(pages.Contains(SparsePages::pageSize * 50));
+
+		pages.Reset(7);
+		REQUIRE_FALSE(pages.Contains(7));
+
+		/* Resetting an index on a page that was never allocated is a no-op. */
+		pages.Reset(SparsePages::pageSize * 500);
+		REQUIRE_FALSE(pages.Contains(SparsePages::pageSize * 500));
+	}
+
+	SECTION("Only touched pages are allocated")
+	{
+		for (uint32_t i = 0; i < 50; i++)
+		{
+			pages.Set(i * 20000, i);
+		}
+
+		const size_t	  page_bytes = SparsePages::pageSize * sizeof(uint32_t);
+		const MemoryUsage usage = pages.GetMemoryUsage();
+		REQUIRE(usage.used >= 50 * page_bytes);
+		/* Plus the page table, one pointer per page up to the highest one. */
+		REQUIRE(usage.used < 52 * page_bytes);
+
+		for (uint32_t i = 0; i < 50; i++)
+		{
+			REQUIRE(pages.Get(i * 20000) == i);
+		}
+	}
+
+	SECTION("ShrinkToFit frees empty pages")
+	{
+		pages.Set(1, 0);
+		pages.Set(SparsePages::pageSize * 10, 1);
+		pages.Reset(SparsePages::pageSize * 10);
+
+		const MemoryUsage before = pages.GetMemoryUsage();
+		pages.ShrinkToFit();
+		const MemoryUsage after = pages.GetMemoryUsage();
+
+		REQUIRE(after.reserved < before.reserved);
+		REQUIRE(pages.Get(1) == 0);
+		REQUIRE_FALSE(pages.Contains(SparsePages::pageSize * 10));
+
+		/* Pages come back on demand. */
+		pages.Set(SparsePages::pageSize * 10, 2);
+		REQUIRE(pages.Get(SparsePages::pageSize * 10) == 2);
+	}
+}
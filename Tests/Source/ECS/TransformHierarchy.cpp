@@ -0,0 +1,243 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Hierarchy.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Prefab.h"
+#include "ECS/Registry.h"
+#include "ECS/TransformSystem.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+using namespace Mupfel;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+
+/** The entity indices in the order a view led by `T` visits them, i.e. the order of `T`'s array. */
+template <typename T> std::vector<uint32_t> VisitOrder(Registry& registry)
+{
+	std::vector<uint32_t> order;
+	for (auto [e, component] : registry.view<T>())
+	{
+		order.push_back(e.Index());
+	}
+	return order;
+}
+
+} // namespace
+
+TEST_CASE("Transform hierarchy", "[transform_hierarchy]")
+{
+	EventSystem		event_system;
+	ThreadPool		thread_pool{4};
+	Registry		registry{event_system, thread_pool};
+	TransformSystem transforms{registry, event_system, thread_pool};
+	transforms.Init();
+
+	auto make = [&](Transform t)
+	{
+		Entity e = registry.CreateEntity();
+		registry.AddComponent<Transform>(e, t);
+		return e;
+	};
+
+	/* A root turned by 90 degrees and scaled by 2, a child one unit along its x axis, and a grandchild. */
+	const float half_pi = std::numbers::pi_v<float> / 2.0f;
+	Entity		root = make(Transform{.pos_x = 10.0f, .scale_x = 2.0f, .scale_y = 2.0f, .rotation = half_pi});
+	Entity		child = make(Transform{.pos_x = 1.0f, .pos_z = 0.5f});
+	Entity		grandchild = make(Transform{.pos_x = 1.0f, .rotation = half_pi});
+	Entity		loner = make(Transform{.pos_x = 3.0f});
+	REQUIRE(TransformSystem::Attach(registry, child, root));
+	REQUIRE(TransformSystem::Attach(registry, grandchild, child));
+
+	transforms.Update();
+	REQUIRE(transforms.GetNodeCount() == 3);
+	REQUIRE(transforms.GetDepth() == 3);
+	REQUIRE(transforms.GetUpdatedNodes() == 3);
+	REQUIRE_FALSE(registry.HasComponent<WorldTransform>(loner));
+
+	SECTION("Composes scale, rotation and position")
+	{
+		const WorldTransform& w = registry.GetComponent<WorldTransform>(root);
+		REQUIRE(w.pos_x == 10.0f);
+		REQUIRE(w.scale_x == 2.0f);
+
+		/* The child's x axis is the world's y axis, stretched by 2. */
+		const WorldTransform& c = registry.GetComponent<WorldTransform>(child);
+		REQUIRE_THAT(c.pos_x, WithinAbs(10.0f, 1e-5));
+		REQUIRE_THAT(c.pos_y, WithinAbs(2.0f, 1e-5));
+		REQUIRE(c.pos_z == 0.5f);
+		REQUIRE(c.scale_x == 2.0f);
+		REQUIRE_THAT(c.rotation, WithinAbs(half_pi, 1e-6));
+
+		const WorldTransform& g = registry.GetComponent<WorldTransform>(grandchild);
+		REQUIRE_THAT(g.pos_x, WithinAbs(10.0f, 1e-5));
+		REQUIRE_THAT(g.pos_y, WithinAbs(4.0f, 1e-5));
+		REQUIRE_THAT(g.rotation, WithinAbs(2.0f * half_pi, 1e-6));
+		REQUIRE_THAT(g.cos_rotation, WithinAbs(-1.0f, 1e-5));
+	}
+
+	SECTION("Recomputes dirty subtrees only")
+	{
+		transforms.Update();
+		REQUIRE(transforms.GetUpdatedNodes() == 0);
+
+		registry.GetComponent<Transform>(child).pos_x = 2.0f;
+		transforms.Update();
+		REQUIRE(transforms.GetUpdatedNodes() == 2);
+		REQUIRE_THAT(registry.GetComponent<WorldTransform>(grandchild).pos_y, WithinAbs(6.0f, 1e-5));
+
+		registry.GetComponent<Transform>(grandchild).pos_x = 0.0f;
+		transforms.Update();
+		REQUIRE(transforms.GetUpdatedNodes() == 1);
+
+		transforms.Invalidate();
+		transforms.Update();
+		REQUIRE(transforms.GetUpdatedNodes() == 3);
+	}
+
+	SECTION("Attach refuses cycles")
+	{
+		REQUIRE_FALSE(TransformSystem::Attach(registry, root, grandchild));
+		REQUIRE_FALSE(TransformSystem::Attach(registry, root, root));
+		REQUIRE_FALSE(registry.HasComponent<Parent>(root));
+
+		/* Moving a subtree to another parent. */
+		REQUIRE(TransformSystem::Attach(registry, child, loner));
+		REQUIRE(registry.GetComponent<Children>(root).entities.empty());
+		REQUIRE(registry.GetComponent<Children>(loner).entities == std::vector<Entity>{child});
+
+		transforms.Update();
+		REQUIRE(transforms.GetNodeCount() == 3);
+		REQUIRE(registry.GetComponent<WorldTransform>(child).pos_x == 4.0f);
+	}
+
+	SECTION("A destroyed parent leaves roots behind")
+	{
+		registry.DestroyEntity(child);
+		REQUIRE_FALSE(registry.HasComponent<Parent>(grandchild));
+		REQUIRE(registry.GetComponent<Children>(root).entities.empty());
+
+		/* The root has no children left: the grandchild is all there is. */
+		transforms.Update();
+		REQUIRE(transforms.GetNodeCount() == 0);
+
+		REQUIRE(TransformSystem::Attach(registry, grandchild, root));
+		transforms.Update();
+		REQUIRE(transforms.GetNodeCount() == 2);
+		REQUIRE_THAT(registry.GetComponent<WorldTransform>(grandchild).pos_y, WithinAbs(2.0f, 1e-5));
+	}
+
+	SECTION("Prefab copies get their own hierarchy")
+	{
+		/* The child's link to the root leaves the prefab and is cut: it is the root of every copy. */
+		Prefab prefab{registry, std::vector<Entity>{child, grandchild}};
+
+		const std::vector<Entity> copies = registry.Instantiate(prefab, 2);
+		for (uint32_t k = 0; k < 2; k++)
+		{
+			const Entity copy_root = copies[k * 2];
+			const Entity copy_child = copies[k * 2 + 1];
+			REQUIRE_FALSE(registry.HasComponent<Parent>(copy_root));
+			REQUIRE(registry.GetComponent<Parent>(copy_child).entity == copy_root);
+			REQUIRE(registry.GetComponent<Children>(copy_root).entities == std::vector<Entity>{copy_child});
+		}
+
+		transforms.Update();
+		REQUIRE(transforms.GetNodeCount() == 7);
+		REQUIRE_THAT(registry.GetComponent<WorldTransform>(copies[3]).pos_x, WithinAbs(2.0f, 1e-5));
+	}
+
+	SECTION("Unrelated churn and Defragment keep the arrangement")
+	{
+		/* A second root created last puts breadth-first order at odds with index order. */
+		const Entity late_root = make(Transform{.pos_y = 1.0f});
+		REQUIRE(TransformSystem::Attach(registry, loner, late_root));
+		transforms.Update();
+
+		const std::vector<uint32_t> arranged{root.Index(), late_root.Index(), child.Index(), loner.Index(),
+											 grandchild.Index()};
+		auto is_arranged = [&](const std::vector<uint32_t>& order)
+		{
+			return order.size() >= arranged.size() &&
+				   std::ranges::equal(std::span(order).first(arranged.size()), arranged);
+		};
+		REQUIRE(is_arranged(VisitOrder<Transform>(registry)));
+
+		/* Projectiles come and go, which breaks index order in the Transform array. */
+		std::vector<Entity> projectiles;
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			projectiles.push_back(make(Transform{}));
+		}
+		registry.DestroyEntity(projectiles[2]);
+		registry.DestroyEntity(projectiles[5]);
+		REQUIRE(registry.IsOrderBroken<Transform>());
+
+		while (!registry.Defragment(0.0))
+		{
+		}
+		transforms.Update();
+
+		REQUIRE_FALSE(registry.IsOrderBroken<Transform>());
+		REQUIRE(is_arranged(VisitOrder<Transform>(registry)));
+		REQUIRE(is_arranged(VisitOrder<WorldTransform>(registry)));
+		REQUIRE_THAT(registry.GetComponent<WorldTransform>(loner).pos_x, WithinAbs(3.0f, 1e-5));
+		REQUIRE_THAT(registry.GetComponent<WorldTransform>(loner).pos_y, WithinAbs(1.0f, 1e-5));
+	}
+}
+
+TEST_CASE("Transform hierarchy across the thread pool", "[transform_hierarchy]")
+{
+	EventSystem		event_system;
+	ThreadPool		thread_pool{4};
+	Registry		registry{event_system, thread_pool};
+	TransformSystem transforms{registry, event_system, thread_pool};
+	transforms.Init();
+
+	/* Two roots with a wide level below each: large enough to be split across the pool. */
+	const uint32_t		width = TransformSystem::parallelThreshold;
+	std::vector<Entity> roots;
+	std::vector<Entity> leaves;
+	for (uint32_t r = 0; r < 2; r++)
+	{
+		roots.push_back(registry.CreateEntity());
+		registry.AddComponent<Transform>(roots.back(), Transform{.pos_y = static_cast<float>(r * 100)});
+		for (uint32_t i = 0; i < width; i++)
+		{
+			Entity mid = registry.CreateEntity();
+			registry.AddComponent<Transform>(mid, Transform{.pos_x = static_cast<float>(i)});
+			REQUIRE(TransformSystem::Attach(registry, mid, roots.back()));
+
+			Entity leaf = registry.CreateEntity();
+			registry.AddComponent<Transform>(leaf, Transform{.pos_x = 0.5f});
+			REQUIRE(TransformSystem::Attach(registry, leaf, mid));
+			leaves.push_back(leaf);
+		}
+	}
+
+	transforms.Update();
+	REQUIRE(transforms.GetNodeCount() == 2 + 4 * width);
+	REQUIRE(transforms.GetDepth() == 3);
+	for (uint32_t r = 0; r < 2; r++)
+	{
+		for (uint32_t i = 0; i < width; i += 97)
+		{
+			const WorldTransform& w = registry.GetComponent<WorldTransform>(leaves[r * width + i]);
+			REQUIRE(w.pos_x == static_cast<float>(i) + 0.5f);
+			REQUIRE(w.pos_y == static_cast<float>(r * 100));
+		}
+	}
+
+	/* Moving the second root moves its half only. */
+	registry.GetComponent<Transform>(roots[1]).pos_y = 7.0f;
+	transforms.Update();
+	REQUIRE(transforms.GetUpdatedNodes() == 1 + 2 * width);
+	REQUIRE(registry.GetComponent<WorldTransform>(leaves.back()).pos_y == 7.0f);
+	REQUIRE(registry.GetComponent<WorldTransform>(leaves.front()).pos_y == 0.0f);
+}
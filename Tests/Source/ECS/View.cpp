@@ -4,6 +4,7 @@
 #include "Random.h"
 #include "catch_amalgamated.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iterator>
 #include <ranges>
@@ -89,6 +90,81 @@ TEST_CASE("Single Component View", "[view_single]")
 	}
 }
 
+TEST_CASE("Views Over Scene Partitions", "[view_scenes]")
+{
+	Mupfel::EventSystem event_system;
+	Mupfel::ThreadPool	thread_pool{2};
+	Mupfel::Registry	registry{event_system, thread_pool};
+
+	/* Three scenes with 10, 20 and 30 entities, created interleaved so their indices mix. */
+	std::vector<Mupfel::Entity> entities;
+	for (uint32_t i = 0; i < 60; i++)
+	{
+		const Mupfel::SceneHandle scene = (i % 6 == 0) ? 0 : ((i % 6 < 3) ? 1 : 2);
+		registry.SetActiveScene(scene);
+		Mupfel::Entity e = registry.CreateEntity();
+		registry.AddComponent<IntComponent>(e, IntComponent{static_cast<int32_t>(scene)});
+		if (i % 2 == 0)
+		{
+			registry.AddComponent<DoubleComponent>(e, DoubleComponent{static_cast<double>(i)});
+		}
+		entities.push_back(e);
+	}
+
+	SECTION("Only the active scene is iterated")
+	{
+		for (Mupfel::SceneHandle scene = 0; scene < 3; scene++)
+		{
+			registry.SetActiveScene(scene);
+
+			uint32_t count = 0;
+			for (auto [e, i] : registry.view<IntComponent>())
+			{
+				REQUIRE(i.i == static_cast<int32_t>(scene));
+				REQUIRE(registry.GetScene(e) == scene);
+				count++;
+			}
+			REQUIRE(count == 10 * (scene + 1));
+
+			std::atomic<uint32_t> parallel_count = 0;
+			registry.ParallelForEach<IntComponent, DoubleComponent>(
+				[&](Mupfel::Entity e, IntComponent& i, DoubleComponent&)
+				{
+					if (i.i == static_cast<int32_t>(scene))
+					{
+						parallel_count++;
+					}
+				});
+			/* Ten entities of every scene have an even creation index, and with it a DoubleComponent. */
+			REQUIRE(parallel_count == 10);
+		}
+	}
+
+	SECTION("Components are reached from any active scene")
+	{
+		registry.SetActiveScene(0);
+		for (uint32_t i = 0; i < entities.size(); i++)
+		{
+			REQUIRE(registry.HasComponent<DoubleComponent>(entities[i]) == (i % 2 == 0));
+		}
+
+		/* Destroying removes the components from the entity's own partition. */
+		registry.DestroyEntity(entities[1]);
+		REQUIRE_FALSE(registry.HasComponent<IntComponent>(entities[1]));
+		REQUIRE(registry.GetScene(entities[1]) == Mupfel::Scene::INVALID_HANDLE);
+		REQUIRE(registry.GetSceneMask(entities[1]).none());
+
+		registry.SetActiveScene(1);
+		uint32_t count = 0;
+		for (auto [e, i] : registry.view<IntComponent>())
+		{
+			count++;
+		}
+		REQUIRE(count == 19);
+		REQUIRE(registry.GetActiveSceneEntities().size() == 19);
+	}
+}
+
 static void InsertEntities(Mupfel::Registry& reg, uint32_t n, std::vector<Mupfel::Entity>& vec)
 {
 	for (uint32_t i = 0; i < n; i++)
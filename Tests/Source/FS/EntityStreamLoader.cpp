@@ -0,0 +1,162 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Light.h"
+#include "ECS/Components/Movement.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include "FS/EntityStreamLoader.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Mupfel;
+
+namespace
+{
+
+struct Health
+{
+	int32_t current = 0;
+	int32_t maximum = 0;
+	bool	regenerates = false;
+};
+
+} // namespace
+
+TEST_CASE("Entity stream loader", "[entity_stream]")
+{
+	EventSystem		   event_system;
+	ThreadPool		   thread_pool{2};
+	Registry		   registry{event_system, thread_pool};
+	EntityStreamLoader loader;
+
+	auto load = [&](const std::string& text)
+	{
+		std::istringstream stream(text);
+		return loader.Load(registry, stream);
+	};
+
+	SECTION("Components and fields")
+	{
+		auto loaded = load(R"([
+			{
+				"name": "Marta",
+				"tags": ["player", {"nested": [1, 2]}],
+				"components": [
+					{"name": "Transform", "pos_x": 1.5, "pos_y": -2, "rotation": 3},
+					{"pos_z": 4, "name": "Movement", "velocity_x": 7, "unknown": {"a": 1}},
+					{"name": "Collider", "type": "Circle", "radius": 16.3},
+					{"name": "Texture", "index": 5, "layer": 2}
+				]
+			},
+			{"components": []}
+		])");
+
+		REQUIRE(loaded.has_value());
+		REQUIRE(*loaded == 2);
+		REQUIRE(registry.GetCurrentEntities() == 2);
+
+		const std::vector<Entity> entities = registry.GetActiveSceneEntities();
+		REQUIRE(entities.size() == 2);
+
+		const Entity marta = entities[0];
+		REQUIRE(registry.GetComponent<Transform>(marta).pos_x == 1.5f);
+		REQUIRE(registry.GetComponent<Transform>(marta).pos_y == -2.0f);
+		REQUIRE(registry.GetComponent<Transform>(marta).rotation == 3.0f);
+		REQUIRE(registry.GetComponent<Transform>(marta).scale_x == 1.0f);
+		/* Fields before the name still count; fields the type doesn't have are skipped. */
+		REQUIRE(registry.GetComponent<Movement>(marta).velocity_x == 7.0f);
+		REQUIRE(registry.GetComponent<Texture>(marta).index == 5);
+		REQUIRE(registry.GetComponent<Texture>(marta).layer == 2);
+
+		REQUIRE_FALSE(registry.HasComponent<Transform>(entities[1]));
+	}
+
+	SECTION("Registered components")
+	{
+		loader.RegisterComponent<Health>("Health", {
+													   {"current", &Health::current},
+													   {"maximum", &Health::maximum},
+													   {"regenerates", &Health::regenerates},
+												   });
+
+		auto loaded = load(R"([{"components": [{"name": "Health", "current": 30, "maximum": 100,
+			"regenerates": true}]}])");
+		REQUIRE(loaded.has_value());
+
+		const Entity e = registry.GetActiveSceneEntities().front();
+		REQUIRE(registry.GetComponent<Health>(e).current == 30);
+		REQUIRE(registry.GetComponent<Health>(e).maximum == 100);
+		REQUIRE(registry.GetComponent<Health>(e).regenerates);
+	}
+
+	SECTION("More entities than fit in a batch")
+	{
+		const uint32_t count = EntityStreamLoader::batchSize * 2 + 17;
+
+		std::string text = "[";
+		for (uint32_t i = 0; i < count; i++)
+		{
+			text += (i ? "," : "");
+			text += R"({"components": [{"name": "Transform", "pos_x": )" + std::to_string(i) + "}]}";
+		}
+		text += "]";
+
+		auto loaded = loader.Load(registry, std::as_bytes(std::span(text)));
+		REQUIRE(loaded.has_value());
+		REQUIRE(*loaded == count);
+
+		const std::vector<Entity> entities = registry.GetActiveSceneEntities();
+		REQUIRE(entities.size() == count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			REQUIRE(registry.GetComponent<Transform>(entities[i]).pos_x == static_cast<float>(i));
+		}
+	}
+
+	SECTION("Store and load back")
+	{
+		Entity first = registry.CreateEntity();
+		registry.AddComponent<Transform>(first, Transform{.pos_x = 0.1f, .pos_y = -3.25f, .rotation = 1e-7f});
+		registry.AddComponent<Texture>(first, Texture{.index = 4, .uvScale = 2.0f, .layer = 1});
+		Entity second = registry.CreateEntity();
+		Light  light;
+		light.r = 0.5f;
+		registry.AddComponent<Light>(second, light);
+		registry.CreateEntity();
+
+		std::stringstream stream;
+		auto			  stored = loader.Store(registry, stream);
+		REQUIRE(stored.has_value());
+		REQUIRE(*stored == 3);
+
+		EventSystem target_events;
+		Registry	target{target_events, thread_pool};
+		auto		loaded = loader.Load(target, stream);
+		REQUIRE(loaded.has_value());
+		REQUIRE(*loaded == 3);
+
+		const std::vector<Entity> entities = target.GetActiveSceneEntities();
+		REQUIRE(target.GetComponent<Transform>(entities[0]).pos_x == 0.1f);
+		REQUIRE(target.GetComponent<Transform>(entities[0]).pos_y == -3.25f);
+		REQUIRE(target.GetComponent<Transform>(entities[0]).rotation == 1e-7f);
+		REQUIRE(target.GetComponent<Texture>(entities[0]).index == 4);
+		REQUIRE(target.GetComponent<Texture>(entities[0]).uvScale == 2.0f);
+		REQUIRE(target.GetComponent<Light>(entities[1]).r == 0.5f);
+		REQUIRE_FALSE(target.HasComponent<Transform>(entities[1]));
+		REQUIRE_FALSE(target.HasComponent<Light>(entities[2]));
+	}
+
+	SECTION("Broken files")
+	{
+		REQUIRE(load(R"([{"components": [{"name": "Transform", "pos_x": ]}])").error() == Error::INVALID_FORMAT);
+		REQUIRE(load(R"({"components": []})").error() == Error::INVALID_FORMAT);
+		REQUIRE(load("").error() == Error::INVALID_FORMAT);
+		REQUIRE(registry.GetCurrentEntities() == 0);
+
+		REQUIRE(loader.Load(registry, std::filesystem::path("does/not/exist.json")).error() == Error::FILE_NOT_FOUND);
+	}
+}
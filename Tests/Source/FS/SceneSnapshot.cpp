@@ -0,0 +1,117 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Movement.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include "FS/MappedFile.h"
+#include "FS/SceneSnapshot.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace Mupfel;
+
+TEST_CASE("Scene snapshot", "[snapshot]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{2};
+	Registry	source{event_system, thread_pool};
+	Registry	target{event_system, thread_pool};
+
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "mupfel_test.msnap";
+
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		Entity e = source.CreateEntity();
+		source.AddComponent<Transform>(e, Transform{.pos_x = static_cast<float>(i), .pos_y = 2.0f * i});
+		if (i % 3 == 0)
+		{
+			Movement m;
+			m.velocity_y = static_cast<float>(i);
+			source.AddComponent<Movement>(e, m);
+		}
+		entities.push_back(e);
+	}
+
+	/* Destroyed entities leave a hole in the indices, which the snapshot closes. */
+	for (uint32_t i = 0; i < 100; i += 10)
+	{
+		source.DestroyEntity(entities[i]);
+	}
+
+	auto stored = SceneSnapshot::Store(source, file);
+	REQUIRE(stored.has_value());
+	REQUIRE(*stored == 90);
+
+	SECTION("Round trip")
+	{
+		auto loaded = SceneSnapshot::Load(target, file);
+		REQUIRE(loaded.has_value());
+		REQUIRE(loaded->size() == 90);
+		REQUIRE(target.GetCurrentEntities() == 90);
+
+		/* Entities come back in the order they were stored, i.e. in index order. */
+		size_t next = 0;
+		for (uint32_t i = 0; i < 100; i++)
+		{
+			if (i % 10 == 0)
+			{
+				continue;
+			}
+
+			const Entity e = (*loaded)[next++];
+			REQUIRE(target.HasComponent<Transform>(e));
+			REQUIRE(target.GetComponent<Transform>(e).pos_x == static_cast<float>(i));
+			REQUIRE(target.GetComponent<Transform>(e).pos_y == 2.0f * i);
+			REQUIRE(target.HasComponent<Movement>(e) == (i % 3 == 0));
+			if (i % 3 == 0)
+			{
+				REQUIRE(target.GetComponent<Movement>(e).velocity_y == static_cast<float>(i));
+			}
+			REQUIRE_FALSE(target.HasComponent<Texture>(e));
+		}
+	}
+
+	SECTION("Broken input leaves the registry untouched")
+	{
+		auto mapped = MappedFile::Open(file);
+		REQUIRE(mapped.has_value());
+		std::vector<std::byte> bytes(mapped->Data().begin(), mapped->Data().end());
+
+		SECTION("Truncated")
+		{
+			bytes.resize(bytes.size() - 8);
+		}
+
+		SECTION("Wrong magic")
+		{
+			bytes[0] = std::byte{'X'};
+		}
+
+		SECTION("Entity ordinal out of range")
+		{
+			SceneSnapshot::SnapshotColumn column;
+			std::memcpy(&column, bytes.data() + sizeof(SceneSnapshot::SnapshotHeader), sizeof(column));
+			const uint32_t invalid = 1000;
+			std::memcpy(bytes.data() + column.entityOffset, &invalid, sizeof(invalid));
+		}
+
+		auto loaded = SceneSnapshot::Load(target, bytes);
+		REQUIRE_FALSE(loaded.has_value());
+		REQUIRE(loaded.error() == Error::INVALID_FORMAT);
+		REQUIRE(target.GetCurrentEntities() == 0);
+	}
+
+	SECTION("Missing file")
+	{
+		auto loaded = SceneSnapshot::Load(target, std::filesystem::temp_directory_path() / "mupfel_missing.msnap");
+		REQUIRE_FALSE(loaded.has_value());
+		REQUIRE(loaded.error() == Error::FILE_NOT_FOUND);
+	}
+
+	std::filesystem::remove(file);
+}
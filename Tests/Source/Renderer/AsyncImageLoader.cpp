@@ -0,0 +1,224 @@
+#include "Core/ThreadPool.h"
+#include "Renderer/AsyncImageLoader.h"
+#include "catch_amalgamated.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Stands in for the GPU: remembers every batch it was handed instead of creating images. */
+class FakeUploadDevice : public Mupfel::ImageUploadDevice
+{
+public:
+	void UploadBatch(std::span<Mupfel::DecodeResult> batch) final
+	{
+		batches++;
+		for (Mupfel::DecodeResult& result : batch)
+		{
+			results.push_back(std::move(result));
+		}
+	}
+
+	uint32_t					   batches = 0;
+	std::vector<Mupfel::DecodeResult> results;
+};
+
+/* Writes a binary PPM whose pixel (x, y) has the color (x, y, 7), so every pixel can be identified after slicing. */
+static std::string WritePPM(const std::string& name, uint32_t width, uint32_t height)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::ofstream				file(path, std::ios::binary);
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const uint8_t pixel[3] = {static_cast<uint8_t>(x), static_cast<uint8_t>(y), 7};
+			file.write(reinterpret_cast<const char*>(pixel), 3);
+		}
+	}
+
+	return path.string();
+}
+
+static void CollectAll(Mupfel::AsyncImageLoader& loader, FakeUploadDevice& device)
+{
+	while (loader.Pending() > 0)
+	{
+		loader.Collect(device);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST_CASE("Async image decode", "[async_image_loader]")
+{
+	Mupfel::ThreadPool		 pool{4};
+	Mupfel::AsyncImageLoader loader{pool};
+	FakeUploadDevice		 device;
+
+	SECTION("Basic image is decoded to RGBA8")
+	{
+		loader.Submit({.path = WritePPM("mupfel_basic.ppm", 4, 3), .firstHandle = 5});
+		CollectAll(loader, device);
+
+		REQUIRE(device.results.size() == 1);
+		REQUIRE(device.results[0].images.has_value());
+
+		const auto& images = device.results[0].images.value();
+		REQUIRE(images.size() == 1);
+		REQUIRE(images[0].handle == 5);
+		REQUIRE(images[0].width == 4);
+		REQUIRE(images[0].height == 3);
+		REQUIRE(images[0].pixels.size() == 4 * 3 * 4);
+
+		/* Pixel (2, 1): red = x, green = y, blue = 7, opaque. */
+		const size_t offset = (1 * 4 + 2) * 4;
+		REQUIRE(images[0].pixels[offset + 0] == 2);
+		REQUIRE(images[0].pixels[offset + 1] == 1);
+		REQUIRE(images[0].pixels[offset + 2] == 7);
+		REQUIRE(images[0].pixels[offset + 3] == 255);
+	}
+
+	SECTION("Sprite sheets are cut row-major into consecutive handles")
+	{
+		loader.Submit(
+			{.path = WritePPM("mupfel_sheet.ppm", 6, 4),
+			 .kind = Mupfel::ImageRequestKind::SpriteSheet,
+			 .spec = {.rows = 2, .columns = 3},
+			 .firstHandle = 10});
+		CollectAll(loader, device);
+
+		REQUIRE(device.results.size() == 1);
+		const auto& images = device.results[0].images.value();
+		REQUIRE(images.size() == 6);
+
+		for (uint32_t i = 0; i < images.size(); i++)
+		{
+			REQUIRE(images[i].handle == 10 + i);
+			REQUIRE(images[i].width == 2);
+			REQUIRE(images[i].height == 2);
+
+			/* The top-left pixel of frame i sits at (column * 2, row * 2) in the sheet. */
+			REQUIRE(images[i].pixels[0] == (i % 3) * 2);
+			REQUIRE(images[i].pixels[1] == (i / 3) * 2);
+		}
+	}
+
+	SECTION("Animated images keep their frame grid")
+	{
+		loader.Submit(
+			{.path = WritePPM("mupfel_animated.ppm", 8, 2),
+			 .kind = Mupfel::ImageRequestKind::Animated,
+			 .spec = {.rows = 1, .columns = 4}});
+		CollectAll(loader, device);
+
+		const auto& images = device.results[0].images.value();
+		REQUIRE(images.size() == 1);
+		REQUIRE(images[0].width == 8);
+		REQUIRE(images[0].spec.columns == 4);
+	}
+
+	SECTION("Failures are reported and keep their place in the order")
+	{
+		loader.Submit({.path = WritePPM("mupfel_ok_0.ppm", 2, 2), .firstHandle = 0});
+		loader.Submit({.path = "does/not/exist.png", .firstHandle = 1});
+		loader.Submit({.path = WritePPM("mupfel_ok_2.ppm", 2, 2), .firstHandle = 2});
+		loader.Flush(device);
+
+		REQUIRE(loader.Pending() == 0);
+		REQUIRE(device.batches == 1);
+		REQUIRE(device.results.size() == 3);
+		REQUIRE(device.results[0].images.has_value());
+		REQUIRE(device.results[1].images.error() == Mupfel::Error::FILE_NOT_FOUND);
+		REQUIRE(device.results[1].request.firstHandle == 1);
+		REQUIRE(device.results[2].images.has_value());
+	}
+
+	SECTION("Many requests are uploaded in submission order")
+	{
+		const std::string path = WritePPM("mupfel_many.ppm", 16, 16);
+
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			loader.Submit({.path = path, .firstHandle = i});
+		}
+		CollectAll(loader, device);
+
+		REQUIRE(device.results.size() == 64);
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			REQUIRE(device.results[i].request.firstHandle == i);
+		}
+	}
+
+	SECTION("The byte budget limits each batch")
+	{
+		const std::string path = WritePPM("mupfel_budget.ppm", 16, 16);
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			loader.Submit({.path = path, .firstHandle = i});
+		}
+
+		/* Every image is 16 * 16 * 4 bytes, so a one byte budget lets exactly one through per call. */
+		while (loader.Pending() > 0)
+		{
+			REQUIRE(loader.Collect(device, 1) <= 1);
+		}
+
+		REQUIRE(device.results.size() == 4);
+		REQUIRE(device.batches == 4);
+	}
+}
+
+TEST_CASE("Async image decode into upload files", "[async_image_loader]")
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "mupfel_upload_files";
+	std::filesystem::create_directories(directory);
+
+	Mupfel::ThreadPool		 pool{2};
+	Mupfel::AsyncImageLoader loader{
+		pool, directory, [](const Mupfel::DecodedImage& image) { return image.width <= 4; }};
+	FakeUploadDevice device;
+
+	SECTION("Images that aren't kept are written out and read back the same")
+	{
+		loader.Submit({.path = WritePPM("mupfel_small.ppm", 4, 4), .firstHandle = 1});
+		loader.Submit({.path = WritePPM("mupfel_large.ppm", 8, 3), .firstHandle = 2});
+		loader.Flush(device);
+
+		const auto& small = device.results[0].images.value();
+		REQUIRE(small[0].file.empty());
+		REQUIRE(small[0].pixels.size() == 4 * 4 * 4);
+
+		const auto& large = device.results[1].images.value();
+		REQUIRE(large[0].file == directory / "2.png");
+		REQUIRE(large[0].pixels.empty());
+		REQUIRE(device.results[1].ByteSize() == 8 * 3 * 4);
+
+		/* The file holds what would have been in memory. */
+		std::ifstream			   file(large[0].file, std::ios::binary);
+		const std::vector<uint8_t> encoded{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+		auto					   decoded = Mupfel::AsyncImageLoader::DecodeMemory(encoded, {});
+		REQUIRE(decoded.has_value());
+		REQUIRE(decoded->front().width == 8);
+		REQUIRE(decoded->front().pixels[(2 * 8 + 5) * 4 + 0] == 5);
+		REQUIRE(decoded->front().pixels[(2 * 8 + 5) * 4 + 1] == 2);
+	}
+
+	SECTION("Files that can't be written fail the request")
+	{
+		Mupfel::AsyncImageLoader broken{pool, directory / "missing"};
+		broken.Submit({.path = WritePPM("mupfel_unwritable.ppm", 8, 3), .firstHandle = 3});
+		broken.Flush(device);
+
+		REQUIRE(device.results[0].images.error() == Mupfel::Error::WRITE_FAILED);
+	}
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,170 @@
+#include "Core/EventSystem.h"
+#include "Core/ThreadPool.h"
+#include "ECS/Components/Texture.h"
+#include "ECS/Components/Transform.h"
+#include "ECS/Registry.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/InstancePacker.h"
+#include "Renderer/VisibilityGrid.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/** An orthographic camera looking straight down at (`x`, `y`): it sees x and y within 10 units of that. */
+Frustum TopDown(float x = 0.0f, float y = 0.0f)
+{
+	const glm::mat4 view = glm::lookAt(glm::vec3(x, y, 100.0f), glm::vec3(x, y, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 proj = glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 500.0f);
+	return Frustum::FromViewProjection(proj * view);
+}
+
+/** A drawable unit quad at (`x`, `y`). */
+Entity MakeQuad(Registry& registry, float x, float y)
+{
+	Entity e = registry.CreateEntity();
+	registry.AddComponent<Transform>(e, Transform{.pos_x = x, .pos_y = y});
+	registry.AddComponent<Texture>(e, Texture{});
+	return e;
+}
+
+} // namespace
+
+TEST_CASE("Frustum tests", "[culling]")
+{
+	const Frustum frustum = TopDown();
+	const float	  r = Frustum::QuadRadius(1.0f, 1.0f);
+
+	SECTION("Spheres")
+	{
+		REQUIRE(frustum.IntersectsSphere(0.0f, 0.0f, 0.0f, r));
+		REQUIRE(frustum.IntersectsSphere(-9.0f, 9.0f, -50.0f, r));
+		REQUIRE_FALSE(frustum.IntersectsSphere(20.0f, 0.0f, 0.0f, r));
+		REQUIRE_FALSE(frustum.IntersectsSphere(0.0f, -20.0f, 0.0f, r));
+
+		/* Straddling an edge counts, just beyond it doesn't. */
+		REQUIRE(frustum.IntersectsSphere(10.5f, 0.0f, 0.0f, r));
+		REQUIRE_FALSE(frustum.IntersectsSphere(10.0f + r + 0.01f, 0.0f, 0.0f, r));
+
+		/* Behind the camera and beyond the far plane. */
+		REQUIRE_FALSE(frustum.IntersectsSphere(0.0f, 0.0f, 200.0f, r));
+		REQUIRE_FALSE(frustum.IntersectsSphere(0.0f, 0.0f, -500.0f, r));
+	}
+
+	SECTION("Boxes")
+	{
+		using Containment = Frustum::Containment;
+		REQUIRE(frustum.ClassifyBox({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}) == Containment::Inside);
+		REQUIRE(frustum.ClassifyBox({15.0f, -1.0f, -1.0f}, {20.0f, 1.0f, 1.0f}) == Containment::Outside);
+		REQUIRE(frustum.ClassifyBox({5.0f, -1.0f, -1.0f}, {15.0f, 1.0f, 1.0f}) == Containment::Intersecting);
+		REQUIRE(frustum.ClassifyBox({-20.0f, -20.0f, -1.0f}, {20.0f, 20.0f, 1.0f}) == Containment::Intersecting);
+	}
+
+	SECTION("The default frustum accepts everything")
+	{
+		const Frustum all;
+		REQUIRE(all.IntersectsSphere(1e6f, -1e6f, 1e6f, 0.0f));
+		REQUIRE(all.ClassifyBox({1e6f, 1e6f, 1e6f}, {2e6f, 2e6f, 2e6f}) == Frustum::Containment::Inside);
+	}
+}
+
+TEST_CASE("Instance culling", "[culling]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{1};
+	Registry	registry{event_system, thread_pool};
+
+	const Entity inside = MakeQuad(registry, 2.0f, -3.0f);
+	const Entity straddling = MakeQuad(registry, 10.4f, 0.0f);
+	MakeQuad(registry, 30.0f, 0.0f);
+	MakeQuad(registry, 0.0f, -11.0f);
+
+	std::vector<TextureInstance> out(8);
+	const uint32_t				 count = InstancePacker::Pack(registry, TopDown(), out);
+	REQUIRE(count == 2);
+	REQUIRE(out[0].pos_x == 2.0f);
+	REQUIRE(out[0].pos_y == -3.0f);
+	REQUIRE(out[1].pos_x == 10.4f);
+
+	/* A full buffer stops packing. */
+	std::vector<TextureInstance> one(1);
+	REQUIRE(InstancePacker::Pack(registry, TopDown(), one) == 1);
+
+	/* The grid finds the same two. */
+	VisibilityGrid grid{4.0f};
+	grid.Build(registry);
+	REQUIRE(grid.Size() == 4);
+
+	std::vector<Entity> visible;
+	grid.Query(TopDown(), visible);
+	std::ranges::sort(visible);
+	std::vector<Entity> expected{inside, straddling};
+	std::ranges::sort(expected);
+	REQUIRE(visible == expected);
+}
+
+TEST_CASE("Visibility grid over a world wider than its cell cap", "[culling]")
+{
+	EventSystem event_system;
+	ThreadPool	thread_pool{1};
+	Registry	registry{event_system, thread_pool};
+
+	/* 5000 units at one unit per cell: more cells than the grid allows along x. */
+	std::mt19937						  rng(3);
+	std::uniform_real_distribution<float> x(0.0f, 5000.0f);
+	std::uniform_real_distribution<float> y(-30.0f, 30.0f);
+	for (uint32_t i = 0; i < 20000; i++)
+	{
+		MakeQuad(registry, x(rng), y(rng));
+	}
+
+	SECTION("Queries match the per-instance test")
+	{
+		VisibilityGrid grid{1.0f};
+		grid.Build(registry);
+		REQUIRE(grid.GetCellCount() <= 1024 * 1024);
+
+		/* Across the grid, up to its far end, where capping the cells used to pile every entity up. */
+		for (const float at : {5.0f, 2500.0f, 4990.0f, 4999.0f})
+		{
+			const Frustum frustum = TopDown(at, 0.0f);
+
+			std::vector<Entity> visible;
+			grid.Query(frustum, visible);
+			std::ranges::sort(visible);
+
+			std::vector<Entity> expected;
+			for (auto [e, texture, t] : registry.view<Texture, Transform>())
+			{
+				if (frustum.IntersectsSphere(t.pos_x, t.pos_y, t.pos_z, Frustum::QuadRadius(1.0f, 1.0f)))
+				{
+					expected.push_back(e);
+				}
+			}
+			std::ranges::sort(expected);
+
+			REQUIRE_FALSE(expected.empty());
+			REQUIRE(visible == expected);
+		}
+	}
+
+	SECTION("A single entity far away")
+	{
+		const Entity far = MakeQuad(registry, 1e30f, 0.0f);
+
+		VisibilityGrid grid{1.0f};
+		grid.Build(registry);
+
+		std::vector<Entity> visible;
+		grid.Query(TopDown(1e30f, 0.0f), visible);
+		REQUIRE(visible == std::vector<Entity>{far});
+	}
+}
@@ -0,0 +1,192 @@
+#include "Renderer/InstanceSorter.h"
+#include "catch_amalgamated.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/**
+ * `count` instances with few distinct layers, depths (negative ones included) and textures, so that many
+ * of them share a key. `frame` holds each instance's number, which identifies it after sorting.
+ */
+std::vector<TextureInstance> MakeInstances(uint32_t count, std::mt19937& rng)
+{
+	const float								depths[] = {-40.5f, -3.0f, -1.0f, -0.25f, 0.0f, 0.5f, 2.0f, 17.0f};
+	std::uniform_int_distribution<uint32_t> layer(0, 3);
+	std::uniform_int_distribution<uint32_t> depth(0, std::size(depths) - 1);
+	std::uniform_int_distribution<uint32_t> texture(0, 5);
+
+	std::vector<TextureInstance> instances(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		instances[i].layer = layer(rng);
+		instances[i].pos_z = depths[depth(rng)];
+		instances[i].index = texture(rng);
+		instances[i].frame = i;
+	}
+	return instances;
+}
+
+/** What the sorter has to produce: `in`, stable-sorted by `MakeKey`. */
+std::vector<TextureInstance> Reference(const std::vector<TextureInstance>& in)
+{
+	std::vector<TextureInstance> sorted = in;
+	std::ranges::stable_sort(sorted, {}, &InstanceSorter::MakeKey);
+	return sorted;
+}
+
+std::vector<uint32_t> Ids(const std::vector<TextureInstance>& instances)
+{
+	std::vector<uint32_t> ids;
+	for (const TextureInstance& instance : instances)
+	{
+		ids.push_back(instance.frame);
+	}
+	return ids;
+}
+
+std::vector<uint64_t> Keys(const std::vector<TextureInstance>& instances)
+{
+	std::vector<uint64_t> keys;
+	for (const TextureInstance& instance : instances)
+	{
+		keys.push_back(InstanceSorter::MakeKey(instance));
+	}
+	return keys;
+}
+
+/**
+ * Instances with equal keys may come out in any order; everything else has to match `Reference`. Ties
+ * are compared as sets of ids.
+ */
+void RequireSortedLike(const std::vector<TextureInstance>& out, const std::vector<TextureInstance>& in)
+{
+	const std::vector<TextureInstance> expected = Reference(in);
+	REQUIRE(Keys(out) == Keys(expected));
+
+	std::vector<uint32_t> ids = Ids(out);
+	std::ranges::sort(ids);
+	std::vector<uint32_t> expected_ids = Ids(in);
+	std::ranges::sort(expected_ids);
+	REQUIRE(ids == expected_ids);
+}
+
+} // namespace
+
+TEST_CASE("Sort keys", "[instance_sorter]")
+{
+	auto key = [](uint32_t layer, float z, uint32_t texture)
+	{
+		TextureInstance instance;
+		instance.layer = layer;
+		instance.pos_z = z;
+		instance.index = texture;
+		return InstanceSorter::MakeKey(instance);
+	};
+
+	/* Layer first, then depth, negative ones included, then texture. */
+	REQUIRE(key(0, 100.0f, 9) < key(1, -100.0f, 0));
+	REQUIRE(key(0, -100.0f, 9) < key(0, -1.0f, 0));
+	REQUIRE(key(0, -1.0f, 9) < key(0, 0.0f, 0));
+	REQUIRE(key(0, 0.0f, 9) < key(0, 0.5f, 0));
+	REQUIRE(key(0, 0.5f, 0) < key(0, 0.5f, 1));
+
+	/* Layers past 8 bits saturate instead of spilling into other fields. */
+	REQUIRE(key(255, 0.0f, 0) == key(1000, 0.0f, 0));
+	REQUIRE(key(255, 0.0f, 0) >> 52 == 0);
+}
+
+TEST_CASE("Instance sorting", "[instance_sorter]")
+{
+	std::mt19937				 rng(11);
+	std::vector<TextureInstance> in = MakeInstances(20000, rng);
+	std::vector<TextureInstance> out(in.size());
+
+	SECTION("Radix sort is a stable sort")
+	{
+		InstanceSorter sorter{InstanceSorter::Mode::Radix};
+		sorter.Sort(in, out);
+		REQUIRE(Ids(out) == Ids(Reference(in)));
+
+		/* One layer and one texture: those digits are skipped, the result is the same. */
+		for (TextureInstance& instance : in)
+		{
+			instance.layer = 2;
+			instance.index = 3;
+		}
+		sorter.Sort(in, out);
+		REQUIRE(Ids(out) == Ids(Reference(in)));
+
+		/* Every key the same: nothing moves at all. */
+		for (TextureInstance& instance : in)
+		{
+			instance.pos_z = -1.0f;
+		}
+		sorter.Sort(in, out);
+		REQUIRE(Ids(out) == Ids(in));
+	}
+
+	SECTION("Off keeps the packing order")
+	{
+		InstanceSorter sorter{InstanceSorter::Mode::Off};
+		sorter.Sort(in, out);
+		REQUIRE(Ids(out) == Ids(in));
+	}
+
+	SECTION("Incremental sorting over coherent frames")
+	{
+		InstanceSorter sorter{InstanceSorter::Mode::Incremental};
+
+		/* The first frame has no order to start from and is a full sort. */
+		sorter.Sort(in, out);
+		REQUIRE(Ids(out) == Ids(Reference(in)));
+
+		uint32_t							  next_id = static_cast<uint32_t>(in.size());
+		std::uniform_int_distribution<size_t> pick(0, in.size() - 1);
+		std::uniform_real_distribution<float> nudge(-0.3f, 0.3f);
+		for (uint32_t frame = 0; frame < 20; frame++)
+		{
+			/* A few sprites move a little, and the packer drops some at the end or gains some on top. */
+			for (uint32_t i = 0; i < 20; i++)
+			{
+				in[pick(rng) % in.size()].pos_z += nudge(rng);
+			}
+			if (frame % 2 == 0)
+			{
+				in.resize(in.size() - 50);
+			}
+			else
+			{
+				for (uint32_t i = 0; i < 30; i++)
+				{
+					TextureInstance added;
+					added.layer = 3;
+					added.pos_z = 20.0f;
+					added.frame = next_id++;
+					in.push_back(added);
+				}
+			}
+
+			out.resize(in.size());
+			sorter.Sort(in, out);
+			REQUIRE_FALSE(sorter.LastSortFellBack());
+			RequireSortedLike(out, in);
+		}
+
+		/* A camera cut: nothing is where it was, the repair gives up and the radix sort takes over. */
+		std::ranges::shuffle(in, rng);
+		std::uniform_real_distribution<float> depth(-100.0f, 100.0f);
+		for (TextureInstance& instance : in)
+		{
+			instance.pos_z = depth(rng);
+		}
+		sorter.Sort(in, out);
+		REQUIRE(sorter.LastSortFellBack());
+		RequireSortedLike(out, in);
+	}
+}
@@ -0,0 +1,64 @@
+#include "Renderer/AsyncImageLoader.h"
+#include "Renderer/PngWriter.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/** Pixels whose channels are x, y, x + y and 255 (modulo 256), so misplaced rows or columns show. */
+std::vector<uint8_t> MakePixels(uint32_t width, uint32_t height)
+{
+	std::vector<uint8_t> pixels;
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			pixels.insert(
+				pixels.end(), {static_cast<uint8_t>(x), static_cast<uint8_t>(y), static_cast<uint8_t>(x + y), 255});
+		}
+	}
+	return pixels;
+}
+
+/** Writes and reads back a `width` x `height` image through the decoder asynchronous loads use. */
+void RoundTrip(uint32_t width, uint32_t height)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "mupfel_png_writer.png";
+	const std::vector<uint8_t>	pixels = MakePixels(width, height);
+	REQUIRE(WritePng(path, width, height, pixels));
+
+	std::ifstream			   file(path, std::ios::binary);
+	const std::vector<uint8_t> encoded{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	file.close();
+	std::filesystem::remove(path);
+
+	auto images = AsyncImageLoader::DecodeMemory(encoded, {});
+	REQUIRE(images.has_value());
+	REQUIRE(images->size() == 1);
+	REQUIRE(images->front().width == width);
+	REQUIRE(images->front().height == height);
+	REQUIRE(images->front().pixels == pixels);
+}
+
+} // namespace
+
+TEST_CASE("PNG writer", "[png_writer]")
+{
+	SECTION("Small images read back unchanged") { RoundTrip(3, 2); }
+
+	SECTION("Images spanning several stored blocks read back unchanged") { RoundTrip(300, 200); }
+
+	SECTION("Missing pixels are refused")
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "mupfel_png_short.png";
+		REQUIRE_FALSE(WritePng(path, 4, 4, std::vector<uint8_t>(4 * 4 * 4 - 1)));
+		REQUIRE_FALSE(WritePng(path, 0, 4, {}));
+	}
+}
@@ -0,0 +1,162 @@
+#include "Renderer/AtlasPacker.h"
+#include "Renderer/TextureAtlas.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+static bool Overlap(const Mupfel::AtlasRect& a, const Mupfel::AtlasRect& b)
+{
+	return a.page == b.page && a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+		   b.y < a.y + a.height;
+}
+
+static Mupfel::DecodedImage MakeImage(uint32_t width, uint32_t height, uint8_t value)
+{
+	Mupfel::DecodedImage image;
+	image.width = width;
+	image.height = height;
+	image.pixels.assign(static_cast<size_t>(width) * height * 4, value);
+	return image;
+}
+
+TEST_CASE("Atlas packing", "[atlas]")
+{
+	Mupfel::AtlasPacker packer{256, 256};
+
+	SECTION("Rectangles never overlap and stay inside their page")
+	{
+		std::mt19937							rng(42);
+		std::uniform_int_distribution<uint32_t> size(1, 48);
+
+		std::vector<Mupfel::AtlasRect> rects;
+		for (uint32_t i = 0; i < 500; i++)
+		{
+			const uint32_t w = size(rng);
+			const uint32_t h = size(rng);
+			auto		   rect = packer.Insert(w, h);
+			REQUIRE(rect.has_value());
+			REQUIRE(rect->width == w);
+			REQUIRE(rect->height == h);
+			REQUIRE(rect->x + w <= 256);
+			REQUIRE(rect->y + h <= 256);
+			rects.push_back(rect.value());
+		}
+
+		for (uint32_t i = 0; i < rects.size(); i++)
+		{
+			for (uint32_t j = i + 1; j < rects.size(); j++)
+			{
+				REQUIRE_FALSE(Overlap(rects[i], rects[j]));
+			}
+		}
+
+		REQUIRE(packer.GetPageCount() > 1);
+		REQUIRE(packer.GetOccupancy() > 0.5f);
+	}
+
+	SECTION("Rectangles larger than a page are rejected")
+	{
+		REQUIRE_FALSE(packer.Insert(257, 1).has_value());
+		REQUIRE_FALSE(packer.Insert(0, 4).has_value());
+		REQUIRE(packer.GetPageCount() == 0);
+
+		/* A full page fits exactly, padding is clipped at the edge. */
+		REQUIRE(packer.Insert(256, 256).has_value());
+		REQUIRE(packer.GetOccupancy() == 1.0f);
+	}
+
+	SECTION("Batches report every position at its input index")
+	{
+		std::vector<Mupfel::AtlasRect> sizes = {{.width = 10, .height = 5}, {.width = 300, .height = 1},
+												{.width = 20, .height = 30}};
+		std::vector<Mupfel::AtlasRect> out(sizes.size());
+
+		REQUIRE(packer.InsertBatch(sizes, out) == 2);
+		REQUIRE(out[0].width == 10);
+		REQUIRE(out[1].width == 0);
+		REQUIRE(out[2].height == 30);
+
+		/* Tallest first: the 30 pixel rectangle took the origin. */
+		REQUIRE(out[2].x == 0);
+		REQUIRE(out[2].y == 0);
+	}
+}
+
+TEST_CASE("Texture atlas", "[atlas]")
+{
+	Mupfel::TextureAtlas atlas{64, 32};
+
+	SECTION("Pixels land inside the returned region")
+	{
+		auto first = atlas.Insert(MakeImage(16, 8, 1));
+		auto second = atlas.Insert(MakeImage(32, 32, 2));
+		REQUIRE(first.has_value());
+		REQUIRE(second.has_value());
+		REQUIRE(atlas.GetPageCount() == 1);
+
+		const std::vector<Mupfel::AtlasPage> pages = atlas.FinishPages();
+		REQUIRE(pages.size() == 1);
+		const std::vector<uint8_t>& pixels = pages[0].pixels;
+		REQUIRE(pixels.size() == 64 * 64 * 4);
+
+		for (const auto& [region, value] : {std::pair{first.value(), 1}, std::pair{second.value(), 2}})
+		{
+			const uint32_t x = static_cast<uint32_t>(region.u * 64.0f);
+			const uint32_t y = static_cast<uint32_t>(region.v * 64.0f);
+			const uint32_t w = static_cast<uint32_t>(region.width * 64.0f);
+			const uint32_t h = static_cast<uint32_t>(region.height * 64.0f);
+
+			REQUIRE(pixels[((y * 64) + x) * 4] == value);
+			REQUIRE(pixels[(((y + h - 1) * 64) + x + w - 1) * 4] == value);
+		}
+	}
+
+	SECTION("Large and animated images are left out")
+	{
+		REQUIRE_FALSE(atlas.Insert(MakeImage(33, 8, 1)).has_value());
+
+		Mupfel::DecodedImage animated = MakeImage(8, 8, 1);
+		animated.spec = {.rows = 1, .columns = 2};
+		REQUIRE_FALSE(atlas.Accepts(animated));
+		REQUIRE(atlas.GetPageCount() == 0);
+	}
+
+	SECTION("Full pages spill into new pages")
+	{
+		/* With one pixel of padding, four 31 x 31 images fill a 64 x 64 page. */
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			auto region = atlas.Insert(MakeImage(31, 31, 3));
+			REQUIRE(region.has_value());
+			REQUIRE(region->layer == i / 4);
+		}
+
+		REQUIRE(atlas.GetPageCount() == 2);
+		const std::vector<Mupfel::AtlasPage> pages = atlas.FinishPages();
+		REQUIRE(pages.size() == 2);
+		REQUIRE(pages[1].index == 1);
+		REQUIRE(pages[1].pixels.size() == 64 * 64 * 4);
+	}
+
+	SECTION("Finished pages are handed out once and never written again")
+	{
+		REQUIRE(atlas.Insert(MakeImage(16, 8, 1)).has_value());
+		REQUIRE(atlas.FinishPages().size() == 1);
+		REQUIRE(atlas.GetFinishedPageCount() == 1);
+		REQUIRE(atlas.FinishPages().empty());
+
+		/* The first page has plenty of room left, but it's closed. */
+		auto second = atlas.Insert(MakeImage(16, 8, 2));
+		REQUIRE(second.has_value());
+		REQUIRE(second->layer == 1);
+		REQUIRE(second->u == 0.0f);
+		REQUIRE(second->v == 0.0f);
+
+		const std::vector<Mupfel::AtlasPage> pages = atlas.FinishPages();
+		REQUIRE(pages.size() == 1);
+		REQUIRE(pages[0].index == 1);
+		REQUIRE(pages[0].pixels[0] == 2);
+		REQUIRE(atlas.GetFinishedPageCount() == 2);
+	}
+}
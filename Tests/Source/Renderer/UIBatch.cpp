@@ -0,0 +1,130 @@
+#include "Renderer/LinearAllocator.h"
+#include "Renderer/UIBatch.h"
+#include "catch_amalgamated.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace Mupfel;
+
+namespace
+{
+
+/** Over-aligned, so misplaced allocations show. */
+struct alignas(32) Wide
+{
+	uint32_t value;
+};
+
+/** The allocator's blocks, as (size, first value) pairs. */
+std::vector<std::pair<size_t, uint32_t>> Blocks(const LinearAllocator<Wide>& allocator)
+{
+	std::vector<std::pair<size_t, uint32_t>> blocks;
+	allocator.ForEachBlock([&](std::span<const Wide> block) { blocks.emplace_back(block.size(), block[0].value); });
+	return blocks;
+}
+
+} // namespace
+
+TEST_CASE("Linear allocator", "[linear_allocator]")
+{
+	LinearAllocator<Wide> allocator{4};
+
+	/* Ten allocations spill over three pages; earlier ones stay where they are. */
+	std::vector<Wide*> allocated;
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		Wide* w = allocator.Allocate();
+		REQUIRE(reinterpret_cast<uintptr_t>(w) % alignof(Wide) == 0);
+		w->value = i;
+		allocated.push_back(w);
+	}
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		REQUIRE(allocated[i]->value == i);
+	}
+	REQUIRE(allocator.Size() == 10);
+	REQUIRE(allocator.Capacity() == 12);
+	REQUIRE(Blocks(allocator) == std::vector<std::pair<size_t, uint32_t>>{{4, 0}, {4, 4}, {2, 8}});
+
+	/* Reset coalesces the pages into one of their combined size. */
+	allocator.Reset();
+	REQUIRE(allocator.Size() == 0);
+	REQUIRE(allocator.Capacity() == 12);
+	REQUIRE(Blocks(allocator).empty());
+
+	/* The next frame of the same size fits that page and allocates nothing. */
+	Wide* first = allocator.Allocate();
+	first->value = 100;
+	for (uint32_t i = 1; i < 12; i++)
+	{
+		allocator.Allocate()->value = 100 + i;
+	}
+	REQUIRE(allocator.Capacity() == 12);
+	REQUIRE(Blocks(allocator) == std::vector<std::pair<size_t, uint32_t>>{{12, 100}});
+
+	/* A single page is reused as it is. */
+	allocator.Reset();
+	REQUIRE(allocator.Allocate() == first);
+}
+
+TEST_CASE("UI batch", "[ui_batch]")
+{
+	UIBatch batch;
+	batch.Begin(800.0f, 600.0f);
+
+	SECTION("Quads are converted to NDC")
+	{
+		batch.Push(0.0f, 0.0f, 800.0f, 600.0f, 0.5f, ImageRegion{.slot = 3, .layer = 2, .u = 0.25f}, 2.0f);
+
+		std::vector<UIInstance> out(1);
+		REQUIRE(batch.CopyTo(out) == 1);
+		REQUIRE(out[0].pos_x == 0.0f);
+		REQUIRE(out[0].pos_y == 0.0f);
+		REQUIRE(out[0].width == 2.0f);
+		REQUIRE(out[0].height == -2.0f);
+		REQUIRE(out[0].rotation == 0.5f);
+		REQUIRE(out[0].index == 3);
+		REQUIRE(out[0].layer == 2);
+		REQUIRE(out[0].uv_u == 0.25f);
+		REQUIRE(out[0].uvScale == 2.0f);
+	}
+
+	SECTION("Quads come out in push order, across pages")
+	{
+		/* More than one page of the allocator. */
+		const uint32_t count = 10000;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			batch.Push(0.0f, 0.0f, 1.0f, 1.0f, static_cast<float>(i), ImageRegion{}, 1.0f);
+		}
+		REQUIRE(batch.Size() == count);
+
+		std::vector<UIInstance> out(count);
+		REQUIRE(batch.CopyTo(out) == count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			REQUIRE(out[i].rotation == static_cast<float>(i));
+		}
+
+		/* A short buffer takes the first quads. */
+		std::vector<UIInstance> few(5000);
+		REQUIRE(batch.CopyTo(few) == 5000);
+		REQUIRE(few.back().rotation == 4999.0f);
+
+		/* The next frame starts empty. */
+		batch.Begin(800.0f, 600.0f);
+		REQUIRE(batch.Size() == 0);
+		batch.Push(0.0f, 0.0f, 1.0f, 1.0f, 7.0f, ImageRegion{}, 1.0f);
+		REQUIRE(batch.CopyTo(out) == 1);
+		REQUIRE(out[0].rotation == 7.0f);
+	}
+
+	SECTION("Nothing is drawn to a framebuffer without area")
+	{
+		batch.Begin(0.0f, 600.0f);
+		batch.Push(0.0f, 0.0f, 1.0f, 1.0f, 0.0f, ImageRegion{}, 1.0f);
+		REQUIRE(batch.Size() == 0);
+	}
+}
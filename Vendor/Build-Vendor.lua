@@ -12,6 +12,8 @@
 --   Ping     -> spdlog/glfw/imgui/stb headers, Vulkan SDK headers
 --   box2d    (no internal deps)           (collision detection/resolution, linked by Core)
 --   catch2   (no internal deps)           (unit test framework, linked by the Tests project)
+--   lz4      (no internal deps)           (resource pack compression, linked by Core)
+--   zstd     (no internal deps)           (resource pack compression, linked by Core)
 
 project "spdlog"
     kind "StaticLib"
@@ -116,3 +118,45 @@ project "catch2"
     includedirs { DepPath("catch2") }
 
     defines { "DO_NOT_USE_WMAIN" }
+
+-- LZ4 and Zstandard, the two codecs resource pack entries can be compressed with. Both are plain C.
+project "lz4"
+    kind "StaticLib"
+    ApplyDefaultProjectSettings()
+
+    language "C"
+
+    files { DepPath("lz4", "lz4.c"), DepPath("lz4", "lz4.h") }
+    includedirs { DepPath("lz4") }
+
+    filter "system:windows"
+        removebuildoptions { "/EHsc", "/Zc:__cplusplus" }
+    filter {}
+
+-- Only the single-threaded compressor and decompressor from lib/ (no dictionary builder, no legacy
+-- formats). ZSTD_DISABLE_ASM drops the x86-64 assembly Huffman decoder, which is a .S file premake
+-- doesn't build on every toolchain; the C fallback decodes the same data.
+project "zstd"
+    kind "StaticLib"
+    ApplyDefaultProjectSettings()
+
+    language "C"
+
+    files
+    {
+        DepPath("zstd", "lib/zstd.h"),
+        DepPath("zstd", "lib/common/*.c"),
+        DepPath("zstd", "lib/common/*.h"),
+        DepPath("zstd", "lib/compress/*.c"),
+        DepPath("zstd", "lib/compress/*.h"),
+        DepPath("zstd", "lib/decompress/*.c"),
+        DepPath("zstd", "lib/decompress/*.h"),
+    }
+
+    includedirs { DepPath("zstd", "lib"), DepPath("zstd", "lib/common") }
+
+    defines { "ZSTD_DISABLE_ASM", "ZSTD_LEGACY_SUPPORT=0" }
+
+    filter "system:windows"
+        removebuildoptions { "/EHsc", "/Zc:__cplusplus" }
+    filter {}